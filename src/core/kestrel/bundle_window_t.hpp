@@ -0,0 +1,136 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_BUNDLE_WINDOW_T_HPP
+#define KESTREL_BUNDLE_WINDOW_T_HPP
+
+#include <cstddef>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+#include <sst/catalog/mono_time_ns.hpp>
+
+namespace kestrel {
+
+//
+// Coalesces items headed to the same destination into one bundle per
+// Key. A bundle opens with its first item and should be sent once it
+// holds max_count items or once window_ns has passed since it opened,
+// whichever comes first. A window of zero or less disables coalescing,
+// so every bundle is due as soon as it has an item.
+//
+// Value is the caller's bundle payload. This class only decides when
+// each bundle is due; the caller does the sending.
+//
+
+template<class Key,
+         class Value,
+         class Time = decltype(sst::mono_time_ns())>
+class bundle_window_t final {
+
+public:
+
+  struct bundle_t final {
+    Value value{};
+    std::size_t count = 0;
+    Time deadline = 0;
+  };
+
+private:
+
+  Time window_ns_;
+  std::size_t max_count_;
+  std::map<Key, bundle_t> bundles_;
+
+public:
+
+  explicit bundle_window_t(Time const window_ns = 0,
+                           std::size_t const max_count = 1) {
+    configure(window_ns, max_count);
+  }
+
+  void configure(Time const window_ns, std::size_t const max_count) {
+    if (max_count < 1) {
+      throw std::invalid_argument(
+          "bundle_window_t: max_count must be at least 1");
+    }
+    window_ns_ = window_ns;
+    max_count_ = max_count;
+  }
+
+  // Returns the open bundle for key, opening an empty one whose window
+  // starts at now if there is none.
+  bundle_t & open(Key const & key, Time const now) {
+    auto const it = bundles_.find(key);
+    if (it != bundles_.end()) {
+      return it->second;
+    }
+    bundle_t & b = bundles_[key];
+    b.deadline = now + (window_ns_ > 0 ? window_ns_ : 0);
+    return b;
+  }
+
+  // Counts one more item into a bundle returned by open() and returns
+  // true if the bundle is now due.
+  bool add(bundle_t & bundle, Time const now) {
+    ++bundle.count;
+    return window_ns_ <= 0 || bundle.count >= max_count_
+           || now >= bundle.deadline;
+  }
+
+  // Removes the bundle for key, normally after sending it.
+  void erase(Key const & key) {
+    bundles_.erase(key);
+  }
+
+  // Removes every bundle whose window has passed, or every bundle if
+  // all is true, and calls f(key, bundle) for each one. Returns the
+  // earliest deadline among the bundles left open, or 0 if none are.
+  // If f throws, the bundle it was given is still removed.
+  template<class F>
+  Time flush(Time const now, bool const all, F && f) {
+    Time earliest = 0;
+    for (auto it = bundles_.begin(); it != bundles_.end();) {
+      if (all || now >= it->second.deadline) {
+        Key const key = it->first;
+        bundle_t b = std::move(it->second);
+        it = bundles_.erase(it);
+        f(key, b);
+      } else {
+        if (earliest == 0 || it->second.deadline < earliest) {
+          earliest = it->second.deadline;
+        }
+        ++it;
+      }
+    }
+    return earliest;
+  }
+
+  std::size_t size() const noexcept {
+    return bundles_.size();
+  }
+
+  bool empty() const noexcept {
+    return bundles_.empty();
+  }
+};
+
+} // namespace kestrel
+
+#endif // #ifndef KESTREL_BUNDLE_WINDOW_T_HPP
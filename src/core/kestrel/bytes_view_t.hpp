@@ -0,0 +1,125 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_BYTES_VIEW_T_HPP
+#define KESTREL_BYTES_VIEW_T_HPP
+
+#include <cstddef>
+#include <stdexcept>
+
+#include <sst/catalog/SST_ASSERT.h>
+
+#include <kestrel/bytes_t.hpp>
+
+namespace kestrel {
+
+//
+// A bytes_view_t refers to a range of bytes owned by someone else,
+// usually a slice of a received packet buffer. It is only valid for as
+// long as the underlying buffer is alive and unmodified. Use to_bytes()
+// to make an owning copy of anything that needs to outlive the buffer.
+//
+
+class bytes_view_t final {
+
+  unsigned char const * data_ = nullptr;
+  bytes_t::size_type size_ = 0;
+
+public:
+
+  using value_type = unsigned char;
+  using size_type = bytes_t::size_type;
+  using const_iterator = unsigned char const *;
+  using iterator = const_iterator;
+
+  bytes_view_t() noexcept = default;
+
+  bytes_view_t(unsigned char const * const data,
+               size_type const size) noexcept
+      : data_(data),
+        size_(size) {
+    SST_ASSERT((data != nullptr || size == 0));
+  }
+
+  bytes_view_t(bytes_t const & src) noexcept
+      : data_(src.data()),
+        size_(src.size()) {
+  }
+
+  // A view of a temporary would dangle right away.
+  bytes_view_t(bytes_t &&) = delete;
+
+  unsigned char const * data() const noexcept {
+    return data_;
+  }
+
+  size_type size() const noexcept {
+    return size_;
+  }
+
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  const_iterator begin() const noexcept {
+    return data_;
+  }
+
+  const_iterator end() const noexcept {
+    return data_ + size_;
+  }
+
+  unsigned char const & operator[](size_type const i) const noexcept {
+    SST_ASSERT((i < size_));
+    return data_[i];
+  }
+
+  bytes_view_t subview(size_type const offset,
+                       size_type const count) const {
+    if (offset > size_ || count > size_ - offset) {
+      throw std::out_of_range("bytes_view_t::subview");
+    }
+    return bytes_view_t(data_ + offset, count);
+  }
+
+  bytes_t to_bytes() const {
+    return bytes_t(begin(), end());
+  }
+
+  friend bool operator==(bytes_view_t const & a,
+                         bytes_view_t const & b) noexcept {
+    if (a.size_ != b.size_) {
+      return false;
+    }
+    for (size_type i = 0; i != a.size_; ++i) {
+      if (a.data_[i] != b.data_[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  friend bool operator!=(bytes_view_t const & a,
+                         bytes_view_t const & b) noexcept {
+    return !(a == b);
+  }
+};
+
+} // namespace kestrel
+
+#endif // #ifndef KESTREL_BYTES_VIEW_T_HPP
@@ -19,6 +19,8 @@
 #ifndef KESTREL_CARMA_CLRMSG_STORE_ENTRY_T_HPP
 #define KESTREL_CARMA_CLRMSG_STORE_ENTRY_T_HPP
 
+#include <cstdint>
+
 #include <sst/catalog/moved_from.hpp>
 
 #include <kestrel/clrmsg_t.hpp>
@@ -26,6 +28,8 @@
 namespace kestrel {
 namespace carma {
 
+class clrmsg_store_t;
+
 class clrmsg_store_entry_t final {
 
   //--------------------------------------------------------------------
@@ -87,6 +91,24 @@ public:
 
   ~clrmsg_store_entry_t() noexcept;
 
+  //--------------------------------------------------------------------
+  // id
+  //--------------------------------------------------------------------
+  //
+  // The id that clrmsg_store_t::add gave this entry, or zero if the
+  // entry has not been added to a store. Copies start out with no id.
+  //
+
+private:
+
+  std::uint64_t id_ = 0;
+
+  friend class clrmsg_store_t;
+
+public:
+
+  std::uint64_t id() const;
+
   //--------------------------------------------------------------------
   // move-assign
   //--------------------------------------------------------------------
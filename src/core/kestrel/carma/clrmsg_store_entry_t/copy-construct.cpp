@@ -30,6 +30,7 @@ clrmsg_store_entry_t::clrmsg_store_entry_t(
     : clrmsg_(other.clrmsg_),
       clrmsg_done_(other.clrmsg_done_),
       dirty_(true),
+      id_(0),
       moved_from_(other.moved_from_) {
 }
 
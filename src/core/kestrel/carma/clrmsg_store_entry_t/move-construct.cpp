@@ -32,6 +32,7 @@ clrmsg_store_entry_t::clrmsg_store_entry_t(
     : clrmsg_(std::move(other.clrmsg_)),
       clrmsg_done_(std::move(other.clrmsg_done_)),
       dirty_(true),
+      id_(std::move(other.id_)),
       moved_from_(std::move(other.moved_from_)) {
 }
 
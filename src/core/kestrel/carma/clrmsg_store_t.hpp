@@ -19,6 +19,9 @@
 #ifndef KESTREL_CARMA_CLRMSG_STORE_T_HPP
 #define KESTREL_CARMA_CLRMSG_STORE_T_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -26,23 +29,83 @@
 #include <sst/catalog/moved_from.hpp>
 
 #include <kestrel/carma/clrmsg_store_entry_t.hpp>
+#include <kestrel/clrmsg_t.hpp>
 #include <kestrel/common_sdk_t.hpp>
 #include <kestrel/tracing_event_t.hpp>
 
 namespace kestrel {
 namespace carma {
 
+//
+// A store of clear messages that survives restarts. The entries are
+// kept in memory and persisted in dir_ as a snapshot plus a write-ahead
+// log:
+//
+//    dir_/snapshot        An atomic file (see write_atomic_file) that
+//                         holds every entry as of the start of the
+//                         current generation.
+//
+//    dir_/log.<g>/records The records appended since the snapshot of
+//                         generation g was written.
+//
+// Both files are sequences of records of the form
+//
+//    size (4 bytes) | crc32c(payload) (4 bytes) | payload (size bytes)
+//
+// where the payload starts with a record type byte and an 8 byte id.
+// A put record follows these with the serialized clrmsg_t, and a meta
+// record, which begins each snapshot, with the next id to hand out.
+//
+// add() and erase() only change memory. flush() appends the records
+// for all changes since the previous flush to the log in one write, so
+// changes are committed in groups at the caller's flush cadence. If an
+// append fails, the next flush() compacts instead of appending behind
+// what may be a partial record. When
+// the log grows past compact_min_bytes and twice the size of the live
+// entries, flush() calls compact(), which writes a new snapshot, starts
+// a new generation, and deletes the old log.
+//
+// The constructor loads the snapshot and replays its log, dropping a
+// torn record at the end of the log, if any. If the log held anything,
+// it then compacts, so recovery never replays more than one log.
+//
+
 class clrmsg_store_t final {
 
   //--------------------------------------------------------------------
   // add
   //--------------------------------------------------------------------
+  //
+  // Adds entry to the store under a new id and returns a reference to
+  // the stored entry. The reference stays valid until the entry is
+  // erased. Throws std::runtime_error, leaving the store unchanged, if
+  // the entry would take the store past its max_bytes limit.
+  //
 
 public:
 
   clrmsg_store_entry_t & add(tracing_event_t tev,
                              clrmsg_store_entry_t entry);
 
+  //--------------------------------------------------------------------
+  // append_log
+  //--------------------------------------------------------------------
+
+private:
+
+  void append_log(tracing_event_t tev,
+                  std::vector<unsigned char> const & data);
+
+  //--------------------------------------------------------------------
+  // compact
+  //--------------------------------------------------------------------
+
+public:
+
+  static constexpr std::uint64_t compact_min_bytes = 1048576;
+
+  void compact(tracing_event_t tev);
+
   //--------------------------------------------------------------------
   // construct
   //--------------------------------------------------------------------
@@ -92,24 +155,117 @@ private:
   //--------------------------------------------------------------------
   // entries_
   //--------------------------------------------------------------------
+
+public:
+
+  using entries_t = std::map<std::uint64_t, clrmsg_store_entry_t>;
+
+private:
+
+  std::unique_ptr<entries_t> entries_;
+
+public:
+
+  // The entries keyed by id, oldest first.
+  entries_t const & entries() const;
+
+  //--------------------------------------------------------------------
+  // erase
+  //--------------------------------------------------------------------
   //
-  // TODO: This data structure is the simplest possible thing that lets
-  //       us implement add(). It will have to change as we implement
-  //       more functionality.
+  // Removes the entry with the given id, if any, and returns whether
+  // there was one.
   //
 
 private:
 
-  std::unique_ptr<std::vector<clrmsg_store_entry_t>> entries_;
+  std::vector<std::uint64_t> erased_;
+
+public:
+
+  bool erase(tracing_event_t tev, std::uint64_t id);
+
+  //--------------------------------------------------------------------
+  // find
+  //--------------------------------------------------------------------
+
+public:
+
+  clrmsg_store_entry_t * find(tracing_event_t tev, std::uint64_t id);
 
   //--------------------------------------------------------------------
   // flush
   //--------------------------------------------------------------------
 
+private:
+
+  std::vector<unsigned char> flush_buf_;
+
 public:
 
   void flush(tracing_event_t tev);
 
+  //--------------------------------------------------------------------
+  // generation_
+  //--------------------------------------------------------------------
+
+private:
+
+  std::uint64_t generation_ = 0;
+
+  std::string log_dir(std::uint64_t generation) const;
+
+  std::string log_file(std::uint64_t generation) const;
+
+  std::string snapshot_file() const;
+
+  //--------------------------------------------------------------------
+  // log_bytes_
+  //--------------------------------------------------------------------
+  //
+  // The size of the current log and of the records that a snapshot of
+  // the current entries would hold, as of the last flush.
+  //
+
+private:
+
+  std::uint64_t log_bytes_ = 0;
+  std::uint64_t live_bytes_ = 0;
+
+  //--------------------------------------------------------------------
+  // log_torn_
+  //--------------------------------------------------------------------
+  //
+  // Whether an append to the current log failed. The failed append may
+  // have left part of a record at the end of the log, and replay would
+  // stop there and drop everything appended after it. While this is
+  // set, flush() compacts instead of appending.
+  //
+
+private:
+
+  bool log_torn_ = false;
+
+  //--------------------------------------------------------------------
+  // max_bytes
+  //--------------------------------------------------------------------
+  //
+  // The serialized size of the clear messages in the store, and the
+  // most that add() lets it grow to, or 0 for no limit. Entries loaded
+  // by the constructor are kept even if they go past the limit.
+  //
+
+private:
+
+  std::size_t bytes_ = 0;
+  std::size_t max_bytes_ = 0;
+
+public:
+
+  std::size_t bytes() const noexcept;
+
+  void set_max_bytes(std::size_t src);
+
   //--------------------------------------------------------------------
   // move-assign
   //--------------------------------------------------------------------
@@ -134,6 +290,39 @@ private:
 
   sst::moved_from moved_from_;
 
+  //--------------------------------------------------------------------
+  // next_id_
+  //--------------------------------------------------------------------
+
+private:
+
+  std::uint64_t next_id_ = 1;
+
+  //--------------------------------------------------------------------
+  // records
+  //--------------------------------------------------------------------
+
+private:
+
+  enum class record_type_t : unsigned char {
+    put = 1,
+    erase = 2,
+    meta = 3,
+  };
+
+  static constexpr std::size_t record_header_size = 8;
+
+  static void put_record(std::vector<unsigned char> & dst,
+                         record_type_t type,
+                         std::uint64_t id,
+                         clrmsg_t const * clrmsg,
+                         std::uint64_t next_id = 0);
+
+  // Applies the records at the front of src, stopping at the first
+  // one that is cut short or fails its checksum, and returns the
+  // number of bytes applied.
+  std::size_t apply_records(std::vector<unsigned char> const & src);
+
   //--------------------------------------------------------------------
   // sdk_
   //--------------------------------------------------------------------
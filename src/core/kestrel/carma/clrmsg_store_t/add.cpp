@@ -22,11 +22,14 @@
 #include <kestrel/carma/clrmsg_store_t.hpp>
 //
 
+#include <cstddef>
+#include <stdexcept>
 #include <utility>
 
 #include <sst/catalog/SST_ASSERT.h>
 #include <sst/catalog/SST_TEV_ADD.hpp>
 #include <sst/catalog/SST_TEV_RETHROW.hpp>
+#include <sst/catalog/c_quote.hpp>
 
 #include <kestrel/carma/clrmsg_store_entry_t.hpp>
 #include <kestrel/tracing_event_t.hpp>
@@ -39,8 +42,21 @@ clrmsg_store_entry_t & clrmsg_store_t::add(tracing_event_t tev,
   SST_TEV_ADD(tev);
   try {
     SST_ASSERT((!moved_from_));
-    entries_->emplace_back(std::move(entry));
-    return entries_->back();
+    std::size_t const size =
+        entry.clrmsg().to_bytes_size<std::size_t>();
+    if (max_bytes_ != 0
+        && (size > max_bytes_ || bytes_ > max_bytes_ - size)) {
+      throw std::runtime_error("The clrmsg store in "
+                               + sst::c_quote(dir_) + " is full.");
+    }
+    auto const id = next_id_;
+    clrmsg_store_entry_t & x =
+        entries_->emplace(id, std::move(entry)).first->second;
+    ++next_id_;
+    bytes_ += size;
+    x.id_ = id;
+    x.dirty(true);
+    return x;
   }
   SST_TEV_RETHROW(tev);
 }
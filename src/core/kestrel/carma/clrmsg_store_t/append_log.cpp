@@ -0,0 +1,66 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/clrmsg_store_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/clrmsg_store_t.hpp>
+//
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sst/catalog/SST_ASSERT.h>
+#include <sst/catalog/SST_TEV_ADD.hpp>
+#include <sst/catalog/SST_TEV_ARG.hpp>
+#include <sst/catalog/SST_TEV_RETHROW.hpp>
+#include <sst/catalog/c_quote.hpp>
+#include <sst/catalog/checked_cast.hpp>
+
+#include <kestrel/tracing_event_t.hpp>
+
+namespace kestrel {
+namespace carma {
+
+void clrmsg_store_t::append_log(
+    tracing_event_t tev,
+    std::vector<unsigned char> const & data) {
+  SST_TEV_ADD(tev);
+  try {
+    SST_ASSERT((!moved_from_));
+    std::string const file = log_file(generation_);
+    if (sdk_) {
+      sdk_->appendFile(SST_TEV_ARG(tev), file, data);
+    } else {
+      std::ofstream stream(file, std::ios::binary | std::ios::app);
+      stream.write(reinterpret_cast<char const *>(data.data()),
+                   sst::checked_cast<std::streamsize>(data.size()));
+      stream.flush();
+      if (!stream) {
+        throw std::runtime_error("Error appending to file: "
+                                 + sst::c_quote(file) + ".");
+      }
+    }
+  }
+  SST_TEV_RETHROW(tev);
+}
+
+} // namespace carma
+} // namespace kestrel
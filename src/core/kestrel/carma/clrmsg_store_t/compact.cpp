@@ -0,0 +1,92 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/clrmsg_store_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/clrmsg_store_t.hpp>
+//
+
+#include <vector>
+
+#include <sst/catalog/SST_ASSERT.h>
+#include <sst/catalog/SST_TEV_ADD.hpp>
+#include <sst/catalog/SST_TEV_ARG.hpp>
+#include <sst/catalog/SST_TEV_RETHROW.hpp>
+#include <sst/catalog/mkdir_p.hpp>
+#include <sst/catalog/rm_f_r.hpp>
+
+#include <kestrel/tracing_event_t.hpp>
+#include <kestrel/write_atomic_file.hpp>
+
+namespace kestrel {
+namespace carma {
+
+void clrmsg_store_t::compact(tracing_event_t tev) {
+  SST_TEV_ADD(tev);
+  try {
+    SST_ASSERT((!moved_from_));
+
+    auto const old_generation = generation_;
+    auto const new_generation = generation_ + 1;
+
+    if (sdk_) {
+      sdk_->removeDir(SST_TEV_ARG(tev), log_dir(new_generation));
+    } else {
+      sst::rm_f_r(log_dir(new_generation));
+    }
+
+    std::vector<unsigned char> data;
+    put_record(data,
+               record_type_t::meta,
+               new_generation,
+               nullptr,
+               next_id_);
+    for (auto const & kv : *entries_) {
+      put_record(data,
+                 record_type_t::put,
+                 kv.first,
+                 &kv.second.clrmsg());
+    }
+
+    // Once the snapshot is written, the new generation is the current
+    // one, even if we crash before the rest of this is done.
+    write_atomic_file(SST_TEV_ARG(tev), sdk_, snapshot_file(), data);
+
+    generation_ = new_generation;
+    log_torn_ = false;
+    log_bytes_ = 0;
+    live_bytes_ = data.size();
+    for (auto & kv : *entries_) {
+      kv.second.dirty(false);
+    }
+    erased_.clear();
+
+    if (sdk_) {
+      sdk_->xMakeDirs(SST_TEV_ARG(tev), log_dir(new_generation));
+      sdk_->removeDir(SST_TEV_ARG(tev), log_dir(old_generation));
+    } else {
+      sst::mkdir_p(log_dir(new_generation));
+      sst::rm_f_r(log_dir(old_generation));
+    }
+  }
+  SST_TEV_RETHROW(tev);
+}
+
+} // namespace carma
+} // namespace kestrel
@@ -22,14 +22,26 @@
 #include <kestrel/carma/clrmsg_store_t.hpp>
 //
 
+#include <stdexcept>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <sst/catalog/SST_TEV_ADD.hpp>
+#include <sst/catalog/SST_TEV_ARG.hpp>
 #include <sst/catalog/SST_TEV_RETHROW.hpp>
+#include <sst/catalog/c_quote.hpp>
+#include <sst/catalog/dir_it.hpp>
 #include <sst/catalog/make_unique.hpp>
+#include <sst/catalog/mkdir_p.hpp>
+#include <sst/catalog/path.hpp>
+#include <sst/catalog/read_whole_file.hpp>
+#include <sst/catalog/rm_f_r.hpp>
+#include <sst/catalog/test_f.hpp>
+#include <sst/catalog/to_string.hpp>
 
 #include <kestrel/common_sdk_t.hpp>
+#include <kestrel/read_atomic_file.hpp>
 #include <kestrel/tracing_event_t.hpp>
 
 namespace kestrel {
@@ -43,7 +55,104 @@ clrmsg_store_t::clrmsg_store_t(tracing_event_t tev,
       sdk_(sdk) {
   SST_TEV_ADD(tev);
   try {
-    // TODO
+
+    if (sdk_) {
+      sdk_->xMakeDirs(SST_TEV_ARG(tev), dir_);
+    } else {
+      sst::mkdir_p(dir_);
+    }
+
+    //------------------------------------------------------------------
+    // Load the snapshot
+    //------------------------------------------------------------------
+    //
+    // The snapshot was written atomically, so anything short of a
+    // complete parse means it was damaged after the fact, and there is
+    // no sound way to continue.
+    //
+
+    {
+      std::vector<unsigned char> const data =
+          read_atomic_file(SST_TEV_ARG(tev), sdk_, snapshot_file());
+      if (apply_records(data) != data.size()) {
+        throw std::runtime_error("Corrupt clrmsg store snapshot in "
+                                 + sst::c_quote(dir_) + ".");
+      }
+      live_bytes_ = data.size();
+    }
+
+    //------------------------------------------------------------------
+    // Replay the log
+    //------------------------------------------------------------------
+    //
+    // A record that is cut short or fails its checksum can only be
+    // the tail of a write that was interrupted by a crash, so replay
+    // stops there and the rest of the log is dropped.
+    //
+
+    bool log_empty;
+    {
+      std::string const file = log_file(generation_);
+      std::vector<unsigned char> data;
+      if (sdk_) {
+        data = sdk_->readFile(SST_TEV_ARG(tev), file);
+      } else if (sst::test_f(file)) {
+        data = sst::read_whole_file(file);
+      }
+      log_bytes_ = apply_records(data);
+      log_empty = data.empty();
+    }
+
+    //------------------------------------------------------------------
+    // Remove the logs of other generations
+    //------------------------------------------------------------------
+    //
+    // A crash between writing a snapshot and removing the log that it
+    // replaces can leave an old log behind, and a crash between
+    // writing a snapshot and creating the next log can leave nothing.
+    //
+
+    {
+      std::string const keep = "log." + sst::to_string(generation_);
+      std::vector<std::string> xs;
+      if (sdk_) {
+        xs = sdk_->listDir(SST_TEV_ARG(tev), dir_);
+      } else {
+        auto it = sst::dir_it(dir_);
+        auto const end = it.end();
+        for (; !(it == end); ++it) {
+          sst::path & path = *it;
+          xs.emplace_back(path.str().substr(it.prefix()));
+        }
+      }
+      for (std::string const & x : xs) {
+        if (x.compare(0, 4, "log.") == 0 && x != keep) {
+          if (sdk_) {
+            sdk_->removeDir(SST_TEV_ARG(tev), dir_ + "/" + x);
+          } else {
+            sst::rm_f_r(dir_ + "/" + x);
+          }
+        }
+      }
+    }
+
+    //------------------------------------------------------------------
+    // Start a fresh generation if the log held anything
+    //------------------------------------------------------------------
+    //
+    // This also gets rid of any torn tail, which would otherwise hide
+    // every record appended after it from the next replay.
+    //
+
+    if (!log_empty) {
+      compact(SST_TEV_ARG(tev));
+    } else if (sdk_) {
+      sdk_->xMakeDirs(SST_TEV_ARG(tev), log_dir(generation_));
+    } else {
+      sst::mkdir_p(log_dir(generation_));
+    }
+
+    //------------------------------------------------------------------
   }
   SST_TEV_RETHROW(tev);
 }
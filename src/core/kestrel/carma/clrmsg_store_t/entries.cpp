@@ -16,13 +16,21 @@
 // SPDX-License-Identifier: Apache-2.0
 //
 
-#ifndef KESTREL_GOODBOX_ENTRY_T_HPP
-#define KESTREL_GOODBOX_ENTRY_T_HPP
+// Include first to test independence.
+#include <kestrel/carma/clrmsg_store_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/clrmsg_store_t.hpp>
+//
+
+#include <sst/catalog/SST_ASSERT.h>
 
 namespace kestrel {
+namespace carma {
 
-struct goodbox_entry_t final {};
+clrmsg_store_t::entries_t const & clrmsg_store_t::entries() const {
+  SST_ASSERT((!moved_from_));
+  return *entries_;
+}
 
+} // namespace carma
 } // namespace kestrel
-
-#endif // #ifndef KESTREL_GOODBOX_ENTRY_T_HPP
@@ -22,10 +22,16 @@
 #include <kestrel/carma/clrmsg_store_t.hpp>
 //
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 #include <sst/catalog/SST_ASSERT.h>
 #include <sst/catalog/SST_TEV_ADD.hpp>
+#include <sst/catalog/SST_TEV_ARG.hpp>
 #include <sst/catalog/SST_TEV_RETHROW.hpp>
 
+#include <kestrel/clrmsg_t.hpp>
 #include <kestrel/tracing_event_t.hpp>
 
 namespace kestrel {
@@ -35,7 +41,51 @@ void clrmsg_store_t::flush(tracing_event_t tev) {
   SST_TEV_ADD(tev);
   try {
     SST_ASSERT((!moved_from_));
-    // TODO
+
+    // A failed append may have left part of a record at the end of the
+    // log. Appending behind it would hide the new records from replay,
+    // so write everything to a new snapshot and start a new log.
+    if (log_torn_) {
+      compact(SST_TEV_ARG(tev));
+      return;
+    }
+
+    std::vector<unsigned char> & data = flush_buf_;
+    data.clear();
+    for (auto const id : erased_) {
+      put_record(data, record_type_t::erase, id, nullptr);
+    }
+    std::uint64_t live_bytes = 0;
+    for (auto const & kv : *entries_) {
+      clrmsg_t const & clrmsg = kv.second.clrmsg();
+      live_bytes += record_header_size + 1 + sizeof(kv.first)
+                    + clrmsg.to_bytes_size<std::size_t>();
+      if (kv.second.dirty()) {
+        put_record(data, record_type_t::put, kv.first, &clrmsg);
+      }
+    }
+    live_bytes_ = live_bytes;
+
+    if (data.empty()) {
+      return;
+    }
+
+    // Commit every change since the last flush with a single append.
+    // Nothing is marked clean until the append has succeeded, so a
+    // failed flush is retried in full by the next one.
+    log_torn_ = true;
+    append_log(SST_TEV_ARG(tev), data);
+    log_torn_ = false;
+    log_bytes_ += data.size();
+    for (auto & kv : *entries_) {
+      kv.second.dirty(false);
+    }
+    erased_.clear();
+
+    if (log_bytes_ >= compact_min_bytes
+        && log_bytes_ > 2 * live_bytes_) {
+      compact(SST_TEV_ARG(tev));
+    }
   }
   SST_TEV_RETHROW(tev);
 }
@@ -30,7 +30,16 @@ namespace carma {
 clrmsg_store_t::clrmsg_store_t(clrmsg_store_t && other) noexcept
     : dir_(std::move(other.dir_)),
       entries_(std::move(other.entries_)),
+      erased_(std::move(other.erased_)),
+      flush_buf_(std::move(other.flush_buf_)),
+      generation_(std::move(other.generation_)),
+      log_bytes_(std::move(other.log_bytes_)),
+      live_bytes_(std::move(other.live_bytes_)),
+      log_torn_(std::move(other.log_torn_)),
+      bytes_(std::move(other.bytes_)),
+      max_bytes_(std::move(other.max_bytes_)),
       moved_from_(std::move(other.moved_from_)),
+      next_id_(std::move(other.next_id_)),
       sdk_(std::move(other.sdk_)) {
 }
 
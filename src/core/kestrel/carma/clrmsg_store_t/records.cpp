@@ -0,0 +1,158 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/clrmsg_store_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/clrmsg_store_t.hpp>
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <sst/catalog/SST_ASSERT.h>
+#include <sst/catalog/checked.hpp>
+#include <sst/catalog/checked_cast.hpp>
+#include <sst/catalog/checked_resize.hpp>
+#include <sst/catalog/integer_rep.hpp>
+#include <sst/catalog/old/from_bytes.hpp>
+#include <sst/catalog/old/to_bytes.hpp>
+
+#include <kestrel/carma/clrmsg_store_entry_t.hpp>
+#include <kestrel/clrmsg_t.hpp>
+#include <kestrel/crc32c.hpp>
+
+namespace kestrel {
+namespace carma {
+
+namespace {
+
+template<class T>
+unsigned char * put_uint(T const x, unsigned char * const dst) {
+  return sst::old::to_bytes(x,
+                            dst,
+                            sizeof(T),
+                            sst::integer_rep::pure_unsigned());
+}
+
+template<class T>
+T get_uint(unsigned char const ** const src, std::size_t & avail) {
+  return sst::old::from_bytes<T>(src,
+                                 sizeof(T),
+                                 avail,
+                                 sst::integer_rep::pure_unsigned());
+}
+
+} // namespace
+
+void clrmsg_store_t::put_record(std::vector<unsigned char> & dst,
+                                record_type_t const type,
+                                std::uint64_t const id,
+                                clrmsg_t const * const clrmsg,
+                                std::uint64_t const next_id) {
+  sst::checked_t<std::size_t> n = 1;
+  n += sizeof(id);
+  if (type == record_type_t::meta) {
+    n += sizeof(next_id);
+  }
+  if (clrmsg != nullptr) {
+    n += clrmsg->to_bytes_size<std::size_t>();
+  }
+  auto const size = sst::checked_cast<std::uint32_t>(n.value());
+  std::size_t const start = dst.size();
+  sst::checked_resize(dst, (n + start + record_header_size).value());
+
+  unsigned char * const payload =
+      dst.data() + start + record_header_size;
+  unsigned char * p = payload;
+  *p++ = static_cast<unsigned char>(type);
+  p = put_uint(id, p);
+  if (type == record_type_t::meta) {
+    p = put_uint(next_id, p);
+  }
+  if (clrmsg != nullptr) {
+    p = clrmsg->to_bytes(p);
+  }
+  SST_ASSERT((p == payload + size));
+
+  p = put_uint(size, dst.data() + start);
+  put_uint(crc32c(payload, size), p);
+}
+
+std::size_t
+clrmsg_store_t::apply_records(std::vector<unsigned char> const & src) {
+  SST_ASSERT((!moved_from_));
+  auto const forget = [this](std::uint64_t const id) {
+    auto const it = entries_->find(id);
+    if (it != entries_->end()) {
+      bytes_ -= it->second.clrmsg().to_bytes_size<std::size_t>();
+      entries_->erase(it);
+    }
+  };
+  std::size_t i = 0;
+  while (src.size() - i >= record_header_size) {
+    unsigned char const * p = src.data() + i;
+    std::size_t avail = record_header_size;
+    auto const size = get_uint<std::uint32_t>(&p, avail);
+    auto const crc = get_uint<std::uint32_t>(&p, avail);
+    if (size < 1 + sizeof(std::uint64_t)
+        || src.size() - i - record_header_size < size
+        || crc32c(p, size) != crc) {
+      break;
+    }
+    avail = size;
+    auto const type = static_cast<record_type_t>(*p++);
+    --avail;
+    auto const id = get_uint<std::uint64_t>(&p, avail);
+    switch (type) {
+      case record_type_t::put: {
+        clrmsg_t clrmsg;
+        clrmsg.from_bytes_init();
+        clrmsg.from_bytes(p, avail);
+        forget(id);
+        bytes_ += clrmsg.to_bytes_size<std::size_t>();
+        auto & entry =
+            entries_
+                ->emplace(id, clrmsg_store_entry_t(std::move(clrmsg)))
+                .first->second;
+        entry.id_ = id;
+        entry.dirty(false);
+        if (id >= next_id_) {
+          next_id_ = id + 1;
+        }
+      } break;
+      case record_type_t::erase: {
+        forget(id);
+      } break;
+      case record_type_t::meta: {
+        generation_ = id;
+        next_id_ = get_uint<std::uint64_t>(&p, avail);
+      } break;
+      default: {
+        return i;
+      } break;
+    }
+    i += record_header_size + size;
+  }
+  return i;
+}
+
+} // namespace carma
+} // namespace kestrel
@@ -101,6 +101,11 @@ public:
   //--------------------------------------------------------------------
   // clrmsgs
   //--------------------------------------------------------------------
+  //
+  // The messages that a client could not send yet because it doesn't
+  // know the recipient's key. They are restored into the detached
+  // clrmsg store by inner_init.
+  //
 
 private:
 
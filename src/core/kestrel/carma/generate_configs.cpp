@@ -391,7 +391,9 @@ void generate_configs(std::list<std::string> args) {
         //--------------------------------------------------------------
         //
         // A suggested number of threads to use for CPU intensive parts
-        // of config generation.
+        // of config generation. This is also written into the configs
+        // as mix_threads, the size of each committee member's mix
+        // thread pool.
         //
 
         if (sst::parse_opt(args, "--num-threads")) {
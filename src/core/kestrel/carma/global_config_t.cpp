@@ -147,14 +147,31 @@ bytes_t global_config_t::auth_encrypt(bytes_t const & plaintext,
                                       bytes_t const & sender_sk,
                                       bytes_t const & recver_pk) const {
   (void)sender_pk;
-  return pkc::auth_encrypt(sender_sk, recver_pk, plaintext).first;
+  return pkc::auth_encrypt_afternm(
+             shared_keys().get(sender_sk, recver_pk),
+             plaintext)
+      .first;
 }
 
 bytes_t global_config_t::auth_decrypt(bytes_t const & ciphertext,
                                       bytes_t const &,
                                       bytes_t const & recver_sk,
                                       bytes_t const & sender_pk) const {
-  return pkc::auth_decrypt(sender_pk, recver_sk, ciphertext).first;
+  bytes_t plaintext;
+  pkc::auth_decrypt_afternm(shared_keys().get(recver_sk, sender_pk),
+                            ciphertext,
+                            plaintext);
+  return plaintext;
+}
+
+//----------------------------------------------------------------------
+// shared_keys
+//----------------------------------------------------------------------
+
+pkc::shared_key_cache_t & global_config_t::shared_keys() const {
+  SST_ASSERT((!moved_from_));
+  SST_ASSERT((shared_keys_ != nullptr));
+  return *shared_keys_;
 }
 
 //----------------------------------------------------------------------
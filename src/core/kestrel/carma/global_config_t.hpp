@@ -19,6 +19,7 @@
 #ifndef KESTREL_CARMA_GLOBAL_CONFIG_T_HPP
 #define KESTREL_CARMA_GLOBAL_CONFIG_T_HPP
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -34,6 +35,7 @@
 #include <kestrel/carma/rangegen/row.hpp>
 #include <kestrel/common_sdk_t.hpp>
 #include <kestrel/json_t.hpp>
+#include <kestrel/pkc/shared_key_cache_t.hpp>
 #include <kestrel/serialization.hpp>
 #include <kestrel/tracing_event_t.hpp>
 #include <kestrel/vrf_shell_t.hpp>
@@ -535,6 +537,24 @@ public:
                        bytes_t const & recver_sk,
                        bytes_t const & sender_pk) const;
 
+  //--------------------------------------------------------------------
+  // shared_keys
+  //--------------------------------------------------------------------
+  //
+  // The crypto_box shared keys used by auth_encrypt and auth_decrypt.
+  // Copies of a global_config_t share the same cache, which is safe
+  // because the cache is keyed by the key material itself.
+  //
+
+private:
+
+  std::shared_ptr<pkc::shared_key_cache_t> shared_keys_ =
+      std::make_shared<pkc::shared_key_cache_t>();
+
+public:
+
+  pkc::shared_key_cache_t & shared_keys() const;
+
   //--------------------------------------------------------------------
 };
 
@@ -132,12 +132,13 @@ local_config_t::mc_group(tracing_event_t tev,
     return it->second;
   }
   std::map<node_count_t, phonebook_pair_t const *> xs;
-  for (phonebook_pair_t const & psn_pbe : phonebook()) {
-    std::shared_ptr<phonebook_entry_t const> const pbe =
-        phonebook().at(SST_TEV_ARG(tev), psn_pbe);
-    if ((pbe->role() == role_t::mc_leader()
-         || pbe->role() == role_t::mc_follower())
-        && pbe->group() == group) {
+  for (phonebook_pair_t const * const p :
+       phonebook().in_mc_group(SST_TEV_ARG(tev), group)) {
+    phonebook_pair_t const & psn_pbe = *p;
+    role_t const role = phonebook().role_of(SST_TEV_ARG(tev), psn_pbe);
+    if (role == role_t::mc_leader() || role == role_t::mc_follower()) {
+      std::shared_ptr<phonebook_entry_t const> const pbe =
+          phonebook().at(SST_TEV_ARG(tev), psn_pbe);
       node_count_t const order = pbe->order();
       if (pbe->role() == role_t::mc_leader() && order != 0U) {
         throw config_exception("MC leader "
@@ -94,11 +94,11 @@ local_config_t::mc_leader(tracing_event_t tev) const {
   if (!val) {
     sst::unique_ptr<phonebook_pair_t const *> new_val;
     node_count_t const x = group();
-    for (phonebook_pair_t const & pair : phonebook()) {
-      std::shared_ptr<phonebook_entry_t const> const entry =
-          phonebook().at(SST_TEV_ARG(tev), pair);
-      if (entry->role() == role_t::mc_leader() && entry->group() == x) {
-        new_val.emplace(&pair);
+    for (phonebook_pair_t const * const pair :
+         phonebook().in_mc_group(SST_TEV_ARG(tev), x)) {
+      if (phonebook().role_of(SST_TEV_ARG(tev), *pair)
+          == role_t::mc_leader()) {
+        new_val.emplace(pair);
         break;
       }
     }
@@ -82,12 +82,9 @@ local_config_t::next_layer(tracing_event_t tev) const {
   if (!val) {
     SST_ASSERT((global().is_rigid()));
     sst::unique_ptr<phonebook_set_t> new_val{sst::in_place};
-    for (phonebook_pair_t const & pair : phonebook()) {
-      std::shared_ptr<phonebook_entry_t const> const entry =
-          phonebook().at(SST_TEV_ARG(tev), pair);
-      if (entry->role() == role_t::mb_server()) {
-        new_val->emplace(&pair);
-      }
+    for (phonebook_pair_t const * const pair :
+         phonebook().with_role(SST_TEV_ARG(tev), role_t::mb_server())) {
+      new_val->emplace(pair);
     }
     next_layer_.compare_exchange_strong(val, std::move(new_val));
   }
@@ -49,12 +49,9 @@ local_config_t::prev_layer(tracing_event_t tev) const {
   if (!prev_layer_) {
     SST_ASSERT((global().is_rigid()));
     phonebook_set_t xs;
-    for (phonebook_pair_t const & psn_pbe : phonebook()) {
-      std::shared_ptr<phonebook_entry_t const> const pbe =
-          phonebook().at(SST_TEV_ARG(tev), psn_pbe);
-      if (pbe->role() == role_t::mc_leader()) {
-        xs.emplace(&psn_pbe);
-      }
+    for (phonebook_pair_t const * const psn_pbe :
+         phonebook().with_role(SST_TEV_ARG(tev), role_t::mc_leader())) {
+      xs.emplace(psn_pbe);
     }
     prev_layer_.emplace(std::move(xs));
   }
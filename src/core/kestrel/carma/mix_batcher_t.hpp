@@ -0,0 +1,150 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_CARMA_MIX_BATCHER_T_HPP
+#define KESTREL_CARMA_MIX_BATCHER_T_HPP
+
+#include <cstddef>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+#include <sst/catalog/mono_time_ns.hpp>
+
+namespace kestrel {
+namespace carma {
+
+//
+// The shape of a batch that the committee leader should start: real
+// messages taken from the loose up packets, and dummies to pad the
+// batch to MixSize. A batch with no real messages means none is due.
+//
+
+struct mix_batch_t final {
+  std::size_t real = 0;
+  std::size_t dummies = 0;
+};
+
+//
+// Decides when the committee leader closes a batch. It tracks the
+// arrival time of each loose up packet, keyed by cid. A full batch is
+// due whenever mixsize packets are waiting. If max_latency_ns is
+// positive, a partial batch of everything waiting is also due once the
+// oldest packet has waited that long, as long as at least min_fill
+// packets are waiting.
+//
+// Arrivals are kept in time order, so finding the oldest is O(1) and
+// adding or removing a packet is O(log n).
+//
+
+template<class Key, class Time = decltype(sst::mono_time_ns())>
+class mix_batcher_t final {
+
+  using by_time_t = std::multimap<Time, Key>;
+
+  std::size_t mixsize_ = 1;
+  Time max_latency_ns_ = 0;
+  std::size_t min_fill_ = 1;
+  by_time_t by_time_;
+  std::map<Key, typename by_time_t::iterator> by_key_;
+
+public:
+
+  mix_batcher_t() = default;
+
+  mix_batcher_t(std::size_t const mixsize,
+                Time const max_latency_ns,
+                std::size_t const min_fill) {
+    configure(mixsize, max_latency_ns, min_fill);
+  }
+
+  void configure(std::size_t const mixsize,
+                 Time const max_latency_ns,
+                 std::size_t const min_fill) {
+    if (mixsize < 1) {
+      throw std::invalid_argument(
+          "mix_batcher_t: mixsize must be at least 1");
+    }
+    if (min_fill < 1 || min_fill > mixsize) {
+      throw std::invalid_argument(
+          "mix_batcher_t: min_fill must be in [1, mixsize]");
+    }
+    mixsize_ = mixsize;
+    max_latency_ns_ = max_latency_ns;
+    min_fill_ = min_fill;
+  }
+
+  // Records that the packet for key arrived at now. A key that is
+  // already waiting keeps its original arrival time.
+  void add(Key const & key, Time const now) {
+    if (by_key_.find(key) != by_key_.end()) {
+      return;
+    }
+    by_key_.emplace(key, by_time_.emplace(now, key));
+  }
+
+  // Forgets the packet for key, if it is waiting.
+  void remove(Key const & key) {
+    auto const it = by_key_.find(key);
+    if (it != by_key_.end()) {
+      by_time_.erase(it->second);
+      by_key_.erase(it);
+    }
+  }
+
+  // Returns the batch that is due at now. The caller takes the real
+  // messages out of its loose packets, removes them here, and calls
+  // this again until no batch is due.
+  mix_batch_t next(Time const now) const {
+    mix_batch_t batch;
+    auto const n = by_key_.size();
+    if (n >= mixsize_) {
+      batch.real = mixsize_;
+    } else if (max_latency_ns_ > 0 && n > 0 && n >= min_fill_
+               && now - by_time_.begin()->first >= max_latency_ns_) {
+      batch.real = n;
+    }
+    if (batch.real != 0) {
+      batch.dummies = mixsize_ - batch.real;
+    }
+    return batch;
+  }
+
+  // Returns the key that has been waiting the longest. Keys that
+  // arrived at the same time come out in the order they were added.
+  // The batcher must not be empty.
+  Key const & oldest() const {
+    if (by_time_.empty()) {
+      throw std::logic_error("mix_batcher_t: no packets are waiting");
+    }
+    return by_time_.begin()->second;
+  }
+
+  std::size_t size() const noexcept {
+    return by_key_.size();
+  }
+
+  bool empty() const noexcept {
+    return by_key_.empty();
+  }
+};
+
+} // namespace carma
+} // namespace kestrel
+
+#endif // #ifndef KESTREL_CARMA_MIX_BATCHER_T_HPP
@@ -0,0 +1,175 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/mix_executor_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/mix_executor_t.hpp>
+//
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <sst/catalog/SST_ASSERT.h>
+
+namespace kestrel {
+namespace carma {
+
+void mix_executor_t::start(unsigned int const num_threads) {
+  SST_ASSERT((threads_.empty()));
+  stop_ = false;
+  threads_.reserve(num_threads);
+  for (unsigned int i = 0; i != num_threads; ++i) {
+    threads_.emplace_back([this]() { run(); });
+  }
+}
+
+void mix_executor_t::post(std::function<void()> job) {
+  SST_ASSERT((job));
+  {
+    std::lock_guard<std::mutex> const lock(mutex_);
+    if (stop_ || threads_.empty()) {
+      throw std::logic_error("mix_executor_t is not running");
+    }
+    jobs_.emplace_back(std::move(job));
+  }
+  cond_.notify_one();
+}
+
+void mix_executor_t::parallel_for(
+    std::size_t const n,
+    std::function<void(std::size_t)> const & f) {
+  SST_ASSERT((f));
+  if (n == 0) {
+    return;
+  }
+
+  // Helpers may start after the loop is over (e.g. if every pool
+  // thread was busy), so everything they touch is kept alive by the
+  // shared state, and they only call f for an index they claimed.
+  struct state_t final {
+    std::function<void(std::size_t)> const * f;
+    std::size_t n;
+    std::atomic<std::size_t> next{0};
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::size_t done = 0;
+    std::exception_ptr error;
+  };
+  auto const state = std::make_shared<state_t>();
+  state->f = &f;
+  state->n = n;
+
+  auto const work = [](state_t & s) noexcept {
+    std::size_t finished = 0;
+    std::exception_ptr error;
+    while (true) {
+      std::size_t const i = s.next.fetch_add(1);
+      if (i >= s.n) {
+        break;
+      }
+      try {
+        (*s.f)(i);
+      } catch (...) {
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+      ++finished;
+    }
+    if (finished != 0) {
+      std::lock_guard<std::mutex> const lock(s.mutex);
+      s.done += finished;
+      if (error && !s.error) {
+        s.error = error;
+      }
+      if (s.done == s.n) {
+        s.cond.notify_all();
+      }
+    }
+  };
+
+  std::size_t helpers = 0;
+  {
+    std::lock_guard<std::mutex> const lock(mutex_);
+    if (!stop_) {
+      helpers = std::min(threads_.size(), n - 1);
+      for (std::size_t k = 0; k != helpers; ++k) {
+        jobs_.emplace_front([state, work]() { work(*state); });
+      }
+    }
+  }
+  for (std::size_t k = 0; k != helpers; ++k) {
+    cond_.notify_one();
+  }
+
+  work(*state);
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->cond.wait(lock, [&]() { return state->done == state->n; });
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+}
+
+void mix_executor_t::run() noexcept {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cond_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+    if (stop_) {
+      return;
+    }
+    std::function<void()> job = std::move(jobs_.front());
+    jobs_.pop_front();
+    lock.unlock();
+    try {
+      job();
+    } catch (...) {
+      // Jobs report their own errors.
+    }
+    lock.lock();
+  }
+}
+
+void mix_executor_t::stop() noexcept {
+  {
+    std::lock_guard<std::mutex> const lock(mutex_);
+    stop_ = true;
+    jobs_.clear();
+  }
+  cond_.notify_all();
+  for (auto & thread : threads_) {
+    try {
+      thread.join();
+    } catch (...) {
+    }
+  }
+  threads_.clear();
+}
+
+} // namespace carma
+} // namespace kestrel
@@ -0,0 +1,94 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_CARMA_MIX_EXECUTOR_T_HPP
+#define KESTREL_CARMA_MIX_EXECUTOR_T_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kestrel {
+namespace carma {
+
+//
+// A fixed-size pool of threads for the CPU heavy part of mix sessions
+// (reconstruction, root finding and decryption). Jobs run outside the
+// primary mutex, so they must not touch primary data. A job reports
+// back by queueing its result for the plugin thread to pick up.
+//
+// With zero threads, nothing is started and the caller is expected to
+// run its jobs inline.
+//
+// parallel_for is for short, data parallel loops that the caller needs
+// the results of right away, such as a mailbox encrypting one share
+// per committee member. The caller takes part in the loop itself, so
+// it never waits for a pool thread that is busy with a long job.
+//
+
+class mix_executor_t final {
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<std::function<void()>> jobs_;
+  std::vector<std::thread> threads_;
+  bool stop_ = false;
+
+  void run() noexcept;
+
+public:
+
+  mix_executor_t() = default;
+
+  mix_executor_t(mix_executor_t const &) = delete;
+  mix_executor_t & operator=(mix_executor_t const &) = delete;
+  mix_executor_t(mix_executor_t &&) = delete;
+  mix_executor_t & operator=(mix_executor_t &&) = delete;
+
+  ~mix_executor_t() noexcept {
+    stop();
+  }
+
+  void start(unsigned int num_threads);
+
+  std::size_t size() const noexcept {
+    return threads_.size();
+  }
+
+  void post(std::function<void()> job);
+
+  // Calls f(0), f(1), ..., f(n - 1), spread over the calling thread
+  // and any idle pool threads, and returns once all calls are done.
+  // If any call throws, one of the exceptions is rethrown after the
+  // remaining calls have finished.
+  void parallel_for(std::size_t n,
+                    std::function<void(std::size_t)> const & f);
+
+  // Discards any queued jobs and joins the threads. Jobs that are
+  // already running are allowed to finish.
+  void stop() noexcept;
+};
+
+} // namespace carma
+} // namespace kestrel
+
+#endif // #ifndef KESTREL_CARMA_MIX_EXECUTOR_T_HPP
@@ -77,13 +77,11 @@ phonebook_entry_t::bucket_mb_servers(tracing_event_t tev) const {
   if (!val) {
     sst::unique_ptr<phonebook_set_t> new_val{sst::in_place};
     node_count_t const b = bucket(SST_TEV_ARG(tev));
-    for (phonebook_pair_t const & pair : phonebook()) {
-      std::shared_ptr<phonebook_entry_t const> const entry =
-          phonebook().at(SST_TEV_ARG(tev), pair);
-      if (entry->role() == role_t::mb_server()
-          && entry->bucket(SST_TEV_ARG(tev)) == b) {
-        new_val->emplace(&pair);
-      }
+    for (phonebook_pair_t const * const pair :
+         phonebook().in_bucket(SST_TEV_ARG(tev),
+                               role_t::mb_server(),
+                               b)) {
+      new_val->emplace(pair);
     }
     bucket_mb_servers_.compare_exchange_strong(val, std::move(new_val));
   }
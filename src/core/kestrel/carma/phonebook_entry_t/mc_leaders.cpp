@@ -83,12 +83,9 @@ phonebook_entry_t::mc_leaders(tracing_event_t tev) const {
   if (!val) {
     SST_ASSERT((global().is_rigid()));
     sst::unique_ptr<phonebook_set_t> new_val{sst::in_place};
-    for (phonebook_pair_t const & pair : phonebook()) {
-      std::shared_ptr<phonebook_entry_t const> const entry =
-          phonebook().at(SST_TEV_ARG(tev), pair);
-      if (entry->role() == role_t::mc_leader()) {
-        new_val->emplace(&pair);
-      }
+    for (phonebook_pair_t const * const pair :
+         phonebook().with_role(SST_TEV_ARG(tev), role_t::mc_leader())) {
+      new_val->emplace(pair);
     }
     mc_leaders_.compare_exchange_strong(val, std::move(new_val));
   }
@@ -27,6 +27,7 @@
 #include <utility>
 
 #include <sst/catalog/SST_ASSERT.h>
+#include <sst/catalog/SST_TEV_ARG.hpp>
 #include <sst/catalog/SST_TEV_BOT.hpp>
 #include <sst/catalog/SST_TEV_TOP.hpp>
 
@@ -69,10 +70,26 @@ phonebook_t::add_fast(tracing_event_t tev, phonebook_entry_t entry) {
   std::shared_ptr<phonebook_entry_t const> & p =
       add_fast(SST_TEV_ARG(tev), entry.psn());
   p = std::make_shared<phonebook_entry_t>(std::move(entry));
+  phonebook_pair_t const & pair = *find(p->psn());
+  index_entry(SST_TEV_ARG(tev), pair, *p);
+  resident_touch(pair, false);
   return p;
   SST_TEV_BOT(tev);
 }
 
+void phonebook_t::add_unpacked(tracing_event_t tev, psn_t psn) {
+  SST_TEV_TOP(tev);
+  add_fast(SST_TEV_ARG(tev), psn);
+  phonebook_pair_t const & pair = *find(psn);
+  auto const it = index_loaded_.find(psn);
+  if (it != index_loaded_.end()) {
+    index_row(SST_TEV_ARG(tev), pair, it->second);
+  } else {
+    index_pending_.emplace_back(&pair);
+  }
+  SST_TEV_BOT(tev);
+}
+
 //----------------------------------------------------------------------
 // add_slow
 //----------------------------------------------------------------------
@@ -126,8 +143,7 @@ phonebook_t::add_slow(tracing_event_t tev, phonebook_entry_t entry) {
   std::shared_ptr<phonebook_entry_t const> p =
       add_fast(SST_TEV_ARG(tev), std::move(entry));
 
-  // TODO: Unload the least recently used entry (or entries) from memory
-  //       if we have too many currently loaded.
+  resident_trim();
 
   return p;
 
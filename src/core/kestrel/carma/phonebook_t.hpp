@@ -19,13 +19,20 @@
 #ifndef KESTREL_CARMA_PHONEBOOK_T_HPP
 #define KESTREL_CARMA_PHONEBOOK_T_HPP
 
+#include <atomic>
+#include <cstddef>
 #include <functional>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include <sst/catalog/SST_NOEXCEPT.hpp>
 #include <sst/catalog/SST_TEV_ARG.hpp>
@@ -35,9 +42,11 @@
 #include <sst/catalog/optional.hpp>
 
 #include <kestrel/carma/global_config_t.hpp>
+#include <kestrel/carma/node_count_t.hpp>
 #include <kestrel/carma/phonebook_entries_t.hpp>
 #include <kestrel/carma/phonebook_entry_t.hpp>
 #include <kestrel/carma/phonebook_pair_t.hpp>
+#include <kestrel/carma/role_t.hpp>
 #include <kestrel/common_sdk_t.hpp>
 #include <kestrel/psn_any_hash_t.hpp>
 #include <kestrel/psn_hash_1_t.hpp>
@@ -89,9 +98,8 @@ public:
   // Adds an entry to the phonebook.
   //
   // This function never causes any entries to be paged to disk. The new
-  // entry will stay in memory and its addition will not cause any other
-  // entries to be paged to disk. TODO: This is probably bad, it should
-  // probably cause unloading.
+  // entry is pinned in memory until the next unpacked flush, as it has
+  // no file to be reloaded from yet.
   //
 
 private:
@@ -99,6 +107,10 @@ private:
   std::shared_ptr<phonebook_entry_t const> &
   add_fast(tracing_event_t tev, psn_t psn);
 
+  // Adds a PSN whose entry is in the unpacked directory, indexing it
+  // from index_file_ if possible.
+  void add_unpacked(tracing_event_t tev, psn_t psn);
+
 public:
 
   std::shared_ptr<phonebook_entry_t const>
@@ -119,6 +131,12 @@ public:
 
 public:
 
+  //
+  // Returns the entry, loading it from disk if it isn't resident. Each
+  // load may unload the least recently used clean entries to stay
+  // within max_resident().
+  //
+
   std::shared_ptr<phonebook_entry_t const>
   at(tracing_event_t tev, phonebook_pair_t const & entry) const;
 
@@ -156,6 +174,12 @@ public:
   // clear_deducible
   //--------------------------------------------------------------------
 
+private:
+
+  // Set by clear_deducible(), after which entries loaded from disk may
+  // hold stale deducible data and are cleared as they're loaded.
+  mutable std::atomic<bool> deducible_stale_{false};
+
 public:
 
   void clear_deducible(tracing_event_t tev) const;
@@ -309,6 +333,138 @@ public:
 
   void flush(tracing_event_t tev, bool const pack = false);
 
+  //--------------------------------------------------------------------
+  // Indexes
+  //--------------------------------------------------------------------
+  //
+  // The role and MC group of every entry are kept in memory and written
+  // to index_file_ by flush(), so membership questions can be answered
+  // without loading entries from disk. Buckets are deducible from the
+  // PSN and the epoch nonce alone, so the bucket index is rebuilt in
+  // memory on first use and dropped by clear_deducible().
+  //
+  // Entries with no index row yet (e.g. from a phonebook directory that
+  // was written before index_file_ existed) are loaded and indexed on
+  // the first query.
+  //
+
+private:
+
+  using role_key_t = decltype(std::declval<role_t const &>().value());
+
+  struct index_row_t final {
+    role_t role;
+    sst::optional<node_count_t> group;
+  };
+
+  std::string index_file_;
+
+  mutable std::recursive_mutex index_mutex_;
+
+  mutable std::unordered_map<phonebook_pair_t const *, index_row_t>
+      index_rows_;
+
+  mutable std::map<psn_t, index_row_t> index_loaded_;
+
+  mutable std::vector<phonebook_pair_t const *> index_pending_;
+
+  mutable std::map<role_key_t, std::vector<phonebook_pair_t const *>>
+      index_roles_;
+
+  mutable std::map<node_count_t, std::vector<phonebook_pair_t const *>>
+      index_groups_;
+
+  mutable sst::optional<
+      std::map<std::pair<role_key_t, node_count_t>,
+               std::vector<phonebook_pair_t const *>>>
+      index_buckets_;
+
+  node_count_t index_bucket(tracing_event_t tev,
+                            phonebook_pair_t const & pair,
+                            role_t role) const;
+
+  void index_entry(tracing_event_t tev,
+                   phonebook_pair_t const & pair,
+                   phonebook_entry_t const & entry) const;
+
+  void index_row(tracing_event_t tev,
+                 phonebook_pair_t const & pair,
+                 index_row_t row) const;
+
+  void index_pending(tracing_event_t tev) const;
+
+  void index_load(tracing_event_t tev);
+
+  void index_flush(tracing_event_t tev);
+
+public:
+
+  // Returns the role of an entry without loading it.
+  role_t role_of(tracing_event_t tev,
+                 phonebook_pair_t const & pair) const;
+
+  // Returns all entries with the given role.
+  std::vector<phonebook_pair_t const *>
+  with_role(tracing_event_t tev, role_t role) const;
+
+  // Returns all clients or MB servers in the given bucket.
+  std::vector<phonebook_pair_t const *>
+  in_bucket(tracing_event_t tev,
+            role_t role,
+            node_count_t bucket) const;
+
+  // Returns all MC leaders, MC followers, and RS servers in the given
+  // MC group.
+  std::vector<phonebook_pair_t const *>
+  in_mc_group(tracing_event_t tev, node_count_t group) const;
+
+  //--------------------------------------------------------------------
+  // max_resident
+  //--------------------------------------------------------------------
+  //
+  // The maximum number of entries to keep in memory, or 0 for no limit.
+  // Only clean entries (ones that can be reloaded from their unpacked
+  // file) and entries not referenced from outside the phonebook are
+  // ever unloaded, so the limit can be exceeded by pinned entries.
+  //
+
+private:
+
+  std::size_t max_resident_ = 0;
+
+  mutable std::mutex resident_mutex_;
+
+  // Clean resident entries, most recently used first.
+  mutable std::list<phonebook_pair_t const *> resident_lru_;
+
+  mutable std::unordered_map<
+      phonebook_pair_t const *,
+      std::list<phonebook_pair_t const *>::iterator>
+      resident_pos_;
+
+  // Dirty resident entries, which have no unpacked file to be reloaded
+  // from.
+  mutable std::unordered_set<phonebook_pair_t const *> resident_pinned_;
+
+  // Set while the unpacked files can't be trusted (after a packed
+  // flush), in which case nothing is unloaded. Atomic, as at() trims
+  // without holding resident_mutex_ from any thread.
+  std::atomic<bool> resident_frozen_{false};
+
+  void resident_touch(phonebook_pair_t const & pair, bool clean) const;
+
+  void resident_clean() const;
+
+  void resident_trim() const;
+
+public:
+
+  std::size_t max_resident() const noexcept {
+    return max_resident_;
+  }
+
+  void set_max_resident(std::size_t src);
+
   //--------------------------------------------------------------------
   // packed_dir_
   //--------------------------------------------------------------------
@@ -78,12 +78,19 @@ phonebook_t::at(tracing_event_t tev,
         std::throw_with_nested(e.add_file(file));
       }
     }
+    if (deducible_stale_.load()) {
+      pbe.clear_deducible();
+    }
     if (std::atomic_compare_exchange_strong(
             &const_cast<phonebook_pair_t &>(entry).second,
             &p,
             pbe_ptr)) {
       p = pbe_ptr;
+      resident_touch(entry, true);
+      resident_trim();
     }
+  } else if (max_resident_ != 0) {
+    resident_touch(entry, true);
   }
   return p;
   SST_TEV_BOT(tev);
@@ -22,6 +22,7 @@
 #include <kestrel/carma/phonebook_t.hpp>
 //
 
+#include <mutex>
 #include <utility>
 
 namespace kestrel {
@@ -32,6 +33,23 @@ void phonebook_t::clear() {
   // Calling clear() on a container does not.
   entries_ = decltype(entries_)();
   psn_hashes_1_ = decltype(psn_hashes_1_)();
+  {
+    std::lock_guard<std::recursive_mutex> const lock(index_mutex_);
+    index_rows_ = decltype(index_rows_)();
+    index_loaded_ = decltype(index_loaded_)();
+    index_pending_ = decltype(index_pending_)();
+    index_roles_ = decltype(index_roles_)();
+    index_groups_ = decltype(index_groups_)();
+    index_buckets_.reset();
+  }
+  {
+    std::lock_guard<std::mutex> const lock(resident_mutex_);
+    resident_lru_ = decltype(resident_lru_)();
+    resident_pos_ = decltype(resident_pos_)();
+    resident_pinned_ = decltype(resident_pinned_)();
+  }
+  resident_frozen_.store(false);
+  deducible_stale_.store(false);
 }
 
 } // namespace carma
@@ -23,6 +23,7 @@
 //
 
 #include <memory>
+#include <mutex>
 
 #include <sst/catalog/SST_TEV_ARG.hpp>
 #include <sst/catalog/SST_TEV_BOT.hpp>
@@ -35,10 +36,24 @@
 namespace kestrel {
 namespace carma {
 
+//
+// Entries that aren't resident are cleared by at() when they're next
+// loaded, so there's no need to load them here.
+//
+
 void phonebook_t::clear_deducible(tracing_event_t tev) const {
   SST_TEV_TOP(tev);
+  deducible_stale_.store(true);
   for (phonebook_pair_t const & psn_pbe : *this) {
-    at(SST_TEV_ARG(tev), psn_pbe)->clear_deducible();
+    std::shared_ptr<phonebook_entry_t const> const p =
+        std::atomic_load(&psn_pbe.second);
+    if (p) {
+      p->clear_deducible();
+    }
+  }
+  {
+    std::lock_guard<std::recursive_mutex> const lock(index_mutex_);
+    index_buckets_.reset();
   }
   SST_TEV_BOT(tev);
 }
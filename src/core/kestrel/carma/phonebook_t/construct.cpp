@@ -49,15 +49,14 @@
 namespace kestrel {
 namespace carma {
 
-// TODO: Paging. We don't want to pull all entries into memory if
-//       there's too many.
-
 //
-// Note that this function may fill the entries_ map past the memory
-// limit depending on how many packed entries there are. We can't unpack
-// them all to disk at once, as that can cause performance problems, so
-// we'll need to somehow slowly unload them from memory onto disk until
-// we get down to the memory limit.
+// Unpacked entries are only listed here, not loaded. Their roles and
+// MC groups come from index_file_ when it has them.
+//
+// Note that this function may fill the entries_ map past max_resident()
+// depending on how many packed entries there are. Packed entries have
+// no unpacked file yet, so they stay pinned in memory until the next
+// unpacked flush writes them out.
 //
 
 phonebook_t::phonebook_t(tracing_event_t tev,
@@ -67,11 +66,18 @@ phonebook_t::phonebook_t(tracing_event_t tev,
     : config_(&config),
       dir_(std::move(dir)),
       entries_dir_(dir_ + "/unpacked"),
+      index_file_(dir_ + "/index.json"),
       packed_dir_(dir_ + "/packed"),
       packed_file_(packed_dir_ + "/entries.json"),
       sdk_(sdk) {
   SST_TEV_TOP(tev);
 
+  //--------------------------------------------------------------------
+  // Load the index
+  //--------------------------------------------------------------------
+
+  index_load(SST_TEV_ARG(tev));
+
   //--------------------------------------------------------------------
   // Load any packed entries
   //--------------------------------------------------------------------
@@ -139,7 +145,7 @@ phonebook_t::phonebook_t(tracing_event_t tev,
         std::string const & psn_slug = src.str().substr(it.prefix());
         psn_t psn = psn_t::from_path_slug(psn_slug);
         if (psn_slug == psn.to_path_slug()) {
-          add_fast(SST_TEV_ARG(tev), std::move(psn));
+          add_unpacked(SST_TEV_ARG(tev), std::move(psn));
         } else {
           // TODO: Delete it? It's not slugified properly.
         }
@@ -151,7 +157,7 @@ phonebook_t::phonebook_t(tracing_event_t tev,
            sdk_->listDir(SST_TEV_ARG(tev), entries_dir_)) {
         psn_t psn = psn_t::from_path_slug(psn_slug);
         if (psn_slug == psn.to_path_slug()) {
-          add_fast(SST_TEV_ARG(tev), std::move(psn));
+          add_unpacked(SST_TEV_ARG(tev), std::move(psn));
         } else {
           // TODO: Delete it? It's not slugified properly.
         }
@@ -161,6 +167,10 @@ phonebook_t::phonebook_t(tracing_event_t tev,
 
   //--------------------------------------------------------------------
 
+  index_loaded_ = decltype(index_loaded_)();
+
+  //--------------------------------------------------------------------
+
   SST_TEV_BOT(tev);
 }
 
@@ -51,6 +51,12 @@ void phonebook_t::flush(tracing_event_t tev, bool const pack) {
       //----------------------------------------------------------------
       // Write out the packed file
       //----------------------------------------------------------------
+      //
+      // The unpacked files are about to be deleted, so every entry
+      // must stay resident from here on.
+      //
+
+      resident_frozen_.store(true);
 
       {
         json_t json = json_t::object();
@@ -83,6 +89,8 @@ void phonebook_t::flush(tracing_event_t tev, bool const pack) {
 
       //----------------------------------------------------------------
 
+      deducible_stale_.store(false);
+
     } else {
 
       //----------------------------------------------------------------
@@ -95,6 +103,9 @@ void phonebook_t::flush(tracing_event_t tev, bool const pack) {
         }
       }
 
+      resident_clean();
+      resident_frozen_.store(false);
+
       //----------------------------------------------------------------
       // Delete any dangling unpacked files
       //----------------------------------------------------------------
@@ -146,7 +157,17 @@ void phonebook_t::flush(tracing_event_t tev, bool const pack) {
 
       //----------------------------------------------------------------
 
+      resident_trim();
+
     } //
+
+    //------------------------------------------------------------------
+    // Write out the index
+    //------------------------------------------------------------------
+
+    index_flush(SST_TEV_ARG(tev));
+
+    //------------------------------------------------------------------
   }
   SST_TEV_RETHROW(tev);
 }
@@ -0,0 +1,72 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/phonebook_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/phonebook_t.hpp>
+//
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <sst/catalog/SST_ASSERT.h>
+#include <sst/catalog/SST_TEV_ARG.hpp>
+#include <sst/catalog/SST_TEV_BOT.hpp>
+#include <sst/catalog/SST_TEV_TOP.hpp>
+
+#include <kestrel/carma/node_count_t.hpp>
+#include <kestrel/carma/phonebook_pair_t.hpp>
+#include <kestrel/carma/role_t.hpp>
+#include <kestrel/tracing_event_t.hpp>
+
+namespace kestrel {
+namespace carma {
+
+std::vector<phonebook_pair_t const *>
+phonebook_t::in_bucket(tracing_event_t tev,
+                       role_t const role,
+                       node_count_t const bucket) const {
+  SST_TEV_TOP(tev);
+  SST_ASSERT((role == role_t::client() || role == role_t::mb_server()));
+  std::lock_guard<std::recursive_mutex> const lock(index_mutex_);
+  index_pending(SST_TEV_ARG(tev));
+  if (!index_buckets_) {
+    index_buckets_.emplace();
+    for (auto const & kv : index_rows_) {
+      role_t const r = kv.second.role;
+      if (r == role_t::client() || r == role_t::mb_server()) {
+        node_count_t const b =
+            index_bucket(SST_TEV_ARG(tev), *kv.first, r);
+        (*index_buckets_)[std::make_pair(r.value(), b)].emplace_back(
+            kv.first);
+      }
+    }
+  }
+  auto const it =
+      index_buckets_->find(std::make_pair(role.value(), bucket));
+  if (it == index_buckets_->end()) {
+    return {};
+  }
+  return it->second;
+  SST_TEV_BOT(tev);
+}
+
+} // namespace carma
+} // namespace kestrel
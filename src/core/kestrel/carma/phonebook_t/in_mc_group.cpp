@@ -0,0 +1,54 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/phonebook_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/phonebook_t.hpp>
+//
+
+#include <mutex>
+#include <vector>
+
+#include <sst/catalog/SST_TEV_ARG.hpp>
+#include <sst/catalog/SST_TEV_BOT.hpp>
+#include <sst/catalog/SST_TEV_TOP.hpp>
+
+#include <kestrel/carma/node_count_t.hpp>
+#include <kestrel/carma/phonebook_pair_t.hpp>
+#include <kestrel/tracing_event_t.hpp>
+
+namespace kestrel {
+namespace carma {
+
+std::vector<phonebook_pair_t const *>
+phonebook_t::in_mc_group(tracing_event_t tev,
+                         node_count_t const group) const {
+  SST_TEV_TOP(tev);
+  std::lock_guard<std::recursive_mutex> const lock(index_mutex_);
+  index_pending(SST_TEV_ARG(tev));
+  auto const it = index_groups_.find(group);
+  if (it == index_groups_.end()) {
+    return {};
+  }
+  return it->second;
+  SST_TEV_BOT(tev);
+}
+
+} // namespace carma
+} // namespace kestrel
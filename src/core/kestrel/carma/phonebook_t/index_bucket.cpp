@@ -0,0 +1,63 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/phonebook_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/phonebook_t.hpp>
+//
+
+#include <memory>
+
+#include <sst/catalog/SST_TEV_ARG.hpp>
+#include <sst/catalog/SST_TEV_BOT.hpp>
+#include <sst/catalog/SST_TEV_TOP.hpp>
+
+#include <kestrel/carma/node_count_t.hpp>
+#include <kestrel/carma/phonebook_entry_t.hpp>
+#include <kestrel/carma/phonebook_pair_t.hpp>
+#include <kestrel/carma/role_t.hpp>
+#include <kestrel/tracing_event_t.hpp>
+
+namespace kestrel {
+namespace carma {
+
+//
+// A bucket only depends on the PSN and the global config, so there's
+// no need to load a non-resident entry from disk to get it. A scratch
+// entry with just the PSN and role set is enough.
+//
+
+node_count_t phonebook_t::index_bucket(tracing_event_t tev,
+                                       phonebook_pair_t const & pair,
+                                       role_t const role) const {
+  SST_TEV_TOP(tev);
+  std::shared_ptr<phonebook_entry_t const> const p =
+      std::atomic_load(&pair.second);
+  if (p) {
+    return p->bucket(SST_TEV_ARG(tev));
+  }
+  phonebook_entry_t x(pair.first);
+  x.set_phonebook(const_cast<phonebook_t &>(*this));
+  x.set_role(role);
+  return x.bucket(SST_TEV_ARG(tev));
+  SST_TEV_BOT(tev);
+}
+
+} // namespace carma
+} // namespace kestrel
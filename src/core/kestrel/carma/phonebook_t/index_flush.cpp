@@ -0,0 +1,57 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/phonebook_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/phonebook_t.hpp>
+//
+
+#include <mutex>
+
+#include <sst/catalog/SST_TEV_ARG.hpp>
+#include <sst/catalog/SST_TEV_BOT.hpp>
+#include <sst/catalog/SST_TEV_TOP.hpp>
+#include <sst/catalog/to_string.hpp>
+
+#include <kestrel/json_t.hpp>
+#include <kestrel/psn_t.hpp>
+#include <kestrel/tracing_event_t.hpp>
+
+namespace kestrel {
+namespace carma {
+
+void phonebook_t::index_flush(tracing_event_t tev) {
+  SST_TEV_TOP(tev);
+  std::lock_guard<std::recursive_mutex> const lock(index_mutex_);
+  index_pending(SST_TEV_ARG(tev));
+  json_t json = json_t::object();
+  for (auto const & pair : entries_) {
+    index_row_t const & row = index_rows_.at(&pair);
+    json_t & x = json[pair.first.to_path_slug()] = json_t::object();
+    x["role"] = row.role;
+    if (row.group) {
+      x["group"] = sst::to_string(*row.group);
+    }
+  }
+  flush(SST_TEV_ARG(tev), json, index_file_);
+  SST_TEV_BOT(tev);
+}
+
+} // namespace carma
+} // namespace kestrel
@@ -0,0 +1,93 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/phonebook_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/phonebook_t.hpp>
+//
+
+#include <exception>
+#include <string>
+#include <utility>
+
+#include <sst/catalog/SST_TEV_ARG.hpp>
+#include <sst/catalog/SST_TEV_BOT.hpp>
+#include <sst/catalog/SST_TEV_TOP.hpp>
+#include <sst/catalog/json/exception.hpp>
+#include <sst/catalog/json/get_from_file.hpp>
+#include <sst/catalog/json/get_from_string.hpp>
+#include <sst/catalog/json/remove_to.hpp>
+#include <sst/catalog/json/unknown_key.hpp>
+#include <sst/catalog/optional.hpp>
+#include <sst/catalog/test_e.hpp>
+
+#include <kestrel/carma/node_count_t.hpp>
+#include <kestrel/carma/role_t.hpp>
+#include <kestrel/json_t.hpp>
+#include <kestrel/psn_t.hpp>
+#include <kestrel/tracing_event_t.hpp>
+
+namespace kestrel {
+namespace carma {
+
+//
+// Reads index_file_ into index_loaded_, which construction then
+// consults for each unpacked PSN. A missing file is not an error.
+//
+
+void phonebook_t::index_load(tracing_event_t tev) {
+  SST_TEV_TOP(tev);
+  json_t json;
+  if (sdk_ == nullptr) {
+    if (!sst::test_e(index_file_)) {
+      return;
+    }
+    json = sst::json::get_from_file<json_t>(index_file_);
+  } else {
+    if (!sdk_->xPathExists(SST_TEV_ARG(tev), index_file_)) {
+      return;
+    }
+    json = sst::json::get_from_string<json_t>(
+        sdk_->readFile(SST_TEV_ARG(tev), index_file_));
+  }
+  try {
+    for (auto & kv : json.items()) {
+      try {
+        psn_t psn = psn_t::from_path_slug(kv.key());
+        if (kv.key() != psn.to_path_slug()) {
+          continue;
+        }
+        role_t role;
+        sst::json::remove_to(kv.value(), role, "role");
+        sst::optional<node_count_t> group;
+        sst::json::remove_to(kv.value(), group, "group");
+        sst::json::unknown_key(kv.value());
+        index_loaded_.emplace(std::move(psn), index_row_t{role, group});
+      } catch (sst::json::exception const & e) {
+        std::throw_with_nested(e.add_key(kv.key()));
+      }
+    }
+  } catch (sst::json::exception const & e) {
+    std::throw_with_nested(e.add_file(index_file_));
+  }
+  SST_TEV_BOT(tev);
+}
+
+} // namespace carma
+} // namespace kestrel
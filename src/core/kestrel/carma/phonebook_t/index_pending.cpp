@@ -0,0 +1,55 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/phonebook_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/phonebook_t.hpp>
+//
+
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <sst/catalog/SST_TEV_ARG.hpp>
+#include <sst/catalog/SST_TEV_BOT.hpp>
+#include <sst/catalog/SST_TEV_TOP.hpp>
+
+#include <kestrel/carma/phonebook_entry_t.hpp>
+#include <kestrel/carma/phonebook_pair_t.hpp>
+#include <kestrel/tracing_event_t.hpp>
+
+namespace kestrel {
+namespace carma {
+
+void phonebook_t::index_pending(tracing_event_t tev) const {
+  SST_TEV_TOP(tev);
+  std::lock_guard<std::recursive_mutex> const lock(index_mutex_);
+  while (!index_pending_.empty()) {
+    phonebook_pair_t const & pair = *index_pending_.back();
+    std::shared_ptr<phonebook_entry_t const> const p =
+        at(SST_TEV_ARG(tev), pair);
+    index_entry(SST_TEV_ARG(tev), pair, *p);
+    index_pending_.pop_back();
+  }
+  SST_TEV_BOT(tev);
+}
+
+} // namespace carma
+} // namespace kestrel
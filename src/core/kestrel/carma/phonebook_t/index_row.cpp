@@ -0,0 +1,64 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/phonebook_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/phonebook_t.hpp>
+//
+
+#include <mutex>
+#include <utility>
+
+#include <sst/catalog/SST_ASSERT.h>
+#include <sst/catalog/SST_TEV_ARG.hpp>
+#include <sst/catalog/SST_TEV_BOT.hpp>
+#include <sst/catalog/SST_TEV_TOP.hpp>
+
+#include <kestrel/carma/node_count_t.hpp>
+#include <kestrel/carma/phonebook_pair_t.hpp>
+#include <kestrel/carma/role_t.hpp>
+#include <kestrel/tracing_event_t.hpp>
+
+namespace kestrel {
+namespace carma {
+
+void phonebook_t::index_row(tracing_event_t tev,
+                            phonebook_pair_t const & pair,
+                            index_row_t const row) const {
+  SST_TEV_TOP(tev);
+  std::lock_guard<std::recursive_mutex> const lock(index_mutex_);
+  auto const r = index_rows_.emplace(&pair, row);
+  SST_ASSERT((r.second));
+  index_roles_[row.role.value()].emplace_back(&pair);
+  if (row.group) {
+    index_groups_[*row.group].emplace_back(&pair);
+  }
+  if (index_buckets_
+      && (row.role == role_t::client()
+          || row.role == role_t::mb_server())) {
+    node_count_t const b =
+        index_bucket(SST_TEV_ARG(tev), pair, row.role);
+    (*index_buckets_)[std::make_pair(row.role.value(), b)].emplace_back(
+        &pair);
+  }
+  SST_TEV_BOT(tev);
+}
+
+} // namespace carma
+} // namespace kestrel
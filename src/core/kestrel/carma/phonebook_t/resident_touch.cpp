@@ -0,0 +1,53 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/phonebook_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/phonebook_t.hpp>
+//
+
+#include <mutex>
+
+#include <kestrel/carma/phonebook_pair_t.hpp>
+
+namespace kestrel {
+namespace carma {
+
+void phonebook_t::resident_touch(phonebook_pair_t const & pair,
+                                 bool const clean) const {
+  std::lock_guard<std::mutex> const lock(resident_mutex_);
+  auto const it = resident_pos_.find(&pair);
+  if (!clean) {
+    if (it != resident_pos_.end()) {
+      resident_lru_.erase(it->second);
+      resident_pos_.erase(it);
+    }
+    resident_pinned_.emplace(&pair);
+  } else if (it != resident_pos_.end()) {
+    resident_lru_.splice(resident_lru_.begin(),
+                         resident_lru_,
+                         it->second);
+  } else if (resident_pinned_.find(&pair) == resident_pinned_.end()) {
+    resident_lru_.push_front(&pair);
+    resident_pos_.emplace(&pair, resident_lru_.begin());
+  }
+}
+
+} // namespace carma
+} // namespace kestrel
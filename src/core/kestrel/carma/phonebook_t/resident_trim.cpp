@@ -0,0 +1,65 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/phonebook_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/phonebook_t.hpp>
+//
+
+#include <memory>
+#include <mutex>
+
+#include <kestrel/carma/phonebook_entry_t.hpp>
+#include <kestrel/carma/phonebook_pair_t.hpp>
+
+namespace kestrel {
+namespace carma {
+
+//
+// An entry that is still referenced from outside the phonebook is
+// skipped, as unloading it would only lead to a second copy being
+// loaded. The use_count() check is racy, but the worst case is the
+// same: the caller keeps its copy alive and the next at() reloads.
+//
+
+void phonebook_t::resident_trim() const {
+  if (max_resident_ == 0 || resident_frozen_.load()) {
+    return;
+  }
+  std::lock_guard<std::mutex> const lock(resident_mutex_);
+  auto n = resident_lru_.size() + resident_pinned_.size();
+  auto it = resident_lru_.end();
+  while (n > max_resident_ && it != resident_lru_.begin()) {
+    --it;
+    phonebook_pair_t & pair = const_cast<phonebook_pair_t &>(**it);
+    std::shared_ptr<phonebook_entry_t const> p =
+        std::atomic_load(&pair.second);
+    if (p.use_count() > 2) {
+      continue;
+    }
+    std::atomic_store(&pair.second,
+                      std::shared_ptr<phonebook_entry_t const>());
+    resident_pos_.erase(*it);
+    it = resident_lru_.erase(it);
+    --n;
+  }
+}
+
+} // namespace carma
+} // namespace kestrel
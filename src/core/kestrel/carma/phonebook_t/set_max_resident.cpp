@@ -17,8 +17,20 @@
 //
 
 // Include first to test independence.
-#include <kestrel/goodbox_entry_t.hpp>
+#include <kestrel/carma/phonebook_t.hpp>
 // Include twice to test idempotence.
-#include <kestrel/goodbox_entry_t.hpp>
+#include <kestrel/carma/phonebook_t.hpp>
+//
+
+#include <cstddef>
+
+namespace kestrel {
+namespace carma {
+
+void phonebook_t::set_max_resident(std::size_t const src) {
+  max_resident_ = src;
+  resident_trim();
+}
 
-namespace kestrel {} // namespace kestrel
+} // namespace carma
+} // namespace kestrel
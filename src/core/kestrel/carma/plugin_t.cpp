@@ -26,6 +26,7 @@
 #include <atomic>
 #include <cassert>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <exception>
 #include <fstream>
@@ -91,19 +92,21 @@
 #include <kestrel/connection_t.hpp>
 #include <kestrel/encpkg_t.hpp>
 #include <kestrel/link_profile_t.hpp>
-#include <kestrel/goodbox_entry_t.hpp>
 #include <kestrel/link_address_packet_t.hpp>
 #include <kestrel/link_address_t.hpp>
 #include <kestrel/link_status_t.hpp>
+#include <kestrel/logging.hpp>
 #include <kestrel/message_status_t.hpp>
 #include <kestrel/open_connection_call_t.hpp>
 #include <kestrel/outbox_entry_t.hpp>
 #include <kestrel/package_status_t.hpp>
 #include <kestrel/packet_packet_t.hpp>
+#include <kestrel/packet_type_t.hpp>
 #include <kestrel/psn_t.hpp>
 #include <kestrel/pkc.hpp>
 #include <kestrel/plugin_state_t.hpp>
 #include <kestrel/sdk_wrapper_t.hpp>
+#include <kestrel/timer_wheel_t.hpp>
 #include <kestrel/tracing_event_t.hpp>
 #include <kestrel/tracing_exception_t.hpp>
 
@@ -316,30 +319,6 @@ void plugin_t::ensure_connection(tracing_event_t tev,
   SST_TEV_RETHROW(tev);
 }
 
-//----------------------------------------------------------------------
-
-namespace {
-
-template<class K, class V, class It>
-bool subtract(std::map<K, V> & xs, It a, It const b) {
-  bool overlap = false;
-  auto it = xs.begin();
-  while (it != xs.end() && a != b) {
-    if (it->first < *a) {
-      ++it;
-    } else {
-      if (!(*a < it->first)) {
-        it = xs.erase(it);
-        overlap = true;
-      }
-      ++a;
-    }
-  }
-  return overlap;
-}
-
-} // namespace
-
 //----------------------------------------------------------------------
 // Link discovery
 //----------------------------------------------------------------------
@@ -533,8 +512,6 @@ void plugin_t::do_network_maintenance(tracing_event_t tev) {
 
     for (auto const & psn_pbe : config().phonebook()) {
       psn_t const & persona = psn_pbe.first;
-      std::shared_ptr<phonebook_entry_t const> const node =
-          config().phonebook().at(SST_TEV_ARG(tev), persona);
       for (auto const & link_type : {link_type_t::send(),
                                      link_type_t::recv(),
                                      link_type_t::bidi()}) {
@@ -572,66 +549,39 @@ void plugin_t::do_network_maintenance(tracing_event_t tev) {
   //--------------------------------------------------------------------
   // Send retrying maintenance
   //--------------------------------------------------------------------
-
-  if (send_retrying_maintenance_previous_ns_ == 0
-      || std::chrono::nanoseconds(
-             current_time_ns - send_retrying_maintenance_previous_ns_)
-             >= send_retrying_maintenance_cooldown_) {
+  //
+  // Each outbox entry comes due at its own randomized retry time, so
+  // retries are spread out instead of all going out together. Only the
+  // entries that were due when the pass started are looked at, and at
+  // most send_retry_burst of them if it's positive. The rest stay due,
+  // most urgent first, for the next pass.
+  //
+
+  outbox_.advance(current_time_ns);
+  if (outbox_.ready() != 0) {
     CARMA_LOG_INFO(sdk_,
                    0,
                    SST_TEV_ARG(tev,
                                  "event",
-                                 "starting_send_retrying_maintenance"));
-    send_retrying_maintenance_previous_ns_ = current_time_ns;
-
-    // Probabilistically resend any outbox entries.
-    std::uniform_int_distribution<decltype(sst::mono_time_ns())> dist(
-        0,
-        sst::checked_cast<decltype(sst::mono_time_ns())>(
-            old_config_.send_retry_window() * 1000000000));
-    for (auto it = outbox_.begin(); it != outbox_.end();) {
-      auto & entry = **it;
-      if (subtract(goodbox_,
-                   entry.handles.begin(),
-                   entry.handles.end())) {
-        if (local.role() == role_t::client()) {
-          try {
-            if (entry.origin_handle() != race_handle_t::null()) {
-              sdk_.onMessageStatusChanged(
-                  SST_TEV_ARG(tev),
-                  entry.origin_handle().value(),
-                  message_status_t::sent().value());
-            }
-          } catch (...) {
-          }
-        }
-        it = outbox_.erase(it);
-      } else if (entry.attempts.size()
-                 > old_config_.send_retry_count()) {
-        if (local.role() == role_t::client()) {
-          try {
-            if (entry.origin_handle() != race_handle_t::null()) {
-              sdk_.onMessageStatusChanged(
-                  SST_TEV_ARG(tev),
-                  entry.origin_handle().value(),
-                  message_status_t::failed().value());
-            }
-          } catch (...) {
-          }
-        }
-        it = outbox_.erase(it);
-      } else if (entry.attempts.empty()) {
-        send(SST_TEV_ARG(tev), entry);
-        ++it;
+                                 "starting_send_retrying_maintenance",
+                                 "send_retry_due",
+                                 sst::to_string(outbox_.ready())));
+    auto n = outbox_.ready();
+    if (old_config_.send_retry_burst > 0
+        && n > old_config_.send_retry_burst) {
+      n = old_config_.send_retry_burst;
+    }
+    outbox_t::handle_t h;
+    for (; n != 0 && outbox_.next_ready(h); --n) {
+      if (outbox_t::value(h)->attempts.size()
+          > old_config_.send_retry_count()) {
+        finish_outbox_entry(SST_TEV_ARG(tev),
+                            h,
+                            message_status_t::failed());
       } else {
-        auto const x = current_time_ns - entry.attempts.back()->time;
-        if (dist(sst::crypto_rng()) < x) {
-          send(SST_TEV_ARG(tev), entry);
-        }
-        ++it;
+        send(SST_TEV_ARG(tev), h);
       }
     }
-
     CARMA_LOG_INFO(sdk_,
                    0,
                    SST_TEV_ARG(tev,
@@ -639,6 +589,67 @@ void plugin_t::do_network_maintenance(tracing_event_t tev) {
                                  "finished_send_retrying_maintenance"));
   }
 
+  //--------------------------------------------------------------------
+  // Mix deadline maintenance
+  //--------------------------------------------------------------------
+  //
+  // Partial batches are normally closed when an up packet arrives, but
+  // if traffic stops entirely, nothing arrives to trigger the deadline.
+  //
+
+  if (local.role() == role_t::mc_leader()
+      && old_config_.mix_max_latency > 0 && !loose_ups.empty()) {
+    try {
+      process_message_context_t pmc(sdk_, *this);
+      mc_leader_cut_batches(SST_TEV_ARG(tev), pmc);
+    } catch (...) {
+      CARMA_LOG_ERROR(sdk_,
+                      0,
+                      SST_TEV_ARG(tev,
+                                    "event",
+                                    "mix_deadline_maintenance_failed",
+                                    "exception",
+                                    sst::what()));
+    }
+  }
+
+  //--------------------------------------------------------------------
+  // Dedup maintenance
+  //--------------------------------------------------------------------
+  //
+  // The duplicate filters rotate on use, but an idle node should still
+  // release old IDs.
+  //
+
+  processed_packet_ids_.expire();
+  mb_processed_cids_.expire();
+  mb_processed_oids_.expire();
+  clrmsg_seen_.expire();
+
+  //--------------------------------------------------------------------
+  // Metrics export
+  //--------------------------------------------------------------------
+
+  if (old_config_.metrics_interval > 0
+      && (metrics_previous_ns_ == 0
+          || std::chrono::nanoseconds(current_time_ns
+                                      - metrics_previous_ns_)
+                 >= std::chrono::seconds(
+                     old_config_.metrics_interval))) {
+    metrics_previous_ns_ = current_time_ns;
+    try {
+      export_metrics(SST_TEV_ARG(tev));
+    } catch (...) {
+      CARMA_LOG_ERROR(sdk_,
+                      0,
+                      SST_TEV_ARG(tev,
+                                    "event",
+                                    "metrics_export_failed",
+                                    "exception",
+                                    sst::what()));
+    }
+  }
+
   //--------------------------------------------------------------------
 }
 
@@ -710,10 +721,15 @@ void plugin_t::processEncPkg(
     encpkg_ptr->init(ePkg);
     auto const & encpkg = *encpkg_ptr;
 
+    // The field stays on the event so that any later error log for
+    // this package carries it. Only the info line itself is skipped
+    // when it would not be logged.
     SST_TEV_ADD(tev, "incoming_encpkg", encpkg.to_json());
-    CARMA_LOG_INFO(sdk_,
-                   0,
-                   SST_TEV_ARG(tev, "event", "incoming_encpkg"));
+    if (KESTREL_SHOULD_LOG(sdk_, log_level_info, 0)) {
+      CARMA_LOG_INFO(sdk_,
+                     0,
+                     SST_TEV_ARG(tev, "event", "incoming_encpkg"));
+    }
 
     if (encpkg.blob().size() == 0) {
       CARMA_LOG_WARN(sdk_,
@@ -721,6 +737,9 @@ void plugin_t::processEncPkg(
                      SST_TEV_ARG(tev, "event", "zero_sized_encpkg"));
     }
 
+    encpkgs_in_.add();
+    bytes_in_.add(encpkg.blob().size());
+
     process_message_context_t pmc(sdk_, *this, handle, ePkg);
 
     unsigned char const * packet_src = encpkg.blob().data();
@@ -744,10 +763,12 @@ void plugin_t::processEncPkg(
                       dpr.packet_type.to_json());
 
         if (dpr.node_info == nullptr) {
+          unknown_senders_.add();
           throw std::runtime_error("I don't know this node");
         }
 
-        if (processed_packet_ids_.count(*dpr.packet_id) != 0) {
+        if (processed_packet_ids_.contains(*dpr.packet_id)) {
+          duplicate_packets_.add();
           CARMA_LOG_TRACE(
               sdk_,
               0,
@@ -755,6 +776,7 @@ void plugin_t::processEncPkg(
           return;
         }
         processed_packet_ids_.insert(*dpr.packet_id);
+        packets_in_[dpr.packet_type.value()]->add();
 
         switch (local.role()) {
           case role_t::client(): {
@@ -1015,6 +1037,83 @@ race_handle_t plugin_t::send(tracing_event_t tev,
   SST_TEV_RETHROW(tev);
 }
 
+race_handle_t plugin_t::send(tracing_event_t tev,
+                             outbox_t::handle_t const h) {
+  SST_TEV_ADD(tev);
+  try {
+    outbox_entry_t & entry = *outbox_t::value(h);
+    race_handle_t const handle = send(SST_TEV_ARG(tev), entry);
+    if (handle != race_handle_t::null()) {
+      outbox_handles_.emplace(handle, h);
+    }
+
+    // If there was no link to send over, try again on the next pass.
+    // Otherwise wait a random time of up to send_retry_window. Either
+    // way, wait at least one tick so the entry isn't due again during
+    // the current pass.
+    using ns_t = decltype(sst::mono_time_ns());
+    ns_t delay =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            network_maintenance_cooldown_)
+            .count();
+    if (!entry.attempts.empty()) {
+      std::uniform_int_distribution<ns_t> dist(
+          0,
+          sst::checked_cast<ns_t>(old_config_.send_retry_window()
+                                  * 1000000000));
+      delay = dist(sst::crypto_rng());
+    }
+    if (delay < outbox_.tick_ns()) {
+      delay = outbox_.tick_ns();
+    }
+    outbox_.reschedule(h, sst::mono_time_ns() + delay);
+
+    return handle;
+  }
+  SST_TEV_RETHROW(tev);
+}
+
+std::size_t plugin_t::outbox_priority(packet_type_t const & type) {
+  if (type == packet_type_t::mb_mc_up_bundle_packet()
+      || type == packet_type_t::mb_mc_up_packet()
+      || type == packet_type_t::mc_leader_init_packet()
+      || type == packet_type_t::mc_mb_down_packet()
+      || type == packet_type_t::mc_v_packet()) {
+    return outbox_priority_mix;
+  }
+  if (type == packet_type_t::add_contact_request()
+      || type == packet_type_t::endorsement_request()
+      || type == packet_type_t::link_address_packet()
+      || type == packet_type_t::registration_complete()) {
+    return outbox_priority_control;
+  }
+  return outbox_priority_normal;
+}
+
+void plugin_t::finish_outbox_entry(tracing_event_t tev,
+                                   outbox_t::handle_t const h,
+                                   message_status_t const & status) {
+  SST_TEV_ADD(tev);
+  try {
+    outbox_entry_t const & entry = *outbox_t::value(h);
+    if (config().local().role() == role_t::client()) {
+      try {
+        if (entry.origin_handle() != race_handle_t::null()) {
+          sdk_.onMessageStatusChanged(SST_TEV_ARG(tev),
+                                      entry.origin_handle().value(),
+                                      status.value());
+        }
+      } catch (...) {
+      }
+    }
+    for (race_handle_t const & handle : entry.handles) {
+      outbox_handles_.erase(handle);
+    }
+    outbox_.erase(h);
+  }
+  SST_TEV_RETHROW(tev);
+}
+
 //----------------------------------------------------------------------
 // IRacePluginNM function overrides
 //----------------------------------------------------------------------
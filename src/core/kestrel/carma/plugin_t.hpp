@@ -20,10 +20,13 @@
 #define KESTREL_CARMA_PLUGIN_T_HPP
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <functional>
 #include <future>
 #include <list>
@@ -47,6 +50,7 @@
 #include <sst/catalog/checked_resize.hpp>
 #include <sst/catalog/cooldown_mutex.hpp>
 #include <sst/catalog/from_varint.hpp>
+#include <sst/catalog/mono_time_ns.hpp>
 #include <sst/catalog/optional.hpp>
 #include <sst/catalog/perfect_ge.hpp>
 #include <sst/catalog/perfect_gt.hpp>
@@ -82,6 +86,8 @@
 #include <kestrel/carma/global_config_t.hpp>
 #include <kestrel/carma/local_config_t.hpp>
 #include <kestrel/carma/mailbox_message_type_t.hpp>
+#include <kestrel/carma/mix_batcher_t.hpp>
+#include <kestrel/carma/mix_executor_t.hpp>
 #include <kestrel/carma/phonebook_entry_t.hpp>
 #include <kestrel/carma/phonebook_pair_t.hpp>
 #include <kestrel/carma/phonebook_t.hpp>
@@ -89,9 +95,11 @@
 #include <kestrel/channel_status_t.hpp>
 #include <kestrel/channel_t.hpp>
 #include <kestrel/corruption_t.hpp>
+#include <kestrel/bundle_window_t.hpp>
 #include <kestrel/bytes_t.hpp>
 #include <kestrel/config.h>
 #include <kestrel/generic_hash_t.hpp>
+#include <kestrel/object_pool_t.hpp>
 #include <kestrel/old_config_t.hpp>
 #include <kestrel/carma/config_t.hpp>
 #include <kestrel/client_mb_packet_t.hpp>
@@ -99,8 +107,8 @@
 #include <kestrel/connection_status_t.hpp>
 #include <kestrel/create_link_call_t.hpp>
 #include <kestrel/create_link_from_address_call_t.hpp>
+#include <kestrel/dedup_window_t.hpp>
 #include <kestrel/link_profile_t.hpp>
-#include <kestrel/goodbox_entry_t.hpp>
 #include <kestrel/graeffe_transform.hpp>
 #include <kestrel/guid_t.hpp>
 #include <kestrel/link_address_t.hpp>
@@ -110,9 +118,11 @@
 #include <kestrel/link_type_t.hpp>
 #include <kestrel/load_link_call_t.hpp>
 #include <kestrel/mb_mc_up_packet_t.hpp>
+#include <kestrel/message_status_t.hpp>
 #include <kestrel/mc_leader_init_packet_t.hpp>
 #include <kestrel/mc_mb_down_packet_t.hpp>
 #include <kestrel/mc_v_packet_t.hpp>
+#include <kestrel/metrics_t.hpp>
 #include <kestrel/open_connection_call_t.hpp>
 #include <kestrel/outbox_entry_t.hpp>
 #include <kestrel/package_status_t.hpp>
@@ -120,6 +130,7 @@
 #include <kestrel/psn_t.hpp>
 #include <kestrel/pkc.hpp>
 #include <kestrel/pooled.hpp>
+#include <kestrel/prime_field_t.hpp>
 #include <kestrel/prime_size_t.hpp>
 #include <kestrel/race_handle_t.hpp>
 #include <kestrel/carma/role_t.hpp>
@@ -128,7 +139,10 @@
 #include <kestrel/secret_sharing.hpp>
 #include <kestrel/serialization.hpp>
 #include <kestrel/span_parents_t.hpp>
+#include <kestrel/sss_recon_context_t.hpp>
+#include <kestrel/sss_share_context_t.hpp>
 #include <kestrel/easy_ta1_plugin_t.hpp>
+#include <kestrel/timer_wheel_t.hpp>
 #include <kestrel/tracing_event_t.hpp>
 
 #if !CARMA_WITH_MOCK_SDK
@@ -353,24 +367,75 @@ protected:
       static_cast<void>(message);
     }
 
+    // type is the type of the packet in msg, which decides the
+    // message's retry priority.
     race_handle_t send_message(tracing_event_t tev,
                                std::vector<unsigned char> const & msg,
-                               psn_t const & psn) {
+                               psn_t const & psn,
+                               packet_type_t const & type) {
       SST_TEV_ADD(tev);
       try {
         auto entry_ptr = plugin.acquire<outbox_entry_t>();
-        auto & entry = *entry_ptr;
-        entry.init(
+        entry_ptr->init(
             origin_handle(),
             psn,
             EncPkg(send_span.trace_id(), send_span.span_id(), msg));
-        plugin.outbox_.emplace_back(std::move(entry_ptr));
-        return plugin.send(SST_TEV_ARG(tev), entry);
+        plugin.messages_out_.add();
+        plugin.bytes_out_.add(msg.size());
+        plugin.packets_out_[type.value()]->add();
+        auto const h =
+            plugin.outbox_.insert(std::move(entry_ptr),
+                                  sst::mono_time_ns(),
+                                  outbox_priority(type));
+        return plugin.send(SST_TEV_ARG(tev), h);
       }
       SST_TEV_RETHROW(tev);
     }
   };
 
+  //
+  // The CPU heavy part of a mix session: reconstruct the power sums
+  // from the v packets, find the roots, and decrypt each root's
+  // mailbox. A job only reads plugin data that is fixed after init, so
+  // it can run on mix_executor_ without the primary mutex.
+  //
+
+  struct mix_output_t final {
+    std::size_t index;
+    bytes_t a;
+    bytes_t b;
+    psn_any_hash_t mailbox_hash;
+  };
+
+  struct mix_job_t final {
+    guid_t mpcid;
+    std::shared_ptr<sss_recon_context_t const> recon;
+    std::vector<std::vector<sst::bigint>> rows;
+    std::vector<mix_output_t> outputs;
+    std::exception_ptr error;
+
+    explicit mix_job_t(
+        guid_t const & mpcid,
+        std::shared_ptr<sss_recon_context_t const> recon)
+        : mpcid(mpcid),
+          recon(std::move(recon)) {
+    }
+  };
+
+  void run_mix_job(mix_job_t & job) noexcept;
+
+  void post_mix_job(std::shared_ptr<mix_job_t> job);
+
+  // Hands finished jobs back to their sessions. Primary.
+  void finish_mix_jobs(tracing_event_t tev);
+
+  mix_executor_t mix_executor_;
+
+  // Finished jobs waiting for finish_mix_jobs. Guarded by
+  // network_maintenance_mutex_, not primary_mutex_, so that the
+  // maintenance thread can wait on it.
+  std::vector<std::shared_ptr<mix_job_t>> mix_results_;
+
   struct server_session_t final {
 
     plugin_t * plugin;
@@ -382,9 +447,14 @@ protected:
       T0_wait_init,
       T1_wait_mb_mc_up,
       T2_wait_v_packet,
+      T2_wait_mix_job,
       T3_end,
     } state;
 
+    // The states that a session waits in, which is all but T3_end.
+    static constexpr std::size_t phase_count =
+        static_cast<std::size_t>(state_t::T3_end);
+
     static std::string to_string(state_t const state) {
       // clang-format off
       switch (state) {
@@ -392,6 +462,7 @@ protected:
         F(T0_wait_init)
         F(T1_wait_mb_mc_up)
         F(T2_wait_v_packet)
+        F(T2_wait_mix_job)
         F(T3_end)
 #undef F
       }
@@ -404,10 +475,28 @@ protected:
     std::vector<pooled<mb_mc_up_packet_t>> p_mb_mc_up; // mixsize
     std::vector<pooled<mc_v_packet_t>> p_v_packet; // mcsize
 
-    std::vector<sst::bigint> T2_z;
-    std::vector<sst::bigint> T2_shrs;
-    std::vector<decltype(+T2_shrs.size())> T2_pts;
-    std::vector<sst::bigint> T2_x;
+    std::vector<std::size_t> T2_pts;
+    std::shared_ptr<mix_job_t> T2_job;
+    bool T2_job_done = false;
+    sdk_span_t T2_send_span;
+
+    // When deduce was called, for the mix.round_ns histogram. Reset to
+    // 0 once the round has been recorded.
+    decltype(sst::mono_time_ns()) start_ns = 0;
+
+    // When the session entered its current state.
+    decltype(sst::mono_time_ns()) state_ns = 0;
+
+    // Moves to state next, recording the time spent in the state being
+    // left in its mix.phase histogram.
+    void enter(state_t const next) {
+      auto const now = sst::mono_time_ns();
+      plugin->mix_phase_ns_[static_cast<std::size_t>(state)]->record(
+          static_cast<std::uint64_t>(now > state_ns ? now - state_ns
+                                                    : 0));
+      state = next;
+      state_ns = now;
+    }
 
     void deduce(tracing_event_t tev,
                 plugin_t & plugin,
@@ -423,12 +512,29 @@ protected:
       sst::checked_resize(
           p_v_packet,
           plugin.local().mc_group(SST_TEV_ARG(tev)).size());
+      T2_job.reset();
+      T2_job_done = false;
+      start_ns = sst::mono_time_ns();
+      state_ns = start_ns;
     }
 
     void create(tracing_event_t tev, plugin_t & plugin) {
       deduce(SST_TEV_ARG(tev), plugin, guid_t::generate());
     }
 
+    // Called when the session goes back to its pool. Hands the packets
+    // back to their own pools right away, but keeps the vectors' storage
+    // for deduce to reuse.
+    void pool_reset() {
+      p_init.reset();
+      p_mb_mc_up.clear();
+      p_v_packet.clear();
+      T2_pts.clear();
+      T2_job.reset();
+      T2_job_done = false;
+      T2_send_span = sdk_span_t();
+    }
+
     bool tick(tracing_event_t tev, process_message_context_t & pmc) {
       SST_TEV_ADD(tev);
       try {
@@ -450,7 +556,7 @@ protected:
               if (p_init == nullptr) {
                 return false;
               }
-              state = state_t::T1_wait_mb_mc_up;
+              enter(state_t::T1_wait_mb_mc_up);
             } break;
             case state_t::T1_wait_mb_mc_up: {
               for (auto const & p : p_mb_mc_up) {
@@ -488,7 +594,7 @@ protected:
               v_packet->prime_size = plugin->prime_size_;
               v_packet->mixsize = config->mixsize;
               v_packet->mpcid = mpcid;
-              v_packet->v = std::move(v);
+              v_packet->v.swap(v);
               if (local.role() == role_t::mc_follower()) {
                 plugin->send(SST_TEV_ARG(tev),
                              pmc,
@@ -500,14 +606,13 @@ protected:
               p_v_packet[local.order()] = std::move(v_packet);
               if (local.role() == role_t::mc_leader()
                   || !config->leader_relay_only) {
-                state = state_t::T2_wait_v_packet;
+                enter(state_t::T2_wait_v_packet);
               } else {
-                state = state_t::T3_end;
+                enter(state_t::T3_end);
               }
             } break;
 
             case state_t::T2_wait_v_packet: {
-              auto const mixsize = config->mixsize;
               auto const mcsize = p_v_packet.size();
               auto const recon_threshold = config->threshold + 1;
               {
@@ -523,14 +628,8 @@ protected:
                   return false;
                 }
               }
-              auto & z = T2_z;
-              auto & shrs = T2_shrs;
               auto & pts = T2_pts;
-              auto & x = T2_x;
-              sst::checked_resize(z, mixsize);
-              sst::checked_resize(shrs, mcsize);
               sst::checked_resize(pts, recon_threshold);
-              sst::checked_resize(x, mixsize);
               {
                 decltype(+mcsize) recon_n = 0;
                 for (decltype(+mcsize) i = 0; i < mcsize; ++i) {
@@ -542,106 +641,58 @@ protected:
                   }
                 }
               }
-              for (decltype(+mixsize) j = 0; j < mixsize; ++j) {
-                decltype(+mcsize) recon_n = 0;
-                for (decltype(+mcsize) i = 0; i < mcsize; ++i) {
-                  if (p_v_packet[i] != nullptr) {
-                    shrs[i] = std::move(p_v_packet[i]->v[j]);
-                    if (++recon_n >= recon_threshold) {
-                      break;
-                    }
-                  }
-                }
-                sss_recon(z[j], shrs, pts, config->prime);
-              }
 
-#if 0
-              CARMA_LOG_TRACE(
-                  plugin->sdk(),
-                  0,
-                  SST_TEV_ARG(tev,
-                                "event",
-                                "mc_server_calculated_root_sum_powers",
-                                "mc_server_calculated_root_sum_powers",
-                                [&]() {
-                                  auto xs = nlohmann::json::array();
-                                  for (decltype(+mixsize) i = 0;
-                                       i < mixsize;
-                                       ++i) {
-                                    xs += z[i].to_string();
-                                  }
-                                  return xs;
-                                }()));
-#endif
+              // The job takes the shares out of the v packets. A v
+              // packet that arrives while the job runs replaces the
+              // packet in p_v_packet, so it never writes into them.
+              auto job = std::make_shared<mix_job_t>(
+                  mpcid,
+                  plugin->recon_context(pts));
+              sst::checked_resize(job->rows, recon_threshold);
+              for (decltype(+recon_threshold) k = 0;
+                   k < recon_threshold;
+                   ++k) {
+                job->rows[k] = std::move(p_v_packet[pts[k]]->v);
+              }
 
-              // zeta must be a primitive root
-              SST_ASSERT(config->prime
-                         == (sst::bigint(1) << config->two_exponent)
-                                    * config->odd_factor
-                                + 1);
-              SST_ASSERT((sst::perfect_gt(config->odd_factor, mixsize)));
-              {
-                NumX poly(config->prime);
-                newton_to_polynomial(
-                    poly,
-                    z,
-                    sst::checked_cast<unsigned int>(mixsize));
-                x = find_roots(
-                    poly,
-                    config->zeta,
-                    sst::checked_cast<long>(config->two_exponent),
-                    sst::checked_cast<long>(config->odd_factor));
+              T2_job = job;
+              if (plugin->mix_executor_.size() == 0) {
+                plugin->run_mix_job(*job);
+                T2_job_done = true;
+              } else {
+                T2_job_done = false;
+                T2_send_span = pmc.send_span;
+                plugin->post_mix_job(std::move(job));
               }
+              enter(state_t::T2_wait_mix_job);
+            } break;
 
-              // All servers must have the roots in the same order.
-              std::sort(x.begin(),
-                        x.end(),
-                        [](sst::bigint const & a,
-                           sst::bigint const & b) { return a < b; });
+            case state_t::T2_wait_mix_job: {
+              if (!T2_job_done) {
+                return false;
+              }
+              auto const job = std::move(T2_job);
+              T2_job_done = false;
+              if (job->error) {
+                std::rethrow_exception(job->error);
+              }
 
-              for (decltype(+mixsize) i = 0; i < mixsize; ++i) {
-                auto packet =
-                    plugin->template acquire<mc_mb_down_packet_t>();
-                bytes_t buf =
-                    x[i].to_bytes(sst::integer_rep::pure_unsigned());
-                buf.resize(global.prime_space());
-                bytes_t::size_type buf_i = 0;
-                bytes_t c;
-                bytes_t::size_type cc_i = 0;
-                deserialize(buf, buf_i, packet->a, packet->b, c);
-                bytes_t const cc = plugin->local().anon_decrypt(c);
-                psn_any_hash_t mailbox_hash;
-                deserialize(cc, cc_i, mailbox_hash);
+              for (auto & out : job->outputs) {
                 std::shared_ptr<phonebook_entry_t const> const mailbox =
                     plugin->phonebook().at(SST_TEV_ARG(tev),
-                                           mailbox_hash);
+                                           out.mailbox_hash);
                 if (mailbox->role() != role_t::mb_server()) {
                   throw corruption_t();
                 }
+                auto packet =
+                    plugin->template acquire<mc_mb_down_packet_t>();
                 packet->type = packet_type_t::mc_mb_down_packet();
-                packet->oid = mpcid + (i + 1);
+                packet->a = std::move(out.a);
+                packet->b = std::move(out.b);
+                packet->oid = mpcid + (out.index + 1);
                 plugin->send(SST_TEV_ARG(tev), pmc, *packet, *mailbox);
               }
 
-#if 0
-              CARMA_LOG_TRACE(
-                  plugin->sdk(),
-                  0,
-                  SST_TEV_ARG(tev,
-                                "event",
-                                "mc_server_calculated_roots",
-                                "mc_server_calculated_roots",
-                                [&]() {
-                                  auto xs = nlohmann::json::array();
-                                  for (decltype(+mixsize) i = 0;
-                                       i < mixsize;
-                                       ++i) {
-                                    xs += x[i].to_string();
-                                  }
-                                  return xs;
-                                }()));
-#endif
-
               CARMA_LOG_TRACE(
                   plugin->sdk(),
                   0,
@@ -651,18 +702,23 @@ protected:
                                 "mc_server_picked_oids",
                                 [&]() {
                                   auto xs = nlohmann::json::array();
-                                  for (decltype(+mixsize) i = 0;
-                                       i < mixsize;
-                                       ++i) {
-                                    xs += (mpcid + (i + 1)).to_json();
+                                  for (auto const & out : job->outputs) {
+                                    xs += (mpcid + (out.index + 1))
+                                              .to_json();
                                   }
                                   return xs;
                                 }()));
 
-              state = state_t::T3_end;
+              enter(state_t::T3_end);
             } break;
 
             case state_t::T3_end: {
+              if (start_ns != 0) {
+                auto const now = sst::mono_time_ns();
+                plugin->mix_round_ns_.record(static_cast<std::uint64_t>(
+                    now > start_ns ? now - start_ns : 0));
+                start_ns = 0;
+              }
               return true;
             } break;
             default: {
@@ -685,16 +741,24 @@ protected:
 
   //--------------------------------------------------------------------
 
-  std::set<std::vector<unsigned char>> processed_packet_ids_;
+  //
+  // Duplicate filters. These only remember IDs for the configured
+  // dedup_retention window (see dedup_window_t), which is far longer
+  // than any retry or resend, and are pruned by network maintenance.
+  //
+
+  dedup_window_t<std::vector<unsigned char>> processed_packet_ids_;
 
   //--------------------------------------------------------------------
 
-  std::set<guid_t> mb_processed_cids_;
-  std::map<guid_t, sdk_span_t> mb_processed_oids_;
+  dedup_window_t<guid_t> mb_processed_cids_;
+  dedup_window_t<guid_t, sdk_span_t> mb_processed_oids_;
 
   //--------------------------------------------------------------------
 
-  std::set<sst::remove_cvref_t<decltype(std::declval<generic_hash_t>().finish())>> clrmsg_seen_;
+  dedup_window_t<sst::remove_cvref_t<
+      decltype(std::declval<generic_hash_t>().finish())>>
+      clrmsg_seen_;
 
   //--------------------------------------------------------------------
 
@@ -713,13 +777,113 @@ protected:
     return s;
   }
 
+  // Lagrange coefficients keyed by the committee member indices whose
+  // v packets were used for reconstruction. The leader almost always
+  // sees the same few index sets, so this stays tiny. Past 64 sets,
+  // the least recently used one is dropped. The contexts are shared
+  // with the mix jobs, so dropping one never pulls it out from under a
+  // job that is still running.
+  struct recon_context_entry_t {
+    std::shared_ptr<sss_recon_context_t const> context;
+    std::list<std::vector<std::size_t>>::iterator lru;
+  };
+  std::map<std::vector<std::size_t>, recon_context_entry_t>
+      recon_contexts_;
+  std::list<std::vector<std::size_t>> recon_contexts_lru_;
+
+  std::shared_ptr<sss_recon_context_t const>
+  recon_context(std::vector<std::size_t> const & pts) {
+    auto const it = recon_contexts_.find(pts);
+    if (it != recon_contexts_.end()) {
+      recon_contexts_lru_.splice(recon_contexts_lru_.begin(),
+                                 recon_contexts_lru_,
+                                 it->second.lru);
+      return it->second.context;
+    }
+    if (recon_contexts_.size() >= 64) {
+      recon_contexts_.erase(recon_contexts_lru_.back());
+      recon_contexts_lru_.pop_back();
+    }
+    std::shared_ptr<sss_recon_context_t const> context;
+    if (mix_field_) {
+      context = std::make_shared<sss_recon_context_t>(pts, *mix_field_);
+    } else {
+      context =
+          std::make_shared<sss_recon_context_t>(pts, old_config_.prime);
+    }
+    recon_contexts_lru_.push_front(pts);
+    recon_contexts_.emplace(
+        pts,
+        recon_context_entry_t{context, recon_contexts_lru_.begin()});
+    return context;
+  }
+
+  // Batched sharing tables keyed by the committee size.
+  std::map<std::size_t, sss_share_context_t> share_contexts_;
+
+  sss_share_context_t & share_context(std::size_t const numshares) {
+    auto const it = share_contexts_.find(numshares);
+    if (it != share_contexts_.end()) {
+      return it->second;
+    }
+    if (mix_field_) {
+      return share_contexts_
+          .emplace(numshares,
+                   sss_share_context_t(numshares,
+                                       old_config_.threshold,
+                                       *mix_field_))
+          .first->second;
+    }
+    return share_contexts_
+        .emplace(numshares,
+                 sss_share_context_t(numshares,
+                                     old_config_.threshold,
+                                     old_config_.prime))
+        .first->second;
+  }
+
+  // Fills y with x, x^2, ..., x^mixsize, the values that get shared
+  // out for one message.
+  void mix_powers(std::vector<sst::bigint> & y, sst::bigint const & x) {
+    auto const ms = old_config_.mixsize;
+    sst::checked_resize(y, ms);
+    y[0] = x;
+    if (mix_field_) {
+      auto const fx = mix_field_->from_bigint(x);
+      auto xi = fx;
+      for (decltype(y.size()) i = 1; i < y.size(); ++i) {
+        xi = mix_field_->mul(xi, fx);
+        y[i] = mix_field_->to_bigint(xi);
+      }
+    } else {
+      for (decltype(y.size()) i = 1; i < y.size(); ++i) {
+        y[i] = mul_mod(x, y[i - 1], old_config_.prime);
+      }
+    }
+  }
+
   std::map<guid_t, pooled<mb_mc_up_packet_t>> loose_ups;
+  // Arrival time of each loose up packet, used by the leader to decide
+  // when to close a batch.
+  mix_batcher_t<guid_t> mix_batcher_;
   std::map<guid_t, std::reference_wrapper<server_session_t>> wanted_ups;
 
+  // Dummy up packets from the MC leader that arrived before its init
+  // packet, and the dummy cids that an init packet announced but whose
+  // packets have not arrived yet. Kept apart from loose_ups and
+  // wanted_ups so that the leader can only fill dummy slots.
+  std::map<guid_t, pooled<mb_mc_up_packet_t>> leader_dummy_ups;
+  std::map<guid_t, std::reference_wrapper<server_session_t>>
+      wanted_dummy_ups;
+
   //--------------------------------------------------------------------
 
   prime_size_t prime_size_;
 
+  // Set during inner_init if old_config_.montgomery_field is enabled
+  // and the prime fits.
+  sst::optional<mix_field_t> mix_field_;
+
   //--------------------------------------------------------------------
 
   struct prepareToBootstrap_info_1_t {
@@ -851,20 +1015,20 @@ protected:
   // Object pooling
   //--------------------------------------------------------------------
   //
-  // TODO: Actually pool. Be careful of thread safety once we start
-  //       allowing plugin calls to execute concurrently.
+  // acquire() hands out an object from the process-wide object_pool_t
+  // for T, which is thread-safe. A reused object has been reset as
+  // described in object_pool_t.hpp, which is not always the same as a
+  // default constructed object, so callers must initialize everything
+  // they use (e.g. with from_bytes_prep, deduce or create).
   //
   // TODO: acquire() should perhaps be given Args&&... to forward to T's
   //       constructor (if allocating) or to its init() function (if
-  //       reusing). All of our own classes that are poolable should
-  //       always have an init() function. For pooling more fundamental
-  //       types, we can support a narrow set of them that we explicitly
-  //       support and do the right thing for them.
+  //       reusing).
   //
 
   template<class T>
   pooled<T> acquire() {
-    return pooled<T>(new T);
+    return object_pool_t<T>::instance().acquire();
   }
 
   //--------------------------------------------------------------------
@@ -973,6 +1137,52 @@ protected:
   std::future<void> link_discovery_cooldown_future_;
   sst::cooldown_mutex link_discovery_cooldown_mutex_{true};
 
+  //--------------------------------------------------------------------
+  // Metrics
+  //--------------------------------------------------------------------
+  //
+  // Everything here is thread-safe (see metrics_t.hpp). The packet
+  // counters are indexed by packet_type_t::value() and are filled in by
+  // the constructor. The histogram references must be declared after
+  // metrics_ so that it is constructed first.
+  //
+  // If old_config_.metrics_interval is positive, network maintenance
+  // periodically writes a snapshot of metrics_, along with the other
+  // statistics kept around the plugin, to old_config_.metrics_file.
+  //
+
+  metrics_t metrics_;
+
+  std::array<metric_counter_t *, packet_type_t::count()> packets_in_{};
+  std::array<metric_counter_t *, packet_type_t::count()> packets_out_{};
+
+  metric_counter_t & messages_out_ = metrics_.counter("messages_out");
+  metric_counter_t & bytes_out_ = metrics_.counter("bytes_out");
+  metric_counter_t & encpkgs_in_ = metrics_.counter("encpkgs_in");
+  metric_counter_t & bytes_in_ = metrics_.counter("bytes_in");
+  metric_counter_t & unknown_senders_ =
+      metrics_.counter("packets_in.unknown_sender");
+  metric_counter_t & duplicate_packets_ =
+      metrics_.counter("packets_in.duplicate");
+
+  metric_histogram_t & encrypt_ns_ =
+      metrics_.histogram("crypto.encrypt_ns");
+  metric_histogram_t & decrypt_ns_ =
+      metrics_.histogram("crypto.decrypt_ns");
+  metric_histogram_t & mix_job_ns_ = metrics_.histogram("mix.job_ns");
+  metric_histogram_t & mix_round_ns_ =
+      metrics_.histogram("mix.round_ns");
+
+  // Time that server sessions spend in each state, indexed by state_t
+  // and named mix.phase.<state>_ns.
+  std::array<metric_histogram_t *, server_session_t::phase_count>
+      mix_phase_ns_{};
+
+  decltype(sst::mono_time_ns()) metrics_previous_ns_{0};
+
+  // Writes the snapshot described above. Primary.
+  void export_metrics(tracing_event_t tev);
+
   //--------------------------------------------------------------------
   // Packet serialization
   //--------------------------------------------------------------------
@@ -1002,10 +1212,15 @@ protected:
     buf1.resize(src.template to_bytes_size<size_type>());
     src.to_bytes(&buf1[0]);
 
-    auto pair = pkc::auth_encrypt(
-        config().local().sk(),
-        config().phonebook().at(SST_TEV_ARG(tev), remote.psn())->pk(),
-        buf1);
+    auto const peer =
+        config().phonebook().at(SST_TEV_ARG(tev), remote.psn());
+    auto pair = [&]() {
+      metric_timer_t const timer(encrypt_ns_);
+      return pkc::auth_encrypt_afternm(
+          global().shared_keys().get(config().local().sk(),
+                                     peer->pk()),
+          buf1);
+    }();
     auto & buf2 = pair.first;
     auto const ct_size = buf2.size();
     unsigned char const * const p_id = pair.second;
@@ -1103,12 +1318,10 @@ protected:
 
       // Decrypt the packet data.
       {
-        unsigned char const * const id = pkc::auth_decrypt(
-            config()
-                .phonebook()
-                .at(SST_TEV_ARG(tev), dpr.node_info->psn())
-                ->pk(),
-            config().local().sk(),
+        metric_timer_t const timer(decrypt_ns_);
+        unsigned char const * const id = pkc::auth_decrypt_afternm(
+            global().shared_keys().get(config().local().sk(),
+                                       dpr.node_info->pk()),
             sst::span(ct, ct_size),
             *dpr.packet_data);
         sst::checked_resize(*dpr.packet_id,
@@ -1156,11 +1369,37 @@ protected:
       process_message_context_t & pmc,
       pooled<mb_mc_up_packet_t> up_packet);
 
-  server_session_t * handle_mb_mc_up_bundle_packet(
+  // Takes a dummy up packet that the MC leader sent to pad a batch.
+  // Follower only. The packet is held until the leader's init packet
+  // names its cid in a dummy slot.
+  server_session_t * handle_mc_leader_dummy_up(
+      tracing_event_t tev,
+      pooled<mb_mc_up_packet_t> up_packet);
+
+  // A bundle may hold the shares of several client packets back to
+  // back. Each up packet's session is ticked here.
+  void handle_mb_mc_up_bundle_packet(
       tracing_event_t tev,
       process_message_context_t & pmc,
       deserialize_packet_result const & dpr);
 
+  // Starts a mix for every full batch of loose up packets and, if
+  // mix_max_latency is set, for a partial batch whose oldest packet
+  // has waited that long. Leader only.
+  void mc_leader_cut_batches(tracing_event_t tev,
+                             process_message_context_t & pmc);
+
+  // Starts a mix with the batch.real oldest loose up packets and pads
+  // the rest of the batch with batch.dummies dummies.
+  void mc_leader_start_mix(tracing_event_t tev,
+                           process_message_context_t & pmc,
+                           mix_batch_t const & batch);
+
+  guid_t mc_leader_add_dummy_up(tracing_event_t tev,
+                                process_message_context_t & pmc,
+                                server_session_t & session,
+                                std::size_t slot);
+
   void mc_server_processEncPkg(tracing_event_t tev,
                                process_message_context_t & pmc,
                                deserialize_packet_result const & dpr);
@@ -1206,6 +1445,40 @@ protected:
                                process_message_context_t & pmc,
                                client_mb_packet_t const & packet);
 
+  //
+  // Up bundles that a mailbox is holding back so that several client
+  // packets can go to a committee leader in one message. Only used if
+  // mb_bundle_window is positive. Primary.
+  //
+
+  struct mb_bundle_t final {
+    std::vector<unsigned char> data;
+    sdk_span_t send_span;
+  };
+
+  using mb_bundles_t = bundle_window_t<psn_t, mb_bundle_t>;
+
+  mb_bundles_t mb_bundles_;
+
+  // The earliest bundle deadline, or 0 if there are no bundles. The
+  // maintenance thread reads this without the primary mutex to decide
+  // when to wake up.
+  std::atomic<decltype(sst::mono_time_ns())> mb_bundle_deadline_ns_{0};
+
+  // Set when mb_bundle_deadline_ns_ moves earlier, so that a sleeping
+  // maintenance thread recomputes its wakeup time.
+  std::atomic_bool mb_bundle_rearm_{false};
+
+  void send_mb_bundle(tracing_event_t tev,
+                      process_message_context_t & pmc,
+                      psn_t const & leader,
+                      mb_bundles_t::bundle_t & bundle);
+
+  // Sends every bundle whose window has passed, or every bundle if
+  // all is true. The maintenance thread flushes due bundles and
+  // inner_shutdown flushes all of them.
+  void flush_mb_bundles(tracing_event_t tev, bool all = false);
+
   void handle_endorsement_request(
       tracing_event_t tev,
       process_message_context_t & pmc,
@@ -1225,8 +1498,35 @@ protected:
   std::map<link_type_t, std::map<psn_t, std::set<link_id_t>>>
       link_sets_;
 
-  std::list<pooled<outbox_entry_t>> outbox_;
-  std::map<race_handle_t, goodbox_entry_t> goodbox_;
+  //
+  // Messages waiting to be confirmed, scheduled by when they should
+  // next be resent. Each send attempt's handle maps back to its entry,
+  // so a confirmation for any attempt removes the entry right away.
+  // Mix traffic is resent ahead of everything else, and endorsement
+  // and bootstrap traffic after everything else. Primary.
+  //
+
+  enum : std::size_t {
+    outbox_priority_mix,
+    outbox_priority_normal,
+    outbox_priority_control,
+    outbox_priority_count
+  };
+
+  static std::size_t outbox_priority(packet_type_t const & type);
+
+  using outbox_t =
+      timer_wheel_t<pooled<outbox_entry_t>, outbox_priority_count>;
+
+  outbox_t outbox_;
+  std::unordered_map<race_handle_t, outbox_t::handle_t>
+      outbox_handles_;
+
+  // Removes an entry from the outbox and, on a client, reports the
+  // message's final status to the SDK.
+  void finish_outbox_entry(tracing_event_t tev,
+                           outbox_t::handle_t h,
+                           message_status_t const & status);
 
   //--------------------------------------------------------------------
 
@@ -1237,10 +1537,6 @@ protected:
   decltype(sst::mono_time_ns()) link_polling_maintenance_previous_ns_{
       0};
 
-  std::chrono::seconds send_retrying_maintenance_cooldown_{20};
-  decltype(sst::mono_time_ns()) send_retrying_maintenance_previous_ns_{
-      0};
-
   std::thread network_maintenance_thread_;
   std::mutex network_maintenance_mutex_;
   std::condition_variable network_maintenance_cond_;
@@ -1263,6 +1559,9 @@ protected:
   race_handle_t send(tracing_event_t tev,
                      outbox_entry_t & outbox_entry);
 
+  // Sends the outbox entry at h and schedules its next retry.
+  race_handle_t send(tracing_event_t tev, outbox_t::handle_t h);
+
   template<class Packet>
   race_handle_t send(tracing_event_t tev,
                      process_message_context_t & pmc,
@@ -1285,7 +1584,10 @@ protected:
                        &id[0],
                        remote);
 
-      return pmc.send_message(SST_TEV_ARG(tev), buf, remote.psn());
+      return pmc.send_message(SST_TEV_ARG(tev),
+                              buf,
+                              remote.psn(),
+                              packet.type);
     }
     SST_TEV_RETHROW(tev);
   }
@@ -23,6 +23,7 @@
 //
 
 #include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <iterator>
 #include <memory>
@@ -57,6 +58,7 @@
 #include <kestrel/CARMA_XLOG_INFO.hpp>
 #include <kestrel/CARMA_XLOG_TRACE.hpp>
 #include <kestrel/bytes_t.hpp>
+#include <kestrel/bytes_view_t.hpp>
 #include <kestrel/carma/bootstrap_config_t.hpp>
 #include <kestrel/carma/client_message_type_t.hpp>
 #include <kestrel/carma/clrmsg_store_entry_t.hpp>
@@ -305,13 +307,26 @@ void plugin_t::handle_detached_clrmsg(tracing_event_t tev,
       sdk(),
       SST_TEV_ARG(tev, "event", "handle_detached_clrmsg_called"));
 
+  // Keep a copy in the persistent store until the message is sent, so
+  // that it survives a restart. This throws if the store is full.
   {
+    std::uint64_t const id =
+        config()
+            .clrmsgs()
+            .add(SST_TEV_ARG(tev), clrmsg_store_entry_t(clrmsg))
+            .id();
     sst::unique_ptr<detached_clrmsg_store_t::entry_t> p{sst::in_place};
     p->handle = handle;
     p->clrmsg = clrmsg;
-    config()
-        .detached_clrmsg_store(SST_TEV_ARG(tev))
-        .add(SST_TEV_ARG(tev), std::move(p));
+    p->store_id = id;
+    try {
+      config()
+          .detached_clrmsg_store(SST_TEV_ARG(tev))
+          .add(SST_TEV_ARG(tev), std::move(p));
+    } catch (...) {
+      config().clrmsgs().erase(SST_TEV_ARG(tev), id);
+      throw;
+    }
   }
 
   phonebook_entry_t recver_client;
@@ -369,9 +384,11 @@ void plugin_t::inner_processClrMsg(tracing_event_t tev,
     clrmsg_t const clrmsg(msg);
 
     SST_TEV_ADD(tev, "incoming_clrmsg", clrmsg.to_json());
-    CARMA_XLOG_INFO(sdk_,
-                    0,
-                    SST_TEV_ARG(tev, "event", "incoming_clrmsg"));
+    if (KESTREL_SHOULD_LOG(sdk_, log_level_info, 0)) {
+      CARMA_XLOG_INFO(sdk_,
+                      0,
+                      SST_TEV_ARG(tev, "event", "incoming_clrmsg"));
+    }
 
     std::vector<unsigned char> const clrmsg_blob = [&] {
       std::vector<unsigned char> v;
@@ -459,10 +476,10 @@ void plugin_t::client_processEncPkg(
       bytes_t const buf = local().anon_decrypt(packet->a);
       bytes_t::size_type buf_i = 0;
 
-      bytes_t chunk_group;
+      bytes_view_t chunk_group;
       bytes_t::size_type chunk_index;
       bytes_t::size_type chunk_count;
-      bytes_t chunk_data;
+      bytes_view_t chunk_data;
       deserialize(buf,
                   buf_i,
                   chunk_group,
@@ -472,10 +489,10 @@ void plugin_t::client_processEncPkg(
 
       sst::optional<bytes_t> const combined =
           config().chunk_joiner().add(SST_TEV_ARG(tev),
-                                      chunk_group,
+                                      chunk_group.to_bytes(),
                                       chunk_index,
                                       chunk_count,
-                                      chunk_data);
+                                      chunk_data.to_bytes());
 
       if (combined) {
         bytes_t::size_type combined_i = 0;
@@ -504,18 +521,20 @@ void plugin_t::client_processEncPkg(
             clrmsg.from_bytes(combined->data() + combined_i, avail);
 
             SST_TEV_ADD(tev, "reconstructed_clrmsg", clrmsg.to_json());
-            KESTREL_INFO(
-                sdk(),
-                SST_TEV_ARG(tev, "event", "reconstructed_clrmsg"));
+            if (KESTREL_SHOULD_LOG(sdk(), log_level_info, 0)) {
+              KESTREL_INFO(
+                  sdk(),
+                  SST_TEV_ARG(tev, "event", "reconstructed_clrmsg"));
+            }
 
             auto const h = clrmsg.content_hash();
-            if (clrmsg_seen_.find(h) != clrmsg_seen_.end()) {
+            if (clrmsg_seen_.contains(h)) {
               KESTREL_TRACE(
                   sdk(),
                   SST_TEV_ARG(tev, "event", "duplicate_clrmsg"));
               return;
             }
-            clrmsg_seen_.emplace(h);
+            clrmsg_seen_.insert(h);
 
             sdk().present(SST_TEV_ARG(tev), clrmsg.to_ClrMsg());
 
@@ -548,27 +567,27 @@ void plugin_t::client_handle_add_contact_request(
 
   bytes_t const & packet = *dpr.packet_data;
   bytes_t::size_type packet_i = dpr.body_offset;
-  bytes_t a_data;
+  bytes_view_t a_data;
   deserialize(packet, packet_i, a_data);
 
   bytes_t::size_type a_data_i = 0;
-  bytes_t chunk_group;
+  bytes_view_t chunk_group;
   bytes_t::size_type chunk_index;
   bytes_t::size_type chunk_count;
-  bytes_t chunk_data;
-  deserialize(a_data,
-              a_data_i,
-              chunk_group,
-              chunk_index,
-              chunk_count,
-              chunk_data);
+  bytes_view_t chunk_data;
+  deserialize_view(a_data,
+                   a_data_i,
+                   chunk_group,
+                   chunk_index,
+                   chunk_count,
+                   chunk_data);
 
   sst::optional<bytes_t> const combined =
       config().chunk_joiner().add(SST_TEV_ARG(tev),
-                                  chunk_group,
+                                  chunk_group.to_bytes(),
                                   chunk_index,
                                   chunk_count,
-                                  chunk_data);
+                                  chunk_data.to_bytes());
 
   if (combined) {
 
@@ -703,6 +722,7 @@ void plugin_t::client_handle_add_contact_response(
                            *sender_client,
                            a_data,
                            mailbox_message_type_t::mail_delivery());
+    config().clrmsgs().erase(SST_TEV_ARG(tev), (*p)->store_id);
     p->reset();
   }
 
@@ -22,12 +22,28 @@
 #include <kestrel/carma/plugin_t.hpp>
 //
 
+#include <cstddef>
+#include <string>
+
+#include <kestrel/packet_type_t.hpp>
+
 namespace kestrel {
 namespace carma {
 
 plugin_t::plugin_t(IRaceSdkNM & sdk)
     : common_plugin_t(sdk, "carma"),
       easy_ta1_plugin_t(sdk, "carma") {
+  for (packet_type_t::value_type i = 0; i < packet_type_t::count();
+       ++i) {
+    std::string const name = packet_type_t(i).to_string();
+    packets_in_[i] = &metrics_.counter("packets_in." + name);
+    packets_out_[i] = &metrics_.counter("packets_out." + name);
+  }
+  for (std::size_t i = 0; i < server_session_t::phase_count; ++i) {
+    std::string const name = server_session_t::to_string(
+        static_cast<server_session_t::state_t>(i));
+    mix_phase_ns_[i] = &metrics_.histogram("mix.phase." + name + "_ns");
+  }
 }
 
 } // namespace carma
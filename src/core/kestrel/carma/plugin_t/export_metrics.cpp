@@ -0,0 +1,140 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/plugin_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/plugin_t.hpp>
+//
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <sst/catalog/SST_TEV_ADD.hpp>
+#include <sst/catalog/SST_TEV_RETHROW.hpp>
+
+#include <kestrel/chunk_joiner_t.hpp>
+#include <kestrel/dedup_window_t.hpp>
+#include <kestrel/json_t.hpp>
+#include <kestrel/log_sink_t.hpp>
+#include <kestrel/metrics_t.hpp>
+#include <kestrel/object_pool_t.hpp>
+#include <kestrel/tracing_event_t.hpp>
+
+namespace kestrel {
+namespace carma {
+
+namespace {
+
+json_t to_json(dedup_window_stats_t const & s) {
+  return {
+      {"hits", s.hits},
+      {"inserts", s.inserts},
+      {"evicted", s.evicted},
+      {"rotations", s.rotations},
+      {"early_rotations", s.early_rotations},
+      {"size", s.size},
+  };
+}
+
+} // namespace
+
+void plugin_t::export_metrics(tracing_event_t tev) {
+  SST_TEV_ADD(tev);
+  try {
+
+    metrics_.gauge("outbox.size").set(
+        static_cast<std::int64_t>(outbox_.size()));
+    metrics_.gauge("outbox.ready").set(
+        static_cast<std::int64_t>(outbox_.ready()));
+    metrics_.gauge("sessions.size").set(
+        static_cast<std::int64_t>(sessions_.size()));
+    metrics_.gauge("mb_bundles.size").set(
+        static_cast<std::int64_t>(mb_bundles_.size()));
+
+    json_t snapshot = metrics_.to_json();
+
+    {
+      json_t & pools = snapshot["object_pools"];
+      pools = json_t::object();
+      for (auto const & kv : object_pool_stats()) {
+        auto const & s = kv.second;
+        pools[kv.first] = {
+            {"acquires", s.acquires},
+            {"hits", s.hits},
+            {"releases", s.releases},
+            {"discards", s.discards},
+            {"in_use", s.in_use},
+            {"free", s.free},
+        };
+      }
+    }
+
+    {
+      auto const s = log_sink_t::instance().stats();
+      snapshot["log_sink"] = {
+          {"written", s.written},
+          {"dropped", s.dropped},
+          {"depth", s.depth},
+          {"max_depth", s.max_depth},
+      };
+    }
+
+    {
+      auto const & keys = global().shared_keys();
+      snapshot["shared_keys"] = {
+          {"size", keys.size()},
+          {"hits", keys.hits()},
+          {"misses", keys.misses()},
+      };
+    }
+
+    {
+      auto const s = config().chunk_joiner().stats();
+      snapshot["chunk_joiner"] = {
+          {"groups", s.groups},
+          {"bytes", s.bytes},
+          {"completed", s.completed},
+          {"expired", s.expired},
+          {"evicted", s.evicted},
+          {"refused", s.refused},
+          {"spilled", s.spilled},
+      };
+    }
+
+    snapshot["dedup"] = {
+        {"processed_packet_ids",
+         to_json(processed_packet_ids_.stats())},
+        {"mb_processed_cids", to_json(mb_processed_cids_.stats())},
+        {"mb_processed_oids", to_json(mb_processed_oids_.stats())},
+        {"clrmsg_seen", to_json(clrmsg_seen_.stats())},
+    };
+
+    std::string const text = snapshot.dump();
+    sdk().writeFile(
+        SST_TEV_ARG(tev),
+        old_config_.metrics_file,
+        std::vector<std::uint8_t>(text.begin(), text.end()));
+
+  } //
+  SST_TEV_RETHROW(tev);
+}
+
+} // namespace carma
+} // namespace kestrel
@@ -53,8 +53,11 @@
 #include <sst/catalog/integer_rep.hpp>
 #include <sst/catalog/json/get_from_string.hpp>
 #include <sst/catalog/json/get_to.hpp>
+#include <sst/catalog/in_place.hpp>
 #include <sst/catalog/make_unique.hpp>
+#include <sst/catalog/mono_time_ns.hpp>
 #include <sst/catalog/to_string.hpp>
+#include <sst/catalog/unique_ptr.hpp>
 #include <sst/catalog/what.hpp>
 #include <sst/time.h>
 
@@ -67,14 +70,17 @@
 #include <kestrel/CARMA_XLOG_INFO.hpp>
 #include <kestrel/carma/bootstrap_config_t.hpp>
 #include <kestrel/carma/config_t.hpp>
+#include <kestrel/carma/phonebook_t.hpp>
+#include <kestrel/carma/role_t.hpp>
 #include <kestrel/channel_id_t.hpp>
 #include <kestrel/channel_status_t.hpp>
 #include <kestrel/channel_t.hpp>
+#include <kestrel/chunk_joiner_t.hpp>
 #include <kestrel/config.h>
 #include <kestrel/connection_status_t.hpp>
 #include <kestrel/connection_t.hpp>
+#include <kestrel/detached_clrmsg_store_t.hpp>
 #include <kestrel/encpkg_t.hpp>
-#include <kestrel/goodbox_entry_t.hpp>
 #include <kestrel/json_t.hpp>
 #include <kestrel/link_address_packet_t.hpp>
 #include <kestrel/link_address_t.hpp>
@@ -82,7 +88,9 @@
 #include <kestrel/open_connection_call_t.hpp>
 #include <kestrel/pkc.hpp>
 #include <kestrel/plugin_state_t.hpp>
+#include <kestrel/prime_field_t.hpp>
 #include <kestrel/psn_t.hpp>
+#include <kestrel/race_handle_t.hpp>
 #include <kestrel/sdk_wrapper_t.hpp>
 #include <kestrel/tracing_event_t.hpp>
 #include <kestrel/tracing_exception_t.hpp>
@@ -187,8 +195,80 @@ void plugin_t::inner_init(tracing_event_t tev,
   prime_size_ = old_config_.prime.num_bytes<decltype(prime_size_)>(
       sst::integer_rep::pure_unsigned());
 
+  if (old_config_.montgomery_field
+      && mix_field_t::fits(old_config_.prime)) {
+    mix_field_.emplace(old_config_.prime);
+  }
+
   sdk_.set_config(SST_TEV_ARG(tev), old_config_);
 
+  config().phonebook().set_max_resident(
+      old_config_.phonebook_max_resident);
+
+  {
+    auto const retention_ns =
+        static_cast<decltype(sst::mono_time_ns())>(
+            old_config_.dedup_retention)
+        * 1000000000;
+    auto const max_entries = old_config_.dedup_max_entries;
+    processed_packet_ids_.configure(retention_ns, max_entries);
+    mb_processed_cids_.configure(retention_ns, max_entries);
+    mb_processed_oids_.configure(retention_ns, max_entries);
+    clrmsg_seen_.configure(retention_ns, max_entries);
+  }
+
+  mix_batcher_.configure(
+      old_config_.mixsize,
+      static_cast<decltype(sst::mono_time_ns())>(
+          old_config_.mix_max_latency)
+          * 1000000000,
+      old_config_.mix_min_fill);
+
+  mb_bundles_.configure(
+      static_cast<decltype(sst::mono_time_ns())>(
+          old_config_.mb_bundle_window)
+          * 1000000,
+      old_config_.mb_bundle_max);
+
+  config().chunk_joiner().configure(
+      static_cast<chunk_joiner_t::time_ns_t>(
+          old_config_.chunk_group_timeout)
+          * 1000000000,
+      old_config_.chunk_memory_budget,
+      old_config_.chunk_spill_size);
+
+  config().clrmsgs().set_max_bytes(old_config_.clrmsg_store_max_bytes);
+
+  //--------------------------------------------------------------------
+  // Restore the messages that were waiting for a contact
+  //--------------------------------------------------------------------
+  //
+  // The add contact request for each of them went out before we last
+  // stopped, and the response handler sends them when it arrives.
+  // Their RACE handles did not survive the restart.
+  //
+
+  if (config().local().role() == role_t::client()) {
+    detached_clrmsg_store_t & detached =
+        config().detached_clrmsg_store(SST_TEV_ARG(tev));
+    for (auto const & kv : config().clrmsgs().entries()) {
+      sst::unique_ptr<detached_clrmsg_store_t::entry_t> p{
+          sst::in_place};
+      p->handle = race_handle_t::null();
+      p->clrmsg = kv.second.clrmsg();
+      p->store_id = kv.first;
+      detached.add(SST_TEV_ARG(tev), std::move(p));
+    }
+  }
+
+  //--------------------------------------------------------------------
+
+  if (config().local().role() == role_t::mc_leader()
+      || config().local().role() == role_t::mc_follower()
+      || config().local().role() == role_t::mb_server()) {
+    mix_executor_.start(old_config_.mix_threads);
+  }
+
   //--------------------------------------------------------------------
 
   CARMA_LOG_INFO(
@@ -204,17 +284,64 @@ void plugin_t::inner_init(tracing_event_t tev,
       auto & mutex = network_maintenance_mutex_;
       auto & cond = network_maintenance_cond_;
       auto const & stop = network_maintenance_stop_;
-      auto const pred = [&]() { return stop.load(); };
+      auto const pred = [&]() {
+        return stop.load() || !mix_results_.empty()
+               || mb_bundle_rearm_.load();
+      };
       std::unique_lock<std::mutex> lock(mutex);
       auto next = std::chrono::steady_clock::now();
-      while (!cond.wait_until(lock, next, pred)) {
+      while (true) {
+        // Finished mix jobs and due mailbox bundles wake us up early.
+        // Those are handled without doing the periodic maintenance.
+        // The plugin thread sets mb_bundle_rearm_ without taking our
+        // mutex, so a wakeup can rarely be missed, in which case the
+        // bundle goes out with the next periodic maintenance.
+        auto wake = next;
+        {
+          auto const deadline = mb_bundle_deadline_ns_.load();
+          if (deadline != 0) {
+            auto const now = sst::mono_time_ns();
+            auto const at =
+                std::chrono::steady_clock::now()
+                + std::chrono::nanoseconds(
+                    deadline > now ? deadline - now : 0);
+            if (at < wake) {
+              wake = at;
+            }
+          }
+        }
+        mb_bundle_rearm_.store(false);
+        cond.wait_until(lock, wake, pred);
+        if (stop.load()) {
+          break;
+        }
+        if (mb_bundle_rearm_.load()) {
+          continue;
+        }
+        bool const mix_due = !mix_results_.empty();
+        bool const bundle_due = [&]() {
+          auto const deadline = mb_bundle_deadline_ns_.load();
+          return deadline != 0 && sst::mono_time_ns() >= deadline;
+        }();
+        bool const periodic = std::chrono::steady_clock::now() >= next;
+        if (!mix_due && !bundle_due && !periodic) {
+          continue;
+        }
         [&](tracing_event_t tev) {
           try {
             SST_TEV_ADD(tev,
                         "network_maintenance_call_id",
                         sst::to_string(network_maintenance_call_id_++));
             primary_lock_t const primary_lock(*this->primary_mutex());
-            do_network_maintenance(SST_TEV_ARG(tev));
+            if (mix_due) {
+              finish_mix_jobs(SST_TEV_ARG(tev));
+            }
+            if (bundle_due) {
+              flush_mb_bundles(SST_TEV_ARG(tev));
+            }
+            if (periodic) {
+              do_network_maintenance(SST_TEV_ARG(tev));
+            }
           } catch (tracing_exception_t const & e) {
             LOG_EXCEPTION(CARMA_LOG_ERROR,
                           e.tev(),
@@ -227,7 +354,9 @@ void plugin_t::inner_init(tracing_event_t tev,
                           sst::what());
           }
         }(SST_TEV_ARG(tev));
-        next = std::chrono::steady_clock::now() + cooldown;
+        if (periodic) {
+          next = std::chrono::steady_clock::now() + cooldown;
+        }
       }
     } catch (tracing_exception_t const & e) {
       LOG_EXCEPTION(CARMA_LOG_FATAL,
@@ -177,7 +177,8 @@ void plugin_t::inner_onBootstrapPkgReceived(
 
     pmc.send_message(SST_TEV_ARG(tev),
                      serialize({}, local().psn(), packet),
-                     sender_mb_server->psn());
+                     sender_mb_server->psn(),
+                     packet_type_t::endorsement_request());
   }
 
   phonebook().add_slow(SST_TEV_ARG(tev), std::move(bootstrappee));
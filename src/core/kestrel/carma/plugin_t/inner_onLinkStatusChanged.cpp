@@ -74,7 +74,6 @@
 #include <kestrel/connection_status_t.hpp>
 #include <kestrel/connection_t.hpp>
 #include <kestrel/encpkg_t.hpp>
-#include <kestrel/goodbox_entry_t.hpp>
 #include <kestrel/json_t.hpp>
 #include <kestrel/link_address_packet_t.hpp>
 #include <kestrel/link_address_t.hpp>
@@ -26,7 +26,7 @@
 #include <sst/catalog/SST_TEV_BOT.hpp>
 #include <sst/catalog/SST_TEV_TOP.hpp>
 
-#include <kestrel/goodbox_entry_t.hpp>
+#include <kestrel/message_status_t.hpp>
 #include <kestrel/package_status_t.hpp>
 #include <kestrel/race_handle_t.hpp>
 #include <kestrel/tracing_event_t.hpp>
@@ -43,10 +43,17 @@ void plugin_t::inner_onPackageStatusChanged(
   // TODO: "Sent" isn't as strong as "received". The former only means
   // the package (probably) made it onto the wire, whereas the latter
   // means the package (probably) made it over the wire to the other
-  // side. We need a probabilistic scoring system.
+  // side. We need a probabilistic scoring system. The RabbitMQ channel
+  // is an exception: it only reports "sent" once the broker confirms
+  // that it has taken the package.
   if (status == package_status_t::sent()
       || status == package_status_t::received()) {
-    goodbox_.emplace(handle, goodbox_entry_t());
+    auto const it = outbox_handles_.find(handle);
+    if (it != outbox_handles_.end()) {
+      finish_outbox_entry(SST_TEV_ARG(tev),
+                          it->second,
+                          message_status_t::sent());
+    }
   }
 
   SST_TEV_BOT(tev);
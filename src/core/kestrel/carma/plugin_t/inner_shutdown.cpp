@@ -24,6 +24,7 @@
 
 #include <sst/catalog/SST_TEV_ADD.hpp>
 #include <sst/catalog/SST_TEV_ARG.hpp>
+#include <sst/catalog/what.hpp>
 
 #include <kestrel/common_sdk_t.hpp>
 #include <kestrel/tracing_event_t.hpp>
@@ -58,6 +59,36 @@ void plugin_t::inner_shutdown(tracing_event_t tev) noexcept {
                                "stopped_network_maintenance_thread"));
   }
 
+  //--------------------------------------------------------------------
+  // Send any open mailbox bundles
+  //--------------------------------------------------------------------
+  //
+  // With the dispatcher gone, nothing else would send these, and the
+  // client packets in them would be lost.
+  //
+
+  try {
+    flush_mb_bundles(SST_TEV_ARG(tev), true);
+  } catch (...) {
+    CARMA_LOG_WARN(sdk_,
+                   0,
+                   SST_TEV_ARG(tev,
+                               "event",
+                               "mb_bundle_flush_failed",
+                               "exception",
+                               sst::what()));
+  }
+
+  //--------------------------------------------------------------------
+  // Stop the mix executor
+  //--------------------------------------------------------------------
+  //
+  // This must come after joining the dispatcher, as the dispatcher
+  // is what hands finished mix jobs back to their sessions.
+  //
+
+  mix_executor_.stop();
+
   //--------------------------------------------------------------------
   // Join any outstanding futures
   //--------------------------------------------------------------------
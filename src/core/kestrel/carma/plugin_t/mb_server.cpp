@@ -24,6 +24,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <exception>
 #include <fstream>
 #include <functional>
@@ -42,10 +43,12 @@
 #include <sst/catalog/SST_TEV_THROW.hpp>
 #include <sst/catalog/SST_TEV_TOP.hpp>
 #include <sst/catalog/bigint.hpp>
+#include <sst/catalog/checked_cast.hpp>
 #include <sst/catalog/checked_resize.hpp>
 #include <sst/catalog/crypto_rng.hpp>
 #include <sst/catalog/floor_sqrt.hpp>
 #include <sst/catalog/integer_rep.hpp>
+#include <sst/catalog/mono_time_ns.hpp>
 #include <sst/catalog/optional.hpp>
 #include <sst/catalog/span.hpp>
 #include <sst/catalog/to_hex.hpp>
@@ -53,6 +56,7 @@
 #include <sst/catalog/unsigned_ceil_div.hpp>
 #include <sst/catalog/unsigned_le.hpp>
 #include <sst/catalog/unsigned_min.hpp>
+#include <sst/catalog/what.hpp>
 
 #include <ClrMsg.h>
 #include <EncPkg.h>
@@ -62,6 +66,7 @@
 #include <RaceLog.h>
 
 #include <kestrel/bytes_t.hpp>
+#include <kestrel/bytes_view_t.hpp>
 #include <kestrel/carma/contains.hpp>
 #include <kestrel/carma/global_config_t.hpp>
 #include <kestrel/carma/local_config_t.hpp>
@@ -86,18 +91,21 @@
 #include <kestrel/mc_leader_init_packet_t.hpp>
 #include <kestrel/mc_mb_down_packet_t.hpp>
 #include <kestrel/mc_v_packet_t.hpp>
+#include <kestrel/metrics_t.hpp>
 #include <kestrel/old_config_t.hpp>
 #include <kestrel/packet_type_t.hpp>
 #include <kestrel/pkc.hpp>
+#include <kestrel/pkc/shared_key_cache_t.hpp>
+#include <kestrel/prime_field_t.hpp>
 #include <kestrel/psn_any_hash_t.hpp>
 #include <kestrel/psn_default_hash_t.hpp>
 #include <kestrel/psn_t.hpp>
 #include <kestrel/race_handle_t.hpp>
 #include <kestrel/sdk_span_t.hpp>
 #include <kestrel/sdk_wrapper_t.hpp>
-#include <kestrel/secret_sharing.hpp>
 #include <kestrel/serialization.hpp>
 #include <kestrel/span_parents_t.hpp>
+#include <kestrel/sss_share_context_t.hpp>
 #include <kestrel/tracing_event_t.hpp>
 
 namespace kestrel {
@@ -132,7 +140,8 @@ bool plugin_t::mb_server_bootstrappee_link_created(
                     packet_type_t::registration_complete().value(),
                     info.channel.value(),
                     cookie.value()))),
-      bootstrappee->psn());
+      bootstrappee->psn(),
+      packet_type_t::registration_complete());
 
   mb_server_bootstrappee_link_creations_.erase(it);
   return true;
@@ -182,7 +191,8 @@ void plugin_t::mailbox_handle_add_contact_request(
                     {},
                     packet_type_t::add_contact_request().value(),
                     a_data))),
-      recver_client_psn);
+      recver_client_psn,
+      packet_type_t::add_contact_request());
 
   KESTREL_TRACE(
       sdk(),
@@ -333,29 +343,17 @@ void plugin_t::handle_client_mb_packet(
   local_config_t const & local = config().local();
 
   mb_processed_cids_.insert(packet.cid);
-  auto const ms = old_config_.mixsize;
 
   std::vector<sst::bigint> y;
-  sst::checked_resize(y, ms);
-  y[0] = packet.x;
-  for (decltype(y.size()) i = 1; i < y.size(); ++i) {
-    y[i] = mul_mod(packet.x, y[i - 1], old_config_.prime);
-  }
+  mix_powers(y, packet.x);
 
   phonebook_vector_t const & mc_group =
       local.mc_group(SST_TEV_ARG(tev), packet.mc_group_number);
   auto const mc_count = mc_group.size();
 
-  std::vector<std::vector<sst::bigint>> all_z;
-  sst::checked_resize(all_z, ms);
-  for (decltype(all_z.size()) i = 0; i < all_z.size(); ++i) {
-    sst::checked_resize(all_z[i], mc_count);
-    sss_share(all_z[i],
-              y[i],
-              mc_count,
-              old_config_.threshold,
-              old_config_.prime);
-  }
+  auto all_z_ptr = acquire<std::vector<std::vector<sst::bigint>>>();
+  auto & all_z = *all_z_ptr;
+  share_context(mc_count).share_many(all_z, y);
 
   auto packets_ptr = acquire<std::vector<mb_mc_up_packet_t>>();
   auto & packets = *packets_ptr;
@@ -366,35 +364,64 @@ void plugin_t::handle_client_mb_packet(
     p->prime_size = prime_size_;
     p->mixsize = old_config_.mixsize;
     p->cid = packet.cid;
-    sst::checked_resize(p->z, ms);
-    for (decltype(p->z.size()) i = 0; i < p->z.size(); ++i) {
-      p->z[i] = std::move(all_z[i][j]);
+    p->z.swap(all_z[j]);
+  }
+
+  // Look up the shared key for each committee member here, as the
+  // phonebook may not be used off the plugin thread.
+  using shared_key_t = pkc::shared_key_cache_t::shared_key_t;
+  std::vector<shared_key_t> keys(mc_count);
+  {
+    auto member = mc_group.begin();
+    for (decltype(+mc_count) j = 0; j != mc_count; ++j, ++member) {
+      if (j != 0) {
+        std::shared_ptr<phonebook_entry_t const> const pbe =
+            config().phonebook().at(SST_TEV_ARG(tev), **member);
+        keys[j] = global().shared_keys().get(local.sk(), pbe->pk());
+      }
     }
   }
 
-  std::vector<unsigned char> combined =
-      serialize({}, packet_type_t::mb_mc_up_bundle_packet().value());
-  std::vector<unsigned char> buf;
-  auto member = mc_group.begin();
-  for (decltype(+mc_count) j = 0; j != mc_count; ++j, ++member) {
-    std::shared_ptr<phonebook_entry_t const> const pbe =
-        config().phonebook().at(SST_TEV_ARG(tev), **member);
-    buf.resize(packets[j].to_bytes_size<decltype(buf.size())>());
-    packets[j].to_bytes(buf.begin());
-    if (j == 0) {
-      serialize(combined, buf);
-    } else {
-      serialize(combined,
-                pkc::auth_encrypt(local.sk(), pbe->pk(), buf).first);
+  // Serialize and encrypt the shares in parallel. The leader's share
+  // stays in the clear, as the whole bundle is encrypted for it.
+  std::vector<std::vector<unsigned char>> shares(mc_count);
+  mix_executor_.parallel_for(
+      sst::checked_cast<std::size_t>(mc_count),
+      [&](std::size_t const j) {
+        auto & buf = shares[j];
+        buf.resize(packets[j].to_bytes_size<decltype(buf.size())>());
+        packets[j].to_bytes(buf.begin());
+        if (j != 0) {
+          buf = pkc::auth_encrypt_afternm(keys[j], buf).first;
+        }
+      });
+
+  // Copy the leader's PSN, as the phonebook may unload the entry.
+  psn_t const leader =
+      config().phonebook().at(SST_TEV_ARG(tev), **mc_group.begin())
+          ->psn();
+  auto const now = sst::mono_time_ns();
+  mb_bundles_t::bundle_t & bundle = mb_bundles_.open(leader, now);
+  if (bundle.count == 0) {
+    serialize(bundle.value.data,
+              packet_type_t::mb_mc_up_bundle_packet().value());
+    bundle.value.send_span = pmc.send_span;
+  }
+  for (auto const & share : shares) {
+    serialize(bundle.value.data, share);
+  }
+
+  if (mb_bundles_.add(bundle, now)) {
+    send_mb_bundle(SST_TEV_ARG(tev), pmc, leader, bundle);
+    mb_bundles_.erase(leader);
+  } else if (bundle.count == 1) {
+    auto const earliest = mb_bundle_deadline_ns_.load();
+    if (earliest == 0 || bundle.deadline < earliest) {
+      mb_bundle_deadline_ns_.store(bundle.deadline);
+      mb_bundle_rearm_.store(true);
+      network_maintenance_cond_.notify_one();
     }
   }
-  std::shared_ptr<phonebook_entry_t const> const ldr =
-      config().phonebook().at(SST_TEV_ARG(tev), **mc_group.begin());
-  buf.clear();
-  serialize(buf,
-            local.psn(),
-            pkc::auth_encrypt(local.sk(), ldr->pk(), combined).first);
-  pmc.send_message(SST_TEV_ARG(tev), buf, ldr->psn());
 
   KESTREL_TRACE(
       sdk(),
@@ -405,6 +432,67 @@ void plugin_t::handle_client_mb_packet(
 
 //----------------------------------------------------------------------
 
+void plugin_t::send_mb_bundle(tracing_event_t tev,
+                              process_message_context_t & pmc,
+                              psn_t const & leader,
+                              mb_bundles_t::bundle_t & bundle) {
+  SST_TEV_TOP(tev);
+
+  local_config_t const & local = config().local();
+  std::shared_ptr<phonebook_entry_t const> const ldr =
+      config().phonebook().at(SST_TEV_ARG(tev), leader);
+  std::vector<unsigned char> buf;
+  {
+    metric_timer_t const timer(encrypt_ns_);
+    serialize(buf,
+              local.psn(),
+              pkc::auth_encrypt_afternm(
+                  global().shared_keys().get(local.sk(), ldr->pk()),
+                  bundle.value.data)
+                  .first);
+  }
+  pmc.send_message(SST_TEV_ARG(tev),
+                   buf,
+                   ldr->psn(),
+                   packet_type_t::mb_mc_up_bundle_packet());
+
+  KESTREL_TRACE(sdk(),
+                SST_TEV_ARG(tev,
+                            "event",
+                            "mb_bundle_sent",
+                            "client_packets",
+                            bundle.count));
+
+  SST_TEV_BOT(tev);
+}
+
+void plugin_t::flush_mb_bundles(tracing_event_t tev, bool const all) {
+  SST_TEV_TOP(tev);
+
+  mb_bundle_deadline_ns_.store(mb_bundles_.flush(
+      sst::mono_time_ns(),
+      all,
+      [&](psn_t const & leader, mb_bundles_t::bundle_t & bundle) {
+        try {
+          process_message_context_t pmc(sdk_, *this);
+          pmc.send_span = bundle.value.send_span;
+          send_mb_bundle(SST_TEV_ARG(tev), pmc, leader, bundle);
+        } catch (...) {
+          CARMA_LOG_ERROR(sdk_,
+                          0,
+                          SST_TEV_ARG(tev,
+                                      "event",
+                                      "mb_bundle_send_failed",
+                                      "exception",
+                                      sst::what()));
+        }
+      }));
+
+  SST_TEV_BOT(tev);
+}
+
+//----------------------------------------------------------------------
+
 void plugin_t::handle_endorsement_request(
     tracing_event_t tev,
     process_message_context_t & pmc,
@@ -434,9 +522,9 @@ void plugin_t::handle_endorsement_request(
   std::shared_ptr<phonebook_entry_t const> const mc_leader =
       phonebook().at(SST_TEV_ARG(tev), *mc_leader_pair);
 
-  bytes_t a;
-  bytes_t b;
-  bytes_t c;
+  bytes_view_t a;
+  bytes_view_t b;
+  bytes_view_t c;
   deserialize(packet, packet_i, a, b, c);
 
   bytes_t::size_type a_i = 0;
@@ -448,12 +536,12 @@ void plugin_t::handle_endorsement_request(
     //       (psn_any_hash_t). The sending code is in
     //       onBootstrapPkgReceived.
     psn_t recver_mb_psn;
-    bytes_t r;
-    bytes_t bb;
-    bytes_t cc;
-    deserialize(a, a_i, recver_mb_psn, r);
-    deserialize(b, b_i, bb);
-    deserialize(c, c_i, cc);
+    bytes_view_t r;
+    bytes_view_t bb;
+    bytes_view_t cc;
+    deserialize_view(a, a_i, recver_mb_psn, r);
+    deserialize_view(b, b_i, bb);
+    deserialize_view(c, c_i, cc);
 
     phonebook_pair_t const * const recver_mb_pair =
         phonebook().find(recver_mb_psn);
@@ -570,7 +658,7 @@ void plugin_t::processEncPkg_mb_server(
                                pmc.origin_span(),
                                prime_size_);
         packet_from_bytes_exact(*dpr.packet_data, packet);
-        if (mb_processed_cids_.count(packet.cid) != 0) {
+        if (mb_processed_cids_.contains(packet.cid)) {
           KESTREL_TRACE(
               sdk(),
               SST_TEV_ARG(tev, "event", "duplicate_client_mb_cid"));
@@ -599,15 +687,16 @@ void plugin_t::processEncPkg_mb_server(
       packet_from_bytes_exact(*dpr.packet_data, *down_packet);
 
       {
-        auto const it = mb_processed_oids_.find(down_packet->oid);
-        if (it != mb_processed_oids_.end()) {
+        sdk_span_t * const prev_span =
+            mb_processed_oids_.find(down_packet->oid);
+        if (prev_span != nullptr) {
           if_tracer([&](tracer_t & tracer) {
             pmc.send_span = sdk_span_t(
                 tracer,
                 "carma_mb_server_bonus_oid",
-                span_parents_t{pmc.origin_span(), it->second});
+                span_parents_t{pmc.origin_span(), *prev_span});
           });
-          it->second = pmc.send_span;
+          *prev_span = pmc.send_span;
           KESTREL_TRACE(
               sdk(),
               SST_TEV_ARG(tev, "event", "carma_mb_server_bonus_oid"));
@@ -618,7 +707,7 @@ void plugin_t::processEncPkg_mb_server(
                                      "carma_mb_server_first_oid",
                                      span_parents_t{pmc.origin_span()});
         });
-        mb_processed_oids_.emplace(down_packet->oid, pmc.send_span);
+        mb_processed_oids_.insert(down_packet->oid, pmc.send_span);
       }
 
       std::vector<unsigned char> const buf =
@@ -32,6 +32,7 @@
 #include <random>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <sst/catalog/SST_TEV_ADD.hpp>
@@ -40,10 +41,16 @@
 #include <sst/catalog/SST_TEV_RETHROW.hpp>
 #include <sst/catalog/SST_TEV_TOP.hpp>
 #include <sst/catalog/SST_UNREACHABLE.hpp>
+#include <sst/catalog/checked_cast.hpp>
 #include <sst/catalog/checked_resize.hpp>
+#include <sst/catalog/crypto_rng.hpp>
 #include <sst/catalog/floor_sqrt.hpp>
+#include <sst/catalog/integer_rep.hpp>
+#include <sst/catalog/mono_time_ns.hpp>
+#include <sst/catalog/perfect_gt.hpp>
 #include <sst/catalog/to_hex.hpp>
 #include <sst/catalog/to_string.hpp>
+#include <sst/catalog/what.hpp>
 
 #include <ClrMsg.h>
 #include <EncPkg.h>
@@ -52,7 +59,9 @@
 #include <PluginResponse.h>
 #include <RaceLog.h>
 
+#include <kestrel/bytes_view_t.hpp>
 #include <kestrel/carma/contains.hpp>
+#include <kestrel/carma/global_config_t.hpp>
 #include <kestrel/carma/local_config_t.hpp>
 #include <kestrel/carma/phonebook_entry_t.hpp>
 #include <kestrel/carma/phonebook_pair_t.hpp>
@@ -62,6 +71,8 @@
 #include <kestrel/common_plugin_t.hpp>
 #include <kestrel/config.h>
 #include <kestrel/encpkg_t.hpp>
+#include <kestrel/graeffe_transform.hpp>
+#include <kestrel/guid_t.hpp>
 #include <kestrel/json_t.hpp>
 #include <kestrel/link_address_packet_t.hpp>
 #include <kestrel/mb_client_packet_t.hpp>
@@ -69,7 +80,9 @@
 #include <kestrel/mc_leader_init_packet_t.hpp>
 #include <kestrel/mc_mb_down_packet_t.hpp>
 #include <kestrel/mc_v_packet_t.hpp>
+#include <kestrel/metrics_t.hpp>
 #include <kestrel/old_config_t.hpp>
+#include <kestrel/packet_type_t.hpp>
 #include <kestrel/pkc.hpp>
 #include <kestrel/pooled.hpp>
 #include <kestrel/sdk_span_t.hpp>
@@ -104,80 +117,210 @@ plugin_t::handle_mb_mc_up_packet(tracing_event_t tev,
     auto const slot = std::distance(b, i);
     session->p_mb_mc_up[slot] = std::move(up_packet);
   } else {
-    loose_ups.emplace(cid, std::move(up_packet));
+    if (loose_ups.emplace(cid, std::move(up_packet)).second) {
+      mix_batcher_.add(cid, sst::mono_time_ns());
+    }
   }
 
   if (config().local().role() == role_t::mc_leader()) {
-    auto const mixsize = old_config_.mixsize;
-    if (loose_ups.size() >= mixsize) {
-
-      SST_ASSERT(session == nullptr);
-      auto new_session = acquire<server_session_t>();
-      new_session->create(SST_TEV_ARG(tev), *this);
-
-      auto init = acquire<mc_leader_init_packet_t>();
-      init->type = packet_type_t::mc_leader_init_packet();
-      init->mpcid = new_session->mpcid;
-      init->mixsize = mixsize;
-      sst::checked_resize(init->cids, mixsize);
-
-      if_tracer([&](tracer_t & tracer) {
-        auto it = loose_ups.begin();
-        sdk_span_t const mix_root(tracer, "carma_mc_leader_mix_root");
-        span_parents_t parents = {mix_root};
-        for (decltype(+mixsize) i = 0; i != mixsize; ++i) {
-          parents.push_back(it->second->origin_span());
-          ++it;
-        }
-        pmc.send_span =
-            sdk_span_t(tracer, "carma_mc_leader_mix", parents);
-      });
-
-      {
-        auto it = loose_ups.begin();
-        for (decltype(+mixsize) i = 0; i != mixsize; ++i) {
-          init->cids[i] = it->first;
-          new_session->p_mb_mc_up[i] = std::move(it->second);
-          it = loose_ups.erase(it);
-        }
-        KESTREL_INFO(sdk(),
-                     SST_TEV_ARG(tev,
-                                 "event",
-                                 "mc_leader_picked_cids",
-                                 "mc_leader_picked_cids",
-                                 [&]() {
-                                   auto xs = nlohmann::json::array();
-                                   for (auto const & cid : init->cids) {
-                                     xs += cid.to_json();
-                                   }
-                                   return xs;
-                                 }()));
-      }
+    mc_leader_cut_batches(SST_TEV_ARG(tev), pmc);
+  }
 
-      bool first_iteration = true;
-      for (phonebook_pair_t const * const & entry :
-           config().local().mc_group(SST_TEV_ARG(tev))) {
-        if (!first_iteration) {
-          send(SST_TEV_ARG(tev),
-               pmc,
-               *init,
-               *config().phonebook().at(SST_TEV_ARG(tev), *entry));
-        }
-        first_iteration = false;
-      }
+  return session;
+
+  SST_TEV_BOT(tev);
+}
+
+plugin_t::server_session_t *
+plugin_t::handle_mc_leader_dummy_up(
+    tracing_event_t tev,
+    pooled<mb_mc_up_packet_t> up_packet) {
+  SST_TEV_TOP(tev);
+
+  SST_ASSERT((config().local().role() == role_t::mc_follower()));
+
+  auto const & cid = up_packet->cid;
+  auto const wanted_it = wanted_dummy_ups.find(cid);
+  if (wanted_it == wanted_dummy_ups.end()) {
+    leader_dummy_ups.emplace(cid, std::move(up_packet));
+    return nullptr;
+  }
+  server_session_t & session = wanted_it->second.get();
+  wanted_dummy_ups.erase(wanted_it);
+  auto const & cids = session.p_init->cids;
+  auto const b = cids.cend() - session.p_init->dummies;
+  auto const i = std::find(b, cids.cend(), cid);
+  if (i == cids.cend()) {
+    throw std::runtime_error("cid not found");
+  }
+  session.p_mb_mc_up[std::distance(cids.cbegin(), i)] =
+      std::move(up_packet);
+  return &session;
+
+  SST_TEV_BOT(tev);
+}
+
+//----------------------------------------------------------------------
+// Leader batch scheduling
+//----------------------------------------------------------------------
 
-      new_session->p_init = std::move(init);
-      session = new_session.get();
-      sessions_.emplace(new_session->mpcid, std::move(new_session));
+void plugin_t::mc_leader_cut_batches(tracing_event_t tev,
+                                     process_message_context_t & pmc) {
+  SST_TEV_TOP(tev);
+
+  SST_ASSERT((config().local().role() == role_t::mc_leader()));
+
+  // Cut as many full batches as the backlog allows, then close a
+  // partial batch if its oldest message has hit the deadline.
+  while (true) {
+    mix_batch_t const batch = mix_batcher_.next(sst::mono_time_ns());
+    if (batch.real == 0) {
+      break;
     }
+    mc_leader_start_mix(SST_TEV_ARG(tev), pmc, batch);
   }
 
-  return session;
+  SST_TEV_BOT(tev);
+}
+
+void plugin_t::mc_leader_start_mix(tracing_event_t tev,
+                                   process_message_context_t & pmc,
+                                   mix_batch_t const & batch) {
+  SST_TEV_TOP(tev);
+
+  auto const mixsize = old_config_.mixsize;
+  auto const real_count = batch.real;
+  SST_ASSERT((real_count > 0));
+  SST_ASSERT((real_count + batch.dummies == mixsize));
+  SST_ASSERT((real_count <= loose_ups.size()));
+
+  auto new_session = acquire<server_session_t>();
+  new_session->create(SST_TEV_ARG(tev), *this);
+
+  auto init = acquire<mc_leader_init_packet_t>();
+  init->type = packet_type_t::mc_leader_init_packet();
+  init->mpcid = new_session->mpcid;
+  init->mixsize = mixsize;
+  init->dummies = batch.dummies;
+  sst::checked_resize(init->cids, mixsize);
+
+  // Take the packets that have waited the longest, not the smallest
+  // cids, so that no packet can be passed over indefinitely.
+  for (decltype(+real_count) i = 0; i != real_count; ++i) {
+    guid_t const cid = mix_batcher_.oldest();
+    auto const it = loose_ups.find(cid);
+    SST_ASSERT((it != loose_ups.end()));
+    init->cids[i] = cid;
+    new_session->p_mb_mc_up[i] = std::move(it->second);
+    mix_batcher_.remove(cid);
+    loose_ups.erase(it);
+  }
+
+  if_tracer([&](tracer_t & tracer) {
+    sdk_span_t const mix_root(tracer, "carma_mc_leader_mix_root");
+    span_parents_t parents = {mix_root};
+    for (decltype(+real_count) i = 0; i != real_count; ++i) {
+      parents.push_back(new_session->p_mb_mc_up[i]->origin_span());
+    }
+    pmc.send_span = sdk_span_t(tracer, "carma_mc_leader_mix", parents);
+  });
+
+  for (auto i = real_count; i != mixsize; ++i) {
+    init->cids[i] = mc_leader_add_dummy_up(SST_TEV_ARG(tev),
+                                           pmc,
+                                           *new_session,
+                                           i);
+  }
+
+  KESTREL_INFO(sdk(),
+               SST_TEV_ARG(tev,
+                           "event",
+                           "mc_leader_picked_cids",
+                           "mc_leader_picked_cids",
+                           [&]() {
+                             auto xs = nlohmann::json::array();
+                             for (auto const & cid : init->cids) {
+                               xs += cid.to_json();
+                             }
+                             return xs;
+                           }(),
+                           "dummy_count",
+                           sst::to_string(batch.dummies)));
+
+  bool first_iteration = true;
+  for (phonebook_pair_t const * const & entry :
+       config().local().mc_group(SST_TEV_ARG(tev))) {
+    if (!first_iteration) {
+      send(SST_TEV_ARG(tev),
+           pmc,
+           *init,
+           *config().phonebook().at(SST_TEV_ARG(tev), *entry));
+    }
+    first_iteration = false;
+  }
+
+  new_session->p_init = std::move(init);
+  auto & session = *new_session;
+  sessions_.emplace(new_session->mpcid, std::move(new_session));
+  if (session.tick(SST_TEV_ARG(tev), pmc)) {
+    sessions_.erase(session.mpcid);
+  }
+
+  SST_TEV_BOT(tev);
+}
+
+guid_t plugin_t::mc_leader_add_dummy_up(tracing_event_t tev,
+                                        process_message_context_t & pmc,
+                                        server_session_t & session,
+                                        std::size_t const slot) {
+  SST_TEV_TOP(tev);
+
+  // A dummy value serializes like a client's (a, b, c) triple but with
+  // an empty c, which no client ever produces. Every committee member
+  // skips such roots after root finding. The random a keeps the roots
+  // distinct.
+  sst::bigint const x =
+      sst::bigint(serialize({}, sst::crypto_rng(32), bytes_t(), bytes_t()),
+                  sst::integer_rep::pure_unsigned());
+
+  auto y_ptr = acquire<std::vector<sst::bigint>>();
+  auto & y = *y_ptr;
+  mix_powers(y, x);
+
+  phonebook_vector_t const & mc_group =
+      config().local().mc_group(SST_TEV_ARG(tev));
+  auto const mc_count = mc_group.size();
+
+  auto all_z_ptr = acquire<std::vector<std::vector<sst::bigint>>>();
+  auto & all_z = *all_z_ptr;
+  share_context(mc_count).share_many(all_z, y);
+
+  guid_t const cid = guid_t::generate();
+  auto member = mc_group.begin();
+  for (decltype(+mc_count) j = 0; j != mc_count; ++j, ++member) {
+    auto p = acquire<mb_mc_up_packet_t>();
+    p->type = packet_type_t::mb_mc_up_packet();
+    p->prime_size = prime_size_;
+    p->mixsize = old_config_.mixsize;
+    p->cid = cid;
+    p->z.swap(all_z[j]);
+    if (j == 0) {
+      session.p_mb_mc_up[slot] = std::move(p);
+    } else {
+      send(SST_TEV_ARG(tev),
+           pmc,
+           *p,
+           *config().phonebook().at(SST_TEV_ARG(tev), **member));
+    }
+  }
+  return cid;
 
   SST_TEV_BOT(tev);
 }
 
-plugin_t::server_session_t * plugin_t::handle_mb_mc_up_bundle_packet(
+//----------------------------------------------------------------------
+
+void plugin_t::handle_mb_mc_up_bundle_packet(
     tracing_event_t tev,
     process_message_context_t & pmc,
     deserialize_packet_result const & dpr) {
@@ -188,21 +331,19 @@ plugin_t::server_session_t * plugin_t::handle_mb_mc_up_bundle_packet(
 
   if (config().local().role() != role_t::mc_leader()) {
     // TODO: Output a warning?
-    return nullptr;
+    return;
   }
 
   phonebook_pair_t const * const p_mb_server =
       config().phonebook().find(*dpr.psn);
   if (!p_mb_server) {
     // TODO: Output a warning?
-    return nullptr;
+    return;
   }
 
   std::shared_ptr<phonebook_entry_t const> const mb_server =
       config().phonebook().at(SST_TEV_ARG(tev), *p_mb_server);
 
-  server_session_t * session = nullptr;
-
   std::vector<unsigned char> const & data = *dpr.packet_data;
   std::vector<unsigned char>::size_type data_i = 0;
 
@@ -211,12 +352,16 @@ plugin_t::server_session_t * plugin_t::handle_mb_mc_up_bundle_packet(
     deserialize(data, data_i, packet_type);
   }
 
+  // The bundle holds one share per committee member for each client
+  // packet, with the client packets back to back.
   node_count_t i = 0U;
   phonebook_vector_t const & mc_group =
       config().local().mc_group(SST_TEV_ARG(tev),
                                 config().local().group());
+  node_count_t const mc_count =
+      sst::checked_cast<node_count_t>(mc_group.size());
   while (data_i < data.size()) {
-    std::vector<unsigned char> buf;
+    bytes_view_t buf;
     deserialize(data, data_i, buf);
     if (i == 0U) {
       auto up_packet = acquire<mb_mc_up_packet_t>();
@@ -225,24 +370,157 @@ plugin_t::server_session_t * plugin_t::handle_mb_mc_up_bundle_packet(
                                  prime_size_,
                                  old_config_.mixsize);
       packet_from_bytes_exact(buf, *up_packet);
-      session = handle_mb_mc_up_packet(SST_TEV_ARG(tev),
-                                       pmc,
-                                       std::move(up_packet));
+      server_session_t * const session =
+          handle_mb_mc_up_packet(SST_TEV_ARG(tev),
+                                 pmc,
+                                 std::move(up_packet));
+      if (session != nullptr) {
+        if (session->tick(SST_TEV_ARG(tev), pmc)) {
+          sessions_.erase(session->mpcid);
+        }
+      }
     } else {
       std::shared_ptr<phonebook_entry_t const> const follower =
           config().phonebook().at(SST_TEV_ARG(tev), *mc_group[i]);
       pmc.send_message(SST_TEV_ARG(tev),
                        serialize({}, mb_server->psn(), buf),
-                       follower->psn());
+                       follower->psn(),
+                       packet_type_t::mb_mc_up_packet());
+    }
+    if (++i == mc_count) {
+      i = 0U;
     }
-    ++i;
   }
 
-  return session;
+  SST_TEV_BOT(tev);
+}
+
+//----------------------------------------------------------------------
+// Mix jobs
+//----------------------------------------------------------------------
+
+void plugin_t::run_mix_job(mix_job_t & job) noexcept {
+  metric_timer_t const timer(mix_job_ns_);
+  try {
+    auto const mixsize = old_config_.mixsize;
+    global_config_t const & global = config().global();
+
+    std::vector<std::vector<sst::bigint> const *> rows;
+    rows.reserve(job.rows.size());
+    for (auto const & row : job.rows) {
+      rows.push_back(&row);
+    }
+    std::vector<sst::bigint> z;
+    sst::checked_resize(z, mixsize);
+    job.recon->recon_many(z, rows);
+
+    // zeta must be a primitive root
+    SST_ASSERT(old_config_.prime
+               == (sst::bigint(1) << old_config_.two_exponent)
+                          * old_config_.odd_factor
+                      + 1);
+    SST_ASSERT((sst::perfect_gt(old_config_.odd_factor, mixsize)));
+
+    std::vector<sst::bigint> x;
+    {
+      NumX poly(old_config_.prime);
+      if (mix_field_) {
+        newton_to_polynomial(poly,
+                             z,
+                             sst::checked_cast<unsigned int>(mixsize),
+                             *mix_field_);
+      } else {
+        newton_to_polynomial(poly,
+                             z,
+                             sst::checked_cast<unsigned int>(mixsize));
+      }
+      x = find_roots(poly,
+                     old_config_.zeta,
+                     sst::checked_cast<long>(old_config_.two_exponent),
+                     sst::checked_cast<long>(old_config_.odd_factor));
+    }
+
+    // All servers must have the roots in the same order.
+    std::sort(x.begin(),
+              x.end(),
+              [](sst::bigint const & a, sst::bigint const & b) {
+                return a < b;
+              });
+
+    job.outputs.clear();
+    job.outputs.reserve(x.size());
+    for (decltype(x.size()) i = 0; i < x.size(); ++i) {
+      bytes_t buf = x[i].to_bytes(sst::integer_rep::pure_unsigned());
+      buf.resize(global.prime_space());
+      bytes_t::size_type buf_i = 0;
+      mix_output_t out;
+      out.index = i;
+      bytes_t c;
+      deserialize(buf, buf_i, out.a, out.b, c);
+      if (c.empty()) {
+        // Dummy padding from mc_leader_add_dummy_up.
+        continue;
+      }
+      bytes_t const cc = local().anon_decrypt(c);
+      bytes_t::size_type cc_i = 0;
+      deserialize(cc, cc_i, out.mailbox_hash);
+      job.outputs.push_back(std::move(out));
+    }
+  } catch (...) {
+    job.error = std::current_exception();
+  }
+}
+
+void plugin_t::post_mix_job(std::shared_ptr<mix_job_t> job) {
+  mix_executor_.post([this, job]() {
+    run_mix_job(*job);
+    {
+      std::lock_guard<std::mutex> const lock(network_maintenance_mutex_);
+      mix_results_.push_back(job);
+    }
+    network_maintenance_cond_.notify_one();
+  });
+}
+
+void plugin_t::finish_mix_jobs(tracing_event_t tev) {
+  SST_TEV_TOP(tev);
+
+  // The caller holds network_maintenance_mutex_.
+  std::vector<std::shared_ptr<mix_job_t>> jobs;
+  jobs.swap(mix_results_);
+
+  for (auto & job : jobs) {
+    auto const it = sessions_.find(job->mpcid);
+    if (it == sessions_.end() || it->second->T2_job != job) {
+      continue;
+    }
+    server_session_t & session = *it->second;
+    process_message_context_t pmc(sdk_, *this);
+    pmc.send_span = session.T2_send_span;
+    session.T2_job_done = true;
+    try {
+      if (session.tick(SST_TEV_ARG(tev), pmc)) {
+        sessions_.erase(it);
+      }
+    } catch (...) {
+      CARMA_LOG_ERROR(sdk_,
+                      0,
+                      SST_TEV_ARG(tev,
+                                    "event",
+                                    "mix_job_failed",
+                                    "mpcid",
+                                    job->mpcid.to_json(),
+                                    "exception",
+                                    sst::what()));
+      sessions_.erase(it);
+    }
+  }
 
   SST_TEV_BOT(tev);
 }
 
+//----------------------------------------------------------------------
+
 void plugin_t::mc_server_processEncPkg(
     tracing_event_t tev,
     process_message_context_t & pmc,
@@ -259,12 +537,18 @@ void plugin_t::mc_server_processEncPkg(
       server_session_t * session = nullptr;
 
       if (dpr.packet_type == packet_type_t::mb_mc_up_bundle_packet()) {
-        session =
-            handle_mb_mc_up_bundle_packet(SST_TEV_ARG(tev), pmc, dpr);
+        handle_mb_mc_up_bundle_packet(SST_TEV_ARG(tev), pmc, dpr);
       } else if (dpr.packet_type == packet_type_t::mb_mc_up_packet()) {
 
-        if (config().phonebook().at(SST_TEV_ARG(tev), *dpr.psn)->role()
-            != role_t::mb_server()) {
+        // Up packets normally come from mailboxes, but our own leader
+        // sends dummy up packets itself when it pads a batch.
+        role_t const sender_role =
+            config().phonebook().at(SST_TEV_ARG(tev), *dpr.psn)->role();
+        bool const from_leader =
+            local.role() == role_t::mc_follower()
+            && config().phonebook().find(*dpr.psn)
+                   == &local.mc_leader(SST_TEV_ARG(tev));
+        if (!from_leader && sender_role != role_t::mb_server()) {
           throw std::runtime_error("up packet from non-mailbox");
         }
 
@@ -275,15 +559,21 @@ void plugin_t::mc_server_processEncPkg(
                                    old_config_.mixsize);
         packet_from_bytes_exact(*dpr.packet_data, *up_packet);
 
-        session = handle_mb_mc_up_packet(SST_TEV_ARG(tev),
-                                         pmc,
-                                         std::move(up_packet));
+        if (from_leader) {
+          session = handle_mc_leader_dummy_up(SST_TEV_ARG(tev),
+                                              std::move(up_packet));
+        } else {
+          session = handle_mb_mc_up_packet(SST_TEV_ARG(tev),
+                                           pmc,
+                                           std::move(up_packet));
+        }
 
       } else if (dpr.packet_type
                  == packet_type_t::mc_leader_init_packet()) {
 
-        if (config().phonebook().at(SST_TEV_ARG(tev), *dpr.psn)->role()
-            != role_t::mc_leader()) {
+        if (local.role() != role_t::mc_follower()
+            || config().phonebook().find(*dpr.psn)
+                   != &local.mc_leader(SST_TEV_ARG(tev))) {
           throw std::runtime_error("init packet from non-leader");
         }
 
@@ -295,16 +585,29 @@ void plugin_t::mc_server_processEncPkg(
 
         session =
             &get_or_deduce_session(SST_TEV_ARG(tev), packet->mpcid);
+        auto const real_count = packet->cids.size() - packet->dummies;
         auto zzz = session->p_mb_mc_up.begin();
-        for (auto const & cid : packet->cids) {
+        for (decltype(+real_count) i = 0; i != real_count; ++i, ++zzz) {
+          auto const & cid = packet->cids[i];
           auto const it = loose_ups.find(cid);
           if (it != loose_ups.end()) {
             *zzz = std::move(it->second);
+            mix_batcher_.remove(cid);
             loose_ups.erase(it);
           } else {
             wanted_ups.emplace(cid, *session);
           }
-          ++zzz;
+        }
+        auto const mixsize = packet->cids.size();
+        for (auto i = real_count; i != mixsize; ++i, ++zzz) {
+          auto const & cid = packet->cids[i];
+          auto const it = leader_dummy_ups.find(cid);
+          if (it != leader_dummy_ups.end()) {
+            *zzz = std::move(it->second);
+            leader_dummy_ups.erase(it);
+          } else {
+            wanted_dummy_ups.emplace(cid, *session);
+          }
         }
         session->p_init = std::move(packet);
 
@@ -22,13 +22,27 @@
 #include <kestrel/chunk_joiner_t.hpp>
 //
 
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
 #include <string>
 #include <utility>
 
+#include <sst/catalog/SST_ASSERT.h>
 #include <sst/catalog/SST_TEV_ARG.hpp>
 #include <sst/catalog/SST_TEV_BOT.hpp>
 #include <sst/catalog/SST_TEV_TOP.hpp>
+#include <sst/catalog/mkdir_p.hpp>
+#include <sst/catalog/mono_time_ns.hpp>
 #include <sst/catalog/optional.hpp>
+#include <sst/catalog/read_whole_file.hpp>
+#include <sst/catalog/rm_f_r.hpp>
+#include <sst/catalog/to_hex.hpp>
+#include <sst/catalog/to_string.hpp>
+#include <sst/catalog/write_whole_file.hpp>
 
 #include <kestrel/common_sdk_t.hpp>
 #include <kestrel/corruption_t.hpp>
@@ -42,54 +56,306 @@ chunk_joiner_t::chunk_joiner_t(tracing_event_t tev,
     : dir_(std::move(dir)),
       sdk_(sdk) {
   SST_TEV_TOP(tev);
+  // Spilled chunks from a previous run belong to groups that are gone.
+  if (sdk_) {
+    if (sdk_->xPathExists(SST_TEV_ARG(tev), dir_)) {
+      sdk_->removeDir(SST_TEV_ARG(tev), dir_);
+    }
+  } else {
+    sst::rm_f_r(dir_);
+  }
+  SST_TEV_BOT(tev);
+}
+
+void chunk_joiner_t::configure(time_ns_t const timeout_ns,
+                               std::size_t const memory_budget,
+                               std::size_t const spill_size) {
+  if (timeout_ns <= 0) {
+    throw std::invalid_argument(
+        "chunk_joiner_t: timeout must be positive");
+  }
+  if (memory_budget == 0) {
+    throw std::invalid_argument(
+        "chunk_joiner_t: memory_budget must be positive");
+  }
+  timeout_ns_ = timeout_ns;
+  memory_budget_ = memory_budget;
+  spill_size_ = spill_size;
+}
+
+//----------------------------------------------------------------------
+// Groups
+//----------------------------------------------------------------------
+
+std::string chunk_joiner_t::spill_dir(bytes_t const & id) const {
+  return dir_ + "/" + sst::to_hex(id);
+}
+
+std::string chunk_joiner_t::spill_file(bytes_t const & id,
+                                       size_type const index) const {
+  return spill_dir(id) + "/" + sst::to_string(index);
+}
+
+void chunk_joiner_t::spill(tracing_event_t tev,
+                           bytes_t const & id,
+                           size_type const index,
+                           bytes_t const & chunk) {
+  SST_TEV_TOP(tev);
+  if (sdk_) {
+    sdk_->writeFile(SST_TEV_ARG(tev), spill_file(id, index), chunk);
+  } else {
+    sst::write_whole_file(chunk, spill_file(id, index));
+  }
+  SST_TEV_BOT(tev);
+}
+
+void chunk_joiner_t::drop(tracing_event_t tev,
+                          groups_t::iterator const it) {
+  SST_TEV_TOP(tev);
+  group_t & group = it->second;
+  charge(group, 0);
+  lru_.erase(group.lru);
+  if (group.spilled) {
+    if (sdk_) {
+      sdk_->removeDir(SST_TEV_ARG(tev), spill_dir(it->first));
+    } else {
+      sst::rm_f_r(spill_dir(it->first));
+    }
+  }
+  groups_.erase(it);
   SST_TEV_BOT(tev);
 }
 
+void chunk_joiner_t::charge(group_t & group, std::size_t const charge) {
+  stats_.bytes -= group.charge;
+  stats_.bytes += charge;
+  group.charge = charge;
+}
+
+//----------------------------------------------------------------------
+// add
+//----------------------------------------------------------------------
+
 sst::optional<bytes_t>
 chunk_joiner_t::add(tracing_event_t tev,
                     bytes_t const & id,
                     bytes_t::size_type const index,
                     bytes_t::size_type const count,
-                    bytes_t chunk) {
+                    bytes_t chunk,
+                    time_ns_t const now) {
   SST_TEV_TOP(tev);
+
   if (index >= count) {
     throw corruption_t();
   }
-  auto const group_it = groups_.find(id);
+
+  expire(SST_TEV_ARG(tev), now);
+
+  auto group_it = groups_.find(id);
   if (group_it == groups_.end()) {
     if (count == 1U) {
+      ++stats_.completed;
       return chunk;
     }
-    group_t & group = groups_[id];
+    if (count / CHAR_BIT >= memory_budget_) {
+      ++stats_.refused;
+      return {};
+    }
+    group_it = groups_.emplace(id, group_t()).first;
+    group_t & group = group_it->second;
     group.count = count;
-    group.chunks[index] = std::move(chunk);
-    return {};
+    group.have.assign(count, false);
+    group.lru = lru_.insert(lru_.end(), id);
+  } else if (count != group_it->second.count) {
+    throw corruption_t();
+  } else {
+    lru_.splice(lru_.end(), lru_, group_it->second.lru);
   }
   group_t & group = group_it->second;
-  if (count != group.count) {
-    throw corruption_t();
+  group.deadline = now + timeout_ns_;
+
+  bool const is_last = index == count - 1U;
+
+  //--------------------------------------------------------------------
+  // Duplicates must match the chunk we already have
+  //--------------------------------------------------------------------
+
+  if (group.have[index]) {
+    if (is_last) {
+      if (chunk != group.last) {
+        throw corruption_t();
+      }
+    } else if (group.spilled) {
+      bytes_t x;
+      if (sdk_) {
+        x = sdk_->readFile(SST_TEV_ARG(tev), spill_file(id, index));
+      } else {
+        x = sst::read_whole_file(spill_file(id, index));
+      }
+      if (chunk != x) {
+        throw corruption_t();
+      }
+    } else {
+      auto const p = group.data.begin()
+                     + static_cast<bytes_t::difference_type>(
+                         index * group.chunk_size);
+      if (chunk.size() != group.chunk_size
+          || !std::equal(chunk.begin(), chunk.end(), p)) {
+        throw corruption_t();
+      }
+    }
+    return {};
   }
-  auto const chunk_it = group.chunks.find(index);
-  if (chunk_it == group.chunks.end()) {
-    group.chunks.emplace(index, std::move(chunk));
-  } else if (chunk != chunk_it->second) {
-    throw corruption_t();
+
+  //--------------------------------------------------------------------
+  // Store the chunk
+  //--------------------------------------------------------------------
+
+  if (is_last) {
+    if (group.chunk_size != 0 && chunk.size() > group.chunk_size) {
+      throw corruption_t();
+    }
+    group.last = std::move(chunk);
+  } else {
+    if (group.chunk_size == 0) {
+      // This is the first chunk that isn't the last one, so it fixes
+      // the size of the joined message.
+      auto const k = chunk.size();
+      auto const max = std::numeric_limits<size_type>::max();
+      if (k == 0 || count - 1U > max / k
+          || (count - 1U) * k > max - k
+          || (group.have[count - 1U] && group.last.size() > k)) {
+        throw corruption_t();
+      }
+      group.chunk_size = k;
+      size_type const size = count * k;
+      if (spill_size_ != 0 && size >= spill_size_) {
+        group.spilled = true;
+        ++stats_.spilled;
+        if (sdk_) {
+          sdk_->xMakeDirs(SST_TEV_ARG(tev), spill_dir(id));
+        } else {
+          sst::mkdir_p(spill_dir(id));
+        }
+      } else if (size > memory_budget_) {
+        ++stats_.refused;
+        drop(SST_TEV_ARG(tev), group_it);
+        return {};
+      } else {
+        group.data.reserve(size);
+        group.data.resize(size - k);
+      }
+    } else if (chunk.size() != group.chunk_size) {
+      throw corruption_t();
+    }
+    if (group.spilled) {
+      spill(SST_TEV_ARG(tev), id, index, chunk);
+    } else {
+      std::copy(chunk.begin(),
+                chunk.end(),
+                group.data.begin()
+                    + static_cast<bytes_t::difference_type>(
+                        index * group.chunk_size));
+    }
   }
-  if (group.chunks.size() < group.count) {
-    return {};
+  group.have[index] = true;
+  ++group.received;
+
+  //--------------------------------------------------------------------
+  // Join the group if it's complete
+  //--------------------------------------------------------------------
+
+  if (group.received == group.count) {
+    bytes_t x;
+    if (group.spilled) {
+      x.reserve((count - 1U) * group.chunk_size + group.last.size());
+      for (size_type i = 0; i < count - 1U; ++i) {
+        bytes_t y;
+        if (sdk_) {
+          y = sdk_->readFile(SST_TEV_ARG(tev), spill_file(id, i));
+        } else {
+          y = sst::read_whole_file(spill_file(id, i));
+        }
+        if (y.size() != group.chunk_size) {
+          throw std::runtime_error("Spilled chunk is missing.");
+        }
+        x.insert(x.end(), y.begin(), y.end());
+      }
+    } else {
+      x = std::move(group.data);
+    }
+    // This fits in the reserved capacity, so x is not reallocated.
+    x.insert(x.end(), group.last.begin(), group.last.end());
+    drop(SST_TEV_ARG(tev), group_it);
+    ++stats_.completed;
+    return x;
   }
-  bytes_t x;
-  for (auto const & y : group.chunks) {
-    x.insert(x.end(), y.second.begin(), y.second.end());
+
+  //--------------------------------------------------------------------
+  // Evict the oldest groups to stay under the memory budget
+  //--------------------------------------------------------------------
+
+  charge(group,
+         count / CHAR_BIT + group.data.capacity() + group.last.size());
+  while (stats_.bytes > memory_budget_) {
+    SST_ASSERT((!lru_.empty()));
+    ++stats_.evicted;
+    drop(SST_TEV_ARG(tev), groups_.find(lru_.front()));
+  }
+
+  return {};
+
+  SST_TEV_BOT(tev);
+}
+
+sst::optional<bytes_t>
+chunk_joiner_t::add(tracing_event_t tev,
+                    bytes_t const & id,
+                    bytes_t::size_type const index,
+                    bytes_t::size_type const count,
+                    bytes_t chunk) {
+  return add(SST_TEV_ARG(tev),
+             id,
+             index,
+             count,
+             std::move(chunk),
+             sst::mono_time_ns());
+}
+
+//----------------------------------------------------------------------
+// expire
+//----------------------------------------------------------------------
+
+void chunk_joiner_t::expire(tracing_event_t tev, time_ns_t const now) {
+  SST_TEV_TOP(tev);
+  while (!lru_.empty()) {
+    auto const it = groups_.find(lru_.front());
+    SST_ASSERT((it != groups_.end()));
+    if (it->second.deadline > now) {
+      break;
+    }
+    ++stats_.expired;
+    drop(SST_TEV_ARG(tev), it);
   }
-  groups_.erase(group_it);
-  return x;
   SST_TEV_BOT(tev);
 }
 
+void chunk_joiner_t::expire(tracing_event_t tev) {
+  expire(SST_TEV_ARG(tev), sst::mono_time_ns());
+}
+
+//----------------------------------------------------------------------
+
 void chunk_joiner_t::flush(tracing_event_t tev) {
   SST_TEV_TOP(tev);
+  expire(SST_TEV_ARG(tev));
   SST_TEV_BOT(tev);
 }
 
+chunk_joiner_stats_t chunk_joiner_t::stats() const {
+  chunk_joiner_stats_t s = stats_;
+  s.groups = groups_.size();
+  return s;
+}
+
 } // namespace kestrel
@@ -19,32 +19,111 @@
 #ifndef KESTREL_CHUNK_JOINER_T_HPP
 #define KESTREL_CHUNK_JOINER_T_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <list>
 #include <map>
 #include <string>
+#include <vector>
 
 #include <sst/catalog/SST_NOEXCEPT.hpp>
+#include <sst/catalog/mono_time_ns.hpp>
 #include <sst/catalog/optional.hpp>
 
 #include <kestrel/bytes_t.hpp>
 #include <kestrel/common_sdk_t.hpp>
 #include <kestrel/tracing_event_t.hpp>
 
-// TODO: We'll eventually need timestamping and a way to delete
-//       incomplete groups that haven't seen updates in a long time.
-
 namespace kestrel {
 
+//
+// Counters kept by each chunk_joiner_t. groups and bytes are the
+// current number of partial groups and the memory they are charged
+// for. The rest count groups that were completed, dropped for going
+// too long without a new chunk, evicted to stay under the memory
+// budget, refused because they could never fit in it, and spilled to
+// storage.
+//
+
+struct chunk_joiner_stats_t final {
+  std::uint64_t groups = 0;
+  std::uint64_t bytes = 0;
+  std::uint64_t completed = 0;
+  std::uint64_t expired = 0;
+  std::uint64_t evicted = 0;
+  std::uint64_t refused = 0;
+  std::uint64_t spilled = 0;
+};
+
+//
+// Reassembles groups of chunks. Every chunk of a group but the last
+// has the same size, so the first such chunk fixes the size of the
+// joined message, and the joined buffer is reserved once at that
+// size and filled in place.
+//
+// A partial group is dropped once it has gone timeout_ns without a
+// new chunk, and the oldest partial groups are evicted whenever the
+// memory they are charged for exceeds memory_budget. Groups whose
+// joined size is at least spill_size (if nonzero) keep their chunks
+// in files under dir_ until they are complete instead, which only
+// costs their bookkeeping in memory. Nothing under dir_ survives a
+// restart, as the groups it belongs to do not.
+//
+
 class chunk_joiner_t final {
 
-  std::string dir_{};
-  common_sdk_t * sdk_{};
+public:
+
+  using time_ns_t = decltype(sst::mono_time_ns());
+
+private:
+
+  using size_type = bytes_t::size_type;
+
+  // The ids of the partial groups, least recently updated first. As
+  // every group gets the same timeout, this is also deadline order.
+  using lru_t = std::list<bytes_t>;
 
   struct group_t {
-    bytes_t::size_type count;
-    std::map<bytes_t::size_type, bytes_t> chunks;
+    size_type count;
+    // The size of every chunk but the last, or 0 until it's known.
+    size_type chunk_size = 0;
+    size_type received = 0;
+    std::vector<bool> have;
+    bytes_t data;
+    bytes_t last;
+    bool spilled = false;
+    std::size_t charge = 0;
+    time_ns_t deadline = 0;
+    lru_t::iterator lru;
   };
 
-  std::map<bytes_t, group_t> groups_{};
+  using groups_t = std::map<bytes_t, group_t>;
+
+  std::string dir_{};
+  common_sdk_t * sdk_{};
+
+  time_ns_t timeout_ns_ = static_cast<time_ns_t>(600) * 1000000000;
+  std::size_t memory_budget_ = std::size_t(64) << 20;
+  std::size_t spill_size_ = 0;
+
+  groups_t groups_{};
+  lru_t lru_{};
+
+  chunk_joiner_stats_t stats_{};
+
+  std::string spill_dir(bytes_t const & id) const;
+
+  std::string spill_file(bytes_t const & id, size_type index) const;
+
+  void spill(tracing_event_t tev,
+             bytes_t const & id,
+             size_type index,
+             bytes_t const & chunk);
+
+  void drop(tracing_event_t tev, groups_t::iterator it);
+
+  void charge(group_t & group, std::size_t charge);
 
   //--------------------------------------------------------------------
   // Default operations
@@ -74,18 +153,54 @@ public:
                           std::string dir,
                           common_sdk_t * sdk = nullptr);
 
+  //--------------------------------------------------------------------
+  // configure
+  //--------------------------------------------------------------------
+
+public:
+
+  void configure(time_ns_t timeout_ns,
+                 std::size_t memory_budget,
+                 std::size_t spill_size);
+
   //--------------------------------------------------------------------
   // add
   //--------------------------------------------------------------------
+  //
+  // Adds a chunk and returns the joined message if this chunk
+  // completed its group. Throws corruption_t if the chunk contradicts
+  // what is known about its group.
+  //
 
 public:
 
+  sst::optional<bytes_t> add(tracing_event_t tev,
+                             bytes_t const & id,
+                             bytes_t::size_type index,
+                             bytes_t::size_type count,
+                             bytes_t chunk,
+                             time_ns_t now);
+
   sst::optional<bytes_t> add(tracing_event_t tev,
                              bytes_t const & id,
                              bytes_t::size_type index,
                              bytes_t::size_type count,
                              bytes_t chunk);
 
+  //--------------------------------------------------------------------
+  // expire
+  //--------------------------------------------------------------------
+  //
+  // Drops the partial groups whose deadlines have passed. This is
+  // called by add() and flush(), but can also be called on its own.
+  //
+
+public:
+
+  void expire(tracing_event_t tev, time_ns_t now);
+
+  void expire(tracing_event_t tev);
+
   //--------------------------------------------------------------------
   // flush
   //--------------------------------------------------------------------
@@ -94,6 +209,14 @@ public:
 
   void flush(tracing_event_t tev);
 
+  //--------------------------------------------------------------------
+  // stats
+  //--------------------------------------------------------------------
+
+public:
+
+  chunk_joiner_stats_t stats() const;
+
   //--------------------------------------------------------------------
 };
 
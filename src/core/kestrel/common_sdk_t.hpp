@@ -52,6 +52,7 @@
 #include <kestrel/connection_id_t.hpp>
 #include <kestrel/json_t.hpp>
 #include <kestrel/link_id_t.hpp>
+#include <kestrel/log_sink_t.hpp>
 #include <kestrel/logging.hpp>
 #include <kestrel/plugin_response_t.hpp>
 #include <kestrel/race_handle_t.hpp>
@@ -171,7 +172,10 @@ public:
       trace += func != nullptr ? func : "?";
       trace += ":";
       sst::to_string(line, std::back_inserter(trace));
-      RaceLog::log(level, plugin_name(), message, trace);
+      log_sink_t::instance().write(level,
+                                   plugin_name(),
+                                   message,
+                                   trace);
       return true;
     } catch (...) {
       return false;
@@ -194,17 +198,9 @@ public:
       SST_TEV_ADD(tev,
                   "unix_time_ns",
                   sst::to_string(sst::unix_time_ns()));
-      std::string message = "carma_tracing_event: ";
-      json_t const * const json = tev.json();
-      if (json == nullptr) {
-        message += "{}";
-      } else {
-        message +=
-            json->dump(-1, ' ', true, json_t::error_handler_t::replace);
-      }
-      message += " js\\on";
-      std::string const trace;
-      RaceLog::log(level, plugin_name(), message, trace);
+      log_sink_t::instance().write(level,
+                                   plugin_name(),
+                                   std::move(tev));
       return true;
     } catch (...) {
       return false;
@@ -293,6 +293,7 @@ static std::map<std::string, json_t> config_compile(
   dst["send_retry_count"] = config.send_retry_count().to_string();
   dst["send_retry_window"] = config.send_retry_window().to_string();
   dst["send_timeout"] = config.send_timeout().to_string();
+  dst["mix_threads"] = sst::checked_cast<json_int_t>(num_threads);
 
   //--------------------------------------------------------------------
 
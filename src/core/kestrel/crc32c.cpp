@@ -0,0 +1,60 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/crc32c.hpp>
+// Include twice to test idempotence.
+#include <kestrel/crc32c.hpp>
+//
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace kestrel {
+
+namespace {
+
+using table_t = std::array<std::uint32_t, 256>;
+
+table_t make_table() noexcept {
+  table_t table{};
+  for (std::uint32_t i = 0; i < 256; ++i) {
+    std::uint32_t x = i;
+    for (int k = 0; k < 8; ++k) {
+      x = (x >> 1) ^ ((x & 1) ? UINT32_C(0x82F63B78) : 0);
+    }
+    table[i] = x;
+  }
+  return table;
+}
+
+} // namespace
+
+std::uint32_t crc32c(unsigned char const * const data,
+                     std::size_t const size,
+                     std::uint32_t crc) noexcept {
+  static table_t const table = make_table();
+  crc = ~crc;
+  for (std::size_t i = 0; i < size; ++i) {
+    crc = (crc >> 8) ^ table[(crc ^ data[i]) & 0xFF];
+  }
+  return ~crc;
+}
+
+} // namespace kestrel
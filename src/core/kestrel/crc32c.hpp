@@ -0,0 +1,39 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_CRC32C_HPP
+#define KESTREL_CRC32C_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace kestrel {
+
+//
+// Returns the CRC-32C (Castagnoli) checksum of size bytes at data. To
+// checksum data in pieces, pass the result for the earlier pieces as
+// crc.
+//
+
+std::uint32_t crc32c(unsigned char const * data,
+                     std::size_t size,
+                     std::uint32_t crc = 0) noexcept;
+
+} // namespace kestrel
+
+#endif // #ifndef KESTREL_CRC32C_HPP
@@ -0,0 +1,233 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_DEDUP_WINDOW_T_HPP
+#define KESTREL_DEDUP_WINDOW_T_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include <sst/catalog/mono_time_ns.hpp>
+
+#include <kestrel/guid_t.hpp>
+
+namespace kestrel {
+
+//
+// Hashes byte-sequence IDs (std::vector<unsigned char>, std::array of
+// bytes, guid_t) with FNV-1a. The IDs we deduplicate are random or
+// cryptographic hashes, so there's no need for anything stronger.
+//
+
+struct dedup_hash_t final {
+  template<class Bytes>
+  std::size_t operator()(Bytes const & src) const noexcept {
+    std::uint64_t h = 14695981039346656037ULL;
+    for (auto const b : src) {
+      h ^= static_cast<unsigned char>(b);
+      h *= 1099511628211ULL;
+    }
+    return static_cast<std::size_t>(h);
+  }
+
+  std::size_t operator()(guid_t const & src) const noexcept {
+    return (*this)(src.value());
+  }
+};
+
+//
+// Counters kept by each dedup_window_t. hits counts lookups that found
+// a key, inserts counts new keys, and evicted counts keys dropped by
+// rotation. rotations counts all rotations and early_rotations counts
+// the ones forced by max_entries.
+//
+
+struct dedup_window_stats_t final {
+  std::uint64_t hits = 0;
+  std::uint64_t inserts = 0;
+  std::uint64_t evicted = 0;
+  std::uint64_t rotations = 0;
+  std::uint64_t early_rotations = 0;
+  std::uint64_t size = 0;
+};
+
+//
+// A time-windowed duplicate filter. Keys live in two generations of
+// exact hash maps: new keys go into the current generation, and when
+// it is retention_ns old it becomes the previous generation, replacing
+// the one before it. A key is therefore remembered for at least
+// retention_ns after it was last inserted and at most twice that.
+//
+// To keep memory flat under load, the current generation also rotates
+// early once it holds max_entries / 2 keys, so at most max_entries
+// keys are held. Early rotation can shorten the window, which is
+// counted in the stats.
+//
+// Lookups are exact, so there are no false positives. Each key can
+// carry a Value, which find() returns a pointer to.
+//
+
+template<class Key, class Value = bool, class Hash = dedup_hash_t>
+class dedup_window_t final {
+
+public:
+
+  using time_ns_t = decltype(sst::mono_time_ns());
+
+private:
+
+  using map_t = std::unordered_map<Key, Value, Hash>;
+
+  time_ns_t retention_ns_;
+  std::size_t max_entries_;
+  map_t current_;
+  map_t previous_;
+  time_ns_t current_start_ = 0;
+  bool started_ = false;
+  dedup_window_stats_t stats_;
+
+  void rotate() {
+    stats_.evicted += previous_.size();
+    previous_ = std::move(current_);
+    current_ = map_t();
+    ++stats_.rotations;
+  }
+
+public:
+
+  explicit dedup_window_t(time_ns_t const retention_ns =
+                              static_cast<time_ns_t>(3600) * 1000000000,
+                          std::size_t const max_entries = 1U << 20) {
+    configure(retention_ns, max_entries);
+  }
+
+  void configure(time_ns_t const retention_ns,
+                 std::size_t const max_entries) {
+    if (retention_ns <= 0) {
+      throw std::invalid_argument(
+          "dedup_window_t: retention must be positive");
+    }
+    if (max_entries < 2) {
+      throw std::invalid_argument(
+          "dedup_window_t: max_entries must be at least 2");
+    }
+    retention_ns_ = retention_ns;
+    max_entries_ = max_entries;
+  }
+
+  // Rotates out any generations that have aged past the window. This
+  // is called by every other function, but can also be called on its
+  // own to release memory while idle.
+  void expire(time_ns_t const now) {
+    if (!started_) {
+      started_ = true;
+      current_start_ = now;
+      return;
+    }
+    if (now - current_start_ < retention_ns_) {
+      return;
+    }
+    rotate();
+    if (now - current_start_ >= 2 * retention_ns_) {
+      rotate();
+    }
+    current_start_ = now;
+  }
+
+  void expire() {
+    expire(sst::mono_time_ns());
+  }
+
+  Value * find(Key const & key, time_ns_t const now) {
+    expire(now);
+    auto it = current_.find(key);
+    if (it == current_.end()) {
+      it = previous_.find(key);
+      if (it == previous_.end()) {
+        return nullptr;
+      }
+    }
+    ++stats_.hits;
+    return &it->second;
+  }
+
+  Value * find(Key const & key) {
+    return find(key, sst::mono_time_ns());
+  }
+
+  bool contains(Key const & key, time_ns_t const now) {
+    return find(key, now) != nullptr;
+  }
+
+  bool contains(Key const & key) {
+    return contains(key, sst::mono_time_ns());
+  }
+
+  // Inserts or refreshes a key. A key found in the previous generation
+  // is moved into the current one, so it gets a full window again.
+  Value & insert(Key key, Value value, time_ns_t const now) {
+    expire(now);
+    if (current_.size() >= max_entries_ / 2) {
+      ++stats_.early_rotations;
+      rotate();
+      current_start_ = now;
+    }
+    auto const it = current_.find(key);
+    if (it != current_.end()) {
+      it->second = std::move(value);
+      return it->second;
+    }
+    previous_.erase(key);
+    ++stats_.inserts;
+    return current_.emplace(std::move(key), std::move(value))
+        .first->second;
+  }
+
+  Value & insert(Key key, Value value = Value()) {
+    return insert(std::move(key),
+                  std::move(value),
+                  sst::mono_time_ns());
+  }
+
+  // Returns true if the key was already present, otherwise inserts it
+  // and returns false.
+  bool test_and_insert(Key const & key, time_ns_t const now) {
+    if (contains(key, now)) {
+      return true;
+    }
+    insert(key, Value(), now);
+    return false;
+  }
+
+  bool test_and_insert(Key const & key) {
+    return test_and_insert(key, sst::mono_time_ns());
+  }
+
+  dedup_window_stats_t stats() const noexcept {
+    dedup_window_stats_t s = stats_;
+    s.size = current_.size() + previous_.size();
+    return s;
+  }
+};
+
+} // namespace kestrel
+
+#endif // #ifndef KESTREL_DEDUP_WINDOW_T_HPP
@@ -19,6 +19,7 @@
 #ifndef KESTREL_DETACHED_CLRMSG_STORE_T_HPP
 #define KESTREL_DETACHED_CLRMSG_STORE_T_HPP
 
+#include <cstdint>
 #include <list>
 #include <map>
 #include <string>
@@ -42,6 +43,10 @@ public:
   struct entry_t {
     race_handle_t handle;
     clrmsg_t clrmsg;
+
+    // The id of the message's copy in the persistent clear message
+    // store, which outlives this store across restarts.
+    std::uint64_t store_id = 0;
   };
 
 private:
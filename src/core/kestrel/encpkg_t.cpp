@@ -22,20 +22,18 @@
 #include <kestrel/encpkg_t.hpp>
 
 #include <EncPkg.h>
-#include <algorithm>
 #include <kestrel/generic_hash_t.hpp>
 #include <kestrel/json_t.hpp>
 #include <kestrel/json_t.hpp>
-#include <sst/catalog/checked_resize.hpp>
 #include <sst/catalog/to_string.hpp>
 #include <sst/catalog/to_hex.hpp>
 
 namespace kestrel {
 
 void encpkg_t::init(EncPkg const & other) {
-  auto const & other_blob = other.getCipherText();
-  sst::checked_resize(blob_, other_blob.size());
-  std::copy(other_blob.begin(), other_blob.end(), blob_.begin());
+  // getCipherText() already returns a fresh copy, so take it over
+  // instead of copying it a second time.
+  blob_ = other.getCipherText();
   trace_id_ = other.getTraceId();
   span_id_ = other.getSpanId();
 }
@@ -46,6 +46,9 @@ class encpkg_t final {
   SST_STATIC_ASSERT((std::is_integral<span_id_type>::value));
 
   std::vector<unsigned char> blob_;
+
+  SST_STATIC_ASSERT((std::is_same<RawData, decltype(blob_)>::value));
+
   trace_id_type trace_id_;
   span_id_type span_id_;
 
@@ -24,7 +24,9 @@
 
 #include <chrono>
 #include <cstdint>
+#include <fstream>
 #include <iterator>
+#include <map>
 #include <stdexcept>
 #include <string>
 #include <thread>
@@ -35,10 +37,11 @@
 #include <sst/catalog/SST_TEV_DEF.hpp>
 #include <sst/catalog/SST_THROW_UNIMPLEMENTED.hpp>
 #include <sst/catalog/c_quote.hpp>
+#include <sst/catalog/checked_cast.hpp>
 #include <sst/catalog/checked_resize.hpp>
 #include <sst/catalog/crypto_rng.hpp>
 #include <sst/catalog/dir_it.hpp>
-#include <sst/catalog/is_positive.hpp>
+#include <sst/catalog/optional.hpp>
 #include <sst/catalog/json/set_from_file.hpp>
 #include <sst/catalog/mkdir_p.hpp>
 #include <sst/catalog/read_whole_file.hpp>
@@ -79,7 +82,16 @@ SdkResponse
 engine_t::appendFile(std::string const & filepath,
                      std::vector<std::uint8_t> const & data) {
   auto const primary_lock = this->primary_lock();
-  SST_THROW_UNIMPLEMENTED();
+  std::string const x = fs_dir_ + "/" + normalize_path(filepath);
+  std::ofstream stream(x, std::ios::binary | std::ios::app);
+  stream.write(reinterpret_cast<char const *>(data.data()),
+               sst::checked_cast<std::streamsize>(data.size()));
+  stream.flush();
+  if (!stream) {
+    throw std::runtime_error("Error appending to file: "
+                             + sst::c_quote(x) + ".");
+  }
+  return this->create_SdkResponse();
 }
 
 SdkResponse engine_t::asyncError(RaceHandle handle,
@@ -115,11 +127,10 @@ RawData engine_t::getEntropy(std::uint32_t const numBytes) {
 SdkResponse engine_t::activateChannel(std::string channelGid,
                                       std::string roleName,
                                       std::int32_t const timeout) {
-  auto const primary_lock = this->primary_lock();
   this->expect_asynchronous(timeout);
   auto & ta2_plugin = this->expect_ta2_plugin(channelGid);
   RaceHandle const handle = this->create_RaceHandle();
-  this->activateChannel_tasks_.push_back(
+  this->activateChannel_tasks_.push(
       {ta2_plugin, handle, std::move(channelGid), std::move(roleName)});
   this->increment_task_count();
   return this->create_SdkResponse(handle);
@@ -134,15 +145,14 @@ engine_t::createLinkFromAddress(std::string channelGid,
                                 std::string linkAddress,
                                 std::vector<std::string> personas,
                                 std::int32_t const timeout) {
-  auto const primary_lock = this->primary_lock();
   this->expect_asynchronous(timeout);
   auto & plugin = this->expect_ta2_plugin(channelGid);
   RaceHandle const handle = this->create_RaceHandle();
-  this->createLinkFromAddress_tasks_.push_back({plugin,
-                                                handle,
-                                                std::move(channelGid),
-                                                std::move(linkAddress),
-                                                std::move(personas)});
+  this->createLinkFromAddress_tasks_.push({plugin,
+                                           handle,
+                                           std::move(channelGid),
+                                           std::move(linkAddress),
+                                           std::move(personas)});
   this->increment_task_count();
   return this->create_SdkResponse(handle);
 }
@@ -215,15 +225,14 @@ SdkResponse engine_t::loadLinkAddress(std::string channelGid,
                                       std::string linkAddress,
                                       std::vector<std::string> personas,
                                       std::int32_t const timeout) {
-  auto const primary_lock = this->primary_lock();
   this->expect_asynchronous(timeout);
   auto & plugin = this->expect_ta2_plugin(channelGid);
   RaceHandle const handle = this->create_RaceHandle();
-  this->loadLinkAddress_tasks_.push_back({plugin,
-                                          handle,
-                                          std::move(channelGid),
-                                          std::move(linkAddress),
-                                          std::move(personas)});
+  this->loadLinkAddress_tasks_.push({plugin,
+                                     handle,
+                                     std::move(channelGid),
+                                     std::move(linkAddress),
+                                     std::move(personas)});
   this->increment_task_count();
   return this->create_SdkResponse(handle);
 }
@@ -249,10 +258,9 @@ engine_t::onChannelStatusChanged(RaceHandle handle,
                                  ChannelStatus status,
                                  ChannelProperties properties,
                                  int32_t const timeout) {
-  auto const primary_lock = this->primary_lock();
   this->expect_asynchronous(timeout);
   auto & plugin = this->carma_;
-  this->onChannelStatusChanged_tasks_.push_back(
+  this->onChannelStatusChanged_tasks_.push(
       {plugin,
        std::move(handle),
        std::move(channelGid),
@@ -276,7 +284,7 @@ engine_t::onConnectionStatusChanged(RaceHandle handle,
   this->expect_asynchronous(timeout);
   auto & plugin = this->carma_;
   LinkID linkId = this->connection_id_to_link_id_.at(connId);
-  this->onConnectionStatusChanged_tasks_.push_back(
+  this->onConnectionStatusChanged_tasks_.push(
       {plugin,
        std::move(handle),
        std::move(connId),
@@ -300,11 +308,11 @@ SdkResponse engine_t::onLinkStatusChanged(RaceHandle handle,
   this->expect_asynchronous(timeout);
   auto & plugin = this->carma_;
   this->link_id_to_link_properties_[linkId] = properties;
-  this->onLinkStatusChanged_tasks_.push_back({plugin,
-                                              std::move(handle),
-                                              std::move(linkId),
-                                              std::move(status),
-                                              std::move(properties)});
+  this->onLinkStatusChanged_tasks_.push({plugin,
+                                         std::move(handle),
+                                         std::move(linkId),
+                                         std::move(status),
+                                         std::move(properties)});
   this->increment_task_count();
   return this->create_SdkResponse();
 }
@@ -325,10 +333,9 @@ SdkResponse engine_t::onMessageStatusChanged(RaceHandle,
 SdkResponse engine_t::onPackageStatusChanged(RaceHandle handle,
                                              PackageStatus status,
                                              int32_t const timeout) {
-  auto const primary_lock = this->primary_lock();
   this->expect_asynchronous(timeout);
   auto & plugin = this->carma_;
-  this->onPackageStatusChanged_tasks_.push_back(
+  this->onPackageStatusChanged_tasks_.push(
       {plugin, std::move(handle), std::move(status)});
   this->increment_task_count();
   return this->create_SdkResponse();
@@ -352,17 +359,16 @@ SdkResponse engine_t::openConnection(LinkType linkType,
                                      int32_t priority,
                                      int32_t sendTimeout,
                                      int32_t const timeout) {
-  auto const primary_lock = this->primary_lock();
   this->expect_asynchronous(timeout);
   auto & plugin = this->rabbitmq_management_;
   RaceHandle const handle = this->create_RaceHandle();
-  this->openConnection_tasks_.push_back({plugin,
-                                         handle,
-                                         std::move(linkType),
-                                         std::move(linkId),
-                                         std::move(linkHints),
-                                         std::move(priority),
-                                         std::move(sendTimeout)});
+  this->openConnection_tasks_.push({plugin,
+                                    handle,
+                                    std::move(linkType),
+                                    std::move(linkId),
+                                    std::move(linkHints),
+                                    std::move(priority),
+                                    std::move(sendTimeout)});
   this->increment_task_count();
   return this->create_SdkResponse(handle);
 }
@@ -391,14 +397,13 @@ SdkResponse engine_t::presentCleartextMessage(ClrMsg msg) {
 //----------------------------------------------------------------------
 
 void engine_t::processClrMsg(std::string psn, std::string msg) {
-  auto const primary_lock = this->primary_lock();
   auto & plugin = this->carma_;
   RaceHandle const handle = this->create_RaceHandle();
-  this->processClrMsg_tasks_.push_back({plugin,
-                                        std::move(handle),
-                                        std::move(psn),
-                                        std::move(msg),
-                                        sst::unix_time_us()});
+  this->processClrMsg_tasks_.push({plugin,
+                                   std::move(handle),
+                                   std::move(psn),
+                                   std::move(msg),
+                                   sst::unix_time_us()});
   this->increment_task_count();
 }
 
@@ -425,11 +430,10 @@ SdkResponse
 engine_t::receiveEncPkg(EncPkg const & pkg,
                         std::vector<ConnectionID> const & connIDs,
                         int32_t const timeout) {
-  auto const primary_lock = this->primary_lock();
   this->expect_asynchronous(timeout);
   auto & plugin = this->carma_;
   RaceHandle const handle = this->create_RaceHandle();
-  this->receiveEncPkg_tasks_.push_back(
+  this->receiveEncPkg_tasks_.push(
       {plugin, handle, std::move(pkg), std::move(connIDs)});
   this->increment_task_count();
   return this->create_SdkResponse(handle);
@@ -456,15 +460,14 @@ SdkResponse engine_t::sendEncryptedPackage(EncPkg ePkg,
                                            ConnectionID connectionId,
                                            uint64_t batchId,
                                            int32_t const timeout) {
-  auto const primary_lock = this->primary_lock();
   this->expect_asynchronous(timeout);
   auto & plugin = this->rabbitmq_management_;
   RaceHandle const handle = this->create_RaceHandle();
-  this->sendEncryptedPackage_tasks_.push_back({plugin,
-                                               handle,
-                                               std::move(ePkg),
-                                               std::move(connectionId),
-                                               std::move(batchId)});
+  this->sendEncryptedPackage_tasks_.push({plugin,
+                                          handle,
+                                          std::move(ePkg),
+                                          std::move(connectionId),
+                                          std::move(batchId)});
   this->increment_task_count();
   return this->create_SdkResponse(handle);
 }
@@ -660,60 +663,28 @@ void engine_t::tick() {
 
   //--------------------------------------------------------------------
 
-  SST_ASSERT((sst::is_positive(this->task_count_.load())));
+  // Drain at most max_tick_batch_ tasks from each queue so that one
+  // busy queue cannot starve the others. Anything left over keeps
+  // task_count_ positive, so run() comes straight back here.
 
-  long long local_task_count;
-
-  //--------------------------------------------------------------------
-  // Move all pending tasks into local storage
-  //--------------------------------------------------------------------
-
-#define F(G)                                                           \
-  G(activateChannel_tasks);                                            \
-  G(createLinkFromAddress_tasks);                                      \
-  G(loadLinkAddress_tasks);                                            \
-  G(onChannelStatusChanged_tasks);                                     \
-  G(onConnectionStatusChanged_tasks);                                  \
-  G(onLinkStatusChanged_tasks);                                        \
-  G(onPackageStatusChanged_tasks);                                     \
-  G(openConnection_tasks);                                             \
-  G(processClrMsg_tasks);                                              \
-  G(receiveEncPkg_tasks);                                              \
-  G(sendEncryptedPackage_tasks);                                       \
-  class semicolon
-
-#define G1(X) decltype(this->X##_) X
-
-#define G2(X)                                                          \
-  do {                                                                 \
-    X = std::move(this->X##_);                                         \
-    this->X##_.clear();                                                \
-  } while (false)
-
-  F(G1);
-  {
-    auto const primary_lock = this->primary_lock();
-    F(G2);
-    local_task_count = this->task_count_.load();
-  }
-
-#undef G2
-#undef G1
-#undef F
+  long long const max_batch = this->max_tick_batch_;
 
   //--------------------------------------------------------------------
   // activateChannel
   //--------------------------------------------------------------------
 
-  while (!activateChannel_tasks.empty()) {
-    auto & task = activateChannel_tasks.front();
-    // TODO: What if this call returns an error or throws?
-    task.ta2_plugin.activateChannel(std::move(task.handle),
-                                    std::move(task.channelGid),
-                                    std::move(task.roleName));
-    activateChannel_tasks.pop_front();
-    this->decrement_task_count();
-    --local_task_count;
+  {
+    sst::optional<activateChannel_task_t> next;
+    for (long long i = 0;
+         i < max_batch && this->activateChannel_tasks_.pop(next);
+         ++i) {
+      auto & task = *next;
+      // TODO: What if this call returns an error or throws?
+      task.ta2_plugin.activateChannel(std::move(task.handle),
+                                      std::move(task.channelGid),
+                                      std::move(task.roleName));
+      this->decrement_task_count();
+    }
   }
 
   //--------------------------------------------------------------------
@@ -723,15 +694,18 @@ void engine_t::tick() {
   // TODO: We're supposed to use task.personas to keep track of a
   //       mapping from links to persona sets.
 
-  while (!createLinkFromAddress_tasks.empty()) {
-    auto & task = createLinkFromAddress_tasks.front();
-    // TODO: What if this call returns an error or throws?
-    task.plugin.createLinkFromAddress(std::move(task.handle),
-                                      std::move(task.channelGid),
-                                      std::move(task.linkAddress));
-    createLinkFromAddress_tasks.pop_front();
-    this->decrement_task_count();
-    --local_task_count;
+  {
+    sst::optional<createLinkFromAddress_task_t> next;
+    for (long long i = 0;
+         i < max_batch && this->createLinkFromAddress_tasks_.pop(next);
+         ++i) {
+      auto & task = *next;
+      // TODO: What if this call returns an error or throws?
+      task.plugin.createLinkFromAddress(std::move(task.handle),
+                                        std::move(task.channelGid),
+                                        std::move(task.linkAddress));
+      this->decrement_task_count();
+    }
   }
 
   //--------------------------------------------------------------------
@@ -741,157 +715,182 @@ void engine_t::tick() {
   // TODO: We're supposed to use task.personas to keep track of a
   //       mapping from links to persona sets.
 
-  while (!loadLinkAddress_tasks.empty()) {
-    auto & task = loadLinkAddress_tasks.front();
-    // TODO: What if this call returns an error or throws?
-    task.plugin.loadLinkAddress(std::move(task.handle),
-                                std::move(task.channelGid),
-                                std::move(task.linkAddress));
-    loadLinkAddress_tasks.pop_front();
-    this->decrement_task_count();
-    --local_task_count;
+  {
+    sst::optional<loadLinkAddress_task_t> next;
+    for (long long i = 0;
+         i < max_batch && this->loadLinkAddress_tasks_.pop(next);
+         ++i) {
+      auto & task = *next;
+      // TODO: What if this call returns an error or throws?
+      task.plugin.loadLinkAddress(std::move(task.handle),
+                                  std::move(task.channelGid),
+                                  std::move(task.linkAddress));
+      this->decrement_task_count();
+    }
   }
 
   //--------------------------------------------------------------------
   // onChannelStatusChanged
   //--------------------------------------------------------------------
 
-  while (!onChannelStatusChanged_tasks.empty()) {
-    auto & task = onChannelStatusChanged_tasks.front();
-    // TODO: What if this call returns an error or throws?
-    task.plugin.onChannelStatusChanged(std::move(task.handle),
-                                       std::move(task.channelGid),
-                                       std::move(task.status),
-                                       std::move(task.properties));
-    onChannelStatusChanged_tasks.pop_front();
-    this->decrement_task_count();
-    --local_task_count;
+  {
+    sst::optional<onChannelStatusChanged_task_t> next;
+    for (long long i = 0;
+         i < max_batch && this->onChannelStatusChanged_tasks_.pop(next);
+         ++i) {
+      auto & task = *next;
+      // TODO: What if this call returns an error or throws?
+      task.plugin.onChannelStatusChanged(std::move(task.handle),
+                                         std::move(task.channelGid),
+                                         std::move(task.status),
+                                         std::move(task.properties));
+      this->decrement_task_count();
+    }
   }
 
   //--------------------------------------------------------------------
   // onConnectionStatusChanged
   //--------------------------------------------------------------------
 
-  while (!onConnectionStatusChanged_tasks.empty()) {
-    auto & task = onConnectionStatusChanged_tasks.front();
-    // TODO: What if this call returns an error or throws?
-    task.plugin.onConnectionStatusChanged(std::move(task.handle),
-                                          std::move(task.connId),
-                                          std::move(task.status),
-                                          std::move(task.linkId),
-                                          std::move(task.properties));
-    onConnectionStatusChanged_tasks.pop_front();
-    this->decrement_task_count();
-    --local_task_count;
+  {
+    sst::optional<onConnectionStatusChanged_task_t> next;
+    for (long long i = 0;
+         i < max_batch
+         && this->onConnectionStatusChanged_tasks_.pop(next);
+         ++i) {
+      auto & task = *next;
+      // TODO: What if this call returns an error or throws?
+      task.plugin.onConnectionStatusChanged(std::move(task.handle),
+                                            std::move(task.connId),
+                                            std::move(task.status),
+                                            std::move(task.linkId),
+                                            std::move(task.properties));
+      this->decrement_task_count();
+    }
   }
 
   //--------------------------------------------------------------------
   // onLinkStatusChanged
   //--------------------------------------------------------------------
 
-  while (!onLinkStatusChanged_tasks.empty()) {
-    auto & task = onLinkStatusChanged_tasks.front();
-    // TODO: What if this call returns an error or throws?
-    task.plugin.onLinkStatusChanged(std::move(task.handle),
-                                    std::move(task.linkId),
-                                    std::move(task.status),
-                                    std::move(task.properties));
-    onLinkStatusChanged_tasks.pop_front();
-    this->decrement_task_count();
-    --local_task_count;
+  {
+    sst::optional<onLinkStatusChanged_task_t> next;
+    for (long long i = 0;
+         i < max_batch && this->onLinkStatusChanged_tasks_.pop(next);
+         ++i) {
+      auto & task = *next;
+      // TODO: What if this call returns an error or throws?
+      task.plugin.onLinkStatusChanged(std::move(task.handle),
+                                      std::move(task.linkId),
+                                      std::move(task.status),
+                                      std::move(task.properties));
+      this->decrement_task_count();
+    }
   }
 
   //--------------------------------------------------------------------
   // onPackageStatusChanged
   //--------------------------------------------------------------------
 
-  while (!onPackageStatusChanged_tasks.empty()) {
-    auto & task = onPackageStatusChanged_tasks.front();
-    // TODO: What if this call returns an error or throws?
-    task.plugin.onPackageStatusChanged(std::move(task.handle),
-                                       std::move(task.status));
-    onPackageStatusChanged_tasks.pop_front();
-    this->decrement_task_count();
-    --local_task_count;
+  {
+    sst::optional<onPackageStatusChanged_task_t> next;
+    for (long long i = 0;
+         i < max_batch && this->onPackageStatusChanged_tasks_.pop(next);
+         ++i) {
+      auto & task = *next;
+      // TODO: What if this call returns an error or throws?
+      task.plugin.onPackageStatusChanged(std::move(task.handle),
+                                         std::move(task.status));
+      this->decrement_task_count();
+    }
   }
 
   //--------------------------------------------------------------------
   // openConnection
   //--------------------------------------------------------------------
 
-  while (!openConnection_tasks.empty()) {
-    auto & task = openConnection_tasks.front();
-    // TODO: What if this call returns an error or throws?
-    task.plugin.openConnection(std::move(task.handle),
-                               std::move(task.linkType),
-                               std::move(task.linkId),
-                               std::move(task.linkHints),
-                               std::move(task.sendTimeout));
-    openConnection_tasks.pop_front();
-    this->decrement_task_count();
-    --local_task_count;
+  {
+    sst::optional<openConnection_task_t> next;
+    for (long long i = 0;
+         i < max_batch && this->openConnection_tasks_.pop(next);
+         ++i) {
+      auto & task = *next;
+      // TODO: What if this call returns an error or throws?
+      task.plugin.openConnection(std::move(task.handle),
+                                 std::move(task.linkType),
+                                 std::move(task.linkId),
+                                 std::move(task.linkHints),
+                                 std::move(task.sendTimeout));
+      this->decrement_task_count();
+    }
   }
 
   //--------------------------------------------------------------------
   // processClrMsg
   //--------------------------------------------------------------------
 
-  while (!processClrMsg_tasks.empty()) {
-    auto & task = processClrMsg_tasks.front();
-    // TODO: What if this call returns an error or throws?
-    task.plugin.processClrMsg(
-        std::move(task.handle),
-        ClrMsg(std::move(task.msg),
-               this->config_.psn()->value(),
-               std::move(task.psn),
-               static_cast<decltype(std::declval<ClrMsg>().getTime())>(
-                   task.unix_time_us),
-               0,
-               0,
-               0,
-               0));
-    processClrMsg_tasks.pop_front();
-    this->decrement_task_count();
-    --local_task_count;
+  {
+    sst::optional<processClrMsg_task_t> next;
+    for (long long i = 0;
+         i < max_batch && this->processClrMsg_tasks_.pop(next);
+         ++i) {
+      auto & task = *next;
+      // TODO: What if this call returns an error or throws?
+      task.plugin.processClrMsg(
+          std::move(task.handle),
+          ClrMsg(std::move(task.msg),
+                 this->config_.psn()->value(),
+                 std::move(task.psn),
+                 static_cast<
+                     decltype(std::declval<ClrMsg>().getTime())>(
+                     task.unix_time_us),
+                 0,
+                 0,
+                 0,
+                 0));
+      this->decrement_task_count();
+    }
   }
 
   //--------------------------------------------------------------------
   // receiveEncPkg
   //--------------------------------------------------------------------
 
-  while (!receiveEncPkg_tasks.empty()) {
-    auto & task = receiveEncPkg_tasks.front();
-    // TODO: What if this call returns an error or throws?
-    task.plugin.processEncPkg(std::move(task.handle),
-                              std::move(task.pkg),
-                              std::move(task.connIDs));
-    receiveEncPkg_tasks.pop_front();
-    this->decrement_task_count();
-    --local_task_count;
+  {
+    sst::optional<receiveEncPkg_task_t> next;
+    for (long long i = 0;
+         i < max_batch && this->receiveEncPkg_tasks_.pop(next);
+         ++i) {
+      auto & task = *next;
+      // TODO: What if this call returns an error or throws?
+      task.plugin.processEncPkg(std::move(task.handle),
+                                std::move(task.pkg),
+                                std::move(task.connIDs));
+      this->decrement_task_count();
+    }
   }
 
   //--------------------------------------------------------------------
   // sendEncryptedPackage
   //--------------------------------------------------------------------
 
-  while (!sendEncryptedPackage_tasks.empty()) {
-    auto & task = sendEncryptedPackage_tasks.front();
-    // TODO: What if this call returns an error or throws?
-    task.plugin.sendPackage(std::move(task.handle),
-                            std::move(task.connectionId),
-                            std::move(task.ePkg),
-                            9999999999999999.0,
-                            std::move(task.batchId));
-    sendEncryptedPackage_tasks.pop_front();
-    this->decrement_task_count();
-    --local_task_count;
+  {
+    sst::optional<sendEncryptedPackage_task_t> next;
+    for (long long i = 0;
+         i < max_batch && this->sendEncryptedPackage_tasks_.pop(next);
+         ++i) {
+      auto & task = *next;
+      // TODO: What if this call returns an error or throws?
+      task.plugin.sendPackage(std::move(task.handle),
+                              std::move(task.connectionId),
+                              std::move(task.ePkg),
+                              9999999999999999.0,
+                              std::move(task.batchId));
+      this->decrement_task_count();
+    }
   }
 
   //--------------------------------------------------------------------
-
-  SST_ASSERT((local_task_count == 0));
-
-  //--------------------------------------------------------------------
 }
 
 void engine_t::run() {
@@ -929,14 +928,12 @@ void engine_t::run() {
     on_start_(info);
   }
 
-  {
+  while (running_.load() == 1) {
+    tick();
     std::unique_lock<std::mutex> lock{this->task_mutex_};
-    while (running_.load() == 1) {
-      tick();
-      this->task_condition_.wait(lock, [&] {
-        return this->task_count_.load() > 0;
-      });
-    }
+    this->task_condition_.wait(lock, [&] {
+      return this->task_count_.load() > 0;
+    });
   }
 
 } //
@@ -994,10 +991,28 @@ void engine_t::stop() {
   if (!running_.compare_exchange_strong(x, 2)) {
     throw std::logic_error("The engine is already stopped");
   }
-  auto const primary_lock = this->primary_lock();
   this->increment_task_count();
 }
 
+std::map<std::string, mpsc_queue_stats_t>
+engine_t::task_queue_stats() const {
+  std::map<std::string, mpsc_queue_stats_t> xs;
+#define F(X) xs[#X] = this->X##_tasks_.stats()
+  F(activateChannel);
+  F(createLinkFromAddress);
+  F(loadLinkAddress);
+  F(onChannelStatusChanged);
+  F(onConnectionStatusChanged);
+  F(onLinkStatusChanged);
+  F(onPackageStatusChanged);
+  F(openConnection);
+  F(processClrMsg);
+  F(receiveEncPkg);
+  F(sendEncryptedPackage);
+#undef F
+  return xs;
+}
+
 void engine_t::on_stop(std::function<void(char const *)> const & f) {
   on_stop_ = f;
 }
@@ -24,7 +24,6 @@
 #include <cstdint>
 #include <functional>
 #include <future>
-#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -45,6 +44,7 @@
 
 #include <kestrel/carma/plugin_t.hpp>
 #include <kestrel/engine_config_t.hpp>
+#include <kestrel/mpsc_queue_t.hpp>
 #include <kestrel/psn_t.hpp>
 #include <kestrel/rabbitmq/plugin_t.hpp>
 #include <kestrel/rabbitmq_management/plugin_t.hpp>
@@ -192,12 +192,27 @@ private:
 
 private:
 
+  //
+  // Each SDK call that the engine thread must handle later has its own
+  // mpsc_queue_t of tasks. Producers push into these queues without
+  // taking primary_mutex_, and tick() drains at most
+  // max_tick_batch_ tasks from each queue per call.
+  //
+  // task_count_ is the total number of queued tasks. task_mutex_ is
+  // only held briefly to avoid lost wakeups, never while running
+  // tasks.
+  //
+
   std::mutex task_mutex_;
   std::atomic<long long> task_count_{0};
   std::condition_variable task_condition_;
+  long long max_tick_batch_ = 64;
 
   void increment_task_count() noexcept {
     ++this->task_count_;
+    {
+      std::lock_guard<std::mutex> const lock(this->task_mutex_);
+    }
     this->task_condition_.notify_one();
   }
 
@@ -330,7 +345,7 @@ private:
     std::string roleName;
   };
 
-  std::list<activateChannel_task_t> activateChannel_tasks_;
+  mpsc_queue_t<activateChannel_task_t> activateChannel_tasks_;
 
 public:
 
@@ -362,7 +377,8 @@ private:
     std::vector<std::string> personas;
   };
 
-  std::list<createLinkFromAddress_task_t> createLinkFromAddress_tasks_;
+  mpsc_queue_t<createLinkFromAddress_task_t>
+      createLinkFromAddress_tasks_;
 
 public:
 
@@ -445,7 +461,7 @@ private:
     std::vector<std::string> personas;
   };
 
-  std::list<loadLinkAddress_task_t> loadLinkAddress_tasks_;
+  mpsc_queue_t<loadLinkAddress_task_t> loadLinkAddress_tasks_;
 
 public:
 
@@ -480,7 +496,7 @@ private:
     ChannelProperties properties;
   };
 
-  std::list<onChannelStatusChanged_task_t>
+  mpsc_queue_t<onChannelStatusChanged_task_t>
       onChannelStatusChanged_tasks_;
 
 public:
@@ -506,7 +522,7 @@ private:
     LinkProperties properties;
   };
 
-  std::list<onConnectionStatusChanged_task_t>
+  mpsc_queue_t<onConnectionStatusChanged_task_t>
       onConnectionStatusChanged_tasks_;
 
 public:
@@ -531,7 +547,7 @@ private:
     LinkProperties properties;
   };
 
-  std::list<onLinkStatusChanged_task_t> onLinkStatusChanged_tasks_;
+  mpsc_queue_t<onLinkStatusChanged_task_t> onLinkStatusChanged_tasks_;
 
   // TODO: We need some kind of pruning process for this map, otherwise
   //       it will only ever increase in size.
@@ -566,7 +582,7 @@ private:
     PackageStatus status;
   };
 
-  std::list<onPackageStatusChanged_task_t>
+  mpsc_queue_t<onPackageStatusChanged_task_t>
       onPackageStatusChanged_tasks_;
 
 public:
@@ -599,7 +615,7 @@ private:
     int32_t sendTimeout;
   };
 
-  std::list<openConnection_task_t> openConnection_tasks_;
+  mpsc_queue_t<openConnection_task_t> openConnection_tasks_;
 
 public:
 
@@ -645,7 +661,7 @@ private:
     std::vector<ConnectionID> connIDs;
   };
 
-  std::list<receiveEncPkg_task_t> receiveEncPkg_tasks_;
+  mpsc_queue_t<receiveEncPkg_task_t> receiveEncPkg_tasks_;
 
 public:
 
@@ -680,7 +696,7 @@ private:
     uint64_t batchId;
   };
 
-  std::list<sendEncryptedPackage_task_t> sendEncryptedPackage_tasks_;
+  mpsc_queue_t<sendEncryptedPackage_task_t> sendEncryptedPackage_tasks_;
 
 public:
 
@@ -840,6 +856,10 @@ public:
   void stop();
   void on_stop(std::function<void(char const *)> const & f);
 
+  // Depth and latency counters of each task queue, keyed by the name
+  // of the SDK call that feeds it.
+  std::map<std::string, mpsc_queue_stats_t> task_queue_stats() const;
+
   //--------------------------------------------------------------------
   // wait()
   //--------------------------------------------------------------------
@@ -875,7 +895,7 @@ private:
     sst::unix_time_us_t unix_time_us;
   };
 
-  std::list<processClrMsg_task_t> processClrMsg_tasks_;
+  mpsc_queue_t<processClrMsg_task_t> processClrMsg_tasks_;
 
 public:
 
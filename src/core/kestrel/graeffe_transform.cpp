@@ -16,6 +16,7 @@
 // SPDX-License-Identifier: Apache-2.0
 //
 
+#include <algorithm>
 #include <cstddef>
 #include <utility>
 #include <vector>
@@ -23,6 +24,7 @@
 #include <sst/catalog/bignum.hpp>
 
 #include <kestrel/graeffe_transform.hpp>
+#include <kestrel/ntt.hpp>
 
 using sst::bignum;
 using std::pair;
@@ -117,6 +119,15 @@ void mul(NumX & x, NumX const & f, NumX const & g) {
 
   // now 0 < deg(f) <= deg(g)
 
+  if (degf + 1 >= ntt_crossover) {
+    if (ntt_mul(x.rep,
+                f.rep,
+                g.rep,
+                *ntt_table_t::get(f.GetModulus()))) {
+      return;
+    }
+  }
+
   auto const d{degf + degg};
 
   size_t imin{};
@@ -298,7 +309,58 @@ pair<NumX, NumX> initial_linear_expansion(NumX const & f,
   return {h, hbar};
 }
 
+// Returns false if the products are too short to be worth transforming
+// or too long for the transform sizes the modulus supports.
+static bool ntt_update_linear_expansion(NumX & h, NumX & hbar) {
+  auto const & modulus{h.GetModulus()};
+  if (std::min(deg(h), deg(hbar)) + 1 < ntt_crossover) {
+    return false;
+  }
+  auto const table{ntt_table_t::get(modulus)};
+  auto const log_size{
+      ntt_log_size(deg(h) + std::max(deg(h), deg(hbar)) + 1)};
+  if (log_size > table->max_log_size()) {
+    return false;
+  }
+  auto const n{size_t(1) << log_size};
+  auto const half{n / 2};
+
+  vector<bignum> hv(h.rep);
+  hv.resize(n, bignum::zero());
+  table->forward(hv, log_size);
+  vector<bignum> hbarv(hbar.rep);
+  hbarv.resize(n, bignum::zero());
+  table->forward(hbarv, log_size);
+
+  // The transform evaluates at w^j, and -w^j = w^(j + n/2), so the
+  // transforms of h(-x) and hbar(-x) are just hv and hbarv rotated by
+  // n/2. That leaves two forward and two inverse transforms for all
+  // three products.
+  vector<bignum> a(n);
+  vector<bignum> b(n);
+  for (size_t j{}; j < n; ++j) {
+    auto const jneg{j ^ half};
+    a[j] = hv[j].mul_mod(hv[jneg], modulus);
+    b[j] = hv[j].mul_mod(hbarv[jneg], modulus);
+    b[j] = b[j].add_mod(hbarv[j].mul_mod(hv[jneg], modulus), modulus);
+  }
+  table->inverse(a, log_size);
+  table->inverse(b, log_size);
+
+  for (size_t i{}; i <= deg(h); ++i) {
+    SetCoeff(h, i, a[2 * i]);
+  }
+  for (size_t i{}; i <= deg(hbar); ++i) {
+    SetCoeff(hbar, i, b[2 * i]);
+  }
+  return true;
+}
+
 void update_linear_expansion(NumX & h, NumX & hbar) {
+  if (ntt_update_linear_expansion(h, hbar)) {
+    return;
+  }
+
   //hneg := h(-x)
 
   //std::cout << "update_linear_expansion\n";
@@ -449,32 +511,49 @@ vector<bignum> find_roots(NumX const & f,
   }
 }
 
-NumX build_from_roots(bignum const & modulus,
-                      vector<bignum> const & roots) {
+static NumX build_from_roots(bignum const & modulus,
+                             vector<bignum> const & roots,
+                             size_t const begin,
+                             size_t const end) {
   NumX f{modulus};
 
-  auto const n{roots.size()};
+  auto const n{end - begin};
 
-  if (n == 0) {
-    f.rep.resize(1);
-    SetCoeff(f, 0, bignum(1));
+  if (n >= 2 * ntt_crossover) {
+    // Product tree. Both halves have at least ntt_crossover roots, so
+    // mul() takes the NTT path.
+    auto const mid{begin + n / 2};
+    mul(f,
+        build_from_roots(modulus, roots, begin, mid),
+        build_from_roots(modulus, roots, mid, end));
     return f;
   }
 
   f.rep.resize(n + 1);
   f.rep[0] = 1;
   for (size_t i = 0; i < n; i++) {
+    auto const & root{roots[begin + i]};
     for (size_t j = i + 1; j > 0; j--) {
-      f.rep[j] = (f.rep[j]).mul_mod(modulus - roots[i], modulus);
+      f.rep[j] = (f.rep[j]).mul_mod(modulus - root, modulus);
       f.rep[j] = (f.rep[j]).add_mod(f.rep[j - 1], modulus);
     }
-    f.rep[0] = (f.rep[0]).mul_mod(modulus - roots[i], modulus);
+    f.rep[0] = (f.rep[0]).mul_mod(modulus - root, modulus);
   }
-  //TODO: re-implement with FFTs
 
   return f;
 }
 
+NumX build_from_roots(bignum const & modulus,
+                      vector<bignum> const & roots) {
+  if (roots.empty()) {
+    NumX f{modulus};
+    f.rep.resize(1);
+    SetCoeff(f, 0, bignum(1));
+    return f;
+  }
+  return build_from_roots(modulus, roots, 0, roots.size());
+}
+
 void newton_to_polynomial(NumX & output,
                           vector<bignum> const & newton_sums,
                           size_t const degree) {
@@ -24,6 +24,8 @@
 
 #include <sst/catalog/bignum.hpp>
 
+#include <kestrel/prime_field_t.hpp>
+
 class NumX final {
 public:
   NumX(sst::bignum const & modulus, sst::bignum const & a)
@@ -107,6 +109,10 @@ inline NumX operator+(NumX const & f, NumX const & g) {
 }
 
 void mul(NumX & x, NumX const & f, sst::bignum const & g);
+
+// If both f and g have at least ntt_crossover coefficients, the
+// product is computed with number theoretic transforms (see
+// kestrel/ntt.hpp) instead of the schoolbook method.
 void mul(NumX & x, NumX const & f, NumX const & g);
 
 extern NumX build_from_roots(sst::bignum const & modulus,
@@ -215,4 +221,46 @@ newton_to_polynomial(NumX & output,
                      std::vector<sst::bignum> const & newton_sums,
                      std::size_t const degree);
 
+/**
+ * The same as newton_to_polynomial above, but with the arithmetic done
+ * in a fixed-width Montgomery field. The modulus of field must be the
+ * modulus of output.
+ */
+template<std::size_t MaxLimbs>
+void newton_to_polynomial(
+    NumX & output,
+    std::vector<sst::bignum> const & newton_sums,
+    std::size_t const degree,
+    kestrel::prime_field_t<MaxLimbs> const & field) {
+  using element_t =
+      typename kestrel::prime_field_t<MaxLimbs>::element_t;
+
+  std::vector<element_t> sums(degree);
+  for (std::size_t i{}; i < degree; ++i) {
+    sums[i] = field.from_bigint(newton_sums[i]);
+  }
+
+  // invs[k] = 1 / (k + 1)
+  std::vector<element_t> invs(degree);
+  for (std::size_t k{}; k < degree; ++k) {
+    invs[k] = field.from_uint(k + 1);
+  }
+  field.batch_inv(invs);
+
+  std::vector<element_t> out(degree + 1);
+  out[degree] = field.one();
+  out[degree - 1] = field.neg(sums[0]);
+  for (std::size_t i{degree - 1}; i-- > 0;) {
+    auto tmp{sums[degree - 1 - i]};
+    for (std::size_t j{}; j < (degree - 1) - i; j++) {
+      tmp = field.add(tmp, field.mul(out[i + j + 1], sums[j]));
+    }
+    out[i] = field.neg(field.mul(tmp, invs[degree - i - 1]));
+  }
+
+  for (std::size_t i{}; i <= degree; ++i) {
+    SetCoeff(output, i, field.to_bigint(out[i]));
+  }
+}
+
 #endif /* GRAEFFE_TRANSFORM_HPP */
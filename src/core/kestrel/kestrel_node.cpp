@@ -28,9 +28,12 @@
 #include <list>
 #include <memory>
 #include <ostream>
+#include <random>
 #include <set>
+#include <stdexcept>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <sst/catalog/SST_ASSERT.hpp>
 #include <sst/catalog/checked.hpp>
@@ -44,11 +47,14 @@
 #include <sst/catalog/precise_sleep_until_unix_time_ns.hpp>
 #include <sst/catalog/rand_range.hpp>
 #include <sst/catalog/unix_time_ns.hpp>
+#include <sst/catalog/unix_time_us.hpp>
 #include <sst/catalog/unknown_oper.hpp>
 #include <sst/catalog/unknown_opt.hpp>
 
 #include <kestrel/engine_t.hpp>
 #include <kestrel/kestrel_cli_args_t.hpp>
+#include <kestrel/load_generator_t.hpp>
+#include <kestrel/load_spec_t.hpp>
 #include <kestrel/psn_t.hpp>
 #include <kestrel/replay_message_spec_t.hpp>
 #include <kestrel/replay_spec_t.hpp>
@@ -68,6 +74,8 @@ void kestrel_node(kestrel_cli_args_t const & kestrel_cli_args,
 
   sst::optional<replay_spec_t> replay;
 
+  sst::optional<load_spec_t> load;
+
   bool parse_options = true;
   while (argv.pop_front(), !argv.empty()) {
     if (parse_options) {
@@ -81,6 +89,16 @@ void kestrel_node(kestrel_cli_args_t const & kestrel_cli_args,
         continue;
       }
 
+      //----------------------------------------------------------------
+      // --load
+      //----------------------------------------------------------------
+
+      if (sst::parse_opt(argv, "--load", sst::opt_arg::required)) {
+        load = sst::json::get_from_file<load_spec_t, json_t>(
+            argv.front());
+        continue;
+      }
+
       //----------------------------------------------------------------
       // --replay
       //----------------------------------------------------------------
@@ -112,6 +130,12 @@ void kestrel_node(kestrel_cli_args_t const & kestrel_cli_args,
 
   engine_t engine(kestrel_cli_args.work_dir());
 
+  std::unique_ptr<load_generator_t> load_generator;
+  if (load) {
+    load_generator.reset(
+        new load_generator_t(std::move(*load), std::random_device()()));
+  }
+
   std::promise<void> on_start_promise;
   std::future<void> on_start_future(on_start_promise.get_future());
 
@@ -129,6 +153,12 @@ void kestrel_node(kestrel_cli_args_t const & kestrel_cli_args,
 
   engine.on_recv_clrmsg(
       [&](engine_t::on_recv_clrmsg_info_t const & info) {
+        if (load_generator
+            && load_generator->on_recv(info.msg,
+                                       info.unix_time_us,
+                                       sst::unix_time_us())) {
+          return;
+        }
         std::cout << info.psn << ": " << info.msg << "\n";
       });
 
@@ -199,6 +229,52 @@ void kestrel_node(kestrel_cli_args_t const & kestrel_cli_args,
     }
   }
 
+  if (load_generator) {
+    load_spec_t const & spec = load_generator->spec();
+    std::shared_ptr<psn_t const> const my_psn_p = engine.config().psn();
+    psn_t const & my_psn = *my_psn_p;
+    std::shared_ptr<std::vector<psn_t> const> const p_clients =
+        engine.config().clients();
+    std::vector<psn_t> const & clients = *p_clients;
+    if (spec.receiver_slug() == "*") {
+      if (clients.size() < 2) {
+        throw std::runtime_error(
+            "--load with receiver \"*\" needs at least two clients");
+      }
+    } else if (!std::binary_search(clients.begin(),
+                                   clients.end(),
+                                   spec.receiver())) {
+      throw std::runtime_error("--load receiver is not a client");
+    }
+    load_generator->start(sst::unix_time_ns());
+    load_generator_t::arrival_t arrival;
+    while (load_generator->next(arrival)) {
+      sst::precise_sleep_until_unix_time_ns(arrival.time);
+      for (long k = 0; k < arrival.count; ++k) {
+        psn_t receiver;
+        if (spec.receiver_slug() == "*") {
+          using i_t = decltype(clients.size());
+          i_t i;
+          do {
+            i = sst::rand_range(
+                static_cast<i_t>(0),
+                static_cast<i_t>(clients.size() - static_cast<i_t>(1)));
+          } while (clients[i] == my_psn);
+          receiver = clients[i];
+        } else {
+          receiver = spec.receiver();
+        }
+        std::string msg = load_generator->make_message();
+        auto const bytes = msg.size();
+        engine.processClrMsg(receiver.value(), std::move(msg));
+        load_generator->on_send(arrival, sst::unix_time_ns(), bytes);
+      }
+    }
+    sst::precise_sleep_until_unix_time_ns(
+        load_generator->drain_until());
+    std::cout << load_generator->report().dump(2) << "\n";
+  }
+
   engine.wait();
 
 } //
@@ -0,0 +1,153 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/load_generator_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/load_generator_t.hpp>
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+
+#include <sst/catalog/SST_ASSERT.hpp>
+#include <sst/catalog/is_positive.hpp>
+#include <sst/catalog/to_string.hpp>
+#include <sst/catalog/unix_time_ns_t.hpp>
+#include <sst/catalog/unix_time_us_t.hpp>
+
+#include <kestrel/json_t.hpp>
+#include <kestrel/load_spec_t.hpp>
+
+namespace kestrel {
+
+load_generator_t::load_generator_t(load_spec_t spec,
+                                   std::uint64_t const seed)
+    : spec_(std::move(spec)),
+      rng_(seed) {
+}
+
+void load_generator_t::start(sst::unix_time_ns_t const now) {
+  dawn_ = sst::is_positive(spec_.dawn()) ? spec_.dawn() : now;
+  offset_ns_ = 0;
+  auto const begin = dawn_ + spec_.warmup();
+  window_begin_.store(begin);
+  window_end_.store(begin + spec_.duration());
+}
+
+bool load_generator_t::next(arrival_t & arrival) {
+  arrival.time = dawn_ + static_cast<sst::unix_time_ns_t>(offset_ns_);
+  if (arrival.time >= window_end_.load()) {
+    return false;
+  }
+  double const mean_gap_ns = 1e9 / spec_.rate();
+  if (spec_.arrival() == "constant") {
+    arrival.count = 1;
+    offset_ns_ += mean_gap_ns;
+  } else if (spec_.arrival() == "poisson") {
+    arrival.count = 1;
+    offset_ns_ +=
+        std::exponential_distribution<double>(1 / mean_gap_ns)(rng_);
+  } else {
+    SST_ASSERT((spec_.arrival() == "burst"));
+    arrival.count = spec_.burst_size();
+    offset_ns_ += mean_gap_ns * static_cast<double>(arrival.count);
+  }
+  return true;
+}
+
+std::string load_generator_t::make_message() {
+  long size;
+  if (spec_.size_distribution() == "uniform") {
+    size = std::uniform_int_distribution<long>(spec_.size_min(),
+                                               spec_.size_max())(rng_);
+  } else {
+    SST_ASSERT((spec_.size_distribution() == "exponential"));
+    double const x = std::exponential_distribution<double>(
+        1 / static_cast<double>(spec_.size_mean()))(rng_);
+    size = std::min(std::max(std::lround(x), spec_.size_min()),
+                    spec_.size_max());
+  }
+  std::string msg = tag();
+  msg += sst::to_string(seq_++);
+  msg += ' ';
+  if (msg.size() < static_cast<std::size_t>(size)) {
+    msg.resize(static_cast<std::size_t>(size), '.');
+  }
+  return msg;
+}
+
+void load_generator_t::on_send(arrival_t const & arrival,
+                               sst::unix_time_ns_t const now,
+                               std::size_t const bytes) {
+  if (arrival.time < window_begin_.load()) {
+    return;
+  }
+  sent_.add();
+  sent_bytes_.add(bytes);
+  send_lag_us_.record(
+      now > arrival.time ?
+          static_cast<std::uint64_t>((now - arrival.time) / 1000) :
+          0);
+}
+
+bool load_generator_t::on_recv(std::string const & msg,
+                               sst::unix_time_us_t const sent,
+                               sst::unix_time_us_t const now) {
+  if (msg.compare(0, std::char_traits<char>::length(tag()), tag())
+      != 0) {
+    return false;
+  }
+  auto const sent_ns = static_cast<sst::unix_time_ns_t>(sent) * 1000;
+  if (sent_ns < window_begin_.load() || sent_ns >= window_end_.load()) {
+    return true;
+  }
+  received_.add();
+  received_bytes_.add(msg.size());
+  latency_us_.record(
+      now > sent ? static_cast<std::uint64_t>(now - sent) : 0);
+  return true;
+}
+
+sst::unix_time_ns_t load_generator_t::drain_until() const {
+  return window_end_.load() + spec_.drain();
+}
+
+json_t load_generator_t::report() const {
+  double const window_s = static_cast<double>(spec_.duration()) / 1e9;
+  auto const per_s = [&](std::uint64_t const n) {
+    return static_cast<double>(n) / window_s;
+  };
+  return {{"spec", spec_},
+          {"sent", sent_.value()},
+          {"sent_bytes", sent_bytes_.value()},
+          {"offered_rate", per_s(sent_.value())},
+          {"send_lag_us", send_lag_us_.to_json()},
+          {"received", received_.value()},
+          {"received_bytes", received_bytes_.value()},
+          {"received_rate", per_s(received_.value())},
+          {"goodput_bps", per_s(received_bytes_.value() * 8)},
+          {"latency_us", latency_us_.to_json()}};
+}
+
+} // namespace kestrel
@@ -0,0 +1,129 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_LOAD_GENERATOR_T_HPP
+#define KESTREL_LOAD_GENERATOR_T_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include <sst/catalog/unix_time_ns_t.hpp>
+#include <sst/catalog/unix_time_us_t.hpp>
+
+#include <kestrel/json_t.hpp>
+#include <kestrel/load_spec_t.hpp>
+#include <kestrel/metrics_t.hpp>
+
+namespace kestrel {
+
+//
+// Drives the open-loop load described by a load_spec_t and keeps score
+// of it. The caller asks next() for each arrival, sends that many
+// make_message() messages, and reports each send with on_send(). The
+// arrival times never depend on how long the sends take, so a system
+// that cannot keep up shows it as send lag and latency instead of as a
+// lower offered rate.
+//
+// Every message starts with tag() and a sequence number. The receive
+// side (on_recv(), fed from engine_t::on_recv_clrmsg) picks out load
+// messages by their tag and measures latency against the send time
+// carried in the ClrMsg itself, so a node counts whatever load reaches
+// it from any sender that runs with the same dawn, warmup, and
+// duration. Only messages sent inside the measurement window count.
+//
+// on_recv() may be called from another thread than the one that calls
+// next(), make_message(), and on_send().
+//
+
+class load_generator_t final {
+
+public:
+
+  struct arrival_t {
+    sst::unix_time_ns_t time;
+    long count;
+  };
+
+  static constexpr char const * tag() noexcept {
+    return "kestrel-load ";
+  }
+
+private:
+
+  load_spec_t const spec_;
+  std::mt19937_64 rng_;
+
+  sst::unix_time_ns_t dawn_ = 0;
+  double offset_ns_ = 0;
+  std::uint64_t seq_ = 0;
+
+  std::atomic<sst::unix_time_ns_t> window_begin_{0};
+  std::atomic<sst::unix_time_ns_t> window_end_{0};
+
+  metric_counter_t sent_;
+  metric_counter_t sent_bytes_;
+  metric_counter_t received_;
+  metric_counter_t received_bytes_;
+  metric_histogram_t send_lag_us_;
+  metric_histogram_t latency_us_;
+
+public:
+
+  explicit load_generator_t(load_spec_t spec, std::uint64_t seed);
+
+  load_generator_t(load_generator_t const &) = delete;
+  load_generator_t & operator=(load_generator_t const &) = delete;
+  load_generator_t(load_generator_t &&) = delete;
+  load_generator_t & operator=(load_generator_t &&) = delete;
+  ~load_generator_t() noexcept = default;
+
+  load_spec_t const & spec() const noexcept {
+    return spec_;
+  }
+
+  // Fixes the time of the first arrival to the spec's dawn, or to now
+  // if the spec has no dawn. Must be called before next().
+  void start(sst::unix_time_ns_t now);
+
+  // Sets arrival to the next arrival and returns true, or returns
+  // false once the load is over.
+  bool next(arrival_t & arrival);
+
+  std::string make_message();
+
+  void on_send(arrival_t const & arrival,
+               sst::unix_time_ns_t now,
+               std::size_t bytes);
+
+  // Returns false if msg is not a load message.
+  bool on_recv(std::string const & msg,
+               sst::unix_time_us_t sent,
+               sst::unix_time_us_t now);
+
+  // When to stop listening for deliveries.
+  sst::unix_time_ns_t drain_until() const;
+
+  json_t report() const;
+};
+
+} // namespace kestrel
+
+#endif // #ifndef KESTREL_LOAD_GENERATOR_T_HPP
@@ -0,0 +1,422 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Include first to test independence.
+#include <kestrel/load_spec_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/load_spec_t.hpp>
+//
+
+#include <string>
+#include <utility>
+
+#include <sst/catalog/SST_ASSERT.hpp>
+#include <sst/catalog/json/exception.hpp>
+#include <sst/catalog/json/remove_to.hpp>
+#include <sst/catalog/json/unknown_key.hpp>
+#include <sst/catalog/to_string.hpp>
+#include <sst/catalog/unix_time_ns_t.hpp>
+
+#include <kestrel/json_t.hpp>
+#include <kestrel/psn_t.hpp>
+
+namespace kestrel {
+
+//----------------------------------------------------------------------
+// arrival
+//----------------------------------------------------------------------
+
+void load_spec_t::parse_arrival(json_t & src, parse_state_t & state) {
+  if (state.called_parse_arrival_) {
+    return;
+  }
+  state.called_parse_arrival_ = true;
+  sst::json::remove_to(src, arrival_, "arrival", default_arrival());
+  if (!(arrival_ == "constant" || arrival_ == "poisson"
+        || arrival_ == "burst")) {
+    throw sst::json::exception(
+        ".arrival must be \"constant\", \"poisson\", or \"burst\"");
+  }
+}
+
+void load_spec_t::unparse_arrival(json_t & dst) const {
+  SST_ASSERT((dst.is_object()));
+  SST_ASSERT((!dst.contains("arrival")));
+  dst["arrival"] = arrival();
+}
+
+std::string const & load_spec_t::arrival() const {
+  return arrival_;
+}
+
+//----------------------------------------------------------------------
+// burst_size
+//----------------------------------------------------------------------
+
+void load_spec_t::parse_burst_size(json_t & src,
+                                   parse_state_t & state) {
+  if (state.called_parse_burst_size_) {
+    return;
+  }
+  state.called_parse_burst_size_ = true;
+  sst::json::remove_to(src,
+                       burst_size_,
+                       "burst_size",
+                       default_burst_size());
+  if (!(burst_size_ > 0)) {
+    throw sst::json::exception(".burst_size must be positive");
+  }
+}
+
+void load_spec_t::unparse_burst_size(json_t & dst) const {
+  SST_ASSERT((dst.is_object()));
+  SST_ASSERT((!dst.contains("burst_size")));
+  dst["burst_size"] = sst::to_string(burst_size());
+}
+
+long load_spec_t::burst_size() const {
+  return burst_size_;
+}
+
+//----------------------------------------------------------------------
+// dawn
+//----------------------------------------------------------------------
+
+void load_spec_t::parse_dawn(json_t & src, parse_state_t & state) {
+  if (state.called_parse_dawn_) {
+    return;
+  }
+  state.called_parse_dawn_ = true;
+  sst::json::remove_to(src, dawn_, "dawn", default_dawn());
+}
+
+void load_spec_t::unparse_dawn(json_t & dst) const {
+  SST_ASSERT((dst.is_object()));
+  SST_ASSERT((!dst.contains("dawn")));
+  dst["dawn"] = sst::to_string(dawn());
+}
+
+sst::unix_time_ns_t load_spec_t::dawn() const {
+  return dawn_;
+}
+
+//----------------------------------------------------------------------
+// drain
+//----------------------------------------------------------------------
+
+void load_spec_t::parse_drain(json_t & src, parse_state_t & state) {
+  if (state.called_parse_drain_) {
+    return;
+  }
+  state.called_parse_drain_ = true;
+  sst::json::remove_to(src, drain_, "drain", default_drain());
+  if (!(drain_ >= 0)) {
+    throw sst::json::exception(".drain must be nonnegative");
+  }
+}
+
+void load_spec_t::unparse_drain(json_t & dst) const {
+  SST_ASSERT((dst.is_object()));
+  SST_ASSERT((!dst.contains("drain")));
+  dst["drain"] = sst::to_string(drain());
+}
+
+sst::unix_time_ns_t load_spec_t::drain() const {
+  return drain_;
+}
+
+//----------------------------------------------------------------------
+// duration
+//----------------------------------------------------------------------
+
+void load_spec_t::parse_duration(json_t & src, parse_state_t & state) {
+  if (state.called_parse_duration_) {
+    return;
+  }
+  state.called_parse_duration_ = true;
+  sst::json::remove_to(src, duration_, "duration", default_duration());
+  if (!(duration_ > 0)) {
+    throw sst::json::exception(".duration must be positive");
+  }
+}
+
+void load_spec_t::unparse_duration(json_t & dst) const {
+  SST_ASSERT((dst.is_object()));
+  SST_ASSERT((!dst.contains("duration")));
+  dst["duration"] = sst::to_string(duration());
+}
+
+sst::unix_time_ns_t load_spec_t::duration() const {
+  return duration_;
+}
+
+//----------------------------------------------------------------------
+// rate
+//----------------------------------------------------------------------
+
+void load_spec_t::parse_rate(json_t & src, parse_state_t & state) {
+  if (state.called_parse_rate_) {
+    return;
+  }
+  state.called_parse_rate_ = true;
+  sst::json::remove_to(src, rate_, "rate", default_rate());
+  if (!(rate_ > 0)) {
+    throw sst::json::exception(".rate must be positive");
+  }
+}
+
+void load_spec_t::unparse_rate(json_t & dst) const {
+  SST_ASSERT((dst.is_object()));
+  SST_ASSERT((!dst.contains("rate")));
+  dst["rate"] = rate();
+}
+
+double load_spec_t::rate() const {
+  return rate_;
+}
+
+//----------------------------------------------------------------------
+// receiver
+//----------------------------------------------------------------------
+
+void load_spec_t::parse_receiver(json_t & src, parse_state_t & state) {
+  if (state.called_parse_receiver_) {
+    return;
+  }
+  state.called_parse_receiver_ = true;
+  sst::json::remove_to(src, receiver_slug_, "receiver", "*");
+  receiver_.emplace(psn_t::from_path_slug(receiver_slug_));
+}
+
+void load_spec_t::unparse_receiver(json_t & dst) const {
+  SST_ASSERT((dst.is_object()));
+  SST_ASSERT((!dst.contains("receiver")));
+  dst["receiver"] = receiver_slug();
+}
+
+std::string const & load_spec_t::receiver_slug() const {
+  return receiver_slug_;
+}
+
+psn_t const & load_spec_t::receiver() const {
+  SST_ASSERT((receiver_));
+  return *receiver_;
+}
+
+//----------------------------------------------------------------------
+// size_distribution
+//----------------------------------------------------------------------
+
+void load_spec_t::parse_size_distribution(json_t & src,
+                                          parse_state_t & state) {
+  if (state.called_parse_size_distribution_) {
+    return;
+  }
+  state.called_parse_size_distribution_ = true;
+  sst::json::remove_to(src,
+                       size_distribution_,
+                       "size_distribution",
+                       default_size_distribution());
+  if (!(size_distribution_ == "uniform"
+        || size_distribution_ == "exponential")) {
+    throw sst::json::exception(
+        ".size_distribution must be \"uniform\" or \"exponential\"");
+  }
+}
+
+void load_spec_t::unparse_size_distribution(json_t & dst) const {
+  SST_ASSERT((dst.is_object()));
+  SST_ASSERT((!dst.contains("size_distribution")));
+  dst["size_distribution"] = size_distribution();
+}
+
+std::string const & load_spec_t::size_distribution() const {
+  return size_distribution_;
+}
+
+//----------------------------------------------------------------------
+// size_max
+//----------------------------------------------------------------------
+
+void load_spec_t::parse_size_max(json_t & src, parse_state_t & state) {
+  if (state.called_parse_size_max_) {
+    return;
+  }
+  state.called_parse_size_max_ = true;
+  sst::json::remove_to(src, size_max_, "size_max", default_size_max());
+  if (!(size_max_ >= 0)) {
+    throw sst::json::exception(".size_max must be nonnegative");
+  }
+}
+
+void load_spec_t::unparse_size_max(json_t & dst) const {
+  SST_ASSERT((dst.is_object()));
+  SST_ASSERT((!dst.contains("size_max")));
+  dst["size_max"] = sst::to_string(size_max());
+}
+
+long load_spec_t::size_max() const {
+  return size_max_;
+}
+
+//----------------------------------------------------------------------
+// size_mean
+//----------------------------------------------------------------------
+
+void load_spec_t::parse_size_mean(json_t & src, parse_state_t & state) {
+  if (state.called_parse_size_mean_) {
+    return;
+  }
+  state.called_parse_size_mean_ = true;
+  sst::json::remove_to(src,
+                       size_mean_,
+                       "size_mean",
+                       default_size_mean());
+  if (!(size_mean_ > 0)) {
+    throw sst::json::exception(".size_mean must be positive");
+  }
+}
+
+void load_spec_t::unparse_size_mean(json_t & dst) const {
+  SST_ASSERT((dst.is_object()));
+  SST_ASSERT((!dst.contains("size_mean")));
+  dst["size_mean"] = sst::to_string(size_mean());
+}
+
+long load_spec_t::size_mean() const {
+  return size_mean_;
+}
+
+//----------------------------------------------------------------------
+// size_min
+//----------------------------------------------------------------------
+
+void load_spec_t::parse_size_min(json_t & src, parse_state_t & state) {
+  if (state.called_parse_size_min_) {
+    return;
+  }
+  state.called_parse_size_min_ = true;
+  sst::json::remove_to(src, size_min_, "size_min", default_size_min());
+  if (!(size_min_ >= 0)) {
+    throw sst::json::exception(".size_min must be nonnegative");
+  }
+}
+
+void load_spec_t::unparse_size_min(json_t & dst) const {
+  SST_ASSERT((dst.is_object()));
+  SST_ASSERT((!dst.contains("size_min")));
+  dst["size_min"] = sst::to_string(size_min());
+}
+
+long load_spec_t::size_min() const {
+  return size_min_;
+}
+
+//----------------------------------------------------------------------
+// warmup
+//----------------------------------------------------------------------
+
+void load_spec_t::parse_warmup(json_t & src, parse_state_t & state) {
+  if (state.called_parse_warmup_) {
+    return;
+  }
+  state.called_parse_warmup_ = true;
+  sst::json::remove_to(src, warmup_, "warmup", default_warmup());
+  if (!(warmup_ >= 0)) {
+    throw sst::json::exception(".warmup must be nonnegative");
+  }
+}
+
+void load_spec_t::unparse_warmup(json_t & dst) const {
+  SST_ASSERT((dst.is_object()));
+  SST_ASSERT((!dst.contains("warmup")));
+  dst["warmup"] = sst::to_string(warmup());
+}
+
+sst::unix_time_ns_t load_spec_t::warmup() const {
+  return warmup_;
+}
+//----------------------------------------------------------------------
+// JSON conversions
+//----------------------------------------------------------------------
+
+void from_json(json_t src, load_spec_t & dst) {
+
+  load_spec_t tmp;
+  load_spec_t::parse_state_t state;
+
+  tmp.parse_arrival(src, state);
+  tmp.parse_burst_size(src, state);
+  tmp.parse_dawn(src, state);
+  tmp.parse_drain(src, state);
+  tmp.parse_duration(src, state);
+  tmp.parse_rate(src, state);
+  tmp.parse_receiver(src, state);
+  tmp.parse_size_distribution(src, state);
+  tmp.parse_size_max(src, state);
+  tmp.parse_size_mean(src, state);
+  tmp.parse_size_min(src, state);
+  tmp.parse_warmup(src, state);
+
+  SST_ASSERT((state.called_parse_arrival_));
+  SST_ASSERT((state.called_parse_burst_size_));
+  SST_ASSERT((state.called_parse_dawn_));
+  SST_ASSERT((state.called_parse_drain_));
+  SST_ASSERT((state.called_parse_duration_));
+  SST_ASSERT((state.called_parse_rate_));
+  SST_ASSERT((state.called_parse_receiver_));
+  SST_ASSERT((state.called_parse_size_distribution_));
+  SST_ASSERT((state.called_parse_size_max_));
+  SST_ASSERT((state.called_parse_size_mean_));
+  SST_ASSERT((state.called_parse_size_min_));
+  SST_ASSERT((state.called_parse_warmup_));
+
+  if (tmp.size_max_ < tmp.size_min_) {
+    throw sst::json::exception(
+        ".size_max must be greater than or equal to .size_min");
+  }
+
+  sst::json::unknown_key(src);
+
+  dst = std::move(tmp);
+
+} //
+
+void to_json(json_t & dst, load_spec_t const & src) {
+
+  json_t tmp = json_t::object();
+
+  src.unparse_arrival(tmp);
+  src.unparse_burst_size(tmp);
+  src.unparse_dawn(tmp);
+  src.unparse_drain(tmp);
+  src.unparse_duration(tmp);
+  src.unparse_rate(tmp);
+  src.unparse_receiver(tmp);
+  src.unparse_size_distribution(tmp);
+  src.unparse_size_max(tmp);
+  src.unparse_size_mean(tmp);
+  src.unparse_size_min(tmp);
+  src.unparse_warmup(tmp);
+
+  dst = std::move(tmp);
+
+} //
+
+//----------------------------------------------------------------------
+
+} // namespace kestrel
@@ -0,0 +1,352 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_LOAD_SPEC_T_HPP
+#define KESTREL_LOAD_SPEC_T_HPP
+
+#include <string>
+
+#include <sst/catalog/SST_NODISCARD.hpp>
+#include <sst/catalog/SST_NOEXCEPT.hpp>
+#include <sst/catalog/unique_ptr.hpp>
+#include <sst/catalog/unix_time_ns_t.hpp>
+
+#include <kestrel/json_t.hpp>
+#include <kestrel/psn_t.hpp>
+
+namespace kestrel {
+
+//
+// An open-loop load to generate from one node. Messages are sent at an
+// average of rate messages per second from dawn (or from startup if
+// dawn is zero) until dawn + warmup + duration, with arrivals that are
+// evenly spaced ("constant"), exponentially spaced ("poisson"), or
+// grouped into evenly spaced bursts of burst_size messages ("burst").
+// Only messages sent after the warmup are counted, and drain is how
+// long to keep listening for deliveries after the last send. All times
+// are in nanoseconds.
+//
+// Message sizes are in bytes, either uniform on [size_min, size_max]
+// or exponential with mean size_mean, clamped to [size_min, size_max].
+//
+
+class load_spec_t final {
+
+  //--------------------------------------------------------------------
+  // Default operations
+  //--------------------------------------------------------------------
+
+public:
+
+  load_spec_t() SST_NOEXCEPT(true) = default;
+
+  ~load_spec_t() SST_NOEXCEPT(true) = default;
+
+  load_spec_t(load_spec_t const &) = default;
+
+  load_spec_t & operator=(load_spec_t const &) = default;
+
+  load_spec_t(load_spec_t &&) SST_NOEXCEPT(true) = default;
+
+  load_spec_t & operator=(load_spec_t &&) SST_NOEXCEPT(true) = default;
+
+  //--------------------------------------------------------------------
+  // parse_state_t
+  //--------------------------------------------------------------------
+  //
+  // Keeps track of which parse_*() functions have already been called
+  // during a from_json() call.
+  //
+
+private:
+
+  struct parse_state_t {
+    bool called_parse_arrival_ = false;
+    bool called_parse_burst_size_ = false;
+    bool called_parse_dawn_ = false;
+    bool called_parse_drain_ = false;
+    bool called_parse_duration_ = false;
+    bool called_parse_rate_ = false;
+    bool called_parse_receiver_ = false;
+    bool called_parse_size_distribution_ = false;
+    bool called_parse_size_max_ = false;
+    bool called_parse_size_mean_ = false;
+    bool called_parse_size_min_ = false;
+    bool called_parse_warmup_ = false;  };
+
+  //--------------------------------------------------------------------
+  // arrival
+  //--------------------------------------------------------------------
+
+private:
+
+  static std::string default_arrival() {
+    return std::string("poisson");
+  }
+
+  std::string arrival_ = default_arrival();
+
+  void parse_arrival(json_t & src, parse_state_t & state);
+
+  void unparse_arrival(json_t & dst) const;
+
+public:
+
+  SST_NODISCARD() std::string const & arrival() const;
+
+  //--------------------------------------------------------------------
+  // burst_size
+  //--------------------------------------------------------------------
+
+private:
+
+  static constexpr long default_burst_size() SST_NOEXCEPT(true) {
+    return 10L;
+  }
+
+  long burst_size_ = default_burst_size();
+
+  void parse_burst_size(json_t & src, parse_state_t & state);
+
+  void unparse_burst_size(json_t & dst) const;
+
+public:
+
+  SST_NODISCARD() long burst_size() const;
+
+  //--------------------------------------------------------------------
+  // dawn
+  //--------------------------------------------------------------------
+
+private:
+
+  static constexpr sst::unix_time_ns_t default_dawn()
+      SST_NOEXCEPT(true) {
+    return static_cast<sst::unix_time_ns_t>(0);
+  }
+
+  sst::unix_time_ns_t dawn_ = default_dawn();
+
+  void parse_dawn(json_t & src, parse_state_t & state);
+
+  void unparse_dawn(json_t & dst) const;
+
+public:
+
+  SST_NODISCARD() sst::unix_time_ns_t dawn() const;
+
+  //--------------------------------------------------------------------
+  // drain
+  //--------------------------------------------------------------------
+
+private:
+
+  static constexpr sst::unix_time_ns_t default_drain()
+      SST_NOEXCEPT(true) {
+    return static_cast<sst::unix_time_ns_t>(10000000000);
+  }
+
+  sst::unix_time_ns_t drain_ = default_drain();
+
+  void parse_drain(json_t & src, parse_state_t & state);
+
+  void unparse_drain(json_t & dst) const;
+
+public:
+
+  SST_NODISCARD() sst::unix_time_ns_t drain() const;
+
+  //--------------------------------------------------------------------
+  // duration
+  //--------------------------------------------------------------------
+
+private:
+
+  static constexpr sst::unix_time_ns_t default_duration()
+      SST_NOEXCEPT(true) {
+    return static_cast<sst::unix_time_ns_t>(60000000000);
+  }
+
+  sst::unix_time_ns_t duration_ = default_duration();
+
+  void parse_duration(json_t & src, parse_state_t & state);
+
+  void unparse_duration(json_t & dst) const;
+
+public:
+
+  SST_NODISCARD() sst::unix_time_ns_t duration() const;
+
+  //--------------------------------------------------------------------
+  // rate
+  //--------------------------------------------------------------------
+
+private:
+
+  static constexpr double default_rate() SST_NOEXCEPT(true) {
+    return 1.0;
+  }
+
+  double rate_ = default_rate();
+
+  void parse_rate(json_t & src, parse_state_t & state);
+
+  void unparse_rate(json_t & dst) const;
+
+public:
+
+  SST_NODISCARD() double rate() const;
+
+  //--------------------------------------------------------------------
+  // receiver
+  //--------------------------------------------------------------------
+
+private:
+
+  std::string receiver_slug_ = "*";
+
+  sst::unique_ptr<psn_t> receiver_;
+
+  void parse_receiver(json_t & src, parse_state_t & state);
+
+  void unparse_receiver(json_t & dst) const;
+
+public:
+
+  // The slug of the persona to send to, or "*" to pick a random
+  // client other than ourselves for each message.
+  SST_NODISCARD() std::string const & receiver_slug() const;
+
+  SST_NODISCARD() psn_t const & receiver() const;
+
+  //--------------------------------------------------------------------
+  // size_distribution
+  //--------------------------------------------------------------------
+
+private:
+
+  static std::string default_size_distribution() {
+    return std::string("uniform");
+  }
+
+  std::string size_distribution_ = default_size_distribution();
+
+  void parse_size_distribution(json_t & src, parse_state_t & state);
+
+  void unparse_size_distribution(json_t & dst) const;
+
+public:
+
+  SST_NODISCARD() std::string const & size_distribution() const;
+
+  //--------------------------------------------------------------------
+  // size_max
+  //--------------------------------------------------------------------
+
+private:
+
+  static constexpr long default_size_max() SST_NOEXCEPT(true) {
+    return 64L;
+  }
+
+  long size_max_ = default_size_max();
+
+  void parse_size_max(json_t & src, parse_state_t & state);
+
+  void unparse_size_max(json_t & dst) const;
+
+public:
+
+  SST_NODISCARD() long size_max() const;
+
+  //--------------------------------------------------------------------
+  // size_mean
+  //--------------------------------------------------------------------
+
+private:
+
+  static constexpr long default_size_mean() SST_NOEXCEPT(true) {
+    return 64L;
+  }
+
+  long size_mean_ = default_size_mean();
+
+  void parse_size_mean(json_t & src, parse_state_t & state);
+
+  void unparse_size_mean(json_t & dst) const;
+
+public:
+
+  SST_NODISCARD() long size_mean() const;
+
+  //--------------------------------------------------------------------
+  // size_min
+  //--------------------------------------------------------------------
+
+private:
+
+  static constexpr long default_size_min() SST_NOEXCEPT(true) {
+    return 64L;
+  }
+
+  long size_min_ = default_size_min();
+
+  void parse_size_min(json_t & src, parse_state_t & state);
+
+  void unparse_size_min(json_t & dst) const;
+
+public:
+
+  SST_NODISCARD() long size_min() const;
+
+  //--------------------------------------------------------------------
+  // warmup
+  //--------------------------------------------------------------------
+
+private:
+
+  static constexpr sst::unix_time_ns_t default_warmup()
+      SST_NOEXCEPT(true) {
+    return static_cast<sst::unix_time_ns_t>(0);
+  }
+
+  sst::unix_time_ns_t warmup_ = default_warmup();
+
+  void parse_warmup(json_t & src, parse_state_t & state);
+
+  void unparse_warmup(json_t & dst) const;
+
+public:
+
+  SST_NODISCARD() sst::unix_time_ns_t warmup() const;
+  //--------------------------------------------------------------------
+  // JSON conversions
+  //--------------------------------------------------------------------
+
+public:
+
+  friend void from_json(json_t src, load_spec_t & dst);
+
+  friend void to_json(json_t & dst, load_spec_t const & src);
+
+  //--------------------------------------------------------------------
+};
+
+} // namespace kestrel
+
+#endif // #ifndef KESTREL_LOAD_SPEC_T_HPP
@@ -0,0 +1,187 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/log_sink_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/log_sink_t.hpp>
+//
+
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <RaceLog.h>
+
+#include <kestrel/json_t.hpp>
+#include <kestrel/tracing_event_t.hpp>
+
+namespace kestrel {
+
+log_sink_t & log_sink_t::instance() {
+  static log_sink_t * const sink = new log_sink_t();
+  return *sink;
+}
+
+std::string log_sink_t::format(tracing_event_t const & tev) {
+  std::string message = "carma_tracing_event: ";
+  json_t const * const json = tev.json();
+  if (json == nullptr) {
+    message += "{}";
+  } else {
+    message +=
+        json->dump(-1, ' ', true, json_t::error_handler_t::replace);
+  }
+  message += " js\\on";
+  return message;
+}
+
+void log_sink_t::emit(record_t & record) noexcept {
+  try {
+    if (record.tev) {
+      record.message = format(*record.tev);
+    }
+    RaceLog::log(record.level,
+                 record.plugin_name,
+                 record.message,
+                 record.trace);
+  } catch (...) {
+  }
+}
+
+void log_sink_t::thread_function() noexcept {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    ready_.wait(lock, [&] { return stop_ || size_ != 0; });
+    if (size_ == 0) {
+      return;
+    }
+    record_t record = std::move(ring_[head_]);
+    ring_[head_].tev.reset();
+    head_ = (head_ + 1) % ring_.size();
+    --size_;
+    lock.unlock();
+    emit(record);
+    lock.lock();
+    ++written_;
+    space_.notify_all();
+  }
+}
+
+void log_sink_t::async(std::size_t const capacity) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  bool const running = thread_.joinable();
+  if (running == (capacity > 0) && capacity == ring_.size()) {
+    return;
+  }
+  async_.store(false);
+  if (thread_.joinable()) {
+    stop_ = true;
+    ready_.notify_one();
+    lock.unlock();
+    thread_.join();
+    lock.lock();
+  }
+  ring_.clear();
+  ring_.shrink_to_fit();
+  head_ = 0;
+  size_ = 0;
+  stop_ = false;
+  if (capacity > 0) {
+    static bool const registered = [] {
+      return std::atexit([] { log_sink_t::instance().flush(); }) == 0;
+    }();
+    static_cast<void>(registered);
+    ring_.resize(capacity);
+    thread_ = std::thread([this] { thread_function(); });
+    async_.store(true);
+  }
+}
+
+void log_sink_t::write(record_t && record) {
+  if (async_.load()) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool const error = record.level >= RaceLog::LL_ERROR;
+    if (error) {
+      space_.wait(lock, [&] {
+        return stop_ || ring_.empty() || size_ < ring_.size();
+      });
+    }
+    if (!stop_ && !ring_.empty()) {
+      if (size_ == ring_.size()) {
+        ++dropped_;
+        return;
+      }
+      ring_[(head_ + size_) % ring_.size()] = std::move(record);
+      ++size_;
+      if (size_ > max_depth_) {
+        max_depth_ = size_;
+      }
+      auto const sequence = ++enqueued_;
+      ready_.notify_one();
+      if (error) {
+        space_.wait(lock, [&] { return written_ >= sequence; });
+      }
+      return;
+    }
+  }
+  emit(record);
+}
+
+void log_sink_t::write(RaceLog::LogLevel const level,
+                       std::string const & plugin_name,
+                       std::string const & message,
+                       std::string const & trace) {
+  record_t record;
+  record.level = level;
+  record.plugin_name = plugin_name;
+  record.message = message;
+  record.trace = trace;
+  write(std::move(record));
+}
+
+void log_sink_t::write(RaceLog::LogLevel const level,
+                       std::string const & plugin_name,
+                       tracing_event_t && tev) {
+  record_t record;
+  record.level = level;
+  record.plugin_name = plugin_name;
+  record.tev.emplace(std::move(tev));
+  write(std::move(record));
+}
+
+void log_sink_t::flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto const sequence = enqueued_;
+  space_.wait(lock, [&] { return stop_ || written_ >= sequence; });
+}
+
+log_sink_stats_t log_sink_t::stats() {
+  std::lock_guard<std::mutex> const lock(mutex_);
+  log_sink_stats_t s;
+  s.written = written_;
+  s.dropped = dropped_;
+  s.depth = size_;
+  s.max_depth = max_depth_;
+  return s;
+}
+
+} // namespace kestrel
@@ -0,0 +1,131 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_LOG_SINK_T_HPP
+#define KESTREL_LOG_SINK_T_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sst/catalog/optional.hpp>
+
+#include <RaceLog.h>
+
+#include <kestrel/tracing_event_t.hpp>
+
+namespace kestrel {
+
+struct log_sink_stats_t final {
+  std::uint64_t written = 0;
+  std::uint64_t dropped = 0;
+  std::uint64_t depth = 0;
+  std::uint64_t max_depth = 0;
+};
+
+//
+// The process-wide destination of all common_sdk_t log messages.
+//
+// By default, write() formats each message and calls RaceLog::log on
+// the caller's thread. After async(n) with n > 0, write() instead
+// moves the message into a ring of n records and returns, and a
+// background thread formats and writes the records in order. Tracing
+// events are moved into the ring as is, so their JSON is only dumped
+// on the background thread.
+//
+// If the ring is full, messages below RaceLog::LL_ERROR are dropped
+// and counted. Error messages wait for space, and then wait until
+// they have been written, so that they are not lost if the process
+// dies right after.
+//
+
+class log_sink_t final {
+
+  struct record_t final {
+    RaceLog::LogLevel level = RaceLog::LL_DEBUG;
+    std::string plugin_name;
+    std::string message;
+    std::string trace;
+    sst::optional<tracing_event_t> tev;
+  };
+
+  std::atomic<bool> async_{false};
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::condition_variable space_;
+  std::vector<record_t> ring_;
+  std::size_t head_ = 0;
+  std::size_t size_ = 0;
+  std::uint64_t enqueued_ = 0;
+  std::uint64_t written_ = 0;
+  std::uint64_t dropped_ = 0;
+  std::uint64_t max_depth_ = 0;
+  bool stop_ = false;
+  std::thread thread_;
+
+  static void emit(record_t & record) noexcept;
+
+  void thread_function() noexcept;
+
+  void write(record_t && record);
+
+  log_sink_t() = default;
+
+  ~log_sink_t() noexcept = default;
+
+public:
+
+  log_sink_t(log_sink_t const &) = delete;
+  log_sink_t & operator=(log_sink_t const &) = delete;
+  log_sink_t(log_sink_t &&) = delete;
+  log_sink_t & operator=(log_sink_t &&) = delete;
+
+  static log_sink_t & instance();
+
+  // Returns the text that is logged for a tracing event.
+  static std::string format(tracing_event_t const & tev);
+
+  // Switches to asynchronous writing with a ring of capacity records,
+  // or back to synchronous writing if capacity is 0. Any records still
+  // in the old ring are written first.
+  void async(std::size_t capacity);
+
+  void write(RaceLog::LogLevel level,
+             std::string const & plugin_name,
+             std::string const & message,
+             std::string const & trace);
+
+  void write(RaceLog::LogLevel level,
+             std::string const & plugin_name,
+             tracing_event_t && tev);
+
+  // Blocks until every record written so far has been output.
+  void flush();
+
+  log_sink_stats_t stats();
+};
+
+} // namespace kestrel
+
+#endif // #ifndef KESTREL_LOG_SINK_T_HPP
@@ -60,6 +60,17 @@ enum : log_level_t {
     }                                                                  \
   }())
 
+//----------------------------------------------------------------------
+//
+// KESTREL_SHOULD_LOG is true if a message at the given level would be
+// logged. Use it to skip building a log line that would not print. Do
+// not use it to skip SST_TEV_ADD fields, as every later log call on the
+// same event carries them, including errors.
+//
+
+#define KESTREL_SHOULD_LOG(sdk, level, sublevel)                       \
+  ((sdk).should_log((level), (sublevel)).first)
+
 //----------------------------------------------------------------------
 
 #define KESTREL_TRACE_2(sdk, message)                                  \
@@ -106,6 +106,21 @@ struct mb_mc_up_packet_t final : origin_handle_t, origin_span_t {
     return src;
   }
 
+  //--------------------------------------------------------------------
+  // Pooling
+  //--------------------------------------------------------------------
+  //
+  // Resets everything but z, whose bigints keep their storage for
+  // from_bytes to overwrite.
+  //
+
+  void pool_reset() {
+    std::vector<sst::bigint> x;
+    x.swap(z);
+    *this = mb_mc_up_packet_t();
+    z.swap(x);
+  }
+
   //--------------------------------------------------------------------
 };
 
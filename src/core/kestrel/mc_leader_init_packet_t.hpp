@@ -38,6 +38,7 @@
 #include <sst/catalog/checked.hpp>
 #include <sst/catalog/perfect_ge.hpp>
 #include <sst/catalog/old/to_bytes.hpp>
+#include <stdexcept>
 #include <vector>
 
 namespace kestrel {
@@ -48,6 +49,10 @@ struct mc_leader_init_packet_t : origin_handle_t, origin_span_t {
   std::vector<guid_t> cids;
   decltype(std::declval<old_config_t>().mixsize) mixsize;
 
+  // The number of dummy up packets that pad the batch. They occupy
+  // the last dummies slots of cids, and the leader sends them itself.
+  decltype(mixsize) dummies = 0;
+
   //--------------------------------------------------------------------
   // Serialization
   //--------------------------------------------------------------------
@@ -60,6 +65,7 @@ struct mc_leader_init_packet_t : origin_handle_t, origin_span_t {
     n += type.to_bytes_size<Size>();
 
     n += mpcid.to_bytes_size<Size>();
+    n += 4;
     n += sst::checked(cids.size())
          * cids[0].template to_bytes_size<Size>();
     return n.value();
@@ -70,6 +76,11 @@ struct mc_leader_init_packet_t : origin_handle_t, origin_span_t {
     SST_ASSERT((type == packet_type_t::mc_leader_init_packet()));
     dst = type.to_bytes(dst);
     dst = mpcid.to_bytes(dst);
+    SST_ASSERT((dummies <= cids.size()));
+    dst = sst::old::to_bytes(dummies,
+                             dst,
+                             4,
+                             sst::integer_rep::pure_unsigned());
     for (auto const & cid : cids) {
       dst = cid.to_bytes(dst);
     }
@@ -95,6 +106,15 @@ struct mc_leader_init_packet_t : origin_handle_t, origin_span_t {
     SST_ASSERT((type == packet_type_t::mc_leader_init_packet()));
 
     src = mpcid.from_bytes(src, avail);
+    dummies = sst::old::from_bytes<decltype(dummies)>(
+        &src,
+        4,
+        avail,
+        sst::integer_rep::pure_unsigned());
+    if (dummies > mixsize) {
+      throw std::runtime_error("mc_leader_init_packet_t: too many "
+                               "dummies");
+    }
     sst::checked_resize(cids, mixsize);
     for (auto & cid : cids) {
       src = cid.from_bytes(src, avail);
@@ -107,6 +107,21 @@ struct mc_v_packet_t final : origin_handle_t, origin_span_t {
     return src;
   }
 
+  //--------------------------------------------------------------------
+  // Pooling
+  //--------------------------------------------------------------------
+  //
+  // Resets everything but v, whose bigints keep their storage for
+  // from_bytes to overwrite.
+  //
+
+  void pool_reset() {
+    std::vector<sst::bigint> x;
+    x.swap(v);
+    *this = mc_v_packet_t();
+    v.swap(x);
+  }
+
   //--------------------------------------------------------------------
 };
 
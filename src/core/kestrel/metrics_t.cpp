@@ -0,0 +1,122 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/metrics_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/metrics_t.hpp>
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <kestrel/json_t.hpp>
+
+namespace kestrel {
+
+constexpr unsigned int metric_histogram_t::sub_bits;
+constexpr std::size_t metric_histogram_t::sub_count;
+constexpr std::size_t metric_histogram_t::bucket_count;
+
+std::uint64_t metric_histogram_t::quantile(double q) const noexcept {
+  std::uint64_t const n = count();
+  if (n == 0) {
+    return 0;
+  }
+  if (q < 0) {
+    q = 0;
+  } else if (q > 1) {
+    q = 1;
+  }
+  auto rank = static_cast<std::uint64_t>(q * static_cast<double>(n));
+  if (rank == 0) {
+    rank = 1;
+  }
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i != bucket_count; ++i) {
+    seen += buckets_[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      std::uint64_t const top =
+          i + 1 == bucket_count ? max() : bucket_min(i + 1) - 1;
+      return top < max() ? top : max();
+    }
+  }
+  return max();
+}
+
+json_t metric_histogram_t::to_json() const {
+  return {{"count", count()},
+          {"sum", sum()},
+          {"max", max()},
+          {"p50", quantile(0.5)},
+          {"p90", quantile(0.9)},
+          {"p99", quantile(0.99)},
+          {"p999", quantile(0.999)}};
+}
+
+metric_counter_t & metrics_t::counter(std::string const & name) {
+  std::lock_guard<std::mutex> const lock(mutex_);
+  auto & p = counters_[name];
+  if (p == nullptr) {
+    p.reset(new metric_counter_t());
+  }
+  return *p;
+}
+
+metric_gauge_t & metrics_t::gauge(std::string const & name) {
+  std::lock_guard<std::mutex> const lock(mutex_);
+  auto & p = gauges_[name];
+  if (p == nullptr) {
+    p.reset(new metric_gauge_t());
+  }
+  return *p;
+}
+
+metric_histogram_t & metrics_t::histogram(std::string const & name) {
+  std::lock_guard<std::mutex> const lock(mutex_);
+  auto & p = histograms_[name];
+  if (p == nullptr) {
+    p.reset(new metric_histogram_t());
+  }
+  return *p;
+}
+
+json_t metrics_t::to_json() const {
+  std::lock_guard<std::mutex> const lock(mutex_);
+  json_t counters = json_t::object();
+  for (auto const & kv : counters_) {
+    counters[kv.first] = kv.second->value();
+  }
+  json_t gauges = json_t::object();
+  for (auto const & kv : gauges_) {
+    gauges[kv.first] = kv.second->value();
+  }
+  json_t histograms = json_t::object();
+  for (auto const & kv : histograms_) {
+    histograms[kv.first] = kv.second->to_json();
+  }
+  return {{"counters", std::move(counters)},
+          {"gauges", std::move(gauges)},
+          {"histograms", std::move(histograms)}};
+}
+
+} // namespace kestrel
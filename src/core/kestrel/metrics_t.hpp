@@ -0,0 +1,213 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_METRICS_T_HPP
+#define KESTREL_METRICS_T_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <sst/catalog/mono_time_ns.hpp>
+
+#include <kestrel/json_t.hpp>
+
+namespace kestrel {
+
+//----------------------------------------------------------------------
+// Metrics
+//----------------------------------------------------------------------
+//
+// Counters, gauges, and histograms are updated with relaxed atomics
+// only, so they can be updated from any thread without locking. A
+// metrics_t registry hands out references to them by name. Looking up
+// a name takes a mutex, so callers on hot paths should look a metric
+// up once and keep the reference, which stays valid for the lifetime
+// of the registry.
+//
+
+class metric_counter_t final {
+  std::atomic<std::uint64_t> value_{0};
+
+public:
+  void add(std::uint64_t const n = 1) noexcept {
+    value_.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  std::uint64_t value() const noexcept {
+    return value_.load(std::memory_order_relaxed);
+  }
+};
+
+class metric_gauge_t final {
+  std::atomic<std::int64_t> value_{0};
+
+public:
+  void set(std::int64_t const x) noexcept {
+    value_.store(x, std::memory_order_relaxed);
+  }
+
+  void add(std::int64_t const x) noexcept {
+    value_.fetch_add(x, std::memory_order_relaxed);
+  }
+
+  std::int64_t value() const noexcept {
+    return value_.load(std::memory_order_relaxed);
+  }
+};
+
+//
+// A log-linear histogram of nonnegative integers in the style of HDR
+// histograms. Values below 2^sub_bits get their own buckets. Above
+// that, each power of two is split into 2^sub_bits equal buckets, so a
+// value is known to within a relative error of 2^-sub_bits. Memory is
+// fixed and recording is a handful of atomic adds.
+//
+
+class metric_histogram_t final {
+public:
+  static constexpr unsigned int sub_bits = 3;
+  static constexpr std::size_t sub_count = std::size_t(1) << sub_bits;
+  static constexpr std::size_t bucket_count =
+      (64 - sub_bits + 1) * sub_count;
+
+  static std::size_t bucket(std::uint64_t const x) noexcept {
+    if (x < sub_count) {
+      return static_cast<std::size_t>(x);
+    }
+    unsigned int e = 0;
+    for (unsigned int k = 32; k != 0; k /= 2) {
+      if ((x >> (e + k)) != 0) {
+        e += k;
+      }
+    }
+    unsigned int const shift = e - sub_bits;
+    return (shift + 1) * sub_count
+           + static_cast<std::size_t>(x >> shift) - sub_count;
+  }
+
+  // Returns the smallest value that falls in bucket i.
+  static std::uint64_t bucket_min(std::size_t const i) noexcept {
+    std::size_t const block = i / sub_count;
+    std::uint64_t const m = i % sub_count;
+    if (block == 0) {
+      return m;
+    }
+    return (sub_count + m) << (block - 1);
+  }
+
+private:
+  std::array<std::atomic<std::uint64_t>, bucket_count> buckets_{};
+  std::atomic<std::uint64_t> count_{0};
+  std::atomic<std::uint64_t> sum_{0};
+  std::atomic<std::uint64_t> max_{0};
+
+public:
+  void record(std::uint64_t const x) noexcept {
+    buckets_[bucket(x)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(x, std::memory_order_relaxed);
+    auto y = max_.load(std::memory_order_relaxed);
+    while (x > y
+           && !max_.compare_exchange_weak(y,
+                                          x,
+                                          std::memory_order_relaxed)) {
+    }
+  }
+
+  std::uint64_t count() const noexcept {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  std::uint64_t sum() const noexcept {
+    return sum_.load(std::memory_order_relaxed);
+  }
+
+  std::uint64_t max() const noexcept {
+    return max_.load(std::memory_order_relaxed);
+  }
+
+  // Returns an upper bound on the q-quantile for 0 <= q <= 1, or 0 if
+  // nothing has been recorded.
+  std::uint64_t quantile(double q) const noexcept;
+
+  json_t to_json() const;
+};
+
+//
+// Records the time from construction to destruction, in nanoseconds,
+// into a histogram.
+//
+
+class metric_timer_t final {
+  metric_histogram_t & histogram_;
+  decltype(sst::mono_time_ns()) start_ns_;
+
+public:
+  explicit metric_timer_t(metric_histogram_t & histogram)
+      : histogram_(histogram),
+        start_ns_(sst::mono_time_ns()) {
+  }
+
+  metric_timer_t(metric_timer_t const &) = delete;
+  metric_timer_t & operator=(metric_timer_t const &) = delete;
+  metric_timer_t(metric_timer_t &&) = delete;
+  metric_timer_t & operator=(metric_timer_t &&) = delete;
+
+  ~metric_timer_t() noexcept {
+    auto const now = sst::mono_time_ns();
+    auto const elapsed = now > start_ns_ ? now - start_ns_ : 0;
+    histogram_.record(static_cast<std::uint64_t>(elapsed));
+  }
+};
+
+//----------------------------------------------------------------------
+
+class metrics_t final {
+  mutable std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<metric_counter_t>> counters_;
+  std::map<std::string, std::unique_ptr<metric_gauge_t>> gauges_;
+  std::map<std::string, std::unique_ptr<metric_histogram_t>>
+      histograms_;
+
+public:
+  metrics_t() = default;
+  metrics_t(metrics_t const &) = delete;
+  metrics_t & operator=(metrics_t const &) = delete;
+  metrics_t(metrics_t &&) = delete;
+  metrics_t & operator=(metrics_t &&) = delete;
+  ~metrics_t() noexcept = default;
+
+  // Each of these creates the metric if it does not exist yet.
+  metric_counter_t & counter(std::string const & name);
+  metric_gauge_t & gauge(std::string const & name);
+  metric_histogram_t & histogram(std::string const & name);
+
+  // Returns a snapshot of every metric, with histograms summarized by
+  // their count, sum, maximum, and a few quantiles.
+  json_t to_json() const;
+};
+
+} // namespace kestrel
+
+#endif // #ifndef KESTREL_METRICS_T_HPP
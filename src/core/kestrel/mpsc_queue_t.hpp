@@ -0,0 +1,246 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_MPSC_QUEUE_T_HPP
+#define KESTREL_MPSC_QUEUE_T_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#include <sst/catalog/mono_time_ns.hpp>
+#include <sst/catalog/optional.hpp>
+
+namespace kestrel {
+
+//
+// Counters kept by each mpsc_queue_t. depth is the number of items
+// currently queued, max_depth is the largest depth seen so far, and
+// the latency counters measure the time from push to pop.
+//
+
+struct mpsc_queue_stats_t final {
+  std::uint64_t pushed = 0;
+  std::uint64_t popped = 0;
+  std::uint64_t overflowed = 0;
+  std::uint64_t depth = 0;
+  std::uint64_t max_depth = 0;
+  std::uint64_t total_latency_ns = 0;
+  std::uint64_t max_latency_ns = 0;
+};
+
+//
+// A multi-producer single-consumer FIFO queue. Producers never block
+// each other or the consumer in the common case: items go into a
+// fixed ring of preallocated cells (Vyukov's bounded queue), and the
+// cells are reused forever.
+//
+// If the ring fills up, producers fall back to a mutex-protected
+// overflow deque instead of failing or spinning, since the consumer
+// may itself be a producer (e.g. a plugin call made while draining
+// the queue). While the overflow deque is in use, all pushes go to it,
+// so each producer's items still come out in the order it pushed them.
+//
+// Only one thread may call pop() at a time.
+//
+
+template<class T>
+class mpsc_queue_t final {
+
+  struct cell_t final {
+    std::atomic<std::size_t> sequence;
+    sst::optional<T> value;
+    decltype(sst::mono_time_ns()) push_ns;
+  };
+
+  struct entry_t final {
+    T value;
+    decltype(sst::mono_time_ns()) push_ns;
+  };
+
+  std::size_t mask_;
+  std::unique_ptr<cell_t[]> cells_;
+
+  alignas(64) std::atomic<std::size_t> enqueue_pos_{0};
+  alignas(64) std::size_t dequeue_pos_ = 0;
+
+  std::atomic<bool> overflowing_{false};
+  std::mutex overflow_mutex_;
+  std::deque<entry_t> overflow_;
+
+  alignas(64) std::atomic<std::uint64_t> pushed_{0};
+  std::atomic<std::uint64_t> overflowed_{0};
+  std::atomic<std::uint64_t> max_depth_{0};
+  alignas(64) std::atomic<std::uint64_t> popped_{0};
+  std::atomic<std::uint64_t> total_latency_ns_{0};
+  std::atomic<std::uint64_t> max_latency_ns_{0};
+
+  static void raise_max(std::atomic<std::uint64_t> & max,
+                        std::uint64_t const x) noexcept {
+    auto y = max.load(std::memory_order_relaxed);
+    while (x > y
+           && !max.compare_exchange_weak(y,
+                                         x,
+                                         std::memory_order_relaxed)) {
+    }
+  }
+
+  void count_push() noexcept {
+    auto const pushed =
+        pushed_.fetch_add(1, std::memory_order_relaxed) + 1;
+    auto const popped = popped_.load(std::memory_order_relaxed);
+    if (pushed > popped) {
+      raise_max(max_depth_, pushed - popped);
+    }
+  }
+
+  void
+  count_pop(decltype(sst::mono_time_ns()) const push_ns) noexcept {
+    popped_.fetch_add(1, std::memory_order_relaxed);
+    auto const now = sst::mono_time_ns();
+    auto const latency =
+        static_cast<std::uint64_t>(now > push_ns ? now - push_ns : 0);
+    total_latency_ns_.fetch_add(latency, std::memory_order_relaxed);
+    raise_max(max_latency_ns_, latency);
+  }
+
+  bool try_push_ring(T & value) {
+    auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      cell_t & cell = cells_[pos & mask_];
+      auto const seq = cell.sequence.load(std::memory_order_acquire);
+      auto const diff = static_cast<std::ptrdiff_t>(seq)
+                        - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(
+                pos,
+                pos + 1,
+                std::memory_order_relaxed)) {
+          cell.value.emplace(std::move(value));
+          cell.push_ns = sst::mono_time_ns();
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+public:
+
+  // capacity must be a power of two.
+  explicit mpsc_queue_t(std::size_t const capacity = 1024)
+      : mask_(capacity - 1),
+        cells_(new cell_t[capacity]) {
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+      throw std::invalid_argument(
+          "mpsc_queue_t: capacity must be a power of two");
+    }
+    for (std::size_t i = 0; i != capacity; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  mpsc_queue_t(mpsc_queue_t const &) = delete;
+  mpsc_queue_t & operator=(mpsc_queue_t const &) = delete;
+  mpsc_queue_t(mpsc_queue_t &&) = delete;
+  mpsc_queue_t & operator=(mpsc_queue_t &&) = delete;
+  ~mpsc_queue_t() noexcept = default;
+
+  void push(T value) {
+    if (!overflowing_.load(std::memory_order_acquire)
+        && try_push_ring(value)) {
+      count_push();
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> const lock(overflow_mutex_);
+      overflow_.push_back({std::move(value), sst::mono_time_ns()});
+      overflowing_.store(true, std::memory_order_release);
+    }
+    overflowed_.fetch_add(1, std::memory_order_relaxed);
+    count_push();
+  }
+
+  // Moves the oldest item into value and returns true, or returns
+  // false if the queue is empty or the next item is still being
+  // pushed. T only needs to be move constructible,
+  // so tasks can hold references. Consumer only.
+  bool pop(sst::optional<T> & value) {
+    cell_t & cell = cells_[dequeue_pos_ & mask_];
+    auto const seq = cell.sequence.load(std::memory_order_acquire);
+    if (seq == dequeue_pos_ + 1) {
+      value.emplace(std::move(*cell.value));
+      cell.value.reset();
+      auto const push_ns = cell.push_ns;
+      cell.sequence.store(dequeue_pos_ + mask_ + 1,
+                          std::memory_order_release);
+      ++dequeue_pos_;
+      count_pop(push_ns);
+      return true;
+    }
+    if (!overflowing_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    // A producer may have claimed the next cell without publishing it
+    // yet. Its item was pushed before anything that producer has in
+    // the overflow deque, so the deque must wait until the ring is
+    // empty.
+    if (enqueue_pos_.load(std::memory_order_acquire) != dequeue_pos_) {
+      return false;
+    }
+    std::lock_guard<std::mutex> const lock(overflow_mutex_);
+    if (overflow_.empty()) {
+      overflowing_.store(false, std::memory_order_release);
+      return false;
+    }
+    value.emplace(std::move(overflow_.front().value));
+    auto const push_ns = overflow_.front().push_ns;
+    overflow_.pop_front();
+    if (overflow_.empty()) {
+      overflowing_.store(false, std::memory_order_release);
+    }
+    count_pop(push_ns);
+    return true;
+  }
+
+  mpsc_queue_stats_t stats() const noexcept {
+    mpsc_queue_stats_t s;
+    s.popped = popped_.load(std::memory_order_relaxed);
+    s.pushed = pushed_.load(std::memory_order_relaxed);
+    s.overflowed = overflowed_.load(std::memory_order_relaxed);
+    s.depth = s.pushed > s.popped ? s.pushed - s.popped : 0;
+    s.max_depth = max_depth_.load(std::memory_order_relaxed);
+    s.total_latency_ns =
+        total_latency_ns_.load(std::memory_order_relaxed);
+    s.max_latency_ns = max_latency_ns_.load(std::memory_order_relaxed);
+    return s;
+  }
+};
+
+} // namespace kestrel
+
+#endif // #ifndef KESTREL_MPSC_QUEUE_T_HPP
@@ -0,0 +1,200 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/ntt.hpp>
+// Include twice to test idempotence.
+#include <kestrel/ntt.hpp>
+//
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <sst/catalog/SST_ASSERT.h>
+#include <sst/catalog/bignum.hpp>
+
+using sst::bignum;
+using std::size_t;
+using std::vector;
+
+namespace {
+
+// Iterative radix-2 Cooley-Tukey transform. The input is permuted into
+// bit-reversed order so that the output comes out in natural order.
+// tw must hold w^0, ..., w^(n/2-1) for a primitive n-th root of unity
+// w, where n = a.size().
+void transform(vector<bignum> & a,
+               vector<bignum> const & tw,
+               bignum const & modulus) {
+  auto const n = a.size();
+  for (size_t i = 1, j = 0; i < n; ++i) {
+    auto bit = n >> 1;
+    for (; (j & bit) != 0; bit >>= 1) {
+      j ^= bit;
+    }
+    j ^= bit;
+    if (i < j) {
+      std::swap(a[i], a[j]);
+    }
+  }
+  bignum v{};
+  for (size_t len = 2; len <= n; len <<= 1) {
+    auto const half = len / 2;
+    auto const step = n / len;
+    for (size_t i = 0; i < n; i += len) {
+      for (size_t j = 0; j < half; ++j) {
+        auto & lo = a[i + j];
+        auto & hi = a[i + j + half];
+        v = hi.mul_mod(tw[j * step], modulus);
+        hi = lo.add_mod(modulus - v, modulus);
+        lo = lo.add_mod(v, modulus);
+      }
+    }
+  }
+}
+
+} // namespace
+
+ntt_table_t::ntt_table_t(bignum const & modulus) : modulus_(modulus) {
+  SST_ASSERT(modulus_ > 2L);
+  auto const p1 = modulus_ - bignum(1);
+  auto t = p1;
+  while ((t % bignum(2)).is_zero()) {
+    t = t >> 1L;
+    ++max_log_size_;
+  }
+  // c^((p-1)/2^k) is a primitive 2^k-th root of unity for every k <= m
+  // exactly when c is a quadratic nonresidue, and the smallest
+  // nonresidue of a prime is always small.
+  auto const half = p1 >> 1L;
+  non_residue_ = 2;
+  while (!(bignum::pow_mod(non_residue_, half, modulus_) == p1)) {
+    non_residue_ = non_residue_ + bignum(1);
+  }
+}
+
+ntt_table_t::level_t const & ntt_table_t::level(size_t const log_size) {
+  SST_ASSERT(log_size <= max_log_size_);
+  std::lock_guard<std::mutex> const lock(mutex_);
+  if (levels_.size() <= log_size) {
+    levels_.resize(log_size + 1);
+  }
+  auto & slot = levels_[log_size];
+  if (slot == nullptr) {
+    std::unique_ptr<level_t> x(new level_t);
+    auto const n = size_t(1) << log_size;
+    auto const half = n / 2;
+    auto const w = bignum::pow_mod(
+        non_residue_,
+        (modulus_ - bignum(1)) >> static_cast<long>(log_size),
+        modulus_);
+    x->twiddles.reserve(half);
+    bignum t{1};
+    for (size_t j = 0; j < half; ++j) {
+      x->twiddles.emplace_back(t);
+      t = t.mul_mod(w, modulus_);
+    }
+    // w^-j = w^(n-j) = -w^(n/2-j).
+    x->inverse_twiddles.reserve(half);
+    for (size_t j = 0; j < half; ++j) {
+      if (j == 0) {
+        x->inverse_twiddles.emplace_back(1);
+      } else {
+        x->inverse_twiddles.emplace_back(modulus_
+                                         - x->twiddles[half - j]);
+      }
+    }
+    x->inverse_size = bignum(n).inv_mod(modulus_);
+    slot = std::move(x);
+  }
+  return *slot;
+}
+
+void ntt_table_t::forward(vector<bignum> & a, size_t const log_size) {
+  SST_ASSERT(a.size() == size_t(1) << log_size);
+  transform(a, level(log_size).twiddles, modulus_);
+}
+
+void ntt_table_t::inverse(vector<bignum> & a, size_t const log_size) {
+  SST_ASSERT(a.size() == size_t(1) << log_size);
+  auto const & lv = level(log_size);
+  transform(a, lv.inverse_twiddles, modulus_);
+  for (auto & x : a) {
+    x = x.mul_mod(lv.inverse_size, modulus_);
+  }
+}
+
+std::shared_ptr<ntt_table_t> ntt_table_t::get(bignum const & modulus) {
+  static std::mutex mutex;
+  static vector<std::shared_ptr<ntt_table_t>> tables;
+  std::lock_guard<std::mutex> const lock(mutex);
+  // There is only ever a handful of primes in use, so a linear search
+  // is fine.
+  for (auto const & table : tables) {
+    if (table->modulus() == modulus) {
+      return table;
+    }
+  }
+  tables.emplace_back(std::make_shared<ntt_table_t>(modulus));
+  return tables.back();
+}
+
+size_t ntt_log_size(size_t const n) {
+  size_t k = 0;
+  while ((size_t(1) << k) < n) {
+    ++k;
+  }
+  return k;
+}
+
+bool ntt_mul(vector<bignum> & x,
+             vector<bignum> const & f,
+             vector<bignum> const & g,
+             ntt_table_t & table) {
+  SST_ASSERT(!f.empty());
+  SST_ASSERT(!g.empty());
+  auto const & modulus = table.modulus();
+  auto const len = f.size() + g.size() - 1;
+  auto const log_size = ntt_log_size(len);
+  if (log_size > table.max_log_size()) {
+    return false;
+  }
+  auto const n = size_t(1) << log_size;
+  vector<bignum> a(f);
+  a.resize(n, bignum::zero());
+  table.forward(a, log_size);
+  if (&f == &g) {
+    for (auto & y : a) {
+      y = y.mul_mod(y, modulus);
+    }
+  } else {
+    vector<bignum> b(g);
+    b.resize(n, bignum::zero());
+    table.forward(b, log_size);
+    for (size_t i = 0; i < n; ++i) {
+      a[i] = a[i].mul_mod(b[i], modulus);
+    }
+  }
+  table.inverse(a, log_size);
+  a.resize(len);
+  x = std::move(a);
+  return true;
+}
@@ -0,0 +1,114 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_NTT_HPP
+#define KESTREL_NTT_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <sst/catalog/bignum.hpp>
+
+/**
+ * The minimum number of coefficients that both operands of a
+ * polynomial product must have before the product is computed with
+ * number theoretic transforms instead of the schoolbook method.
+ */
+constexpr std::size_t ntt_crossover = 32;
+
+/**
+ * Twiddle factor tables for number theoretic transforms modulo a prime
+ * p = M*2^m + 1. The largest supported transform size is 2^m, where m
+ * is the 2-adic valuation of p - 1. Tables for each transform size are
+ * computed on first use and then kept for the lifetime of the object.
+ *
+ * Use ntt_table_t::get to share one table per modulus across the whole
+ * process.
+ */
+class ntt_table_t final {
+
+  struct level_t {
+    std::vector<sst::bignum> twiddles;
+    std::vector<sst::bignum> inverse_twiddles;
+    sst::bignum inverse_size;
+  };
+
+  sst::bignum const modulus_;
+  std::size_t max_log_size_{};
+  sst::bignum non_residue_{};
+  std::vector<std::unique_ptr<level_t const>> levels_;
+  std::mutex mutex_;
+
+  level_t const & level(std::size_t log_size);
+
+public:
+
+  explicit ntt_table_t(sst::bignum const & modulus);
+
+  ntt_table_t(ntt_table_t const &) = delete;
+  ntt_table_t & operator=(ntt_table_t const &) = delete;
+  ntt_table_t(ntt_table_t &&) = delete;
+  ntt_table_t & operator=(ntt_table_t &&) = delete;
+  ~ntt_table_t() noexcept = default;
+
+  sst::bignum const & modulus() const noexcept {
+    return modulus_;
+  }
+
+  std::size_t max_log_size() const noexcept {
+    return max_log_size_;
+  }
+
+  /**
+   * Transform a in place into its evaluations at the powers of a
+   * primitive 2^log_size-th root of unity w, i.e. a[j] = A(w^j).
+   * a.size() must be exactly 2^log_size.
+   */
+  void forward(std::vector<sst::bignum> & a, std::size_t log_size);
+
+  /**
+   * Undo forward, including the scaling by 2^-log_size.
+   */
+  void inverse(std::vector<sst::bignum> & a, std::size_t log_size);
+
+  /**
+   * Return the table for modulus, creating it if this is the first
+   * request for that modulus.
+   */
+  static std::shared_ptr<ntt_table_t> get(sst::bignum const & modulus);
+};
+
+/**
+ * Return the smallest k such that 2^k >= n.
+ */
+std::size_t ntt_log_size(std::size_t n);
+
+/**
+ * Compute the coefficients of the product of the polynomials with
+ * coefficients f and g modulo the modulus of table. Returns false and
+ * leaves x untouched if the product is too long for the transform
+ * sizes supported by the modulus.
+ */
+bool ntt_mul(std::vector<sst::bignum> & x,
+             std::vector<sst::bignum> const & f,
+             std::vector<sst::bignum> const & g,
+             ntt_table_t & table);
+
+#endif // #ifndef KESTREL_NTT_HPP
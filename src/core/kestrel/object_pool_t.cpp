@@ -0,0 +1,65 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/object_pool_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/object_pool_t.hpp>
+//
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace kestrel {
+
+namespace {
+
+std::mutex & registry_mutex() {
+  static std::mutex * const x = new std::mutex;
+  return *x;
+}
+
+std::vector<object_pool_base_t const *> & registry() {
+  static auto * const x = new std::vector<object_pool_base_t const *>;
+  return *x;
+}
+
+} // namespace
+
+void object_pool_base_t::register_pool(
+    object_pool_base_t const & pool) {
+  std::lock_guard<std::mutex> const lock(registry_mutex());
+  registry().push_back(&pool);
+}
+
+std::map<std::string, object_pool_stats_t> object_pool_stats() {
+  std::vector<object_pool_base_t const *> pools;
+  {
+    std::lock_guard<std::mutex> const lock(registry_mutex());
+    pools = registry();
+  }
+  std::map<std::string, object_pool_stats_t> stats;
+  for (auto const * const pool : pools) {
+    stats[pool->name()] = pool->stats();
+  }
+  return stats;
+}
+
+} // namespace kestrel
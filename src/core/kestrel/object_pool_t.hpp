@@ -0,0 +1,294 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_OBJECT_POOL_T_HPP
+#define KESTREL_OBJECT_POOL_T_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace kestrel {
+
+//
+// Counters kept by each object_pool_t. hits is the number of acquires
+// that were served from the free list instead of allocating, in_use is
+// the number of objects currently handed out, and free is the number
+// of objects waiting in the free list.
+//
+
+struct object_pool_stats_t final {
+  std::uint64_t acquires = 0;
+  std::uint64_t hits = 0;
+  std::uint64_t releases = 0;
+  std::uint64_t discards = 0;
+  std::uint64_t in_use = 0;
+  std::uint64_t free = 0;
+};
+
+class object_pool_base_t {
+
+protected:
+
+  object_pool_base_t() = default;
+
+  ~object_pool_base_t() noexcept = default;
+
+  // Adds the pool to the list that object_pool_stats reports on.
+  static void register_pool(object_pool_base_t const & pool);
+
+public:
+
+  object_pool_base_t(object_pool_base_t const &) = delete;
+  object_pool_base_t & operator=(object_pool_base_t const &) = delete;
+
+  virtual std::string name() const = 0;
+
+  virtual object_pool_stats_t stats() const = 0;
+};
+
+// Returns the statistics of every pool that has been used so far,
+// keyed by pool name.
+std::map<std::string, object_pool_stats_t> object_pool_stats();
+
+//
+// How an object is made ready for reuse when it goes back to its pool.
+// Each overload returns false if the object cannot be reused, in which
+// case it is deleted instead.
+//
+//    1. A class with a pool_reset() member function is reset by calling
+//       it. This is how a class keeps the storage of its big members,
+//       such as vectors of bigints, across reuses.
+//
+//    2. A std::vector of trivially destructible elements is cleared,
+//       which keeps its capacity. A std::vector of any other elements
+//       is left as it is, so that its elements keep their own storage
+//       too. Callers of acquire() must resize such a vector and
+//       overwrite every element, which is what all of our callers do
+//       anyway.
+//
+//    3. Any other type is reset by move assigning a default constructed
+//       object to it, if it can be.
+//
+
+namespace object_pool_detail {
+
+template<class T>
+auto reset(T & x, int) -> decltype(x.pool_reset(), bool()) {
+  x.pool_reset();
+  return true;
+}
+
+template<class T>
+bool reset_vector(std::vector<T> & x, std::true_type) {
+  x.clear();
+  return true;
+}
+
+template<class T>
+bool reset_vector(std::vector<T> &, std::false_type) {
+  return true;
+}
+
+template<class T>
+bool reset(std::vector<T> & x, long) {
+  return reset_vector(
+      x,
+      std::integral_constant<
+          bool,
+          std::is_trivially_destructible<T>::value>());
+}
+
+template<class T>
+bool reset_assign(T & x, std::true_type) {
+  x = T();
+  return true;
+}
+
+template<class T>
+bool reset_assign(T &, std::false_type) {
+  return false;
+}
+
+template<class T>
+bool reset(T & x, ...) {
+  return reset_assign(
+      x,
+      std::integral_constant<
+          bool,
+          std::is_default_constructible<T>::value
+              && std::is_move_assignable<T>::value>());
+}
+
+} // namespace object_pool_detail
+
+template<class T>
+class object_pool_t;
+
+//
+// The deleter of pooled<T>. A default constructed deleter, as found in
+// a default constructed pooled<T>, just deletes the object.
+//
+
+template<class T>
+class pool_deleter_t final {
+
+  object_pool_t<T> * pool_ = nullptr;
+
+public:
+
+  pool_deleter_t() noexcept = default;
+
+  explicit pool_deleter_t(object_pool_t<T> & pool) noexcept
+      : pool_(&pool) {
+  }
+
+  void operator()(T * const p) const noexcept {
+    if (pool_ != nullptr) {
+      pool_->release(p);
+    } else {
+      delete p;
+    }
+  }
+};
+
+//
+// A free list of objects of type T. There is one pool per type for the
+// whole process, and it is never destroyed, so pooled objects may
+// outlive whatever acquired them. All member functions are
+// thread-safe.
+//
+
+template<class T>
+class object_pool_t final : public object_pool_base_t {
+
+  mutable std::mutex mutex_;
+  std::vector<T *> free_;
+  std::size_t max_free_ = 256;
+  object_pool_stats_t stats_;
+
+  object_pool_t() = default;
+
+  ~object_pool_t() noexcept = default;
+
+public:
+
+  static object_pool_t & instance() {
+    static object_pool_t * const pool = []() {
+      auto * const p = new object_pool_t();
+      register_pool(*p);
+      return p;
+    }();
+    return *pool;
+  }
+
+  std::unique_ptr<T, pool_deleter_t<T>> acquire() {
+    T * p = nullptr;
+    {
+      std::lock_guard<std::mutex> const lock(mutex_);
+      ++stats_.acquires;
+      ++stats_.in_use;
+      if (!free_.empty()) {
+        p = free_.back();
+        free_.pop_back();
+        ++stats_.hits;
+      }
+    }
+    if (p == nullptr) {
+      try {
+        p = new T;
+      } catch (...) {
+        std::lock_guard<std::mutex> const lock(mutex_);
+        --stats_.in_use;
+        throw;
+      }
+    }
+    return std::unique_ptr<T, pool_deleter_t<T>>(
+        p,
+        pool_deleter_t<T>(*this));
+  }
+
+  // Resets the object and keeps it for reuse, or deletes it if it
+  // cannot be reset or the free list is full.
+  void release(T * const p) noexcept {
+    if (p == nullptr) {
+      return;
+    }
+    // Resetting may release other pooled objects, so it is done
+    // without holding the mutex.
+    bool keep;
+    try {
+      keep = object_pool_detail::reset(*p, 0);
+    } catch (...) {
+      keep = false;
+    }
+    {
+      std::lock_guard<std::mutex> const lock(mutex_);
+      ++stats_.releases;
+      --stats_.in_use;
+      if (keep && free_.size() < max_free_) {
+        try {
+          free_.push_back(p);
+          return;
+        } catch (...) {
+        }
+      }
+      ++stats_.discards;
+    }
+    delete p;
+  }
+
+  // Sets how many free objects the pool may hold. Objects beyond that
+  // are deleted when released.
+  void set_max_free(std::size_t const n) {
+    std::vector<T *> extra;
+    {
+      std::lock_guard<std::mutex> const lock(mutex_);
+      max_free_ = n;
+      while (free_.size() > max_free_) {
+        extra.push_back(free_.back());
+        free_.pop_back();
+      }
+    }
+    for (T * const p : extra) {
+      delete p;
+    }
+  }
+
+  std::string name() const override {
+    return typeid(T).name();
+  }
+
+  object_pool_stats_t stats() const override {
+    std::lock_guard<std::mutex> const lock(mutex_);
+    object_pool_stats_t s = stats_;
+    s.free = free_.size();
+    return s;
+  }
+};
+
+} // namespace kestrel
+
+#endif // #ifndef KESTREL_OBJECT_POOL_T_HPP
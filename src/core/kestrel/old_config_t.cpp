@@ -160,6 +160,101 @@ void from_json(nlohmann::json src, old_config_t & dst) {
 
   sst::json::get_to(src, dst.leader_relay_only, "leader_relay_only");
   sst::json::get_to(src, dst.inter_server_direct_only, "inter_server_direct_only");
+
+  if (src.contains("montgomery_field")) {
+    dst.montgomery_field = src["montgomery_field"];
+  }
+
+  if (src.contains("mix_max_latency")) {
+    dst.mix_max_latency = src["mix_max_latency"];
+  }
+
+  if (src.contains("mix_min_fill")) {
+    dst.mix_min_fill = src["mix_min_fill"];
+    if (dst.mix_min_fill == 0 || dst.mix_min_fill > dst.mixsize) {
+      throw std::runtime_error("mix_min_fill must be in [1, MixSize]");
+    }
+  }
+
+  if (src.contains("mix_threads")) {
+    dst.mix_threads = src["mix_threads"];
+  }
+
+  if (src.contains("mb_bundle_window")) {
+    dst.mb_bundle_window = src["mb_bundle_window"];
+    if (dst.mb_bundle_window < 0) {
+      throw std::runtime_error("mb_bundle_window must be nonnegative");
+    }
+  }
+
+  if (src.contains("mb_bundle_max")) {
+    dst.mb_bundle_max = src["mb_bundle_max"];
+    if (dst.mb_bundle_max == 0) {
+      throw std::runtime_error("mb_bundle_max must be positive");
+    }
+  }
+
+  if (src.contains("phonebook_max_resident")) {
+    dst.phonebook_max_resident = src["phonebook_max_resident"];
+  }
+
+  if (src.contains("dedup_retention")) {
+    dst.dedup_retention = src["dedup_retention"];
+    if (dst.dedup_retention <= 0) {
+      throw std::runtime_error("dedup_retention must be positive");
+    }
+  }
+
+  if (src.contains("dedup_max_entries")) {
+    dst.dedup_max_entries = src["dedup_max_entries"];
+    if (dst.dedup_max_entries < 2) {
+      throw std::runtime_error("dedup_max_entries must be at least 2");
+    }
+  }
+
+  if (src.contains("chunk_group_timeout")) {
+    dst.chunk_group_timeout = src["chunk_group_timeout"];
+    if (dst.chunk_group_timeout <= 0) {
+      throw std::runtime_error("chunk_group_timeout must be positive");
+    }
+  }
+
+  if (src.contains("chunk_memory_budget")) {
+    dst.chunk_memory_budget = src["chunk_memory_budget"];
+    if (dst.chunk_memory_budget == 0) {
+      throw std::runtime_error("chunk_memory_budget must be positive");
+    }
+  }
+
+  if (src.contains("chunk_spill_size")) {
+    dst.chunk_spill_size = src["chunk_spill_size"];
+  }
+
+  if (src.contains("async_log_capacity")) {
+    dst.async_log_capacity = src["async_log_capacity"];
+  }
+
+  if (src.contains("metrics_interval")) {
+    dst.metrics_interval = src["metrics_interval"];
+    if (dst.metrics_interval < 0) {
+      throw std::runtime_error("metrics_interval must be nonnegative");
+    }
+  }
+
+  if (src.contains("metrics_file")) {
+    dst.metrics_file = src["metrics_file"];
+    if (dst.metrics_file.empty()) {
+      throw std::runtime_error("metrics_file must not be empty");
+    }
+  }
+
+  if (src.contains("send_retry_burst")) {
+    dst.send_retry_burst = src["send_retry_burst"];
+  }
+
+  if (src.contains("clrmsg_store_max_bytes")) {
+    dst.clrmsg_store_max_bytes = src["clrmsg_store_max_bytes"];
+  }
 }
 
 } // namespace kestrel
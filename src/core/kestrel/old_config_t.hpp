@@ -190,6 +190,72 @@ public:
   bool leader_relay_only;
   bool inter_server_direct_only;
 
+  // Use the fixed-width Montgomery arithmetic in prime_field_t for the
+  // mix instead of sst::bigint whenever the prime fits.
+  bool montgomery_field = true;
+
+  // If positive, the committee leader closes a partial batch once its
+  // oldest message has waited this many seconds, padding the batch
+  // with dummy messages. A partial batch is only closed if it holds at
+  // least mix_min_fill real messages.
+  int mix_max_latency = 0;
+  size_t mix_min_fill = 1;
+
+  // Number of threads that committee members use for reconstruction
+  // and root finding, so that several mixes can run at once, and that
+  // mailboxes use to encrypt the shares of each client packet. With 0,
+  // this work is done inline on the plugin thread.
+  unsigned int mix_threads = 0;
+
+  // If positive, a mailbox holds the up bundle for each committee
+  // leader for up to this many milliseconds so that the shares of
+  // several client packets go out in one message. A bundle is sent
+  // early once it holds mb_bundle_max client packets.
+  int mb_bundle_window = 0;
+  size_t mb_bundle_max = 16;
+
+  // Maximum number of phonebook entries to keep in memory, or 0 for no
+  // limit.
+  size_t phonebook_max_resident = 0;
+
+  // How long, in seconds, the duplicate filters remember packet and
+  // message IDs, and the most IDs each filter may hold. A filter that
+  // fills up forgets its oldest half early.
+  int dedup_retention = 3600;
+  size_t dedup_max_entries = 1048576;
+
+  // How long, in seconds, a partly received chunk group may go without
+  // a new chunk before it is dropped, and the most bytes that partial
+  // groups may hold in memory before the oldest are evicted. Groups
+  // whose joined size is at least chunk_spill_size keep their chunks
+  // in the plugin's storage directory instead, unless it is 0. See
+  // chunk_joiner_t.
+  int chunk_group_timeout = 600;
+  size_t chunk_memory_budget = 67108864;
+  size_t chunk_spill_size = 0;
+
+  // If positive, log messages are handed to a background writer
+  // through a ring of this many records instead of being written on
+  // the calling thread. See log_sink_t.
+  size_t async_log_capacity = 0;
+
+  // If positive, network maintenance writes a JSON snapshot of the
+  // plugin's metrics to metrics_file at most every this many seconds.
+  // The file is written through the SDK, so it lands in the plugin's
+  // storage directory.
+  int metrics_interval = 0;
+  std::string metrics_file = "metrics.json";
+
+  // If positive, the most messages that network maintenance resends in
+  // one pass. Messages that are due but don't fit wait for the next
+  // pass, with mix traffic going first.
+  size_t send_retry_burst = 0;
+
+  // The most bytes of undelivered messages that a client keeps in its
+  // clear message store, or 0 for no limit. A message that arrives
+  // while the store is full is refused. See clrmsg_store_t.
+  size_t clrmsg_store_max_bytes = 16777216;
+
   friend void from_json(nlohmann::json src, old_config_t & dst);
 };
 
@@ -77,6 +77,11 @@ public:
   CARMA_PACKET_TYPE_LIST
 #undef CARMA_ITEM
 
+  // The number of packet types. Every valid value is less than this.
+  static constexpr value_type count() noexcept {
+    return static_cast<value_type>(enum_t::count);
+  }
+
   //--------------------------------------------------------------------
 
   std::string to_string() const {
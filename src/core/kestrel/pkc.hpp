@@ -437,6 +437,106 @@ auth_encrypt(SenderSecretKey const & sender_secret_key,
                                                 id);
 }
 
+//----------------------------------------------------------------------
+// auth_precompute
+//----------------------------------------------------------------------
+//
+// Computes the shared key that auth_encrypt_afternm and
+// auth_decrypt_afternm use in place of a secret key and a public key.
+// The same shared key is obtained from (our secret key, their public
+// key) on one side and (their secret key, our public key) on the other.
+//
+
+template<class Size>
+Size auth_shared_key_size() {
+  return sst::checked_cast<Size>(crypto_box_BEFORENMBYTES);
+}
+
+inline void auth_precompute(unsigned char const * const secret_key,
+                            unsigned char const * const public_key,
+                            unsigned char * const shared_key) {
+  SST_ASSERT((secret_key != nullptr));
+  SST_ASSERT((public_key != nullptr));
+  SST_ASSERT((shared_key != nullptr));
+  int const s =
+      sodium::crypto_box_beforenm(shared_key, public_key, secret_key);
+  if (s != 0) {
+    throw std::runtime_error(
+        "crypto_box_beforenm() failed (libsodium error code "
+        + sst::to_string(s) + ").");
+  }
+}
+
+//----------------------------------------------------------------------
+// auth_encrypt_afternm
+//----------------------------------------------------------------------
+//
+// Same as auth_encrypt, but with a shared key from auth_precompute.
+// The ciphertext is identical in format to one made by auth_encrypt.
+//
+
+template<class PlaintextSize>
+unsigned char *
+auth_encrypt_afternm(unsigned char const * const shared_key,
+                     unsigned char const * const plaintext,
+                     PlaintextSize const plaintext_size,
+                     unsigned char * const ciphertext) {
+  SST_ASSERT((shared_key != nullptr));
+  SST_ASSERT((plaintext != nullptr));
+  SST_ASSERT((!sst::is_negative(plaintext_size)));
+  SST_ASSERT((ciphertext != nullptr));
+  ciphertext[0] = 1;
+  sst::crypto_rng(ciphertext + 1, crypto_box_NONCEBYTES);
+  int const s = sodium::crypto_box_easy_afternm(
+      ciphertext + 1 + crypto_box_NONCEBYTES,
+      plaintext,
+      sst::checked_cast<unsigned long long>(plaintext_size),
+      ciphertext + 1,
+      shared_key);
+  if (s != 0) {
+    throw std::runtime_error(
+        "crypto_box_easy_afternm() failed (libsodium error code "
+        + sst::to_string(s) + ").");
+  }
+  return ciphertext + 1;
+}
+
+template<class SharedKey, class Plaintext, class Ciphertext>
+unsigned char * auth_encrypt_afternm(SharedKey const & shared_key,
+                                     Plaintext const & plaintext,
+                                     Ciphertext & ciphertext) {
+  SST_STATIC_ASSERT(
+      (sst::is_byte<typename SharedKey::value_type>::value));
+  SST_STATIC_ASSERT(
+      (sst::is_byte<typename Plaintext::value_type>::value));
+  SST_STATIC_ASSERT(
+      (sst::is_byte<typename Ciphertext::value_type>::value));
+  SST_ASSERT(
+      (shared_key.size()
+       == auth_shared_key_size<typename SharedKey::size_type>()));
+  ciphertext.resize(
+      auth_ciphertext_size<typename Ciphertext::size_type>(
+          plaintext.size()));
+  return auth_encrypt_afternm(
+      reinterpret_cast<unsigned char const *>(shared_key.data()),
+      reinterpret_cast<unsigned char const *>(plaintext.data()),
+      plaintext.size(),
+      reinterpret_cast<unsigned char *>(ciphertext.data()));
+}
+
+template<class Ciphertext = std::vector<unsigned char>,
+         class SharedKey,
+         class Plaintext>
+std::pair<Ciphertext, unsigned char *>
+auth_encrypt_afternm(SharedKey const & shared_key,
+                     Plaintext const & plaintext) {
+  Ciphertext ciphertext;
+  unsigned char * const id =
+      auth_encrypt_afternm(shared_key, plaintext, ciphertext);
+  return std::pair<Ciphertext, unsigned char *>(std::move(ciphertext),
+                                                id);
+}
+
 //----------------------------------------------------------------------
 // ciphertext_is_anon
 //----------------------------------------------------------------------
@@ -725,6 +825,80 @@ auto auth_decrypt(SenderPublicKey const & sender_public_key,
   return R(std::move(plaintext), id);
 }
 
+//----------------------------------------------------------------------
+// auth_decrypt_afternm
+//----------------------------------------------------------------------
+//
+// Same as auth_decrypt, but with a shared key from auth_precompute.
+//
+
+template<class CiphertextByte,
+         class CiphertextSize,
+         sst::enable_if_t<std::is_same<sst::remove_cv_t<CiphertextByte>,
+                                       unsigned char>::value> = 0>
+CiphertextByte *
+auth_decrypt_afternm(unsigned char const * const shared_key,
+                     CiphertextByte * const ciphertext,
+                     CiphertextSize const ciphertext_size,
+                     unsigned char * const plaintext) {
+  SST_ASSERT((shared_key != nullptr));
+  SST_ASSERT((ciphertext != nullptr));
+  SST_ASSERT((!sst::is_negative(ciphertext_size)));
+  SST_ASSERT((plaintext != nullptr));
+  if (!ciphertext_is_auth(ciphertext, ciphertext_size)) {
+    throw invalid_ciphertext();
+  }
+  static_cast<void>(auth_plaintext_size(ciphertext_size));
+  int const s = sodium::crypto_box_open_easy_afternm(
+      plaintext,
+      ciphertext + 1 + crypto_box_NONCEBYTES,
+      sst::checked_cast<unsigned long long>(
+          ciphertext_size - static_cast<CiphertextSize>(1)
+          - static_cast<CiphertextSize>(crypto_box_NONCEBYTES)),
+      ciphertext + 1,
+      shared_key);
+  if (s == -1) {
+    throw invalid_ciphertext();
+  }
+  if (s != 0) {
+    throw std::runtime_error(
+        "crypto_box_open_easy_afternm() failed (libsodium error code "
+        + sst::to_string(s) + ").");
+  }
+  return ciphertext + 1;
+}
+
+template<class SharedKey, class Ciphertext, class Plaintext>
+auto auth_decrypt_afternm(SharedKey const & shared_key,
+                          Ciphertext && ciphertext,
+                          Plaintext & plaintext)
+    -> sst::conditional_t<std::is_const<sst::remove_reference_t<
+                              decltype(*ciphertext.data())>>::value,
+                          unsigned char const *,
+                          unsigned char *> {
+  using R =
+      sst::conditional_t<std::is_const<sst::remove_reference_t<
+                             decltype(*ciphertext.data())>>::value,
+                         unsigned char const *,
+                         unsigned char *>;
+  SST_STATIC_ASSERT(
+      (sst::is_byte<typename SharedKey::value_type>::value));
+  SST_ASSERT(
+      (shared_key.size()
+       == auth_shared_key_size<typename SharedKey::size_type>()));
+  SST_STATIC_ASSERT((sst::is_byte<typename sst::remove_reference_t<
+                         Ciphertext>::value_type>::value));
+  SST_STATIC_ASSERT(
+      (sst::is_byte<typename Plaintext::value_type>::value));
+  plaintext.resize(auth_plaintext_size<typename Plaintext::size_type>(
+      ciphertext.size()));
+  return auth_decrypt_afternm(
+      reinterpret_cast<unsigned char const *>(shared_key.data()),
+      reinterpret_cast<R>(ciphertext.data()),
+      ciphertext.size(),
+      reinterpret_cast<unsigned char *>(plaintext.data()));
+}
+
 //----------------------------------------------------------------------
 
 } // namespace pkc
@@ -0,0 +1,111 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/pkc/shared_key_cache_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/pkc/shared_key_cache_t.hpp>
+//
+
+#include <cstddef>
+#include <mutex>
+
+#include <sst/catalog/SST_ASSERT.h>
+
+#include <kestrel/generic_hash_t.hpp>
+#include <kestrel/pkc.hpp>
+#include <kestrel/sodium.hpp>
+
+namespace kestrel {
+namespace pkc {
+
+shared_key_cache_t::shared_key_cache_t(std::size_t const max_entries)
+    : max_entries_(max_entries == 0 ? 1 : max_entries) {
+}
+
+shared_key_cache_t::~shared_key_cache_t() noexcept {
+  clear();
+}
+
+shared_key_cache_t::shared_key_t
+shared_key_cache_t::get(unsigned char const * const secret_key,
+                        std::size_t const secret_key_size,
+                        unsigned char const * const public_key,
+                        std::size_t const public_key_size) {
+  generic_hash_t hash;
+  hash.update(secret_key, secret_key_size);
+  hash.update(public_key, public_key_size);
+  id_t const & id = hash.finish();
+  {
+    std::lock_guard<std::mutex> const lock(mutex_);
+    auto const it = keys_.find(id);
+    if (it != keys_.end()) {
+      ++hits_;
+      lru_.splice(lru_.begin(), lru_, it->second.lru);
+      return it->second.key;
+    }
+  }
+  shared_key_t key;
+  auth_precompute(secret_key, public_key, key.data());
+  std::lock_guard<std::mutex> const lock(mutex_);
+  ++misses_;
+  auto const it = keys_.find(id);
+  if (it != keys_.end()) {
+    // Another thread computed the same key while we were unlocked.
+    lru_.splice(lru_.begin(), lru_, it->second.lru);
+    return it->second.key;
+  }
+  if (keys_.size() >= max_entries_) {
+    auto const victim = keys_.find(lru_.back());
+    SST_ASSERT((victim != keys_.end()));
+    sodium::sodium_memzero(victim->second.key.data(),
+                           victim->second.key.size());
+    keys_.erase(victim);
+    lru_.pop_back();
+  }
+  lru_.push_front(id);
+  keys_.emplace(id, entry_t{key, lru_.begin()});
+  return key;
+}
+
+void shared_key_cache_t::clear() {
+  std::lock_guard<std::mutex> const lock(mutex_);
+  for (auto & kv : keys_) {
+    sodium::sodium_memzero(kv.second.key.data(), kv.second.key.size());
+  }
+  keys_.clear();
+  lru_.clear();
+}
+
+std::size_t shared_key_cache_t::size() const {
+  std::lock_guard<std::mutex> const lock(mutex_);
+  return keys_.size();
+}
+
+std::size_t shared_key_cache_t::hits() const {
+  std::lock_guard<std::mutex> const lock(mutex_);
+  return hits_;
+}
+
+std::size_t shared_key_cache_t::misses() const {
+  std::lock_guard<std::mutex> const lock(mutex_);
+  return misses_;
+}
+
+} // namespace pkc
+} // namespace kestrel
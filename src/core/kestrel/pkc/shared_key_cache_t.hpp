@@ -0,0 +1,133 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_PKC_SHARED_KEY_CACHE_T_HPP
+#define KESTREL_PKC_SHARED_KEY_CACHE_T_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include <sst/catalog/SST_ASSERT.h>
+#include <sst/catalog/SST_STATIC_ASSERT.h>
+#include <sst/catalog/is_byte.hpp>
+
+#include <sodium.h>
+
+namespace kestrel {
+namespace pkc {
+
+//
+// A shared_key_cache_t remembers the auth_precompute result for each
+// (secret key, public key) pair it has seen, so that repeated traffic
+// with the same peer only pays for the curve operation once.
+//
+// Entries are keyed by a hash of the key material itself rather than
+// by who the peer is, so a peer whose public key changes (or a local
+// keypair change) simply misses the cache instead of reusing a stale
+// shared key. The cache holds at most max_entries keys, and the least
+// recently used entry is dropped (and zeroed) to make room when it is
+// full.
+//
+// All member functions are thread-safe.
+//
+
+class shared_key_cache_t final {
+
+public:
+
+  using shared_key_t =
+      std::array<unsigned char, crypto_box_BEFORENMBYTES>;
+
+private:
+
+  using id_t = std::array<unsigned char, crypto_generichash_BYTES>;
+
+  struct id_hash_t final {
+    std::size_t operator()(id_t const & x) const noexcept {
+      std::size_t h;
+      SST_STATIC_ASSERT((sizeof(h) <= sizeof(id_t)));
+      std::memcpy(&h, x.data(), sizeof(h));
+      return h;
+    }
+  };
+
+  struct entry_t final {
+    shared_key_t key;
+    std::list<id_t>::iterator lru;
+  };
+
+  mutable std::mutex mutex_;
+  std::unordered_map<id_t, entry_t, id_hash_t> keys_;
+
+  // The ids of keys_, most recently used first.
+  std::list<id_t> lru_;
+
+  std::size_t max_entries_;
+  std::size_t hits_ = 0;
+  std::size_t misses_ = 0;
+
+  shared_key_t get(unsigned char const * secret_key,
+                   std::size_t secret_key_size,
+                   unsigned char const * public_key,
+                   std::size_t public_key_size);
+
+public:
+
+  explicit shared_key_cache_t(std::size_t max_entries = 4096);
+
+  shared_key_cache_t(shared_key_cache_t const &) = delete;
+  shared_key_cache_t & operator=(shared_key_cache_t const &) = delete;
+  shared_key_cache_t(shared_key_cache_t &&) = delete;
+  shared_key_cache_t & operator=(shared_key_cache_t &&) = delete;
+  ~shared_key_cache_t() noexcept;
+
+  // Returns the shared key for our secret key and their public key,
+  // computing it on a miss.
+  template<class SecretKey, class PublicKey>
+  shared_key_t get(SecretKey const & secret_key,
+                   PublicKey const & public_key) {
+    SST_STATIC_ASSERT(
+        (sst::is_byte<typename SecretKey::value_type>::value));
+    SST_STATIC_ASSERT(
+        (sst::is_byte<typename PublicKey::value_type>::value));
+    SST_ASSERT((secret_key.size() == crypto_box_SECRETKEYBYTES));
+    SST_ASSERT((public_key.size() == crypto_box_PUBLICKEYBYTES));
+    return get(
+        reinterpret_cast<unsigned char const *>(secret_key.data()),
+        secret_key.size(),
+        reinterpret_cast<unsigned char const *>(public_key.data()),
+        public_key.size());
+  }
+
+  void clear();
+
+  std::size_t size() const;
+
+  std::size_t hits() const;
+
+  std::size_t misses() const;
+};
+
+} // namespace pkc
+} // namespace kestrel
+
+#endif // #ifndef KESTREL_PKC_SHARED_KEY_CACHE_T_HPP
@@ -21,10 +21,12 @@
 
 #include <memory>
 
+#include <kestrel/object_pool_t.hpp>
+
 namespace kestrel {
 
 template<class T>
-using pooled = std::unique_ptr<T>;
+using pooled = std::unique_ptr<T, pool_deleter_t<T>>;
 
 } // namespace kestrel
 
@@ -0,0 +1,350 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_PRIME_FIELD_T_HPP
+#define KESTREL_PRIME_FIELD_T_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <sst/catalog/SST_ASSERT.h>
+#include <sst/catalog/bigint.hpp>
+#include <sst/catalog/integer_rep.hpp>
+
+#include <kestrel/bytes_t.hpp>
+
+namespace kestrel {
+
+//
+// Arithmetic modulo an odd prime of at most 64 * MaxLimbs bits using
+// fixed-size limb arrays and Montgomery multiplication. Elements never
+// allocate, and only inversion goes through sst::bigint.
+//
+// Elements are only meaningful together with the prime_field_t object
+// that created them.
+//
+
+template<std::size_t MaxLimbs>
+class prime_field_t final {
+
+  static_assert(MaxLimbs > 0, "");
+
+public:
+
+  using limb_t = std::uint64_t;
+
+  class element_t final {
+    friend class prime_field_t;
+    // Montgomery form, little-endian limbs. Limbs past the modulus
+    // size are always zero.
+    std::array<limb_t, MaxLimbs> v_{};
+
+  public:
+
+    bool operator==(element_t const & other) const noexcept {
+      return v_ == other.v_;
+    }
+
+    bool operator!=(element_t const & other) const noexcept {
+      return !(*this == other);
+    }
+  };
+
+private:
+
+  __extension__ using dlimb_t = unsigned __int128;
+
+  sst::bigint modulus_;
+  std::size_t n_ = 0;
+  std::array<limb_t, MaxLimbs> p_{};
+  limb_t p_inv_ = 0; // -p^-1 mod 2^64
+  element_t one_{};
+  // R^2 mod p, not in Montgomery form.
+  std::array<limb_t, MaxLimbs> r2_{};
+
+  static void to_limbs(std::array<limb_t, MaxLimbs> & dst,
+                       sst::bigint const & x,
+                       std::size_t const n) {
+    bytes_t buf(n * sizeof(limb_t));
+    x.to_bytes(buf.begin(),
+               buf.size(),
+               sst::integer_rep::pure_unsigned());
+    dst.fill(0);
+    for (std::size_t i = 0; i < buf.size(); ++i) {
+      dst[i / sizeof(limb_t)] |= static_cast<limb_t>(buf[i])
+                                 << (8 * (i % sizeof(limb_t)));
+    }
+  }
+
+  // a >= p, comparing the low n_ limbs.
+  bool geq_p(limb_t const * const a) const noexcept {
+    for (std::size_t i = n_; i-- > 0;) {
+      if (a[i] != p_[i]) {
+        return a[i] > p_[i];
+      }
+    }
+    return true;
+  }
+
+  // a -= p, returning the borrow.
+  limb_t sub_p(limb_t * const a) const noexcept {
+    limb_t borrow = 0;
+    for (std::size_t i = 0; i < n_; ++i) {
+      dlimb_t const d = static_cast<dlimb_t>(a[i]) - p_[i] - borrow;
+      a[i] = static_cast<limb_t>(d);
+      borrow = static_cast<limb_t>(d >> 64) & 1U;
+    }
+    return borrow;
+  }
+
+  // Coarsely integrated operand scanning. Inputs are < p and the output
+  // is a * b / R mod p.
+  void mont_mul(limb_t * const r,
+                limb_t const * const a,
+                limb_t const * const b) const noexcept {
+    std::array<limb_t, MaxLimbs + 2> t{};
+    auto const n = n_;
+    for (std::size_t i = 0; i < n; ++i) {
+      limb_t c = 0;
+      for (std::size_t j = 0; j < n; ++j) {
+        dlimb_t const s =
+            static_cast<dlimb_t>(a[j]) * b[i] + t[j] + c;
+        t[j] = static_cast<limb_t>(s);
+        c = static_cast<limb_t>(s >> 64);
+      }
+      dlimb_t s = static_cast<dlimb_t>(t[n]) + c;
+      t[n] = static_cast<limb_t>(s);
+      t[n + 1] = static_cast<limb_t>(s >> 64);
+      limb_t const m = t[0] * p_inv_;
+      s = static_cast<dlimb_t>(m) * p_[0] + t[0];
+      c = static_cast<limb_t>(s >> 64);
+      for (std::size_t j = 1; j < n; ++j) {
+        s = static_cast<dlimb_t>(m) * p_[j] + t[j] + c;
+        t[j - 1] = static_cast<limb_t>(s);
+        c = static_cast<limb_t>(s >> 64);
+      }
+      s = static_cast<dlimb_t>(t[n]) + c;
+      t[n - 1] = static_cast<limb_t>(s);
+      t[n] = t[n + 1] + static_cast<limb_t>(s >> 64);
+    }
+    if (t[n] != 0 || geq_p(t.data())) {
+      sub_p(t.data());
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      r[i] = t[i];
+    }
+  }
+
+public:
+
+  //--------------------------------------------------------------------
+  // Construction
+  //--------------------------------------------------------------------
+
+  // Returns true if modulus can be used with this limb bound.
+  static bool fits(sst::bigint const & modulus) {
+    return modulus > 2 && modulus % sst::bigint(2) == sst::bigint(1)
+           && modulus < (sst::bigint(1) << (64 * MaxLimbs));
+  }
+
+  explicit prime_field_t(sst::bigint const & modulus)
+      : modulus_(modulus) {
+    if (!fits(modulus)) {
+      throw std::invalid_argument("prime_field_t: unsupported modulus");
+    }
+    n_ = 1;
+    while (modulus_ >= (sst::bigint(1) << (64 * n_))) {
+      ++n_;
+    }
+    to_limbs(p_, modulus_, n_);
+    limb_t inv = 1;
+    for (int i = 0; i < 6; ++i) {
+      inv *= 2 - p_[0] * inv;
+    }
+    p_inv_ = 0 - inv;
+    sst::bigint const r = (sst::bigint(1) << (64 * n_)) % modulus_;
+    to_limbs(one_.v_, r, n_);
+    to_limbs(r2_, mul_mod(r, r, modulus_), n_);
+  }
+
+  sst::bigint const & modulus() const noexcept {
+    return modulus_;
+  }
+
+  std::size_t limbs() const noexcept {
+    return n_;
+  }
+
+  //--------------------------------------------------------------------
+  // Conversions
+  //--------------------------------------------------------------------
+
+  element_t zero() const noexcept {
+    return element_t();
+  }
+
+  element_t const & one() const noexcept {
+    return one_;
+  }
+
+  element_t from_bigint(sst::bigint const & x) const {
+    SST_ASSERT((x >= 0));
+    element_t r;
+    to_limbs(r.v_, x < modulus_ ? x : x % modulus_, n_);
+    mont_mul(r.v_.data(), r.v_.data(), r2_.data());
+    return r;
+  }
+
+  element_t from_uint(std::uint64_t const x) const {
+    element_t r;
+    r.v_[0] = x;
+    if (n_ == 1 && x >= p_[0]) {
+      r.v_[0] = x % p_[0];
+    }
+    mont_mul(r.v_.data(), r.v_.data(), r2_.data());
+    return r;
+  }
+
+  // Writes x as size little-endian bytes, the same format as
+  // sst::bigint::to_bytes with sst::integer_rep::pure_unsigned().
+  template<class ByteIt>
+  ByteIt to_bytes(element_t const & x,
+                  ByteIt dst,
+                  std::size_t const size) const {
+    std::array<limb_t, MaxLimbs> one{};
+    one[0] = 1;
+    std::array<limb_t, MaxLimbs> y{};
+    mont_mul(y.data(), x.v_.data(), one.data());
+    for (std::size_t i = 0; i < size; ++i, ++dst) {
+      auto const k = i / sizeof(limb_t);
+      *dst = k < n_ ? static_cast<unsigned char>(
+                 y[k] >> (8 * (i % sizeof(limb_t)))) :
+                      0U;
+    }
+    return dst;
+  }
+
+  sst::bigint to_bigint(element_t const & x) const {
+    bytes_t buf(n_ * sizeof(limb_t));
+    to_bytes(x, buf.begin(), buf.size());
+    return sst::bigint(buf, sst::integer_rep::pure_unsigned());
+  }
+
+  //--------------------------------------------------------------------
+  // Arithmetic
+  //--------------------------------------------------------------------
+
+  bool is_zero(element_t const & x) const noexcept {
+    for (std::size_t i = 0; i < n_; ++i) {
+      if (x.v_[i] != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  element_t add(element_t const & a,
+                element_t const & b) const noexcept {
+    element_t r;
+    limb_t c = 0;
+    for (std::size_t i = 0; i < n_; ++i) {
+      dlimb_t const s = static_cast<dlimb_t>(a.v_[i]) + b.v_[i] + c;
+      r.v_[i] = static_cast<limb_t>(s);
+      c = static_cast<limb_t>(s >> 64);
+    }
+    if (c != 0 || geq_p(r.v_.data())) {
+      sub_p(r.v_.data());
+    }
+    return r;
+  }
+
+  element_t sub(element_t const & a,
+                element_t const & b) const noexcept {
+    element_t r;
+    limb_t borrow = 0;
+    for (std::size_t i = 0; i < n_; ++i) {
+      dlimb_t const d =
+          static_cast<dlimb_t>(a.v_[i]) - b.v_[i] - borrow;
+      r.v_[i] = static_cast<limb_t>(d);
+      borrow = static_cast<limb_t>(d >> 64) & 1U;
+    }
+    if (borrow != 0) {
+      limb_t c = 0;
+      for (std::size_t i = 0; i < n_; ++i) {
+        dlimb_t const s = static_cast<dlimb_t>(r.v_[i]) + p_[i] + c;
+        r.v_[i] = static_cast<limb_t>(s);
+        c = static_cast<limb_t>(s >> 64);
+      }
+    }
+    return r;
+  }
+
+  element_t neg(element_t const & a) const noexcept {
+    return sub(zero(), a);
+  }
+
+  element_t mul(element_t const & a,
+                element_t const & b) const noexcept {
+    element_t r;
+    mont_mul(r.v_.data(), a.v_.data(), b.v_.data());
+    return r;
+  }
+
+  element_t inv(element_t const & a) const {
+    if (is_zero(a)) {
+      throw std::domain_error("prime_field_t: inverse of zero");
+    }
+    return from_bigint(inv_mod(to_bigint(a), modulus_));
+  }
+
+  //
+  // Replaces every element of xs by its inverse using Montgomery's
+  // trick: one inversion and 3(n-1) multiplications.
+  //
+  void batch_inv(std::vector<element_t> & xs) const {
+    if (xs.empty()) {
+      return;
+    }
+    std::vector<element_t> prefix(xs.size());
+    prefix[0] = xs[0];
+    for (std::size_t i = 1; i < xs.size(); ++i) {
+      prefix[i] = mul(prefix[i - 1], xs[i]);
+    }
+    element_t acc = inv(prefix.back());
+    for (std::size_t i = xs.size(); i-- > 1;) {
+      element_t const x = xs[i];
+      xs[i] = mul(acc, prefix[i - 1]);
+      acc = mul(acc, x);
+    }
+    xs[0] = acc;
+  }
+};
+
+//
+// Field type for the CARMA mixing prime. The default prime is
+// 101 * 2^3767 + 1, which needs 59 limbs.
+//
+
+using mix_field_t = prime_field_t<60>;
+
+} // namespace kestrel
+
+#endif // #ifndef KESTREL_PRIME_FIELD_T_HPP
@@ -149,6 +149,12 @@ class connection_t final {
   }
 
   //--------------------------------------------------------------------
+  //
+  // The outbox owns every package sent on this connection that has not
+  // yet had its final status fired. The worker thread only holds weak
+  // pointers, so dropping an entry here cancels it. Entries that have
+  // been fired are dropped from the front by inner_sendPackage().
+  //
 
   using outbox_t = std::deque<std::shared_ptr<outbox_entry_t>>;
 
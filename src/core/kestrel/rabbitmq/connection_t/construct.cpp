@@ -61,7 +61,7 @@ connection_t::connection_t(tracing_event_t tev,
     worker_ = w.lock();
     bool const create = worker_ == nullptr;
     if (create) {
-      worker_ = std::make_shared<worker_t>(SST_TEV_ARG(tev), link);
+      worker_ = std::make_shared<worker_t>(SST_TEV_ARG(tev), plugin);
       CARMA_XLOG_DEBUG(plugin.sdk(),
                        0,
                        SST_TEV_ARG(tev, "event", "worker_created"));
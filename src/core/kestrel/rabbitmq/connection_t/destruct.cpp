@@ -73,6 +73,7 @@ connection_t::~connection_t() noexcept {
         SST_ASSERT(queue().status == status_t::active);
         queue().status = status_t::destroy;
         ++worker().queue_actions_;
+        worker().wake();
       }
     }
     try {
@@ -75,18 +75,6 @@ public:
 
   //--------------------------------------------------------------------
 
-private:
-
-  bool sent_ = false;
-
-public:
-
-  SST_NODISCARD() bool & sent() noexcept {
-    return sent_;
-  }
-
-  //--------------------------------------------------------------------
-
 public:
 
   enum class fired_t { not_yet, by_main_thread, by_worker_thread };
@@ -58,6 +58,16 @@ void plugin_t::inner_sendPackage(tracing_event_t tev,
     collect_garbage(SST_TEV_ARG(tev));
     connection_t & connection = expect_connection(connectionId);
     worker_t & worker = connection.worker();
+    while (!connection.outbox().empty()) {
+      std::shared_ptr<outbox_entry_t> const & front =
+          connection.outbox().front();
+      if (front != nullptr
+          && front->fired().load()
+                 == outbox_entry_t::fired_t::not_yet) {
+        break;
+      }
+      connection.outbox().pop_front();
+    }
     connection.outbox().emplace_back(nullptr);
     std::shared_ptr<outbox_entry_t> & x = connection.outbox().back();
     std::shared_ptr<outbox_entry_t> y =
@@ -70,6 +80,7 @@ void plugin_t::inner_sendPackage(tracing_event_t tev,
       worker.outbox().emplace(y);
     }
     x = std::move(y);
+    worker.wake();
   }
   SST_TEV_RETHROW(tev);
 }
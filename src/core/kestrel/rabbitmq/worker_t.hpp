@@ -26,6 +26,7 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <future>
 #include <map>
 #include <memory>
@@ -60,6 +61,20 @@ class plugin_t;
 class link_t;
 class connection_t;
 
+//
+// A worker owns one thread and one AMQP connection to one broker, and
+// serves every link that uses that broker in the same role. The
+// plugin looks workers up by broker address, credentials, and role
+// (see worker_key_cmp_t), so adding a link to a known broker only adds
+// a queue to an existing worker. A receiver consumes all of its queues
+// on one channel, and a sender publishes to all of its queues on one
+// channel. Thread and connection counts therefore scale with the
+// number of brokers, not the number of links.
+//
+// Since a worker outlives any particular link, it never refers back to
+// a link. Per-link information lives in the queues and connections.
+//
+
 class worker_t final {
 
   friend class plugin_t;
@@ -91,30 +106,6 @@ public:
     return *plugin_;
   }
 
-  //--------------------------------------------------------------------
-  // Parent link
-  //--------------------------------------------------------------------
-  //
-  // link_ is a back pointer to the parent link. The lifetime of a
-  // worker is a subset of its parent link, so link_ will never be null.
-  //
-
-private:
-
-  link_t * link_;
-
-public:
-
-  link_t & link() SST_NOEXCEPT(true) {
-    SST_ASSERT((link_ != nullptr));
-    return *link_;
-  }
-
-  link_t const & link() const SST_NOEXCEPT(true) {
-    SST_ASSERT((link_ != nullptr));
-    return *link_;
-  }
-
   //--------------------------------------------------------------------
   // Mutexing
   //--------------------------------------------------------------------
@@ -187,6 +178,38 @@ public:
 
   sst::unique_ptr<std::atomic<bool>> stop_{sst::in_place, false};
 
+  //--------------------------------------------------------------------
+  // Wakeups
+  //--------------------------------------------------------------------
+  //
+  // wake_fd_ is an eventfd that other threads write to whenever they
+  // give the worker thread something to do: a new outbox entry, a new
+  // queue action, or a stop request. The worker thread blocks on it,
+  // and on the AMQP socket if it is a receiver, instead of sleeping.
+  //
+
+  int wake_fd_ = -1;
+
+  // The longest the worker thread blocks in wait(). This only bounds
+  // how long we can miss input that is buffered inside the TLS layer,
+  // which poll() cannot see.
+  sst::mono_time_ms_t max_wait_ms_ = 1000;
+
+public:
+
+  void wake() noexcept;
+
+private:
+
+  // True if a receive() would find data without blocking.
+  bool input_pending(tracing_event_t tev);
+
+  // Blocks until wake() is called, the timeout expires, or, if
+  // watch_socket is true, the AMQP socket becomes readable.
+  void wait(tracing_event_t tev,
+            bool watch_socket,
+            sst::mono_time_ms_t timeout_ms);
+
   //--------------------------------------------------------------------
 
   void error_sleep() noexcept;
@@ -217,6 +240,66 @@ private:
 
   std::shared_ptr<outbox_entry_t> outbox_entry_;
 
+  //--------------------------------------------------------------------
+  // Publisher confirms
+  //--------------------------------------------------------------------
+  //
+  // A sender puts its channel into confirm mode and publishes entries
+  // back-to-back without waiting for each one. The broker numbers the
+  // messages published on a channel 1, 2, 3, ... and acknowledges them
+  // by that delivery tag, possibly several at a time. unconfirmed_
+  // holds the published entries in delivery tag order until the
+  // broker acks or nacks them, which is when PACKAGE_SENT or
+  // PACKAGE_FAILED_GENERIC is fired.
+  //
+  // If the connection drops, the broker forgets the delivery tags, so
+  // connect() moves all unconfirmed entries to resend_ to be published
+  // again on the new channel ahead of the rest of the outbox.
+  //
+  // The entries are held by weak pointer, as the connection that owns
+  // an entry may fail it and go away at any time.
+  //
+
+private:
+
+  struct unconfirmed_t final {
+    std::uint64_t delivery_tag;
+    std::weak_ptr<outbox_entry_t> entry;
+  };
+
+  using unconfirmed_queue_t = std::deque<unconfirmed_t>;
+
+  sst::unique_ptr<unconfirmed_queue_t> unconfirmed_{sst::in_place};
+
+  SST_NODISCARD() unconfirmed_queue_t & unconfirmed() noexcept {
+    SST_ASSERT(unconfirmed_ != nullptr);
+    return *unconfirmed_;
+  }
+
+  using resend_t = std::deque<std::weak_ptr<outbox_entry_t>>;
+
+  sst::unique_ptr<resend_t> resend_{sst::in_place};
+
+  SST_NODISCARD() resend_t & resend() noexcept {
+    SST_ASSERT(resend_ != nullptr);
+    return *resend_;
+  }
+
+  std::uint64_t next_delivery_tag_ = 1;
+
+  // The most entries we let be unconfirmed at once. This bounds the
+  // amount of work that must be redone after a connection drop.
+  std::size_t max_unconfirmed_ = 1024;
+
+  // Handles a basic.ack or basic.nack from the broker.
+  void confirm(tracing_event_t tev,
+               std::uint64_t delivery_tag,
+               bool multiple,
+               bool ack);
+
+  // Handles all confirms that can be read without blocking.
+  void receive_confirms(tracing_event_t tev);
+
   //--------------------------------------------------------------------
   // RabbitMQ connection
   //--------------------------------------------------------------------
@@ -279,7 +362,7 @@ private:
 
 public:
 
-  explicit worker_t(tracing_event_t tev, link_t & link);
+  explicit worker_t(tracing_event_t tev, plugin_t & plugin);
 
   worker_t(worker_t const &) = delete;
   worker_t & operator=(worker_t const &) = delete;
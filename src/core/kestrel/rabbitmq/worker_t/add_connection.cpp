@@ -95,6 +95,9 @@ worker_t::add_connection(tracing_event_t tev,
       queue.status = queue_t::status_t::active;
       --queue_actions_;
     }
+    if (r.second) {
+      wake();
+    }
     return queue;
   }
   SST_TEV_RETHROW(tev);
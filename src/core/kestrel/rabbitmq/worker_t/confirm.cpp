@@ -0,0 +1,100 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/rabbitmq/worker_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/rabbitmq/worker_t.hpp>
+//
+
+#include <kestrel/catalog/KESTREL_WITH_KESTREL_RABBITMQ.h>
+
+#if KESTREL_WITH_KESTREL_RABBITMQ
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+#include <sst/catalog/SST_TEV_ADD.hpp>
+#include <sst/catalog/SST_TEV_DEF.hpp>
+#include <sst/catalog/SST_TEV_RETHROW.hpp>
+
+#include <PackageStatus.h>
+
+#include <kestrel/rabbitmq/outbox_entry_t.hpp>
+#include <kestrel/rabbitmq/plugin_t.hpp>
+#include <kestrel/tracing_event_t.hpp>
+
+namespace kestrel {
+namespace rabbitmq {
+
+void worker_t::confirm(tracing_event_t tev,
+                       std::uint64_t const delivery_tag,
+                       bool const multiple,
+                       bool const ack) {
+  SST_TEV_ADD(tev);
+  try {
+
+    // Each entry is removed right after its event is fired. If the SDK
+    // throws, the entries after it stay unconfirmed until a reconnect
+    // republishes them or their connection fails them.
+    auto const fire = [&](unconfirmed_t const & u) {
+      std::shared_ptr<outbox_entry_t> const entry = u.entry.lock();
+      if (entry != nullptr) {
+        auto & x = entry->fired();
+        auto a = outbox_entry_t::fired_t::not_yet;
+        auto const b = outbox_entry_t::fired_t::by_worker_thread;
+        if (x.compare_exchange_strong(a, b)) {
+          plugin().sdk().onPackageStatusChanged(
+              SST_TEV_DEF(tracing_event_t),
+              entry->handle().value(),
+              ack ? PACKAGE_SENT : PACKAGE_FAILED_GENERIC,
+              0);
+        }
+      }
+    };
+
+    if (multiple) {
+      while (!unconfirmed().empty()
+             && unconfirmed().front().delivery_tag <= delivery_tag) {
+        fire(unconfirmed().front());
+        unconfirmed().pop_front();
+      }
+    } else {
+      auto const it = std::lower_bound(
+          unconfirmed().begin(),
+          unconfirmed().end(),
+          delivery_tag,
+          [](unconfirmed_t const & u, std::uint64_t const tag) {
+            return u.delivery_tag < tag;
+          });
+      if (it != unconfirmed().end()
+          && it->delivery_tag == delivery_tag) {
+        fire(*it);
+        unconfirmed().erase(it);
+      }
+    }
+
+  } //
+  SST_TEV_RETHROW(tev);
+}
+
+} // namespace rabbitmq
+} // namespace kestrel
+
+#endif // #if KESTREL_WITH_KESTREL_RABBITMQ
@@ -27,6 +27,7 @@
 #if KESTREL_WITH_KESTREL_RABBITMQ
 
 #include <stdexcept>
+#include <utility>
 
 #include <sys/time.h>
 
@@ -37,6 +38,7 @@
 #include <amqp.h>
 #include <amqp_tcp_socket.h>
 #include <kestrel/catalog/KESTREL_WITH_OPENSSL_SSL.h>
+#include <kestrel/link_role_t.hpp>
 #include <kestrel/rabbitmq/link_addrinfo_t.hpp>
 #include <kestrel/tracing_event_t.hpp>
 
@@ -122,6 +124,18 @@ void worker_t::connect(tracing_event_t tev,
             throw std::runtime_error("amqp_channel_open() failed");
           }
         }
+        if (server.role() == link_role_t::loader()) {
+          (void)amqp_confirm_select(connection_, channel_);
+          amqp_rpc_reply_t const r = amqp_get_rpc_reply(connection_);
+          if (r.reply_type != AMQP_RESPONSE_NORMAL) {
+            throw std::runtime_error("amqp_confirm_select() failed");
+          }
+          next_delivery_tag_ = 1;
+          while (!unconfirmed().empty()) {
+            resend().push_front(std::move(unconfirmed().back().entry));
+            unconfirmed().pop_back();
+          }
+        }
         connected_ = true;
       }
     } catch (...) {
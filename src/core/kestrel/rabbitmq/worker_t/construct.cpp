@@ -26,22 +26,28 @@
 
 #if KESTREL_WITH_KESTREL_RABBITMQ
 
+#include <stdexcept>
+
+#include <sys/eventfd.h>
+
 #include <sst/catalog/SST_TEV_ADD.hpp>
 #include <sst/catalog/SST_TEV_ARG.hpp>
 #include <sst/catalog/SST_TEV_RETHROW.hpp>
 
-#include <kestrel/rabbitmq/link_t.hpp>
 #include <kestrel/rabbitmq/plugin_t.hpp>
 #include <kestrel/tracing_event_t.hpp>
 
 namespace kestrel {
 namespace rabbitmq {
 
-worker_t::worker_t(tracing_event_t tev, link_t & link)
-    : plugin_(&link.plugin()),
-      link_(&link) {
+worker_t::worker_t(tracing_event_t tev, plugin_t & plugin)
+    : plugin_(&plugin) {
   SST_TEV_ADD(tev);
   try {
+    wake_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wake_fd_ < 0) {
+      throw std::runtime_error("eventfd() failed.");
+    }
   }
   SST_TEV_RETHROW(tev);
 }
@@ -26,6 +26,8 @@
 
 #if KESTREL_WITH_KESTREL_RABBITMQ
 
+#include <unistd.h>
+
 #include <amqp.h>
 
 namespace kestrel {
@@ -33,12 +35,17 @@ namespace rabbitmq {
 
 worker_t::~worker_t() noexcept {
   stop_->store(true);
+  wake();
   if (thread_->valid()) {
     try {
       thread_->get();
     } catch (...) {
     }
   }
+  if (wake_fd_ >= 0) {
+    ::close(wake_fd_);
+    wake_fd_ = -1;
+  }
   if (have_envelope_) {
     amqp_destroy_envelope(&envelope_);
     have_envelope_ = false;
@@ -0,0 +1,76 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/rabbitmq/worker_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/rabbitmq/worker_t.hpp>
+//
+
+#include <kestrel/catalog/KESTREL_WITH_KESTREL_RABBITMQ.h>
+
+#if KESTREL_WITH_KESTREL_RABBITMQ
+
+#include <cerrno>
+#include <stdexcept>
+
+#include <poll.h>
+
+#include <sst/catalog/SST_ASSERT.h>
+#include <sst/catalog/SST_TEV_ADD.hpp>
+#include <sst/catalog/SST_TEV_ARG.hpp>
+#include <sst/catalog/SST_TEV_RETHROW.hpp>
+
+#include <amqp.h>
+#include <kestrel/tracing_event_t.hpp>
+
+namespace kestrel {
+namespace rabbitmq {
+
+bool worker_t::input_pending(tracing_event_t tev) {
+  SST_TEV_ADD(tev);
+  try {
+    SST_ASSERT(connection_ != nullptr);
+    SST_ASSERT(connected_);
+
+    // RabbitMQ-C may already have read more than it has handed out, in
+    // which case the socket will not become readable for it.
+    if (amqp_frames_enqueued(connection_)
+        || amqp_data_in_buffer(connection_)) {
+      return true;
+    }
+
+    pollfd fd{};
+    fd.fd = amqp_get_sockfd(connection_);
+    fd.events = POLLIN;
+    int const r = ::poll(&fd, 1, 0);
+    if (r < 0) {
+      if (errno == EINTR) {
+        return false;
+      }
+      throw std::runtime_error("poll() failed.");
+    }
+    return r > 0;
+  }
+  SST_TEV_RETHROW(tev);
+}
+
+} // namespace rabbitmq
+} // namespace kestrel
+
+#endif // #if KESTREL_WITH_KESTREL_RABBITMQ
@@ -0,0 +1,114 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/rabbitmq/worker_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/rabbitmq/worker_t.hpp>
+//
+
+#include <kestrel/catalog/KESTREL_WITH_KESTREL_RABBITMQ.h>
+
+#if KESTREL_WITH_KESTREL_RABBITMQ
+
+#include <stdexcept>
+
+#include <sys/time.h>
+
+#include <sst/catalog/SST_ASSERT.h>
+#include <sst/catalog/SST_TEV_ADD.hpp>
+#include <sst/catalog/SST_TEV_ARG.hpp>
+#include <sst/catalog/SST_TEV_RETHROW.hpp>
+
+#include <amqp.h>
+#include <kestrel/tracing_event_t.hpp>
+
+namespace kestrel {
+namespace rabbitmq {
+
+void worker_t::receive_confirms(tracing_event_t tev) {
+  SST_TEV_ADD(tev);
+  try {
+    try {
+
+      SST_ASSERT(connection_ != nullptr);
+      SST_ASSERT(socket_ != nullptr);
+      SST_ASSERT(connected_);
+
+      while (!unconfirmed().empty()
+             && input_pending(SST_TEV_ARG(tev))) {
+
+        timeval timeout{};
+        timeout.tv_usec = receive_timeout_us_;
+
+        amqp_frame_t frame{};
+        int const s = amqp_simple_wait_frame_noblock(connection_,
+                                                     &frame,
+                                                     &timeout);
+        if (s == AMQP_STATUS_TIMEOUT) {
+          return;
+        }
+        if (s != AMQP_STATUS_OK) {
+          throw std::runtime_error(
+              "amqp_simple_wait_frame_noblock() failed.");
+        }
+
+        if (frame.frame_type != AMQP_FRAME_METHOD) {
+          continue;
+        }
+        switch (frame.payload.method.id) {
+          case AMQP_BASIC_ACK_METHOD: {
+            amqp_basic_ack_t const & m =
+                *static_cast<amqp_basic_ack_t const *>(
+                    frame.payload.method.decoded);
+            confirm(SST_TEV_ARG(tev),
+                    m.delivery_tag,
+                    m.multiple != 0,
+                    true);
+          } break;
+          case AMQP_BASIC_NACK_METHOD: {
+            amqp_basic_nack_t const & m =
+                *static_cast<amqp_basic_nack_t const *>(
+                    frame.payload.method.decoded);
+            confirm(SST_TEV_ARG(tev),
+                    m.delivery_tag,
+                    m.multiple != 0,
+                    false);
+          } break;
+          case AMQP_CHANNEL_CLOSE_METHOD:
+          case AMQP_CONNECTION_CLOSE_METHOD: {
+            throw std::runtime_error(
+                "The broker closed the publishing channel.");
+          } break;
+          default: {
+          } break;
+        }
+      }
+
+    } catch (...) {
+      disconnect();
+      throw;
+    }
+  }
+  SST_TEV_RETHROW(tev);
+}
+
+} // namespace rabbitmq
+} // namespace kestrel
+
+#endif // #if KESTREL_WITH_KESTREL_RABBITMQ
@@ -27,10 +27,9 @@
 #if KESTREL_WITH_KESTREL_RABBITMQ
 
 #include <array>
-#include <chrono>
+#include <memory>
 #include <mutex>
 #include <string>
-#include <thread>
 #include <utility>
 
 #include <sst/catalog/SST_ASSERT.h>
@@ -52,6 +51,7 @@
 #include <kestrel/json_t.hpp>
 #include <kestrel/link_role_t.hpp>
 #include <kestrel/rabbitmq/link_addrinfo_t.hpp>
+#include <kestrel/rabbitmq/outbox_entry_t.hpp>
 #include <kestrel/rabbitmq/plugin_t.hpp>
 #include <kestrel/tracing_event_t.hpp>
 
@@ -214,14 +214,25 @@ void worker_t::thread_function(
       }
 
       //----------------------------------------------------------------
-      // If we're a sender, send all the packages we can
+      // If we're a sender, publish all the packages we can
       //----------------------------------------------------------------
+      //
+      // Entries are published back-to-back without waiting for the
+      // broker, up to max_unconfirmed_ at a time. They are completed
+      // later by receive_confirms(). Entries that their connection has
+      // already failed are skipped.
+      //
 
       if (sender) {
-        while (true) {
+        while (unconfirmed().size() < max_unconfirmed_) {
 
           std::shared_ptr<outbox_entry_t> & entry = outbox_entry_;
 
+          while (entry == nullptr && !resend().empty()) {
+            entry = resend().front().lock();
+            resend().pop_front();
+          }
+
           if (entry == nullptr) {
             std::lock_guard<std::mutex> const lock(outbox_mutex());
             while (!outbox().empty()) {
@@ -239,30 +250,18 @@ void worker_t::thread_function(
           }
           SST_ASSERT(entry != nullptr);
 
-          if (!entry->sent()) {
+          if (entry->fired().load()
+              == outbox_entry_t::fired_t::not_yet) {
             send(SST_TEV_ARG(tev),
                  entry->package(),
                  *entry->connection().queue().name);
-            entry->sent() = true;
-          }
-          SST_ASSERT(entry->sent());
-
-          {
-            auto & x = entry->fired();
-            auto a = outbox_entry_t::fired_t::not_yet;
-            auto const b = outbox_entry_t::fired_t::by_worker_thread;
-            if (x.compare_exchange_strong(a, b) || a == b) {
-              plugin().sdk().onPackageStatusChanged(
-                  SST_TEV_DEF(tracing_event_t),
-                  entry->handle().value(),
-                  PACKAGE_SENT,
-                  0);
-            }
+            unconfirmed().push_back({next_delivery_tag_++, entry});
           }
 
           entry = nullptr;
 
         } //
+        receive_confirms(SST_TEV_ARG(tev));
       }
 
       //----------------------------------------------------------------
@@ -293,6 +292,8 @@ void worker_t::thread_function(
                 name.insert(name.end(), p, p + data.len);
               }
             }
+            amqp_destroy_envelope(&envelope_);
+            have_envelope_ = false;
             auto const it = queues().find(name);
             SST_ASSERT(it != queues().end());
             queue_t const & queue = it->second;
@@ -301,6 +302,13 @@ void worker_t::thread_function(
                                          *queue.connection_ids,
                                          0);
           }
+          // Only call receive() when something has arrived, as it
+          // blocks for up to receive_timeout_us_ otherwise. Once the
+          // first byte of a message is here, the rest of it follows
+          // quickly.
+          if (!input_pending(SST_TEV_ARG(tev))) {
+            break;
+          }
           receive(SST_TEV_ARG(tev));
           if (!have_envelope_) {
             break;
@@ -308,11 +316,26 @@ void worker_t::thread_function(
         }
       }
 
-      // This loop seems to run kind of hot. I'm not sure why the call
-      // to receive() above isn't relieving the CPU, as that call does
-      // make a non-blocking call to RabbitMQ-C with a decent timeout
-      // parameter. We'll just do a little sleep here, I guess.
-      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+      //----------------------------------------------------------------
+      // Block until there is more to do
+      //----------------------------------------------------------------
+      //
+      // Other threads wake us through wake_fd_ when they add an outbox
+      // entry or a queue action. A receiver also wakes up when its
+      // socket becomes readable, and so does a sender that is waiting
+      // for confirms. The timeout only covers the periodic queue scan.
+      //
+
+      if (!sst::is_positive(num_actions)) {
+        sst::mono_time_ms_t timeout_ms =
+            last_scan_ms_ + queue_ttl_ms_ / 4 - sst::mono_time_ms();
+        if (timeout_ms > max_wait_ms_) {
+          timeout_ms = max_wait_ms_;
+        }
+        wait(SST_TEV_ARG(tev),
+             receiver || !unconfirmed().empty(),
+             timeout_ms);
+      }
 
       //----------------------------------------------------------------
     } catch (tracing_exception_t const & e) {
@@ -0,0 +1,95 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/rabbitmq/worker_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/rabbitmq/worker_t.hpp>
+//
+
+#include <kestrel/catalog/KESTREL_WITH_KESTREL_RABBITMQ.h>
+
+#if KESTREL_WITH_KESTREL_RABBITMQ
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+
+#include <poll.h>
+#include <unistd.h>
+
+#include <sst/catalog/SST_ASSERT.h>
+#include <sst/catalog/SST_TEV_ADD.hpp>
+#include <sst/catalog/SST_TEV_ARG.hpp>
+#include <sst/catalog/SST_TEV_RETHROW.hpp>
+#include <sst/catalog/checked_cast.hpp>
+#include <sst/catalog/mono_time_ms_t.hpp>
+
+#include <amqp.h>
+#include <kestrel/tracing_event_t.hpp>
+
+namespace kestrel {
+namespace rabbitmq {
+
+void worker_t::wait(tracing_event_t tev,
+                    bool const watch_socket,
+                    sst::mono_time_ms_t const timeout_ms) {
+  SST_TEV_ADD(tev);
+  try {
+    SST_ASSERT(wake_fd_ >= 0);
+
+    bool const poll_socket = watch_socket && connected_;
+    if (poll_socket && input_pending(SST_TEV_ARG(tev))) {
+      return;
+    }
+
+    std::array<pollfd, 2> fds{};
+    nfds_t n = 0;
+    fds[n].fd = wake_fd_;
+    fds[n].events = POLLIN;
+    ++n;
+    if (poll_socket) {
+      fds[n].fd = amqp_get_sockfd(connection_);
+      fds[n].events = POLLIN;
+      ++n;
+    }
+
+    int const r = ::poll(fds.data(),
+                         n,
+                         sst::checked_cast<int>(
+                             timeout_ms < 0 ? 0 : timeout_ms));
+    if (r < 0) {
+      if (errno == EINTR) {
+        return;
+      }
+      throw std::runtime_error("poll() failed.");
+    }
+
+    if (fds[0].revents & POLLIN) {
+      std::uint64_t count;
+      static_cast<void>(::read(wake_fd_, &count, sizeof(count)));
+    }
+  }
+  SST_TEV_RETHROW(tev);
+}
+
+} // namespace rabbitmq
+} // namespace kestrel
+
+#endif // #if KESTREL_WITH_KESTREL_RABBITMQ
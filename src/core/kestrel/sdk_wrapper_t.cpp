@@ -41,6 +41,7 @@
 
 // CARMA headers
 #include <kestrel/config.h>
+#include <kestrel/log_sink_t.hpp>
 #include <kestrel/old_config_t.hpp>
 #include <kestrel/race_to_json.hpp>
 #include <kestrel/tracing_event_t.hpp>
@@ -50,6 +51,7 @@ namespace kestrel {
 void sdk_wrapper_t::set_config(tracing_event_t,
                                old_config_t const & config) {
   log_level(config.loglevel);
+  log_sink_t::instance().async(config.async_log_capacity);
 }
 
 //----------------------------------------------------------------------
@@ -26,9 +26,12 @@
 #include <sst/catalog/perfect_gt.hpp>
 #include <sst/catalog/perfect_lt.hpp>
 #include <sst/catalog/type_max.hpp>
+#include <cstddef>
 #include <stdexcept>
 #include <vector>
 
+#include <kestrel/prime_field_t.hpp>
+
 namespace kestrel {
 
 template<class Numshares, class Degree>
@@ -71,6 +74,53 @@ void sss_share(std::vector<sst::bigint> & shrs,
   }
 }
 
+//
+// The same as above, but with the arithmetic done in a fixed-width
+// Montgomery field instead of with sst::bigint.
+//
+
+template<class Numshares, class Degree, std::size_t MaxLimbs>
+void sss_share(std::vector<sst::bigint> & shrs,
+               sst::bigint const & secret,
+               Numshares numshares,
+               Degree degree,
+               prime_field_t<MaxLimbs> const & field) {
+  SST_ASSERT(sst::perfect_gt(numshares, 0));
+  SST_ASSERT(sst::perfect_gt(degree, 0));
+  SST_ASSERT(sst::perfect_gt(numshares, degree));
+  SST_ASSERT(sst::perfect_lt(degree, sst::type_max<Degree>::value));
+  SST_ASSERT(
+      sst::perfect_lt(numshares, sst::type_max<Numshares>::value));
+  SST_ASSERT(secret >= 0);
+  SST_ASSERT(secret < field.modulus());
+
+  using element_t = typename prime_field_t<MaxLimbs>::element_t;
+
+  sst::checked_resize(shrs, numshares);
+  std::vector<element_t> poly;
+  sst::checked_resize(poly, degree + 1);
+  poly[0] = field.from_bigint(secret);
+  for (decltype(poly.size()) i = 1; i < poly.size(); ++i) {
+    poly[i] = field.from_bigint(rand_range(field.modulus()));
+    if (i == poly.size() - 1) {
+      while (field.is_zero(poly[i])) {
+        poly[i] = field.from_bigint(rand_range(field.modulus()));
+      }
+    }
+  }
+  element_t evalpoint = field.zero();
+  element_t y;
+  for (decltype(+numshares) i = 0; i != numshares; ++i) {
+    evalpoint = field.add(evalpoint, field.one());
+    y = poly[poly.size() - 1];
+    for (decltype(poly.size()) j = 1; j < poly.size(); ++j) {
+      y = field.mul(y, evalpoint);
+      y = field.add(y, poly[poly.size() - 1 - j]);
+    }
+    shrs[i] = field.to_bigint(y);
+  }
+}
+
 template<class Index>
 void sss_recon(sst::bigint & secret,
                std::vector<sst::bigint> const & shrs,
@@ -110,6 +160,57 @@ void sss_recon(sst::bigint & secret,
   }
 }
 
+//
+// The same as above, but with the arithmetic done in a fixed-width
+// Montgomery field instead of with sst::bigint. All denominators are
+// inverted at once with Montgomery's trick.
+//
+
+template<class Index, std::size_t MaxLimbs>
+void sss_recon(sst::bigint & secret,
+               std::vector<sst::bigint> const & shrs,
+               std::vector<Index> const & pts,
+               prime_field_t<MaxLimbs> const & field) {
+  SST_ASSERT(sst::perfect_gt(shrs.size(), 0));
+  SST_ASSERT(sst::perfect_gt(pts.size(), 0));
+  SST_ASSERT(sst::perfect_ge(shrs.size(), pts.size()));
+
+  using element_t = typename prime_field_t<MaxLimbs>::element_t;
+
+  auto const numshares = pts.size();
+  std::vector<element_t> x;
+  sst::checked_resize(x, numshares);
+  for (decltype(+numshares) i = 0; i != numshares; ++i) {
+    if (pts[i] >= shrs.size()) {
+      throw std::runtime_error("Invalid reconstruction point");
+    }
+    x[i] = field.from_bigint(sst::bigint(1) + pts[i]);
+  }
+
+  std::vector<element_t> num;
+  std::vector<element_t> den;
+  sst::checked_resize(num, numshares);
+  sst::checked_resize(den, numshares);
+  for (decltype(+numshares) j = 0; j != numshares; ++j) {
+    num[j] = field.from_bigint(shrs[pts[j]]);
+    den[j] = field.one();
+    for (decltype(+numshares) i = 0; i != numshares; ++i) {
+      if (i == j) {
+        continue;
+      }
+      num[j] = field.mul(num[j], x[i]);
+      den[j] = field.mul(den[j], field.sub(x[i], x[j]));
+    }
+  }
+  field.batch_inv(den);
+
+  element_t acc = field.zero();
+  for (decltype(+numshares) j = 0; j != numshares; ++j) {
+    acc = field.add(acc, field.mul(num[j], den[j]));
+  }
+  secret = field.to_bigint(acc);
+}
+
 } // namespace kestrel
 
 #endif // #ifndef KESTREL_SECRET_SHARING_HPP
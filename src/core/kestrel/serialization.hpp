@@ -35,6 +35,7 @@
 #include <sst/catalog/varint_size.hpp>
 
 #include <kestrel/bytes_t.hpp>
+#include <kestrel/bytes_view_t.hpp>
 #include <kestrel/carma/mailbox_message_type_t.hpp>
 #include <kestrel/psn_t.hpp>
 
@@ -76,6 +77,17 @@ namespace kestrel {
 // deserialize. The function deserializes into each object in turn,
 // updating the input buffer index as it moves along.
 //
+// A bytes_view_t object can be deserialized into, in which case it is
+// set to refer to the bytes inside the input buffer instead of copying
+// them. It is only valid for as long as the input buffer is.
+//
+
+//
+// deserialize_view() is the same as deserialize(), except that the
+// input buffer is a bytes_view_t. This allows a field that was itself
+// deserialized as a bytes_view_t to be parsed further without copying
+// it out first. deserialize() is implemented in terms of it.
+//
 
 //----------------------------------------------------------------------
 
@@ -95,12 +107,17 @@ inline bytes_t & serialize(bytes_t & dst) {
   return dst;
 }
 
-inline void deserialize(bytes_t const & src, bytes_t::size_type & idx) {
+inline void deserialize_view(bytes_view_t const src,
+                             bytes_t::size_type & idx) {
   SST_ASSERT((idx < src.size()));
   bytes_t::size_type old_idx = idx;
   SST_ASSERT((serialize_size().value == idx - old_idx));
 }
 
+inline void deserialize(bytes_t const & src, bytes_t::size_type & idx) {
+  deserialize_view(src, idx);
+}
+
 //----------------------------------------------------------------------
 
 template<class Src, sst::enable_if_t<sst::is_integer<Src>::value> = 0>
@@ -120,9 +137,9 @@ bytes_t & serialize(bytes_t & dst, Src const src) {
 }
 
 template<class Dst, sst::enable_if_t<sst::is_integer<Dst>::value> = 0>
-void deserialize(bytes_t const & src,
-                 bytes_t::size_type & idx,
-                 Dst & dst) {
+void deserialize_view(bytes_view_t const src,
+                      bytes_t::size_type & idx,
+                      Dst & dst) {
   SST_ASSERT((idx < src.size()));
   bytes_t::size_type old_idx = idx;
   // TODO: SST should eventually provide a way to find the size of the
@@ -137,11 +154,18 @@ void deserialize(bytes_t const & src,
     throw std::runtime_error("Corrupt or malicious package data");
   }
   ++i;
-  dst = sst::from_varint<Dst>(&src[idx]);
+  dst = sst::from_varint<Dst>(src.data() + idx);
   idx = i;
   SST_ASSERT((serialize_size(dst).value == idx - old_idx));
 }
 
+template<class Dst, sst::enable_if_t<sst::is_integer<Dst>::value> = 0>
+void deserialize(bytes_t const & src,
+                 bytes_t::size_type & idx,
+                 Dst & dst) {
+  deserialize_view(src, idx, dst);
+}
+
 //----------------------------------------------------------------------
 
 inline serialize_size_t serialize_size(serialize_size_t const src) {
@@ -185,23 +209,59 @@ inline bytes_t & serialize(bytes_t & dst, bytes_t const & src) {
   return dst;
 }
 
-inline void deserialize(bytes_t const & src,
-                        bytes_t::size_type & idx,
-                        bytes_t & dst) {
+inline serialize_size_t serialize_size(bytes_view_t const src) {
+  auto const a = serialize_size(src.size()).value;
+  auto const b = src.size();
+  return {sst::checked_cast<bytes_t::size_type>(sst::checked(a) + b)};
+}
+
+inline bytes_t & serialize(bytes_t & dst, bytes_view_t const src) {
+  SST_ASSERT((src.empty() || src.data() < dst.data()
+              || src.data() >= dst.data() + dst.size()));
+  bytes_t::size_type const old_dst_size = dst.size();
+  serialize(dst, src.size());
+  dst.insert(dst.end(), src.begin(), src.end());
+  SST_ASSERT((serialize_size(src).value == dst.size() - old_dst_size));
+  return dst;
+}
+
+inline void deserialize_view(bytes_view_t const src,
+                             bytes_t::size_type & idx,
+                             bytes_view_t & dst) {
   SST_ASSERT((idx < src.size()));
-  SST_ASSERT((&src != &dst));
   bytes_t::size_type old_idx = idx;
-  decltype(dst.size()) n{};
-  deserialize(src, idx, n);
+  bytes_t::size_type n{};
+  deserialize_view(src, idx, n);
   if (sst::unsigned_gt(n, src.size() - idx)) {
     throw std::runtime_error("Corrupt or malicious package data");
   }
-  dst.clear();
-  dst.insert(dst.end(), &src[0] + idx, &src[0] + idx + n);
-  idx += static_cast<decltype(src.size())>(n);
+  dst = bytes_view_t(src.data() + idx, n);
+  idx += n;
   SST_ASSERT((serialize_size(dst).value == idx - old_idx));
 }
 
+inline void deserialize(bytes_t const & src,
+                        bytes_t::size_type & idx,
+                        bytes_view_t & dst) {
+  deserialize_view(src, idx, dst);
+}
+
+inline void deserialize_view(bytes_view_t const src,
+                             bytes_t::size_type & idx,
+                             bytes_t & dst) {
+  SST_ASSERT((src.data() != dst.data() || src.empty()));
+  bytes_view_t x;
+  deserialize_view(src, idx, x);
+  dst.assign(x.begin(), x.end());
+}
+
+inline void deserialize(bytes_t const & src,
+                        bytes_t::size_type & idx,
+                        bytes_t & dst) {
+  SST_ASSERT((&src != &dst));
+  deserialize_view(src, idx, dst);
+}
+
 //----------------------------------------------------------------------
 
 inline serialize_size_t serialize_size(std::string const & src) {
@@ -218,20 +278,18 @@ inline bytes_t & serialize(bytes_t & dst, std::string const & src) {
   return dst;
 }
 
+inline void deserialize_view(bytes_view_t const src,
+                             bytes_t::size_type & idx,
+                             std::string & dst) {
+  bytes_view_t x;
+  deserialize_view(src, idx, x);
+  dst.assign(x.begin(), x.end());
+}
+
 inline void deserialize(bytes_t const & src,
                         bytes_t::size_type & idx,
                         std::string & dst) {
-  SST_ASSERT((idx < src.size()));
-  bytes_t::size_type old_idx = idx;
-  decltype(dst.size()) n{};
-  deserialize(src, idx, n);
-  if (sst::unsigned_gt(n, src.size() - idx)) {
-    throw std::runtime_error("Corrupt or malicious package data");
-  }
-  dst.clear();
-  dst.insert(dst.end(), &src[0] + idx, &src[0] + idx + n);
-  idx += static_cast<decltype(src.size())>(n);
-  SST_ASSERT((serialize_size(dst).value == idx - old_idx));
+  deserialize_view(src, idx, dst);
 }
 
 //----------------------------------------------------------------------
@@ -247,17 +305,23 @@ inline bytes_t & serialize(bytes_t & dst, psn_t const & src) {
   return dst;
 }
 
-inline void deserialize(bytes_t const & src,
-                        bytes_t::size_type & idx,
-                        psn_t & dst) {
+inline void deserialize_view(bytes_view_t const src,
+                             bytes_t::size_type & idx,
+                             psn_t & dst) {
   SST_ASSERT((idx < src.size()));
   bytes_t::size_type old_idx = idx;
   std::string x;
-  deserialize(src, idx, x);
+  deserialize_view(src, idx, x);
   dst = std::move(x);
   SST_ASSERT((serialize_size(dst).value == idx - old_idx));
 }
 
+inline void deserialize(bytes_t const & src,
+                        bytes_t::size_type & idx,
+                        psn_t & dst) {
+  deserialize_view(src, idx, dst);
+}
+
 //----------------------------------------------------------------------
 
 inline serialize_size_t
@@ -273,17 +337,24 @@ inline bytes_t & serialize(bytes_t & dst,
   return dst;
 }
 
-inline void deserialize(bytes_t const & src,
-                        bytes_t::size_type & idx,
-                        carma::mailbox_message_type_t & dst) {
+inline void
+deserialize_view(bytes_view_t const src,
+                 bytes_t::size_type & idx,
+                 carma::mailbox_message_type_t & dst) {
   SST_ASSERT((idx < src.size()));
   bytes_t::size_type old_idx = idx;
   carma::mailbox_message_type_t::value_type x;
-  deserialize(src, idx, x);
+  deserialize_view(src, idx, x);
   dst = carma::mailbox_message_type_t(x);
   SST_ASSERT((serialize_size(dst).value == idx - old_idx));
 }
 
+inline void deserialize(bytes_t const & src,
+                        bytes_t::size_type & idx,
+                        carma::mailbox_message_type_t & dst) {
+  deserialize_view(src, idx, dst);
+}
+
 //----------------------------------------------------------------------
 // Variadics
 //----------------------------------------------------------------------
@@ -312,6 +383,17 @@ bytes_t serialize(bytes_t && dst, Args &&... args) {
   return std::move(dst);
 }
 
+template<class Dst,
+         class... Args,
+         sst::enable_if_t<(sizeof...(Args) > 0)> = 0>
+void deserialize_view(bytes_view_t const src,
+                      bytes_t::size_type & idx,
+                      Dst & dst,
+                      Args &&... args) {
+  deserialize_view(src, idx, dst);
+  deserialize_view(src, idx, std::forward<Args>(args)...);
+}
+
 template<class Dst,
          class... Args,
          sst::enable_if_t<(sizeof...(Args) > 0)> = 0>
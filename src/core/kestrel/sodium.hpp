@@ -36,9 +36,12 @@ void init_once();
     return ::F(std::forward<Args>(args)...);                           \
   }
 
+KESTREL_SODIUM_FUNCTION(crypto_box_beforenm)
 KESTREL_SODIUM_FUNCTION(crypto_box_easy)
+KESTREL_SODIUM_FUNCTION(crypto_box_easy_afternm)
 KESTREL_SODIUM_FUNCTION(crypto_box_keypair)
 KESTREL_SODIUM_FUNCTION(crypto_box_open_easy)
+KESTREL_SODIUM_FUNCTION(crypto_box_open_easy_afternm)
 KESTREL_SODIUM_FUNCTION(crypto_box_seal)
 KESTREL_SODIUM_FUNCTION(crypto_box_seal_open)
 KESTREL_SODIUM_FUNCTION(crypto_generichash_final)
@@ -48,6 +51,7 @@ KESTREL_SODIUM_FUNCTION(crypto_vrf_keypair)
 KESTREL_SODIUM_FUNCTION(crypto_vrf_proof_to_hash)
 KESTREL_SODIUM_FUNCTION(crypto_vrf_prove)
 KESTREL_SODIUM_FUNCTION(crypto_vrf_verify)
+KESTREL_SODIUM_FUNCTION(sodium_memzero)
 
 #undef KESTREL_SODIUM_FUNCTION
 
@@ -0,0 +1,186 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/sss_recon_context_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/sss_recon_context_t.hpp>
+//
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <sst/catalog/SST_ASSERT.h>
+#include <sst/catalog/bigint.hpp>
+#include <sst/catalog/checked_resize.hpp>
+
+#include <kestrel/prime_field_t.hpp>
+
+namespace kestrel {
+
+sss_recon_context_t::sss_recon_context_t(std::vector<std::size_t> pts,
+                                         sst::bigint const & modulus)
+    : pts_(std::move(pts)),
+      modulus_(modulus) {
+  SST_ASSERT(!pts_.empty());
+  SST_ASSERT(modulus_ > 1);
+
+  auto const n = pts_.size();
+  std::vector<sst::bigint> x;
+  sst::checked_resize(x, n);
+  for (decltype(+n) i = 0; i != n; ++i) {
+    x[i] = sst::bigint(1) + pts_[i];
+  }
+
+  // coeffs_[j] = prod_{i != j} x[i] / (x[i] - x[j]). Collect the
+  // numerators and denominators, then invert all denominators with
+  // one inversion (Montgomery's trick).
+  std::vector<sst::bigint> den;
+  sst::checked_resize(coeffs_, n);
+  sst::checked_resize(den, n);
+  for (decltype(+n) j = 0; j != n; ++j) {
+    coeffs_[j] = 1;
+    den[j] = 1;
+    for (decltype(+n) i = 0; i != n; ++i) {
+      if (i == j) {
+        continue;
+      }
+      coeffs_[j] = mul_mod(coeffs_[j], x[i], modulus_);
+      den[j] = mul_mod(den[j], sub_mod(x[i], x[j], modulus_), modulus_);
+    }
+  }
+  std::vector<sst::bigint> prefix;
+  sst::checked_resize(prefix, n);
+  prefix[0] = den[0];
+  for (decltype(+n) j = 1; j != n; ++j) {
+    prefix[j] = mul_mod(prefix[j - 1], den[j], modulus_);
+  }
+  sst::bigint acc = inv_mod(prefix[n - 1], modulus_);
+  for (decltype(+n) j = n; j-- > 1;) {
+    coeffs_[j] = mul_mod(coeffs_[j],
+                         mul_mod(acc, prefix[j - 1], modulus_),
+                         modulus_);
+    acc = mul_mod(acc, den[j], modulus_);
+  }
+  coeffs_[0] = mul_mod(coeffs_[0], acc, modulus_);
+}
+
+sss_recon_context_t::sss_recon_context_t(std::vector<std::size_t> pts,
+                                         mix_field_t const & field)
+    : pts_(std::move(pts)),
+      modulus_(field.modulus()),
+      field_(&field) {
+  SST_ASSERT(!pts_.empty());
+
+  auto const n = pts_.size();
+  std::vector<mix_field_t::element_t> x;
+  std::vector<mix_field_t::element_t> den;
+  sst::checked_resize(x, n);
+  sst::checked_resize(den, n);
+  sst::checked_resize(field_coeffs_, n);
+  for (decltype(+n) i = 0; i != n; ++i) {
+    x[i] = field.from_bigint(sst::bigint(1) + pts_[i]);
+  }
+  for (decltype(+n) j = 0; j != n; ++j) {
+    field_coeffs_[j] = field.one();
+    den[j] = field.one();
+    for (decltype(+n) i = 0; i != n; ++i) {
+      if (i == j) {
+        continue;
+      }
+      field_coeffs_[j] = field.mul(field_coeffs_[j], x[i]);
+      den[j] = field.mul(den[j], field.sub(x[i], x[j]));
+    }
+  }
+  field.batch_inv(den);
+  sst::checked_resize(coeffs_, n);
+  for (decltype(+n) j = 0; j != n; ++j) {
+    field_coeffs_[j] = field.mul(field_coeffs_[j], den[j]);
+    coeffs_[j] = field.to_bigint(field_coeffs_[j]);
+  }
+}
+
+void sss_recon_context_t::recon(
+    sst::bigint & secret,
+    std::vector<sst::bigint> const & shrs) const {
+  auto const n = pts_.size();
+  for (decltype(+n) k = 0; k != n; ++k) {
+    if (pts_[k] >= shrs.size()) {
+      throw std::runtime_error("Invalid reconstruction point");
+    }
+  }
+  if (field_ != nullptr) {
+    auto acc = field_->zero();
+    for (decltype(+n) k = 0; k != n; ++k) {
+      acc = field_->add(
+          acc,
+          field_->mul(field_coeffs_[k],
+                      field_->from_bigint(shrs[pts_[k]])));
+    }
+    secret = field_->to_bigint(acc);
+  } else {
+    secret = 0;
+    for (decltype(+n) k = 0; k != n; ++k) {
+      secret = add_mod(secret,
+                       mul_mod(coeffs_[k], shrs[pts_[k]], modulus_),
+                       modulus_);
+    }
+  }
+}
+
+void sss_recon_context_t::recon_many(
+    std::vector<sst::bigint> & secrets,
+    std::vector<std::vector<sst::bigint> const *> const & rows) const {
+  auto const n = pts_.size();
+  if (rows.size() != n) {
+    throw std::runtime_error("Invalid reconstruction rows");
+  }
+  auto const m = secrets.size();
+  for (auto const row : rows) {
+    SST_ASSERT(row != nullptr);
+    if (row->size() < m) {
+      throw std::runtime_error("Invalid reconstruction rows");
+    }
+  }
+  if (field_ != nullptr) {
+    for (decltype(+m) j = 0; j != m; ++j) {
+      auto acc = field_->zero();
+      for (decltype(+n) k = 0; k != n; ++k) {
+        acc = field_->add(
+            acc,
+            field_->mul(field_coeffs_[k],
+                        field_->from_bigint((*rows[k])[j])));
+      }
+      secrets[j] = field_->to_bigint(acc);
+    }
+  } else {
+    for (decltype(+m) j = 0; j != m; ++j) {
+      secrets[j] = 0;
+      for (decltype(+n) k = 0; k != n; ++k) {
+        secrets[j] =
+            add_mod(secrets[j],
+                    mul_mod(coeffs_[k], (*rows[k])[j], modulus_),
+                    modulus_);
+      }
+    }
+  }
+}
+
+} // namespace kestrel
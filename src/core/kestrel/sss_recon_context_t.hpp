@@ -0,0 +1,89 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_SSS_RECON_CONTEXT_T_HPP
+#define KESTREL_SSS_RECON_CONTEXT_T_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include <sst/catalog/bigint.hpp>
+
+#include <kestrel/prime_field_t.hpp>
+
+namespace kestrel {
+
+//
+// Lagrange coefficients at zero for a fixed prime and a fixed set of
+// reconstruction points, as used by sss_recon. Point k corresponds to
+// the x-coordinate k + 1, which is how sss_share numbers its shares.
+//
+// Building a context costs one modular inversion in total. After that,
+// each reconstruction is just a dot product with the shares.
+//
+
+class sss_recon_context_t final {
+
+  std::vector<std::size_t> pts_;
+  sst::bigint modulus_;
+  std::vector<sst::bigint> coeffs_;
+  mix_field_t const * field_ = nullptr;
+  std::vector<mix_field_t::element_t> field_coeffs_;
+
+public:
+
+  explicit sss_recon_context_t(std::vector<std::size_t> pts,
+                               sst::bigint const & modulus);
+
+  // field must outlive the context.
+  explicit sss_recon_context_t(std::vector<std::size_t> pts,
+                               mix_field_t const & field);
+
+  std::vector<std::size_t> const & pts() const noexcept {
+    return pts_;
+  }
+
+  sst::bigint const & modulus() const noexcept {
+    return modulus_;
+  }
+
+  // The Lagrange coefficient at zero of each point, in pts() order.
+  std::vector<sst::bigint> const & coeffs() const noexcept {
+    return coeffs_;
+  }
+
+  //
+  // Reconstructs one secret. As with sss_recon, shrs is indexed by
+  // point, not by position in pts().
+  //
+  void recon(sst::bigint & secret,
+             std::vector<sst::bigint> const & shrs) const;
+
+  //
+  // Reconstructs secrets.size() secrets at once. rows[k] holds the
+  // shares of all secrets for point pts()[k], i.e. secrets[j] is
+  // reconstructed from (*rows[k])[j] for all k.
+  //
+  void recon_many(
+      std::vector<sst::bigint> & secrets,
+      std::vector<std::vector<sst::bigint> const *> const & rows) const;
+};
+
+} // namespace kestrel
+
+#endif // #ifndef KESTREL_SSS_RECON_CONTEXT_T_HPP
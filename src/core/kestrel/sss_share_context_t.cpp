@@ -0,0 +1,145 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/sss_share_context_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/sss_share_context_t.hpp>
+//
+
+#include <cstddef>
+#include <vector>
+
+#include <sst/catalog/SST_ASSERT.h>
+#include <sst/catalog/bigint.hpp>
+#include <sst/catalog/checked_resize.hpp>
+#include <sst/catalog/crypto_rng.hpp>
+#include <sst/catalog/integer_rep.hpp>
+
+#include <kestrel/bytes_t.hpp>
+#include <kestrel/prime_field_t.hpp>
+
+namespace kestrel {
+
+sss_share_context_t::sss_share_context_t(std::size_t const numshares,
+                                         std::size_t const degree,
+                                         sst::bigint const & modulus)
+    : numshares_(numshares),
+      degree_(degree),
+      modulus_(modulus) {
+  SST_ASSERT(degree_ > 0);
+  SST_ASSERT(numshares_ > degree_);
+  SST_ASSERT(modulus_ > 1);
+
+  // Eight extra bytes make the bias of reducing the random bytes
+  // modulo the prime negligible.
+  coeff_size_ = modulus_.num_bytes<std::size_t>(
+                    sst::integer_rep::pure_unsigned())
+                + 8;
+
+  sst::checked_resize(powers_, numshares_ * degree_);
+  for (std::size_t i = 0; i != numshares_; ++i) {
+    sst::bigint const x = sst::bigint(1) + i;
+    sst::bigint y = 1;
+    for (std::size_t k = 0; k != degree_; ++k) {
+      y = mul_mod(y, x, modulus_);
+      powers_[i * degree_ + k] = y;
+    }
+  }
+}
+
+sss_share_context_t::sss_share_context_t(std::size_t const numshares,
+                                         std::size_t const degree,
+                                         mix_field_t const & field)
+    : sss_share_context_t(numshares, degree, field.modulus()) {
+  field_ = &field;
+  sst::checked_resize(field_powers_, powers_.size());
+  for (decltype(powers_.size()) i = 0; i != powers_.size(); ++i) {
+    field_powers_[i] = field.from_bigint(powers_[i]);
+  }
+}
+
+void sss_share_context_t::draw_coeffs(std::size_t const count) {
+  rng_buf_.resize(count * coeff_size_);
+  sst::crypto_rng()(rng_buf_.begin(), rng_buf_.size());
+  sst::checked_resize(coeffs_, count);
+  bytes_t chunk;
+  for (std::size_t c = 0; c != count; ++c) {
+    auto const first = rng_buf_.begin() + c * coeff_size_;
+    chunk.assign(first, first + coeff_size_);
+    coeffs_[c] = sst::bigint(chunk, sst::integer_rep::pure_unsigned())
+                 % modulus_;
+  }
+  // Keep the polynomial degree exact, as sss_share does.
+  for (std::size_t c = degree_ - 1; c < count; c += degree_) {
+    while (coeffs_[c] == 0) {
+      coeffs_[c] = rand_range(modulus_);
+    }
+  }
+  if (field_ != nullptr) {
+    sst::checked_resize(field_coeffs_, count);
+    for (std::size_t c = 0; c != count; ++c) {
+      field_coeffs_[c] = field_->from_bigint(coeffs_[c]);
+    }
+  }
+}
+
+void sss_share_context_t::share_many(
+    std::vector<std::vector<sst::bigint>> & shrs,
+    std::vector<sst::bigint> const & secrets) {
+  auto const m = secrets.size();
+  auto const d = degree_;
+  sst::checked_resize(shrs, numshares_);
+  for (auto & row : shrs) {
+    sst::checked_resize(row, m);
+  }
+  if (m == 0) {
+    return;
+  }
+  draw_coeffs(m * d);
+  for (std::size_t j = 0; j != m; ++j) {
+    SST_ASSERT(secrets[j] >= 0);
+    SST_ASSERT(secrets[j] < modulus_);
+    if (field_ != nullptr) {
+      auto const & field = *field_;
+      auto const secret = field.from_bigint(secrets[j]);
+      for (std::size_t i = 0; i != numshares_; ++i) {
+        auto acc = secret;
+        for (std::size_t k = 0; k != d; ++k) {
+          acc = field.add(acc,
+                          field.mul(field_coeffs_[j * d + k],
+                                    field_powers_[i * d + k]));
+        }
+        shrs[i][j] = field.to_bigint(acc);
+      }
+    } else {
+      for (std::size_t i = 0; i != numshares_; ++i) {
+        auto & acc = shrs[i][j];
+        acc = secrets[j];
+        for (std::size_t k = 0; k != d; ++k) {
+          acc = add_mod(
+              acc,
+              mul_mod(coeffs_[j * d + k], powers_[i * d + k], modulus_),
+              modulus_);
+        }
+      }
+    }
+  }
+}
+
+} // namespace kestrel
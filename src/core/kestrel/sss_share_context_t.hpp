@@ -0,0 +1,89 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_SSS_SHARE_CONTEXT_T_HPP
+#define KESTREL_SSS_SHARE_CONTEXT_T_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include <sst/catalog/bigint.hpp>
+
+#include <kestrel/bytes_t.hpp>
+#include <kestrel/prime_field_t.hpp>
+
+namespace kestrel {
+
+//
+// Batched version of sss_share for a fixed prime, share count and
+// degree. The powers x^1, ..., x^degree of the evaluation points
+// x = 1, ..., numshares are computed once, and all random polynomial
+// coefficients for a batch are drawn from the RNG in a single call.
+//
+
+class sss_share_context_t final {
+
+  std::size_t numshares_;
+  std::size_t degree_;
+  sst::bigint modulus_;
+  std::size_t coeff_size_;
+  mix_field_t const * field_ = nullptr;
+
+  // powers_[i * degree_ + (k - 1)] = (i + 1)^k
+  std::vector<sst::bigint> powers_;
+  std::vector<mix_field_t::element_t> field_powers_;
+
+  // Reused between calls to share_many.
+  bytes_t rng_buf_;
+  std::vector<sst::bigint> coeffs_;
+  std::vector<mix_field_t::element_t> field_coeffs_;
+
+  void draw_coeffs(std::size_t count);
+
+public:
+
+  explicit sss_share_context_t(std::size_t numshares,
+                               std::size_t degree,
+                               sst::bigint const & modulus);
+
+  // field must outlive the context.
+  explicit sss_share_context_t(std::size_t numshares,
+                               std::size_t degree,
+                               mix_field_t const & field);
+
+  std::size_t numshares() const noexcept {
+    return numshares_;
+  }
+
+  std::size_t degree() const noexcept {
+    return degree_;
+  }
+
+  //
+  // Shares every secret in secrets. On return, shrs has numshares()
+  // rows of secrets.size() entries each, and shrs[i][j] is share i of
+  // secrets[j]. This is the layout of mb_mc_up_packet_t::z, so each
+  // row can be moved straight into the packet for committee member i.
+  //
+  void share_many(std::vector<std::vector<sst::bigint>> & shrs,
+                  std::vector<sst::bigint> const & secrets);
+};
+
+} // namespace kestrel
+
+#endif // #ifndef KESTREL_SSS_SHARE_CONTEXT_T_HPP
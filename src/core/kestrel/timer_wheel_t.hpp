@@ -0,0 +1,302 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef KESTREL_TIMER_WHEEL_T_HPP
+#define KESTREL_TIMER_WHEEL_T_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <stdexcept>
+#include <utility>
+
+#include <sst/catalog/mono_time_ns.hpp>
+
+namespace kestrel {
+
+//
+// A hierarchical timer wheel with priority classes. Each item has a
+// deadline and a priority below Priorities, with 0 being the most
+// urgent. advance() moves every item whose deadline has passed onto
+// the ready list for its priority, and next_ready() hands the ready
+// items out most urgent first, and in the order they came due within
+// a priority.
+//
+// Time is cut into ticks of tick_ns. The wheel has Levels levels of
+// 2^SlotBits slots each, where a slot on level k covers 2^(k*SlotBits)
+// ticks. An item goes on the lowest level whose slots are wide enough
+// to reach its deadline and is moved down a level each time the wheel
+// reaches its slot, so advance() only touches the slots it passes and
+// the items that come due. Deadlines beyond the top level are parked
+// in its farthest slot and rescheduled from there.
+//
+// Items live in list nodes that never move in memory, so a handle
+// stays valid until the item is erased, wherever the item is. Erasing
+// and rescheduling are O(1).
+//
+
+template<class T,
+         std::size_t Priorities = 1,
+         unsigned int SlotBits = 6,
+         std::size_t Levels = 4>
+class timer_wheel_t final {
+
+  static_assert(Priorities > 0, "");
+  static_assert(SlotBits > 0 && SlotBits * Levels < 64, "");
+  static_assert(Levels > 0, "");
+
+public:
+
+  using time_ns_t = decltype(sst::mono_time_ns());
+
+private:
+
+  static constexpr std::size_t slot_count = std::size_t(1) << SlotBits;
+  static constexpr std::uint64_t slot_mask = slot_count - 1;
+
+  struct node_t final {
+    T value;
+    time_ns_t deadline;
+    std::size_t priority;
+    // The node's level and slot, or level == Levels if it's on the
+    // ready list for its priority.
+    std::size_t level;
+    std::size_t slot;
+
+    node_t(T && value, time_ns_t deadline, std::size_t priority)
+        : value(std::move(value)),
+          deadline(deadline),
+          priority(priority),
+          level(Levels),
+          slot(0) {
+    }
+  };
+
+  using list_t = std::list<node_t>;
+
+public:
+
+  using handle_t = typename list_t::iterator;
+
+private:
+
+  time_ns_t tick_ns_;
+  std::uint64_t tick_ = 0;
+  bool started_ = false;
+  std::array<std::array<list_t, slot_count>, Levels> slots_;
+  std::array<list_t, Priorities> ready_;
+  std::size_t size_ = 0;
+  std::size_t pending_ = 0;
+
+  std::uint64_t to_tick(time_ns_t const t) const noexcept {
+    return t <= 0 ? 0 : static_cast<std::uint64_t>(t / tick_ns_);
+  }
+
+  // Deadlines round up so that an item never comes due early.
+  std::uint64_t to_deadline_tick(time_ns_t const t) const noexcept {
+    if (t <= 0) {
+      return 0;
+    }
+    auto const q = static_cast<std::uint64_t>(t / tick_ns_);
+    return t % tick_ns_ == 0 ? q : q + 1;
+  }
+
+  list_t & list_of(handle_t const h) noexcept {
+    if (h->level == Levels) {
+      return ready_[h->priority];
+    }
+    return slots_[h->level][h->slot];
+  }
+
+  // Moves the node at h from the list src to wherever its deadline
+  // says it belongs.
+  void place(list_t & src, handle_t const h) {
+    std::uint64_t const t = to_deadline_tick(h->deadline);
+    if (t <= tick_) {
+      bool const was_pending = h->level != Levels;
+      h->level = Levels;
+      list_t & dst = ready_[h->priority];
+      dst.splice(dst.end(), src, h);
+      if (was_pending) {
+        --pending_;
+      }
+      return;
+    }
+    std::size_t level = 0;
+    while (level + 1 < Levels
+           && (t >> (level * SlotBits)) - (tick_ >> (level * SlotBits))
+                  >= slot_count) {
+      ++level;
+    }
+    std::uint64_t const shift = level * SlotBits;
+    std::uint64_t slot = t >> shift;
+    if (slot - (tick_ >> shift) >= slot_count) {
+      // Too far out for the top level. Park the node in the slot the
+      // wheel will reach last.
+      slot = (tick_ >> shift) + slot_count - 1;
+    }
+    if (h->level == Levels) {
+      ++pending_;
+    }
+    h->level = level;
+    h->slot = static_cast<std::size_t>(slot & slot_mask);
+    list_t & dst = slots_[h->level][h->slot];
+    dst.splice(dst.end(), src, h);
+  }
+
+  // Reschedules every node in a slot, which moves each of them down a
+  // level or onto a ready list.
+  void cascade(list_t & slot) {
+    while (!slot.empty()) {
+      place(slot, slot.begin());
+    }
+  }
+
+  // Moves the wheel straight to tick t by rescheduling every node that
+  // isn't ready. This is cheaper than stepping when the wheel would
+  // step past more ticks than it holds nodes.
+  void jump(std::uint64_t const t) {
+    list_t all;
+    for (auto & level : slots_) {
+      for (auto & slot : level) {
+        all.splice(all.end(), slot);
+      }
+    }
+    tick_ = t;
+    cascade(all);
+  }
+
+public:
+
+  explicit timer_wheel_t(time_ns_t const tick_ns = 100000000)
+      : tick_ns_(tick_ns) {
+    if (tick_ns <= 0) {
+      throw std::invalid_argument(
+          "timer_wheel_t: tick_ns must be positive");
+    }
+  }
+
+  timer_wheel_t(timer_wheel_t const &) = delete;
+  timer_wheel_t & operator=(timer_wheel_t const &) = delete;
+  timer_wheel_t(timer_wheel_t &&) = delete;
+  timer_wheel_t & operator=(timer_wheel_t &&) = delete;
+  ~timer_wheel_t() noexcept = default;
+
+  // Moves the wheel forward to now. Items inserted before the first
+  // call are placed relative to it.
+  void advance(time_ns_t const now) {
+    std::uint64_t const target = to_tick(now);
+    if (started_ && target <= tick_) {
+      return;
+    }
+    if (!started_ || target - tick_ > pending_) {
+      started_ = true;
+      jump(target);
+      return;
+    }
+    while (tick_ < target) {
+      ++tick_;
+      for (std::size_t level = Levels - 1; level != 0; --level) {
+        std::uint64_t const low =
+            (std::uint64_t(1) << (level * SlotBits)) - 1;
+        if ((tick_ & low) == 0) {
+          cascade(slots_[level][static_cast<std::size_t>(
+              (tick_ >> (level * SlotBits)) & slot_mask)]);
+        }
+      }
+      cascade(slots_[0][static_cast<std::size_t>(tick_ & slot_mask)]);
+    }
+  }
+
+  void advance() {
+    advance(sst::mono_time_ns());
+  }
+
+  handle_t insert(T value,
+                  time_ns_t const deadline,
+                  std::size_t const priority = 0) {
+    if (priority >= Priorities) {
+      throw std::invalid_argument("timer_wheel_t: bad priority");
+    }
+    list_t staging;
+    staging.emplace_back(std::move(value), deadline, priority);
+    handle_t const h = staging.begin();
+    place(staging, h);
+    ++size_;
+    return h;
+  }
+
+  // Gives the item at h a new deadline. This is also how an item taken
+  // from next_ready() goes back into the wheel.
+  void reschedule(handle_t const h, time_ns_t const deadline) {
+    h->deadline = deadline;
+    place(list_of(h), h);
+  }
+
+  void erase(handle_t const h) noexcept {
+    if (h->level != Levels) {
+      --pending_;
+    }
+    list_of(h).erase(h);
+    --size_;
+  }
+
+  // Sets h to the most urgent ready item and returns true, or returns
+  // false if nothing is ready. The item stays ready until it is erased
+  // or rescheduled.
+  bool next_ready(handle_t & h) noexcept {
+    for (auto & list : ready_) {
+      if (!list.empty()) {
+        h = list.begin();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static T & value(handle_t const h) noexcept {
+    return h->value;
+  }
+
+  static time_ns_t deadline(handle_t const h) noexcept {
+    return h->deadline;
+  }
+
+  time_ns_t tick_ns() const noexcept {
+    return tick_ns_;
+  }
+
+  // The number of items, ready or not.
+  std::size_t size() const noexcept {
+    return size_;
+  }
+
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  // The number of items that are ready.
+  std::size_t ready() const noexcept {
+    return size_ - pending_;
+  }
+};
+
+} // namespace kestrel
+
+#endif // #ifndef KESTREL_TIMER_WHEEL_T_HPP
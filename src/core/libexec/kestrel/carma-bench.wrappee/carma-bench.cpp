@@ -0,0 +1,537 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <map>
+#include <new>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sst/catalog/bigint.hpp>
+#include <sst/catalog/json/get_from_file.hpp>
+#include <sst/catalog/mono_time_ns.hpp>
+#include <sst/catalog/opt_arg.hpp>
+#include <sst/catalog/optional.hpp>
+#include <sst/catalog/parse_opt.hpp>
+#include <sst/catalog/rand_range.hpp>
+#include <sst/catalog/to_string.hpp>
+#include <sst/catalog/unknown_oper.hpp>
+#include <sst/catalog/unknown_opt.hpp>
+
+#include <kestrel/graeffe_transform.hpp>
+#include <kestrel/json_t.hpp>
+#include <kestrel/metrics_t.hpp>
+#include <kestrel/prime_field_t.hpp>
+#include <kestrel/secret_sharing.hpp>
+#include <kestrel/sss_recon_context_t.hpp>
+#include <kestrel/sss_share_context_t.hpp>
+
+using namespace kestrel;
+
+//----------------------------------------------------------------------
+// Allocation counting
+//----------------------------------------------------------------------
+//
+// Every operator new in this program is counted. Memory that libraries
+// get from malloc directly, such as OpenSSL's, is not. The benchmarks
+// run on one thread, so plain counters are enough.
+//
+
+namespace {
+
+std::uint64_t alloc_count_ = 0;
+std::uint64_t alloc_bytes_ = 0;
+
+} // namespace
+
+void * operator new(std::size_t const size) {
+  ++alloc_count_;
+  alloc_bytes_ += size;
+  void * const p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void * const p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void * const p, std::size_t) noexcept {
+  std::free(p);
+}
+
+//----------------------------------------------------------------------
+
+namespace {
+
+struct settings_t {
+  std::uint64_t min_time_ns = 200000000;
+  std::uint64_t min_iterations = 3;
+  std::uint64_t max_iterations = 1000000;
+};
+
+//
+// Calls f once untimed, which fills caches such as ntt_table_t::get,
+// then calls it until both min_iterations and min_time_ns are reached.
+// items is how many secrets, roots, or sums one call of f handles.
+//
+
+json_t measure(settings_t const & settings,
+               json_t const & bench_case,
+               std::uint64_t const items,
+               std::function<void()> const & f) {
+  f();
+  metric_histogram_t ns;
+  std::uint64_t allocs = 0;
+  std::uint64_t alloc_bytes = 0;
+  std::uint64_t total_ns = 0;
+  std::uint64_t n = 0;
+  while (n < settings.max_iterations
+         && (n < settings.min_iterations
+             || total_ns < settings.min_time_ns)) {
+    auto const count0 = alloc_count_;
+    auto const bytes0 = alloc_bytes_;
+    auto const t0 = sst::mono_time_ns();
+    f();
+    auto const t1 = sst::mono_time_ns();
+    allocs += alloc_count_ - count0;
+    alloc_bytes += alloc_bytes_ - bytes0;
+    auto const dt = static_cast<std::uint64_t>(t1 - t0);
+    ns.record(dt);
+    total_ns += dt;
+    ++n;
+  }
+  double const s = static_cast<double>(total_ns) / 1e9;
+  double const dn = static_cast<double>(n);
+  return {
+      {"case", bench_case},
+      {"iterations", n},
+      {"ns_per_op", total_ns / n},
+      {"ns", ns.to_json()},
+      {"allocs_per_op", static_cast<double>(allocs) / dn},
+      {"alloc_bytes_per_op", static_cast<double>(alloc_bytes) / dn},
+      {"ops_per_s", s > 0 ? dn / s : 0.0},
+      {"items_per_s",
+       s > 0 ? dn * static_cast<double>(items) / s : 0.0},
+  };
+}
+
+//
+// Returns thresholds[name], overridden by thresholds.ops[op][name].
+//
+
+double threshold(json_t const & thresholds,
+                 std::string const & op,
+                 char const * const name,
+                 double const fallback) {
+  double x = thresholds.value(name, fallback);
+  auto const ops = thresholds.find("ops");
+  if (ops != thresholds.end()) {
+    auto const it = ops->find(op);
+    if (it != ops->end()) {
+      x = it->value(name, x);
+    }
+  }
+  return x;
+}
+
+void compare(json_t & regressions,
+             json_t const & thresholds,
+             json_t const & result,
+             json_t const & baseline) {
+  std::string const op = result["case"]["op"];
+  auto const check = [&](char const * const metric,
+                         double const current,
+                         double const before,
+                         char const * const ratio,
+                         double const fallback) {
+    double const limit =
+        before * threshold(thresholds, op, ratio, fallback);
+    if (current > limit) {
+      regressions.push_back({{"case", result["case"]},
+                             {"metric", metric},
+                             {"baseline", before},
+                             {"current", current},
+                             {"limit", limit}});
+    }
+  };
+  check("ns_p50",
+        result["ns"]["p50"].get<double>(),
+        baseline["ns"]["p50"].get<double>(),
+        "time_ratio",
+        1.25);
+  check("allocs_per_op",
+        result["allocs_per_op"].get<double>(),
+        baseline["allocs_per_op"].get<double>(),
+        "alloc_ratio",
+        1.0);
+}
+
+json_t default_config() {
+  return {
+      {"primes",
+       {{{"two_exp", 123}, {"odd_factor", 101}, {"zeta", 3}},
+        {{"two_exp", 513}, {"odd_factor", 101}, {"zeta", 3}},
+        {{"two_exp", 3767}, {"odd_factor", 101}, {"zeta", 3}}}},
+      {"mix_sizes", {16, 64, 100}},
+      {"committee_sizes", {4, 8, 16}},
+  };
+}
+
+} // namespace
+
+//
+// Benchmarks the arithmetic of the mix: secret sharing by the mailbox
+// servers, and reconstruction and root finding by the mix committees.
+// Every prime p = 2^two_exp * odd_factor + 1 in the sweep is combined
+// with every mix size and committee size. Sharing uses degree
+// (committee_size - 1) / 2, and root finding is skipped for mix sizes
+// that are not below odd_factor, which the mix does not allow either.
+// An operation runs with both sst::bigint and the Montgomery field
+// when it has both and the prime fits in mix_field_t.
+//
+// The optional --config file overrides any of these defaults:
+//
+//    {
+//      "min_time_s": 0.2,
+//      "min_iterations": 3,
+//      "max_iterations": 1000000,
+//      "primes": [
+//        {"two_exp": 123, "odd_factor": 101, "zeta": 3},
+//        {"two_exp": 513, "odd_factor": 101, "zeta": 3},
+//        {"two_exp": 711, "odd_factor": 257, "zeta": 3},
+//        {"two_exp": 3767, "odd_factor": 101, "zeta": 3}
+//      ],
+//      "mix_sizes": [16, 64, 100],
+//      "committee_sizes": [4, 8, 16],
+//      "ops": ["find_roots", "sss_recon_many"],
+//      "thresholds": {
+//        "time_ratio": 1.25,
+//        "alloc_ratio": 1.0,
+//        "ops": {"find_roots": {"time_ratio": 1.5}}
+//      }
+//    }
+//
+// The report is printed to standard output as JSON. Each result holds
+// the case, the iteration count, the mean and a histogram of the
+// nanoseconds per operation, the allocations per operation, and the
+// operation and item throughput.
+//
+// --baseline takes an earlier report. Every case in both reports is
+// checked against the thresholds: the median time may not exceed the
+// baseline's by more than time_ratio, and the allocations per
+// operation may not exceed the baseline's by more than alloc_ratio.
+// Any violations are listed under "regressions", and the exit status
+// is nonzero if there are any.
+//
+
+int main(int const argc, char ** const argv) {
+
+  std::list<std::string> args(argv, argv + argc);
+
+  json_t config = default_config();
+  sst::optional<json_t> baseline;
+
+  bool parse_options = true;
+  while (args.pop_front(), !args.empty()) {
+    if (parse_options) {
+
+      //----------------------------------------------------------------
+      // Options terminator
+      //----------------------------------------------------------------
+
+      if (sst::parse_opt(args, "--", sst::opt_arg::forbidden)) {
+        parse_options = false;
+        continue;
+      }
+
+      //----------------------------------------------------------------
+      // --baseline
+      //----------------------------------------------------------------
+
+      if (sst::parse_opt(args, "--baseline", sst::opt_arg::required)) {
+        baseline = sst::json::get_from_file<json_t>(args.front());
+        continue;
+      }
+
+      //----------------------------------------------------------------
+      // --config
+      //----------------------------------------------------------------
+
+      if (sst::parse_opt(args, "--config", sst::opt_arg::required)) {
+        config.update(sst::json::get_from_file<json_t>(args.front()));
+        continue;
+      }
+
+      //----------------------------------------------------------------
+      // Unknown options
+      //----------------------------------------------------------------
+
+      sst::unknown_opt(args);
+
+      //----------------------------------------------------------------
+    }
+
+    //------------------------------------------------------------------
+    // Unknown operands
+    //------------------------------------------------------------------
+
+    sst::unknown_oper(args);
+
+    //------------------------------------------------------------------
+  }
+
+  settings_t settings;
+  settings.min_time_ns = static_cast<std::uint64_t>(
+      config.value("min_time_s", 0.2) * 1e9);
+  settings.min_iterations =
+      config.value("min_iterations", settings.min_iterations);
+  settings.max_iterations =
+      config.value("max_iterations", settings.max_iterations);
+
+  auto const mix_sizes =
+      config.at("mix_sizes").get<std::vector<std::size_t>>();
+  auto const committee_sizes =
+      config.at("committee_sizes").get<std::vector<std::size_t>>();
+  for (auto const committee_size : committee_sizes) {
+    if (committee_size < 2) {
+      throw std::runtime_error("committee sizes must be at least 2");
+    }
+  }
+
+  auto const ops = config.value("ops", std::vector<std::string>());
+  auto const wanted = [&](char const * const op) {
+    return ops.empty()
+           || std::find(ops.begin(), ops.end(), op) != ops.end();
+  };
+
+  json_t results = json_t::array();
+
+  for (json_t const & prime : config.at("primes")) {
+    int const two_exp = prime.at("two_exp");
+    int const odd_factor = prime.at("odd_factor");
+    int const zeta = prime.value("zeta", 3);
+    sst::bigint const p = (sst::bigint(1) << two_exp) * odd_factor + 1;
+
+    sst::optional<mix_field_t> field;
+    if (mix_field_t::fits(p)) {
+      field.emplace(p);
+    }
+
+    // A committee_size or mix_size of zero is left out of the case.
+    auto const run = [&](char const * const op,
+                         char const * const field_name,
+                         std::size_t const mix_size,
+                         std::size_t const committee_size,
+                         std::uint64_t const items,
+                         std::function<void()> const & f) {
+      if (!wanted(op)) {
+        return;
+      }
+      json_t bench_case = {{"op", op},
+                           {"field", field_name},
+                           {"two_exp", two_exp},
+                           {"odd_factor", odd_factor}};
+      if (mix_size != 0) {
+        bench_case["mix_size"] = mix_size;
+      }
+      if (committee_size != 0) {
+        bench_case["committee_size"] = committee_size;
+      }
+      std::cerr << bench_case.dump() << std::endl;
+      results.push_back(measure(settings, bench_case, items, f));
+    };
+
+    auto const degree_for = [](std::size_t const committee_size) {
+      return std::max<std::size_t>(1, (committee_size - 1) / 2);
+    };
+
+    //------------------------------------------------------------------
+    // One secret at a time
+    //------------------------------------------------------------------
+
+    for (auto const committee_size : committee_sizes) {
+      auto const degree = degree_for(committee_size);
+      std::vector<std::size_t> pts(degree + 1);
+      std::iota(pts.begin(), pts.end(), std::size_t(0));
+      sst::bigint const x = rand_range(p);
+      std::vector<sst::bigint> shrs;
+      sst::bigint secret;
+
+      auto const sweep = [&](char const * const field_name,
+                             auto const & m) {
+        sss_share(shrs, x, committee_size, degree, m);
+        run("sss_share", field_name, 0, committee_size, 1, [&] {
+          sss_share(shrs, x, committee_size, degree, m);
+        });
+        run("sss_recon", field_name, 0, committee_size, 1, [&] {
+          sss_recon(secret, shrs, pts, m);
+        });
+      };
+      sweep("bigint", p);
+      if (field) {
+        sweep("montgomery", *field);
+      }
+    }
+
+    //------------------------------------------------------------------
+    // A whole mix at a time
+    //------------------------------------------------------------------
+
+    for (auto const mix_size : mix_sizes) {
+      std::vector<sst::bigint> values(mix_size);
+      for (auto & x : values) {
+        x = rand_range(p);
+      }
+
+      std::vector<sst::bigint> sums(mix_size);
+      values_to_newton(sums, values, mix_size, p);
+      {
+        std::vector<sst::bigint> out(mix_size);
+        run("values_to_newton", "bigint", mix_size, 0, mix_size, [&] {
+          values_to_newton(out, values, mix_size, p);
+        });
+      }
+
+      if (static_cast<std::size_t>(odd_factor) > mix_size) {
+        run("newton_to_polynomial",
+            "bigint",
+            mix_size,
+            0,
+            mix_size,
+            [&] {
+              NumX poly(p);
+              newton_to_polynomial(poly, sums, mix_size);
+            });
+        if (field) {
+          run("newton_to_polynomial",
+              "montgomery",
+              mix_size,
+              0,
+              mix_size,
+              [&] {
+                NumX poly(p);
+                newton_to_polynomial(poly, sums, mix_size, *field);
+              });
+        }
+
+        NumX poly(p);
+        newton_to_polynomial(poly, sums, mix_size);
+
+        if (wanted("find_roots")) {
+          if (find_roots(poly, zeta, two_exp, odd_factor).size()
+              != mix_size) {
+            throw std::runtime_error(
+                "find_roots did not find every root with two_exp="
+                + sst::to_string(two_exp)
+                + ", odd_factor=" + sst::to_string(odd_factor)
+                + ", zeta=" + sst::to_string(zeta)
+                + ". Is p prime and zeta a primitive root?");
+          }
+        }
+        run("find_roots", "bigint", mix_size, 0, mix_size, [&] {
+          (void)find_roots(poly, zeta, two_exp, odd_factor);
+        });
+
+        sst::bigint const rho = sst::bigint(1) << (two_exp - 2);
+        sst::bigint const tau = rand_range(p);
+        run("tangent_graeffe_transform",
+            "bigint",
+            mix_size,
+            0,
+            mix_size,
+            [&] { (void)tangent_graeffe_transform(poly, rho, tau); });
+      }
+
+      for (auto const committee_size : committee_sizes) {
+        auto const degree = degree_for(committee_size);
+        std::vector<std::size_t> pts(degree + 1);
+        std::iota(pts.begin(), pts.end(), std::size_t(0));
+        std::vector<std::vector<sst::bigint>> rows;
+        std::vector<sst::bigint> out(mix_size);
+
+        auto const sweep = [&](char const * const field_name,
+                               auto const & m) {
+          sss_share_context_t share(committee_size, degree, m);
+          sss_recon_context_t const recon(pts, m);
+          share.share_many(rows, values);
+          std::vector<std::vector<sst::bigint> const *> row_ptrs;
+          for (auto const i : pts) {
+            row_ptrs.push_back(&rows[i]);
+          }
+          run("sss_share_many",
+              field_name,
+              mix_size,
+              committee_size,
+              mix_size,
+              [&] { share.share_many(rows, values); });
+          run("sss_recon_many",
+              field_name,
+              mix_size,
+              committee_size,
+              mix_size,
+              [&] { recon.recon_many(out, row_ptrs); });
+        };
+        sweep("bigint", p);
+        if (field) {
+          sweep("montgomery", *field);
+        }
+      }
+    }
+  }
+
+  //--------------------------------------------------------------------
+  // Regressions
+  //--------------------------------------------------------------------
+
+  json_t report = {{"results", results}};
+
+  bool regressed = false;
+  if (baseline) {
+    std::map<std::string, json_t const *> before;
+    for (json_t const & result : baseline->at("results")) {
+      before.emplace(result.at("case").dump(), &result);
+    }
+    json_t const thresholds =
+        config.value("thresholds", json_t::object());
+    json_t regressions = json_t::array();
+    for (json_t const & result : results) {
+      auto const it = before.find(result["case"].dump());
+      if (it != before.end()) {
+        compare(regressions, thresholds, result, *it->second);
+      }
+    }
+    regressed = !regressions.empty();
+    report["regressions"] = std::move(regressions);
+  }
+
+  std::cout << report.dump(2) << std::endl;
+
+  return regressed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
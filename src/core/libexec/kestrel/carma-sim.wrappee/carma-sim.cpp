@@ -0,0 +1,170 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <atomic>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sst/catalog/SST_TEV_ARG.hpp>
+#include <sst/catalog/SST_TEV_DEF.hpp>
+#include <sst/catalog/dir_it.hpp>
+#include <sst/catalog/json/get_from_file.hpp>
+#include <sst/catalog/path.hpp>
+#include <sst/catalog/to_string.hpp>
+
+#include <IRacePluginNM.h>
+#include <IRaceSdkNM.h>
+#include <RaceLog.h>
+
+#include <kestrel/carma/config_t.hpp>
+#include <kestrel/carma/plugin_t.hpp>
+#include <kestrel/carma/role_t.hpp>
+#include <kestrel/json_t.hpp>
+#include <kestrel/psn_t.hpp>
+#include <kestrel/sim_network_t.hpp>
+#include <kestrel/tracing_event_t.hpp>
+
+using namespace kestrel;
+using namespace kestrel::carma;
+
+namespace {
+
+std::atomic_bool sigint_(false);
+
+} // namespace
+
+extern "C" void handle_sigint(int) {
+  sigint_ = true;
+}
+
+//
+// Runs every node of a generate_configs directory in this process on
+// a sim_network_t. The optional JSON file holds the sim_network_t
+// config plus a "messages" object that says how many messages to
+// whisper between random pairs of clients:
+//
+//    {
+//      "seed": 1,
+//      "speed": 1,
+//      "link": {"latency_ms": 50, "bandwidth_bps": 10000000},
+//      "messages": {"count": 100, "start_s": 30, "period_s": 0.5}
+//    }
+//
+// Each delivery is printed as it happens, and the network statistics
+// are printed as JSON at the end.
+//
+
+int main(int const argc, char ** const argv) {
+
+  tracing_event_t SST_TEV_DEF(tev);
+
+  if (std::signal(SIGINT, &handle_sigint) == SIG_ERR) {
+    throw std::runtime_error("std::signal() failed");
+  }
+
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: carma sim <configs_dir> [<json_file>]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  RaceLog::setLogLevel(RaceLog::LL_DEBUG);
+  RaceLog::setLogLevelStdout(RaceLog::LL_WARNING);
+  RaceLog::setLogLevelFile(RaceLog::LL_DEBUG);
+
+  nlohmann::json const sim_config =
+      argc == 3 ? sst::json::get_from_file<nlohmann::json>(argv[2]) :
+                  nlohmann::json::object();
+
+  sim_network_t network(sigint_, sim_config);
+
+  std::vector<psn_t> clients;
+  for (sst::path & path : sst::dir_it(argv[1])) {
+    if (path.test_d()) {
+      config_t const config(SST_TEV_ARG(tev), path.str());
+      psn_t const & me = config.local().psn();
+      if (config.phonebook().at(SST_TEV_ARG(tev), me)->role()
+          == role_t::client()) {
+        clients.push_back(me);
+      }
+      network.add_node(me.string(),
+                       path.str(),
+                       [](IRaceSdkNM & sdk) {
+                         return std::unique_ptr<IRacePluginNM>(
+                             new plugin_t(sdk));
+                       });
+    }
+  }
+
+  nlohmann::json const messages =
+      sim_config.value("messages", nlohmann::json::object());
+  auto const count = messages.value("count", 0ULL);
+  if (count > 0) {
+    if (clients.size() < 2) {
+      throw std::runtime_error("need at least two clients to whisper");
+    }
+    double const start_s = messages.value("start_s", 30.0);
+    double const period_s = messages.value("period_s", 1.0);
+    std::mt19937_64 rng(sim_config.value("seed", 0ULL));
+    std::uniform_int_distribution<std::size_t> pick(0,
+                                                    clients.size() - 1);
+    for (decltype(+count) k = 0; k < count; ++k) {
+      auto const i = pick(rng);
+      auto j = pick(rng);
+      while (j == i) {
+        j = pick(rng);
+      }
+      network.whisper(
+          clients[i].string(),
+          clients[j].string(),
+          "sim " + sst::to_string(k),
+          static_cast<sim_network_t::time_ns_t>(
+              (start_s + period_s * static_cast<double>(k)) * 1e9));
+    }
+  }
+
+  network.run();
+
+  auto const stats = network.stats();
+  nlohmann::json const report = {
+      {"packages_sent", stats.packages_sent},
+      {"packages_delivered", stats.packages_delivered},
+      {"packages_lost", stats.packages_lost},
+      {"packages_unroutable", stats.packages_unroutable},
+      {"bytes_sent", stats.bytes_sent},
+      {"messages_sent", stats.messages_sent},
+      {"messages_delivered", stats.messages_delivered},
+      {"mean_latency_ms",
+       stats.messages_delivered == 0 ?
+           0.0 :
+           static_cast<double>(stats.total_latency_ns)
+               / static_cast<double>(stats.messages_delivered) / 1e6},
+      {"max_latency_ms",
+       static_cast<double>(stats.max_latency_ns) / 1e6},
+  };
+  std::cout << report.dump(2) << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -26,6 +26,7 @@
 #include <kestrel/post_json_t.hpp>
 #include <chrono>
 #include <cstdint>
+#include <fstream>
 #include <iostream>
 #include <limits>
 #include <map>
@@ -533,10 +534,23 @@ mock_sdk_t::readFile(std::string const & filepath) {
   }
 }
 
-SdkResponse mock_sdk_t::appendFile(std::string const &,
-                                   std::vector<std::uint8_t> const &) {
+SdkResponse
+mock_sdk_t::appendFile(std::string const & filepath,
+                       std::vector<std::uint8_t> const & data) {
   std::lock_guard<decltype(mutex_)> const lock(mutex_);
-  throw std::runtime_error("appendFile() not supported yet");
+  std::string const x =
+      pluginConfigFilePath + "/" + normalize_path(filepath);
+  std::ofstream stream(x, std::ios::binary | std::ios::app);
+  stream.write(reinterpret_cast<char const *>(data.data()),
+               sst::checked_cast<std::streamsize>(data.size()));
+  stream.flush();
+  if (!stream) {
+    throw std::runtime_error("Error appending to file: "
+                             + sst::c_quote(x) + ".");
+  }
+  SdkResponse r{};
+  r.status = SDK_OK;
+  return r;
 }
 
 SdkResponse
@@ -0,0 +1,457 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/sim_network_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/sim_network_t.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <kestrel/json_t.hpp>
+#include <kestrel/sim_sdk_t.hpp>
+
+// RACE SDK
+#include <ClrMsg.h>
+#include <EncPkg.h>
+#include <IRacePluginNM.h>
+#include <PackageStatus.h>
+#include <PluginConfig.h>
+#include <PluginResponse.h>
+
+namespace kestrel {
+
+namespace {
+
+bool handle_plugin_response(PluginResponse const pr) {
+  switch (pr) {
+    case PLUGIN_OK:
+      return true;
+    case PLUGIN_TEMP_ERROR:
+    case PLUGIN_ERROR:
+      return false;
+    case PLUGIN_FATAL:
+      throw std::runtime_error("PLUGIN_FATAL");
+    default:
+      throw std::runtime_error("invalid PluginResponse");
+  }
+}
+
+void expect(bool const x, char const * const s) {
+  if (!x) {
+    throw std::invalid_argument{std::string{"expected "} + s};
+  }
+}
+#define expect(x) expect(x, #x)
+
+void check_link(nlohmann::json const & link) {
+  expect(link.is_object());
+  if (link.contains("latency_ms")) {
+    expect(link["latency_ms"].is_number_integer());
+    expect(link["latency_ms"] >= 0);
+  }
+  if (link.contains("jitter_ms")) {
+    expect(link["jitter_ms"].is_number_integer());
+    expect(link["jitter_ms"] >= 0);
+  }
+  if (link.contains("bandwidth_bps")) {
+    expect(link["bandwidth_bps"].is_number());
+    expect(link["bandwidth_bps"] > 0);
+  }
+  if (link.contains("loss")) {
+    expect(link["loss"].is_number());
+    expect(link["loss"] >= 0);
+    expect(link["loss"] <= 1);
+  }
+}
+
+nlohmann::json parse_config(nlohmann::json const & unparsed_config) {
+
+  expect(unparsed_config.is_object());
+
+  nlohmann::json const config =
+      [&](nlohmann::json && a) {
+        a.update(unparsed_config);
+        return a;
+      }(nlohmann::json::object({
+          {"seed", 0},
+          {"speed", 1},
+          {"duration_s", 0},
+          {"until_delivered", true},
+          {"link", nlohmann::json::object()},
+          {"nodes", nlohmann::json::object()},
+      }));
+
+  expect(config["seed"].is_number_integer());
+  expect(config["seed"] >= 0);
+
+  // A speed of zero would let virtual time jump ahead of the plugins'
+  // own timers, which still use the monotonic clock.
+  expect(config["speed"].is_number());
+  expect(config["speed"] > 0);
+
+  expect(config["duration_s"].is_number());
+  expect(config["duration_s"] >= 0);
+
+  expect(config["until_delivered"].is_boolean());
+
+  check_link(config["link"]);
+
+  expect(config["nodes"].is_object());
+  for (auto const & kv : config["nodes"].items()) {
+    check_link(kv.value());
+  }
+
+  return config;
+}
+
+#undef expect
+
+sim_network_t::link_model_t
+parse_link(nlohmann::json const & src,
+           sim_network_t::link_model_t link) {
+  if (src.contains("latency_ms")) {
+    link.latency_ns = src["latency_ms"].get<sim_network_t::time_ns_t>()
+                      * 1000000;
+  }
+  if (src.contains("jitter_ms")) {
+    link.jitter_ns = src["jitter_ms"].get<sim_network_t::time_ns_t>()
+                     * 1000000;
+  }
+  if (src.contains("bandwidth_bps")) {
+    link.bandwidth_bps = src["bandwidth_bps"].get<double>();
+  }
+  if (src.contains("loss")) {
+    link.loss = src["loss"].get<double>();
+  }
+  return link;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------
+
+sim_network_t::sim_network_t(std::atomic_bool const & sigint,
+                             nlohmann::json const & config,
+                             parsed_tag)
+    : sigint_(sigint),
+      config_(config),
+      default_link_(parse_link(config["link"], link_model_t())),
+      speed_(config["speed"].get<double>()),
+      duration_ns_(static_cast<time_ns_t>(
+          config["duration_s"].get<double>() * 1e9)),
+      until_delivered_(config["until_delivered"].get<bool>()),
+      rng_(config["seed"].get<std::uint64_t>()),
+      start_(std::chrono::steady_clock::now()) {
+}
+
+sim_network_t::sim_network_t(std::atomic_bool const & sigint,
+                             nlohmann::json const & config)
+    : sim_network_t(sigint, parse_config(config), parsed_tag()) {
+}
+
+sim_network_t::~sim_network_t() noexcept {
+  // Destroy the plugins before any of the SDKs, since a plugin may
+  // still be calling into any SDK until it is destroyed.
+  for (auto & kv : nodes_) {
+    kv.second.plugin.reset();
+  }
+}
+
+sim_network_t::node_t &
+sim_network_t::node(std::string const & pseudonym) {
+  auto const it = nodes_.find(pseudonym);
+  if (it == nodes_.end()) {
+    throw std::runtime_error("unknown node: " + pseudonym);
+  }
+  return it->second;
+}
+
+void sim_network_t::add_node(std::string const & pseudonym,
+                             std::string const & config_dir,
+                             plugin_factory_t const & make_plugin) {
+  if (nodes_.count(pseudonym) != 0) {
+    throw std::runtime_error("duplicate node: " + pseudonym);
+  }
+  node_t & node = nodes_[pseudonym];
+  node.uplink = default_link_;
+  if (config_["nodes"].contains(pseudonym)) {
+    node.uplink = parse_link(config_["nodes"][pseudonym], node.uplink);
+  }
+  node.sdk.reset(new sim_sdk_t(*this, pseudonym, config_dir));
+  node.plugin = make_plugin(*node.sdk);
+}
+
+//----------------------------------------------------------------------
+// Virtual clock
+//----------------------------------------------------------------------
+
+sim_network_t::time_ns_t sim_network_t::now_ns_locked() const {
+  auto const wall =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start_)
+          .count();
+  return std::max(now_ns_,
+                  static_cast<time_ns_t>(static_cast<double>(wall)
+                                         * speed_));
+}
+
+sim_network_t::time_ns_t sim_network_t::now_ns() {
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+  return now_ns_locked();
+}
+
+void sim_network_t::schedule_locked(time_ns_t const time_ns,
+                                    std::function<void()> fn) {
+  events_.emplace(event_key_t(time_ns, event_seq_++), std::move(fn));
+  cv_.notify_one();
+}
+
+//----------------------------------------------------------------------
+
+void sim_network_t::post(std::string const & pseudonym,
+                         time_ns_t const delay_ns,
+                         plugin_call_t f,
+                         bool const retry) {
+  IRacePluginNM * const plugin = node(pseudonym).plugin.get();
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+  schedule_locked(
+      now_ns_locked() + delay_ns,
+      [this, pseudonym, plugin, f, retry] {
+        PluginResponse r;
+        try {
+          r = f(*plugin);
+        } catch (...) {
+          throw std::runtime_error("plugin calls should never throw");
+        }
+        if (!handle_plugin_response(r) && retry) {
+          post(pseudonym, retry_ns_, f, retry);
+        }
+      });
+}
+
+void sim_network_t::send(std::string const & from,
+                         std::vector<std::string> const & personas,
+                         RawData const & data,
+                         RaceHandle const handle) {
+  node_t & src = node(from);
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+  time_ns_t const now = now_ns_locked();
+  time_ns_t const tx_ns =
+      static_cast<time_ns_t>(static_cast<double>(data.size()) * 8 * 1e9
+                             / src.uplink.bandwidth_bps);
+  std::uniform_real_distribution<double> loss_dist(0, 1);
+  std::uniform_int_distribution<time_ns_t> jitter_dist(
+      0,
+      src.uplink.jitter_ns);
+  for (auto const & persona : personas) {
+    ++stats_.packages_sent;
+    stats_.bytes_sent += data.size();
+    src.uplink_free_ns = std::max(now, src.uplink_free_ns) + tx_ns;
+    auto const dst = nodes_.find(persona);
+    if (dst == nodes_.end()) {
+      ++stats_.packages_unroutable;
+      continue;
+    }
+    if (src.uplink.loss > 0 && loss_dist(rng_) < src.uplink.loss) {
+      ++stats_.packages_lost;
+      continue;
+    }
+    time_ns_t const arrive_ns = src.uplink_free_ns
+                                + src.uplink.latency_ns
+                                + jitter_dist(rng_);
+    IRacePluginNM * const plugin = dst->second.plugin.get();
+    schedule_locked(arrive_ns, [this, plugin, data] {
+      {
+        std::lock_guard<decltype(mutex_)> const lock(mutex_);
+        ++stats_.packages_delivered;
+      }
+      PluginResponse r;
+      try {
+        r = plugin->processEncPkg(NULL_RACE_HANDLE, EncPkg(data), {});
+      } catch (...) {
+        throw std::runtime_error("processEncPkg() should never throw");
+      }
+      handle_plugin_response(r);
+    });
+  }
+  IRacePluginNM * const plugin = src.plugin.get();
+  schedule_locked(std::max(now, src.uplink_free_ns), [plugin, handle] {
+    PluginResponse r;
+    try {
+      r = plugin->onPackageStatusChanged(handle, PACKAGE_SENT);
+    } catch (...) {
+      throw std::runtime_error(
+          "onPackageStatusChanged() should never throw");
+    }
+    handle_plugin_response(r);
+  });
+}
+
+//----------------------------------------------------------------------
+// Messages
+//----------------------------------------------------------------------
+
+void sim_network_t::whisper(std::string const & from,
+                            std::string const & to,
+                            std::string const & msg,
+                            time_ns_t const at_ns) {
+  IRacePluginNM * const plugin = node(from).plugin.get();
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+  ++whispers_pending_;
+  schedule_locked(at_ns, [this, plugin, from, to, msg] {
+    {
+      std::lock_guard<decltype(mutex_)> const lock(mutex_);
+      --whispers_pending_;
+      ++stats_.messages_sent;
+      messages_in_flight_[{from, to, msg}] = now_ns_locked();
+    }
+    PluginResponse r;
+    try {
+      r = plugin->processClrMsg(NULL_RACE_HANDLE,
+                                ClrMsg(msg, from, to, 0, 0, 0, 0));
+    } catch (...) {
+      throw std::runtime_error("processClrMsg() should never throw");
+    }
+    handle_plugin_response(r);
+  });
+}
+
+void sim_network_t::deliver(ClrMsg const & msg) {
+  time_ns_t now;
+  {
+    std::lock_guard<decltype(mutex_)> const lock(mutex_);
+    now = now_ns_locked();
+    auto const it = messages_in_flight_.find(
+        {msg.getFrom(), msg.getTo(), msg.getMsg()});
+    if (it != messages_in_flight_.end()) {
+      time_ns_t const latency_ns = now - it->second;
+      ++stats_.messages_delivered;
+      stats_.total_latency_ns += latency_ns;
+      stats_.max_latency_ns =
+          std::max(stats_.max_latency_ns, latency_ns);
+      messages_in_flight_.erase(it);
+    }
+  }
+  std::lock_guard<decltype(stdout_mutex_)> const lock(stdout_mutex_);
+  std::cout << std::fixed << std::setprecision(3)
+            << static_cast<double>(now) / 1e9 << " " << msg.getTo()
+            << " <- " << msg.getFrom() << ": " << msg.getMsg()
+            << std::endl;
+}
+
+//----------------------------------------------------------------------
+// run
+//----------------------------------------------------------------------
+
+void sim_network_t::run() {
+
+  {
+    std::lock_guard<decltype(mutex_)> const lock(mutex_);
+    start_ = std::chrono::steady_clock::now();
+  }
+
+  for (auto & kv : nodes_) {
+    PluginResponse r;
+    try {
+      PluginConfig x;
+      x.etcDirectory = "";
+      r = kv.second.plugin->init(x);
+    } catch (...) {
+      throw std::runtime_error("init() should never throw");
+    }
+    handle_plugin_response(r);
+    if (r != PLUGIN_OK) {
+      throw std::runtime_error("init() failed for " + kv.first);
+    }
+  }
+
+  auto const shutdown_all = [&](bool const check) {
+    for (auto & kv : nodes_) {
+      PluginResponse r;
+      try {
+        r = kv.second.plugin->shutdown();
+      } catch (...) {
+        if (check) {
+          throw std::runtime_error("shutdown() should never throw");
+        }
+        continue;
+      }
+      if (check) {
+        handle_plugin_response(r);
+      }
+    }
+  };
+
+  try {
+    std::unique_lock<decltype(mutex_)> lock(mutex_);
+    while (!sigint_) {
+      time_ns_t const now = now_ns_locked();
+      if (duration_ns_ > 0 && now >= duration_ns_) {
+        break;
+      }
+      if (until_delivered_ && stats_.messages_sent > 0
+          && whispers_pending_ == 0 && messages_in_flight_.empty()) {
+        break;
+      }
+      auto const next = events_.begin();
+      if (next == events_.end() || next->first.first > now) {
+        auto wait =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                idle_wait_);
+        if (next != events_.end()) {
+          auto const d = static_cast<double>(next->first.first - now);
+          wait = std::min(wait,
+                          std::chrono::nanoseconds(
+                              static_cast<time_ns_t>(d / speed_)));
+        }
+        cv_.wait_for(lock, wait);
+        continue;
+      }
+      now_ns_ = std::max(now_ns_, next->first.first);
+      std::function<void()> const fn = std::move(next->second);
+      events_.erase(next);
+      lock.unlock();
+      fn();
+      lock.lock();
+    }
+  } catch (...) {
+    shutdown_all(false);
+    throw;
+  }
+
+  shutdown_all(true);
+}
+
+sim_network_t::stats_t sim_network_t::stats() {
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+  return stats_;
+}
+
+} // namespace kestrel
@@ -0,0 +1,210 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef CARMA_SIM_NETWORK_T_HPP
+#define CARMA_SIM_NETWORK_T_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <kestrel/json_t.hpp>
+
+// RACE SDK
+#include <ClrMsg.h>
+#include <IRacePluginNM.h>
+#include <IRaceSdkNM.h>
+#include <PluginResponse.h>
+#include <SdkResponse.h>
+
+namespace kestrel {
+
+class sim_sdk_t;
+
+//
+// An in-process network of IRacePluginNM nodes. Each node gets its own
+// sim_sdk_t, and every package sent through sendEncryptedPackage() is
+// delivered to the recipient's plugin by this class instead of by a
+// message broker, after a delay computed from the sender's link model.
+//
+// All plugin callbacks (processEncPkg, onPackageStatusChanged, and so
+// on) are made from the thread that calls run(), in virtual time order.
+// The virtual clock starts at zero when run() is called and follows
+// the wall clock scaled by speed, which must be positive.
+//
+// Only the network is virtualized. The plugins' own timers (retries,
+// maintenance cooldowns, bundle windows, and so on) still run on the
+// monotonic clock, so speed should stay close enough to 1 for those
+// timers to keep their meaning relative to network delays. Runs are
+// repeatable in their network behavior (given the same seed) but not
+// in their exact interleavings.
+//
+
+class sim_network_t final {
+
+public:
+  using time_ns_t = std::int64_t;
+
+  using plugin_factory_t =
+      std::function<std::unique_ptr<IRacePluginNM>(IRaceSdkNM &)>;
+
+  using plugin_call_t = std::function<PluginResponse(IRacePluginNM &)>;
+
+  //--------------------------------------------------------------------
+
+  // The uplink of a node. Sends from the same node are serialized at
+  // bandwidth_bps bits per second, then each package takes latency_ns
+  // plus a uniform random [0, jitter_ns] to arrive, unless it is lost,
+  // which happens independently with probability loss.
+  struct link_model_t {
+    time_ns_t latency_ns = 0;
+    time_ns_t jitter_ns = 0;
+    double bandwidth_bps = 1e12;
+    double loss = 0;
+  };
+
+  struct stats_t {
+    std::uint64_t packages_sent = 0;
+    std::uint64_t packages_delivered = 0;
+    std::uint64_t packages_lost = 0;
+    std::uint64_t packages_unroutable = 0;
+    std::uint64_t bytes_sent = 0;
+    std::uint64_t messages_sent = 0;
+    std::uint64_t messages_delivered = 0;
+    time_ns_t total_latency_ns = 0;
+    time_ns_t max_latency_ns = 0;
+  };
+
+  //--------------------------------------------------------------------
+
+private:
+  struct node_t {
+    std::unique_ptr<sim_sdk_t> sdk;
+    std::unique_ptr<IRacePluginNM> plugin;
+    link_model_t uplink;
+    time_ns_t uplink_free_ns = 0;
+  };
+
+  using event_key_t = std::pair<time_ns_t, std::uint64_t>;
+
+  std::atomic_bool const & sigint_;
+
+  nlohmann::json const config_;
+  link_model_t const default_link_;
+  double const speed_;
+  time_ns_t const duration_ns_;
+  bool const until_delivered_;
+  time_ns_t const retry_ns_ = 100000000;
+  std::chrono::milliseconds idle_wait_{100};
+
+  // Nodes are only added before run() is called, so the map itself
+  // needs no locking.
+  std::map<std::string, node_t> nodes_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::mt19937_64 rng_;
+  std::chrono::steady_clock::time_point start_;
+  time_ns_t now_ns_ = 0;
+  std::uint64_t event_seq_ = 0;
+  std::map<event_key_t, std::function<void()>> events_;
+  std::uint64_t whispers_pending_ = 0;
+  std::map<std::vector<std::string>, time_ns_t> messages_in_flight_;
+  stats_t stats_;
+
+  std::mutex stdout_mutex_;
+
+  time_ns_t now_ns_locked() const;
+
+  void schedule_locked(time_ns_t time_ns, std::function<void()> fn);
+
+  node_t & node(std::string const & pseudonym);
+
+  struct parsed_tag {};
+  explicit sim_network_t(std::atomic_bool const & sigint,
+                         nlohmann::json const & config,
+                         parsed_tag);
+
+  //--------------------------------------------------------------------
+
+public:
+  explicit sim_network_t(std::atomic_bool const & sigint,
+                         nlohmann::json const & config);
+
+  sim_network_t(sim_network_t const &) = delete;
+  sim_network_t & operator=(sim_network_t const &) = delete;
+  sim_network_t(sim_network_t &&) = delete;
+  sim_network_t & operator=(sim_network_t &&) = delete;
+
+  ~sim_network_t() noexcept;
+
+  // Adds a node whose files (config.json and so on) live in
+  // config_dir. The node's uplink is taken from config["nodes"]
+  // [pseudonym] if present, falling back to config["link"].
+  void add_node(std::string const & pseudonym,
+                std::string const & config_dir,
+                plugin_factory_t const & make_plugin);
+
+  time_ns_t now_ns();
+
+  // Calls f on the plugin of the given node after delay_ns of virtual
+  // time. If retry is true and f does not return PLUGIN_OK, the call is
+  // repeated every 100ms until it does.
+  void post(std::string const & pseudonym,
+            time_ns_t delay_ns,
+            plugin_call_t f,
+            bool retry = false);
+
+  // Sends a package from one node to each of the given personas and
+  // reports PACKAGE_SENT back to the sender once the last copy has left
+  // the sender's uplink.
+  void send(std::string const & from,
+            std::vector<std::string> const & personas,
+            RawData const & data,
+            RaceHandle handle);
+
+  // Hands a message to the plugin of the from node at virtual time
+  // at_ns, as if its user had typed it.
+  void whisper(std::string const & from,
+               std::string const & to,
+               std::string const & msg,
+               time_ns_t at_ns);
+
+  // Called by a node's sim_sdk_t when its plugin presents a message.
+  void deliver(ClrMsg const & msg);
+
+  // Initializes every plugin, runs the network until SIGINT, until the
+  // duration has elapsed, or (with until_delivered) until every
+  // whispered message has been delivered, and shuts the plugins down.
+  void run();
+
+  stats_t stats();
+};
+
+} // namespace kestrel
+
+#endif // CARMA_SIM_NETWORK_T_HPP
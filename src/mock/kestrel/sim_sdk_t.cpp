@@ -0,0 +1,665 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/sim_sdk_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/sim_sdk_t.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sst/catalog/SST_ASSERT.h>
+#include <sst/catalog/SST_STATIC_ASSERT.h>
+#include <sst/catalog/SST_THROW_UNIMPLEMENTED.hpp>
+#include <sst/catalog/c_quote.hpp>
+#include <sst/catalog/checked_cast.hpp>
+#include <sst/catalog/dir_it.hpp>
+#include <sst/catalog/mkdir_p.hpp>
+#include <sst/catalog/path.hpp>
+#include <sst/catalog/promote.hpp>
+#include <sst/catalog/read_whole_file.hpp>
+#include <sst/catalog/rm_f_r.hpp>
+#include <sst/catalog/test_f.hpp>
+#include <sst/catalog/to_string.hpp>
+#include <sst/catalog/type_max.hpp>
+#include <sst/catalog/type_min.hpp>
+#include <sst/catalog/write_whole_file.hpp>
+
+#include <kestrel/normalize_path.hpp>
+#include <kestrel/sim_network_t.hpp>
+
+// RACE SDK
+#include <ClrMsg.h>
+#include <ConnectionStatus.h>
+#include <ConnectionType.h>
+#include <EncPkg.h>
+#include <IRacePluginNM.h>
+#include <LinkStatus.h>
+#include <PluginResponse.h>
+#include <SdkResponse.h>
+#include <TransmissionType.h>
+
+namespace kestrel {
+
+sim_sdk_t::sim_sdk_t(sim_network_t & network,
+                     std::string const & pseudonym,
+                     std::string const & config_dir)
+    : network_(network),
+      pseudonym_(pseudonym),
+      config_dir_(config_dir) {
+}
+
+RawData sim_sdk_t::getEntropy(std::uint32_t const numBytes) {
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+  RawData entropy;
+  if (numBytes > 0) {
+    entropy.reserve(sst::checked_cast<RawData::size_type>(numBytes));
+    using T1 = RawData::value_type;
+    using T2 = sst::promote<T1>::type;
+    SST_STATIC_ASSERT((std::is_same<T2, int>::value
+                       || std::is_same<T2, unsigned int>::value));
+    std::uniform_int_distribution<T2> d(sst::type_min<T1>::value,
+                                        sst::type_max<T1>::value);
+    std::random_device r;
+    for (decltype(+numBytes) i = 0; i < numBytes; ++i) {
+      entropy.push_back(static_cast<T1>(d(r)));
+    }
+  }
+  return entropy;
+}
+
+std::string sim_sdk_t::getActivePersona() {
+  return pseudonym_;
+}
+
+SdkResponse sim_sdk_t::asyncError(RaceHandle, PluginResponse) {
+  throw std::runtime_error("asyncError() not supported yet");
+}
+
+SdkResponse sim_sdk_t::makeDir(std::string const & path) {
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+  sst::mkdir_p(config_dir_ + "/" + normalize_path(path));
+  SdkResponse r{};
+  r.status = SDK_OK;
+  return r;
+}
+
+SdkResponse sim_sdk_t::removeDir(std::string const & path) {
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+  sst::rm_f_r(config_dir_ + "/" + normalize_path(path));
+  SdkResponse r{};
+  r.status = SDK_OK;
+  return r;
+}
+
+std::vector<std::string>
+sim_sdk_t::listDir(std::string const & directoryPath) {
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+  std::vector<std::string> list;
+  auto it =
+      sst::dir_it(config_dir_ + "/" + normalize_path(directoryPath));
+  auto const end = it.end();
+  for (; !(it == end); ++it) {
+    sst::path & path = *it;
+    list.emplace_back(path.str().substr(it.prefix()));
+  }
+  return list;
+}
+
+std::vector<std::uint8_t>
+sim_sdk_t::readFile(std::string const & filepath) {
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+  std::string const x = config_dir_ + "/" + normalize_path(filepath);
+  if (sst::test_f(x)) {
+    return sst::read_whole_file<std::vector<std::uint8_t>>(x);
+  } else {
+    return {};
+  }
+}
+
+SdkResponse
+sim_sdk_t::appendFile(std::string const & filepath,
+                      std::vector<std::uint8_t> const & data) {
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+  std::string const x = config_dir_ + "/" + normalize_path(filepath);
+  std::ofstream stream(x, std::ios::binary | std::ios::app);
+  stream.write(reinterpret_cast<char const *>(data.data()),
+               sst::checked_cast<std::streamsize>(data.size()));
+  stream.flush();
+  if (!stream) {
+    throw std::runtime_error("Error appending to file: "
+                             + sst::c_quote(x) + ".");
+  }
+  SdkResponse r{};
+  r.status = SDK_OK;
+  return r;
+}
+
+SdkResponse
+sim_sdk_t::writeFile(std::string const & filepath,
+                     std::vector<std::uint8_t> const & data) {
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+  if (filepath.find("..") != filepath.npos) {
+    throw std::runtime_error(
+        "Path must not contain \"..\" as a substring: "
+        + sst::c_quote(filepath) + ".");
+  }
+  sst::write_whole_file(data, config_dir_ + "/" + filepath);
+  SdkResponse r{};
+  r.status = SDK_OK;
+  return r;
+}
+
+SdkResponse sim_sdk_t::onPluginStatusChanged(PluginStatus) {
+  SdkResponse r{};
+  r.status = SDK_OK;
+  return r;
+}
+
+//----------------------------------------------------------------------
+// Links
+//----------------------------------------------------------------------
+
+LinkID
+sim_sdk_t::always_create_link(std::set<std::string> const & personas) {
+  std::string link_id = sst::to_string(race_handle_++) + ":";
+  for (auto const & persona : personas) {
+    for (auto const c : persona) {
+      if (c == '%') {
+        link_id += "%%";
+      } else if (c == ',') {
+        link_id += "%2C";
+      } else {
+        link_id += c;
+      }
+    }
+    link_id += ',';
+  }
+  link_info_t link_info;
+  link_info.personas = personas;
+  link_info.link_properties.linkType = LT_SEND;
+  link_info.link_properties.transmissionType = TT_UNICAST;
+  link_info.link_properties.connectionType = CT_INDIRECT;
+  link_info.link_properties.channelGid = channel_name_;
+  link_info.link_properties.linkAddress = "";
+  link_infos_.emplace(link_id, link_info);
+  links_for_[personas].insert(link_id);
+  return link_id;
+}
+
+//----------------------------------------------------------------------
+// sendEncryptedPackage
+//----------------------------------------------------------------------
+
+SdkResponse
+sim_sdk_t::sendEncryptedPackage(EncPkg const ePkg,
+                                ConnectionID const connectionId,
+                                uint64_t,
+                                int32_t) {
+  SdkResponse r{};
+  r.status = SDK_OK;
+  r.queueUtilization = 0;
+  std::vector<std::string> personas;
+  {
+    std::lock_guard<decltype(mutex_)> const lock(mutex_);
+    if (open_connections_.count(connectionId) == 0) {
+      throw std::runtime_error("unknown connectionId");
+    }
+    auto const & link_info =
+        link_infos_.at(connections_.at(connectionId));
+    personas.assign(link_info.personas.begin(),
+                    link_info.personas.end());
+    r.handle = race_handle_++;
+  }
+  network_.send(pseudonym_, personas, ePkg.getRawData(), r.handle);
+  return r;
+}
+
+//----------------------------------------------------------------------
+
+SdkResponse sim_sdk_t::presentCleartextMessage(ClrMsg const msg) {
+  network_.deliver(msg);
+  SdkResponse r;
+  r.status = SDK_OK;
+  r.queueUtilization = 0;
+  r.handle = NULL_RACE_HANDLE;
+  return r;
+}
+
+SdkResponse sim_sdk_t::openConnection(LinkType const linkType,
+                                      LinkID const linkId,
+                                      std::string,
+                                      int32_t,
+                                      int32_t,
+                                      int32_t const timeout) {
+  switch (linkType) {
+    case LT_SEND:
+    case LT_RECV:
+    case LT_BIDI:
+      break;
+    default:
+      throw std::runtime_error("invalid linkType");
+  }
+
+  if (timeout != 0) {
+    throw std::runtime_error(
+        "non-asynchronous calls are not supported");
+  }
+
+  SdkResponse r;
+  r.status = SDK_OK;
+  r.queueUtilization = 0;
+
+  ConnectionID connection_id;
+  LinkProperties link_properties;
+  {
+    std::lock_guard<decltype(mutex_)> const lock(mutex_);
+    auto const it = link_infos_.find(linkId);
+    if (it == link_infos_.end()) {
+      throw std::runtime_error("unknown linkId");
+    }
+    link_info_t & link_info = it->second;
+    r.handle = race_handle_++;
+    connection_id =
+        sst::to_string(link_info.connection_count++) + ":" + linkId;
+    connections_.emplace(connection_id, linkId);
+    link_properties = link_info.link_properties;
+  }
+
+  RaceHandle const handle = r.handle;
+  network_.post(
+      pseudonym_,
+      0,
+      [this, handle, connection_id, linkId, link_properties](
+          IRacePluginNM & plugin) {
+        {
+          std::lock_guard<decltype(mutex_)> const lock(mutex_);
+          open_connections_.insert(connection_id);
+        }
+        return plugin.onConnectionStatusChanged(handle,
+                                                connection_id,
+                                                CONNECTION_OPEN,
+                                                linkId,
+                                                link_properties);
+      },
+      true);
+
+  return r;
+}
+
+SdkResponse sim_sdk_t::closeConnection(ConnectionID const connectionId,
+                                       int32_t const timeout) {
+  if (timeout != 0) {
+    throw std::runtime_error(
+        "non-asynchronous calls are not supported");
+  }
+
+  SdkResponse r;
+  r.status = SDK_OK;
+  r.queueUtilization = 0;
+
+  LinkID link_id;
+  LinkProperties link_properties;
+  {
+    std::lock_guard<decltype(mutex_)> const lock(mutex_);
+    auto const it = open_connections_.find(connectionId);
+    if (it == open_connections_.end()) {
+      throw std::runtime_error("unknown connectionId");
+    }
+    open_connections_.erase(it);
+    r.handle = race_handle_++;
+    link_id = connections_.at(connectionId);
+    link_properties = link_infos_.at(link_id).link_properties;
+  }
+
+  RaceHandle const handle = r.handle;
+  network_.post(
+      pseudonym_,
+      0,
+      [handle, connectionId, link_id, link_properties](
+          IRacePluginNM & plugin) {
+        return plugin.onConnectionStatusChanged(handle,
+                                                connectionId,
+                                                CONNECTION_CLOSED,
+                                                link_id,
+                                                link_properties);
+      },
+      true);
+
+  return r;
+}
+
+std::vector<LinkID> sim_sdk_t::getLinksForPersonas(
+    std::vector<std::string> const recipientPersonas,
+    LinkType const linkType) {
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+
+  switch (linkType) {
+    case LT_SEND:
+    case LT_RECV:
+    case LT_BIDI:
+      break;
+    default:
+      throw std::runtime_error("invalid linkType");
+  }
+
+  if (recipientPersonas.empty()) {
+    return {};
+  }
+
+  if (linkType != LT_SEND) {
+    return {};
+  }
+
+  std::set<std::string> personas;
+  personas.insert(recipientPersonas.begin(), recipientPersonas.end());
+
+  std::vector<LinkID> links;
+  if (links_for_[personas].empty()) {
+    links.push_back(always_create_link(personas));
+  } else {
+    links.insert(links.end(),
+                 links_for_[personas].begin(),
+                 links_for_[personas].end());
+  }
+  return links;
+}
+
+LinkID
+sim_sdk_t::getLinkForConnection(ConnectionID const connectionId) {
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+  auto const it = connections_.find(connectionId);
+  if (it == connections_.end()) {
+    throw std::runtime_error("unknown connectionId");
+  }
+  return it->second;
+}
+
+LinkProperties sim_sdk_t::getLinkProperties(LinkID const linkId) {
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+  auto const it = link_infos_.find(linkId);
+  if (it == link_infos_.end()) {
+    throw std::runtime_error("unknown linkId");
+  }
+  return it->second.link_properties;
+}
+
+std::map<std::string, ChannelProperties>
+sim_sdk_t::getSupportedChannels() {
+  std::map<std::string, ChannelProperties> m;
+  auto xs = getAllChannelProperties();
+  for (auto & x : xs) {
+    m.emplace(x.channelGid, std::move(x));
+  }
+  return m;
+}
+
+//----------------------------------------------------------------------
+// getChannelProperties
+//----------------------------------------------------------------------
+
+ChannelProperties sim_sdk_t::getChannelProperties(std::string) {
+  SST_ASSERT((false));
+  SST_THROW_UNIMPLEMENTED();
+}
+
+//----------------------------------------------------------------------
+// getAllChannelProperties
+//----------------------------------------------------------------------
+
+std::vector<ChannelProperties> sim_sdk_t::getAllChannelProperties() {
+  std::vector<ChannelProperties> v(1);
+  v[0].linkDirection = LD_CREATOR_TO_LOADER;
+  v[0].transmissionType = TT_UNICAST;
+  v[0].connectionType = CT_INDIRECT;
+  v[0].channelGid = channel_name_;
+  v[0].roles.emplace_back();
+  return v;
+}
+
+//----------------------------------------------------------------------
+// deactivateChannel
+//----------------------------------------------------------------------
+
+SdkResponse sim_sdk_t::deactivateChannel(std::string, std::int32_t) {
+  SST_ASSERT((false));
+  SST_THROW_UNIMPLEMENTED();
+}
+
+//----------------------------------------------------------------------
+// activateChannel
+//----------------------------------------------------------------------
+
+SdkResponse
+sim_sdk_t::activateChannel(std::string, std::string, std::int32_t) {
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+  SdkResponse r;
+  r.status = SDK_OK;
+  r.queueUtilization = 0;
+  r.handle = NULL_RACE_HANDLE;
+  return r;
+}
+
+//----------------------------------------------------------------------
+// destroyLink
+//----------------------------------------------------------------------
+
+SdkResponse sim_sdk_t::destroyLink(LinkID, std::int32_t) {
+  SST_ASSERT((false));
+  SST_THROW_UNIMPLEMENTED();
+}
+
+//----------------------------------------------------------------------
+// createLink
+//----------------------------------------------------------------------
+
+SdkResponse sim_sdk_t::createLink(std::string channelGid,
+                                  std::vector<std::string> personas,
+                                  std::int32_t timeout) {
+  if (channelGid != channel_name_) {
+    throw std::runtime_error("unknown channel name: " + channelGid);
+  }
+  if (timeout != 0) {
+    throw std::runtime_error(
+        "non-asynchronous calls are not supported");
+  }
+  SdkResponse r{};
+  r.status = SDK_OK;
+  LinkID link_id;
+  LinkProperties link_properties;
+  {
+    std::lock_guard<decltype(mutex_)> const lock(mutex_);
+    r.handle = race_handle_++;
+    link_id = always_create_link(
+        std::set<std::string>(personas.cbegin(), personas.cend()));
+    link_properties = link_infos_.at(link_id).link_properties;
+  }
+  RaceHandle const handle = r.handle;
+  network_.post(
+      pseudonym_,
+      0,
+      [handle, link_id, link_properties](IRacePluginNM & plugin) {
+        return plugin.onLinkStatusChanged(handle,
+                                          link_id,
+                                          LINK_CREATED,
+                                          link_properties);
+      },
+      true);
+  return r;
+}
+
+//----------------------------------------------------------------------
+// loadLinkAddress
+//----------------------------------------------------------------------
+
+SdkResponse sim_sdk_t::loadLinkAddress(std::string,
+                                       std::string,
+                                       std::vector<std::string>,
+                                       std::int32_t) {
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+  SdkResponse r{};
+  r.status = SDK_OK;
+  r.handle = race_handle_++;
+  return r;
+}
+
+//----------------------------------------------------------------------
+// loadLinkAddresses
+//----------------------------------------------------------------------
+
+SdkResponse sim_sdk_t::loadLinkAddresses(std::string,
+                                         std::vector<std::string>,
+                                         std::vector<std::string>,
+                                         std::int32_t) {
+  SST_ASSERT((false));
+  SST_THROW_UNIMPLEMENTED();
+}
+
+//----------------------------------------------------------------------
+// createLinkFromAddress
+//----------------------------------------------------------------------
+
+SdkResponse sim_sdk_t::createLinkFromAddress(std::string,
+                                             std::string,
+                                             std::vector<std::string>,
+                                             std::int32_t) {
+  SST_ASSERT((false));
+  SST_THROW_UNIMPLEMENTED();
+}
+
+//----------------------------------------------------------------------
+// bootstrapDevice
+//----------------------------------------------------------------------
+
+SdkResponse sim_sdk_t::bootstrapDevice(RaceHandle,
+                                       std::vector<std::string>) {
+  SST_ASSERT((false));
+  SST_THROW_UNIMPLEMENTED();
+}
+
+//----------------------------------------------------------------------
+// bootstrapFailed
+//----------------------------------------------------------------------
+
+SdkResponse sim_sdk_t::bootstrapFailed(RaceHandle) {
+  SST_ASSERT((false));
+  SST_THROW_UNIMPLEMENTED();
+}
+
+//----------------------------------------------------------------------
+// setPersonasForLink
+//----------------------------------------------------------------------
+
+SdkResponse sim_sdk_t::setPersonasForLink(std::string,
+                                          std::vector<std::string>) {
+  SST_ASSERT((false));
+  SST_THROW_UNIMPLEMENTED();
+}
+
+//----------------------------------------------------------------------
+// getPersonasForLink
+//----------------------------------------------------------------------
+
+std::vector<std::string> sim_sdk_t::getPersonasForLink(std::string) {
+  SST_ASSERT((false));
+  SST_THROW_UNIMPLEMENTED();
+}
+
+//----------------------------------------------------------------------
+// onMessageStatusChanged
+//----------------------------------------------------------------------
+
+SdkResponse sim_sdk_t::onMessageStatusChanged(RaceHandle,
+                                              MessageStatus) {
+  std::lock_guard<decltype(mutex_)> const lock(mutex_);
+  SdkResponse r{};
+  r.status = SDK_OK;
+  return r;
+}
+
+//----------------------------------------------------------------------
+// sendBootstrapPkg
+//----------------------------------------------------------------------
+
+SdkResponse sim_sdk_t::sendBootstrapPkg(ConnectionID,
+                                        std::string,
+                                        RawData,
+                                        int32_t) {
+  SST_ASSERT((false));
+  SST_THROW_UNIMPLEMENTED();
+}
+
+//----------------------------------------------------------------------
+// requestPluginUserInput
+//----------------------------------------------------------------------
+
+SdkResponse sim_sdk_t::requestPluginUserInput(std::string const &,
+                                              std::string const &,
+                                              bool) {
+  SST_ASSERT((false));
+  SST_THROW_UNIMPLEMENTED();
+}
+
+//----------------------------------------------------------------------
+// requestCommonUserInput
+//----------------------------------------------------------------------
+
+SdkResponse sim_sdk_t::requestCommonUserInput(std::string const &) {
+  SST_ASSERT((false));
+  SST_THROW_UNIMPLEMENTED();
+}
+
+//----------------------------------------------------------------------
+// flushChannel
+//----------------------------------------------------------------------
+
+SdkResponse sim_sdk_t::flushChannel(std::string, uint64_t, int32_t) {
+  SST_ASSERT((false));
+  SST_THROW_UNIMPLEMENTED();
+}
+
+//----------------------------------------------------------------------
+// getLinksForChannel
+//----------------------------------------------------------------------
+
+std::vector<LinkID> sim_sdk_t::getLinksForChannel(std::string) {
+  SST_ASSERT((false));
+  SST_THROW_UNIMPLEMENTED();
+}
+
+//----------------------------------------------------------------------
+// displayInfoToUser
+//----------------------------------------------------------------------
+
+SdkResponse sim_sdk_t::displayInfoToUser(std::string const &,
+                                         RaceEnums::UserDisplayType) {
+  SST_ASSERT((false));
+  SST_THROW_UNIMPLEMENTED();
+}
+
+} // namespace kestrel
@@ -0,0 +1,217 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef CARMA_SIM_SDK_T_HPP
+#define CARMA_SIM_SDK_T_HPP
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+// RACE SDK
+#include <ChannelProperties.h>
+#include <ClrMsg.h>
+#include <EncPkg.h>
+#include <IRaceSdkNM.h>
+#include <LinkProperties.h>
+#include <PluginResponse.h>
+#include <RaceEnums.h>
+#include <SdkResponse.h>
+
+namespace kestrel {
+
+class sim_network_t;
+
+//
+// The IRaceSdkNM of one node of a sim_network_t. Links, connections,
+// and files behave like in mock_sdk_t, with the node's files rooted at
+// its config directory, but everything that mock_sdk_t would do through
+// RabbitMQ or its polling loop is handed to the network instead.
+//
+
+class sim_sdk_t final : public IRaceSdkNM {
+
+  sim_network_t & network_;
+
+  std::string const pseudonym_;
+
+  std::string const config_dir_;
+
+  std::string channel_name_ = "carma_sim";
+
+  std::mutex mutex_;
+
+  RaceHandle race_handle_ = 1;
+
+  //--------------------------------------------------------------------
+
+  struct link_info_t {
+    std::set<std::string> personas;
+    std::uintmax_t connection_count = 0;
+    LinkProperties link_properties;
+  };
+
+  std::map<LinkID, link_info_t> link_infos_;
+  std::map<ConnectionID, LinkID> connections_;
+  std::set<ConnectionID> open_connections_;
+  std::map<std::set<std::string>, std::set<LinkID>> links_for_;
+
+  LinkID always_create_link(std::set<std::string> const & personas);
+
+  //--------------------------------------------------------------------
+
+public:
+  explicit sim_sdk_t(sim_network_t & network,
+                     std::string const & pseudonym,
+                     std::string const & config_dir);
+
+  //--------------------------------------------------------------------
+  // IRaceSdkNM functions
+  //--------------------------------------------------------------------
+  //
+  // These are kept in the same order as in mock_sdk_t. See there for
+  // how to update them.
+  //
+
+  RawData getEntropy(std::uint32_t numBytes) final;
+
+  std::string getActivePersona() final;
+
+  SdkResponse asyncError(RaceHandle handle,
+                         PluginResponse status) final;
+
+  SdkResponse makeDir(std::string const & directoryPath) final;
+
+  SdkResponse removeDir(std::string const & directoryPath) final;
+
+  std::vector<std::string>
+  listDir(std::string const & directoryPath) final;
+
+  std::vector<std::uint8_t>
+  readFile(std::string const & filepath) final;
+
+  SdkResponse appendFile(std::string const & filepath,
+                         std::vector<std::uint8_t> const & data) final;
+
+  SdkResponse writeFile(std::string const & filepath,
+                        std::vector<std::uint8_t> const & data) final;
+
+  SdkResponse onPluginStatusChanged(PluginStatus pluginStatus) final;
+
+  SdkResponse sendEncryptedPackage(EncPkg ePkg,
+                                   ConnectionID connectionId,
+                                   uint64_t batchId,
+                                   int32_t timeout) final;
+
+  SdkResponse presentCleartextMessage(ClrMsg msg) final;
+
+  SdkResponse openConnection(LinkType linkType,
+                             LinkID linkId,
+                             std::string linkHints,
+                             int32_t priority,
+                             int32_t sendTimeout,
+                             int32_t timeout) final;
+
+  SdkResponse closeConnection(ConnectionID connectionId,
+                              int32_t timeout) final;
+
+  std::vector<LinkID>
+  getLinksForPersonas(std::vector<std::string> recipientPersonas,
+                      LinkType linkType) final;
+
+  LinkID getLinkForConnection(ConnectionID connectionId) final;
+
+  LinkProperties getLinkProperties(LinkID linkId) final;
+
+  std::map<std::string, ChannelProperties> getSupportedChannels() final;
+
+  ChannelProperties getChannelProperties(std::string channelGid) final;
+
+  std::vector<ChannelProperties> getAllChannelProperties() final;
+
+  SdkResponse deactivateChannel(std::string channelGid,
+                                std::int32_t timeout) final;
+
+  SdkResponse activateChannel(std::string channelGid,
+                              std::string roleName,
+                              std::int32_t timeout) final;
+
+  SdkResponse destroyLink(LinkID linkId, std::int32_t timeout) final;
+
+  SdkResponse createLink(std::string channelGid,
+                         std::vector<std::string> personas,
+                         std::int32_t timeout) final;
+
+  SdkResponse loadLinkAddress(std::string channelGid,
+                              std::string linkAddress,
+                              std::vector<std::string> personas,
+                              std::int32_t timeout) final;
+
+  SdkResponse loadLinkAddresses(std::string channelGid,
+                                std::vector<std::string> linkAddresses,
+                                std::vector<std::string> personas,
+                                std::int32_t timeout) final;
+
+  SdkResponse createLinkFromAddress(std::string channelGid,
+                                    std::string linkAddress,
+                                    std::vector<std::string> personas,
+                                    std::int32_t timeout) final;
+
+  SdkResponse
+  bootstrapDevice(RaceHandle handle,
+                  std::vector<std::string> ta2Channels) final;
+
+  SdkResponse bootstrapFailed(RaceHandle handle) final;
+
+  SdkResponse
+  setPersonasForLink(std::string linkId,
+                     std::vector<std::string> personas) final;
+
+  std::vector<std::string> getPersonasForLink(std::string linkId) final;
+
+  SdkResponse onMessageStatusChanged(RaceHandle handle,
+                                     MessageStatus status) final;
+
+  SdkResponse sendBootstrapPkg(ConnectionID connectionId,
+                               std::string persona,
+                               RawData pkg,
+                               int32_t timeout) final;
+
+  SdkResponse requestPluginUserInput(std::string const & key,
+                                     std::string const & prompt,
+                                     bool cache) final;
+
+  SdkResponse requestCommonUserInput(std::string const & key) final;
+
+  SdkResponse flushChannel(std::string channelGid,
+                           uint64_t batchId,
+                           int32_t timeout) final;
+
+  std::vector<LinkID> getLinksForChannel(std::string channelGid) final;
+
+  SdkResponse
+  displayInfoToUser(std::string const & data,
+                    RaceEnums::UserDisplayType displayType) final;
+};
+
+} // namespace kestrel
+
+#endif // CARMA_SIM_SDK_T_HPP
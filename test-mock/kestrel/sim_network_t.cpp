@@ -0,0 +1,295 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/sim_network_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/sim_network_t.hpp>
+//
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/SST_TEST_THROW.hpp>
+#include <sst/catalog/test_main.hpp>
+
+#include <kestrel/json_t.hpp>
+
+// RACE SDK
+#include <ClrMsg.h>
+#include <ConnectionStatus.h>
+#include <EncPkg.h>
+#include <IRacePluginNM.h>
+#include <IRaceSdkNM.h>
+#include <LinkProperties.h>
+#include <PluginResponse.h>
+#include <SdkResponse.h>
+
+using kestrel::sim_network_t;
+
+namespace {
+
+//
+// A plugin that sends each message directly to its recipient as
+// "from\nto\nmsg" and presents every package it receives. It opens one
+// connection per recipient and queues messages until it is open.
+//
+
+class direct_plugin_t final : public IRacePluginNM {
+
+  IRaceSdkNM & sdk_;
+  std::map<std::string, ConnectionID> connections_;
+  std::map<LinkID, std::string> opening_;
+  std::map<std::string, std::vector<RawData>> queued_;
+
+  void send(ConnectionID const & connection, RawData const & data) {
+    sdk_.sendEncryptedPackage(EncPkg(0, 0, data), connection, 0, 0);
+  }
+
+public:
+  explicit direct_plugin_t(IRaceSdkNM & sdk) : sdk_(sdk) {
+  }
+
+  PluginResponse init(PluginConfig const &) override {
+    return PLUGIN_OK;
+  }
+
+  PluginResponse shutdown() override {
+    return PLUGIN_OK;
+  }
+
+  PluginResponse processClrMsg(RaceHandle,
+                               ClrMsg const & msg) override {
+    std::string const to = msg.getTo();
+    std::string const s =
+        msg.getFrom() + "\n" + to + "\n" + msg.getMsg();
+    RawData const data(s.begin(), s.end());
+    auto const it = connections_.find(to);
+    if (it != connections_.end()) {
+      send(it->second, data);
+      return PLUGIN_OK;
+    }
+    if (queued_.count(to) == 0) {
+      std::vector<LinkID> const links =
+          sdk_.getLinksForPersonas({to}, LT_SEND);
+      if (links.empty()) {
+        return PLUGIN_ERROR;
+      }
+      opening_[links.front()] = to;
+      sdk_.openConnection(LT_SEND, links.front(), "", 0, 0, 0);
+    }
+    queued_[to].push_back(data);
+    return PLUGIN_OK;
+  }
+
+  PluginResponse
+  processEncPkg(RaceHandle,
+                EncPkg const & ePkg,
+                std::vector<ConnectionID> const &) override {
+    RawData const data = ePkg.getCipherText();
+    std::string const s(data.begin(), data.end());
+    auto const i = s.find('\n');
+    auto const j = s.find('\n', i + 1);
+    if (i == std::string::npos || j == std::string::npos) {
+      return PLUGIN_ERROR;
+    }
+    sdk_.presentCleartextMessage(ClrMsg(s.substr(j + 1),
+                                        s.substr(0, i),
+                                        s.substr(i + 1, j - i - 1),
+                                        0,
+                                        0));
+    return PLUGIN_OK;
+  }
+
+  PluginResponse onConnectionStatusChanged(RaceHandle,
+                                           ConnectionID connId,
+                                           ConnectionStatus status,
+                                           LinkID linkId,
+                                           LinkProperties) override {
+    auto const it = opening_.find(linkId);
+    if (status != CONNECTION_OPEN || it == opening_.end()) {
+      return PLUGIN_OK;
+    }
+    std::string const to = it->second;
+    opening_.erase(it);
+    connections_[to] = connId;
+    for (RawData const & data : queued_[to]) {
+      send(connId, data);
+    }
+    queued_.erase(to);
+    return PLUGIN_OK;
+  }
+
+  PluginResponse prepareToBootstrap(RaceHandle,
+                                    LinkID,
+                                    std::string,
+                                    DeviceInfo) override {
+    return PLUGIN_OK;
+  }
+
+  PluginResponse onBootstrapPkgReceived(std::string, RawData) override {
+    return PLUGIN_OK;
+  }
+
+  PluginResponse onPackageStatusChanged(RaceHandle,
+                                        PackageStatus) override {
+    return PLUGIN_OK;
+  }
+
+  PluginResponse onLinkPropertiesChanged(LinkID,
+                                         LinkProperties) override {
+    return PLUGIN_OK;
+  }
+
+  PluginResponse onPersonaLinksChanged(std::string,
+                                       LinkType,
+                                       std::vector<LinkID>) override {
+    return PLUGIN_OK;
+  }
+
+  PluginResponse onChannelStatusChanged(RaceHandle,
+                                        std::string,
+                                        ChannelStatus,
+                                        ChannelProperties) override {
+    return PLUGIN_OK;
+  }
+
+  PluginResponse onLinkStatusChanged(RaceHandle,
+                                     LinkID,
+                                     LinkStatus,
+                                     LinkProperties) override {
+    return PLUGIN_OK;
+  }
+
+  PluginResponse onUserInputReceived(RaceHandle,
+                                     bool,
+                                     std::string const &) override {
+    return PLUGIN_OK;
+  }
+
+  PluginResponse onUserAcknowledgementReceived(RaceHandle) override {
+    return PLUGIN_OK;
+  }
+
+  PluginResponse notifyEpoch(std::string const &) override {
+    return PLUGIN_OK;
+  }
+};
+
+std::unique_ptr<IRacePluginNM> make_plugin(IRaceSdkNM & sdk) {
+  return std::unique_ptr<IRacePluginNM>(new direct_plugin_t(sdk));
+}
+
+void add_nodes(sim_network_t & net,
+               std::vector<std::string> const & names) {
+  for (std::string const & name : names) {
+    net.add_node(name, ".", make_plugin);
+  }
+}
+
+} // namespace
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    std::atomic_bool const sigint{false};
+    sim_network_t::time_ns_t const ms = 1000000;
+
+    //------------------------------------------------------------------
+    // Invalid configurations are refused
+    //------------------------------------------------------------------
+
+    SST_TEST_THROW((sim_network_t(sigint, {{"speed", 0}})),
+                   std::invalid_argument);
+
+    SST_TEST_THROW((sim_network_t(sigint, {{"speed", -1}})),
+                   std::invalid_argument);
+
+    SST_TEST_THROW(
+        (sim_network_t(sigint, {{"link", {{"loss", 2}}}})),
+        std::invalid_argument);
+
+    //------------------------------------------------------------------
+    // Every message is delivered, no sooner than the link latency
+    //------------------------------------------------------------------
+
+    {
+      sim_network_t net(sigint,
+                        {
+                            {"seed", 1},
+                            {"duration_s", 10},
+                            {"link", {{"latency_ms", 20}}},
+                            {"nodes", {{"c", {{"latency_ms", 50}}}}},
+                        });
+      add_nodes(net, {"a", "b", "c"});
+      net.whisper("a", "b", "m1", 0);
+      net.whisper("a", "b", "m2", 0);
+      net.whisper("b", "c", "m3", 10 * ms);
+      net.whisper("c", "a", "m4", 20 * ms);
+      net.run();
+      sim_network_t::stats_t const s = net.stats();
+      SST_TEST_BOOL((s.messages_sent == 4));
+      SST_TEST_BOOL((s.messages_delivered == 4));
+      SST_TEST_BOOL((s.packages_sent == 4));
+      SST_TEST_BOOL((s.packages_delivered == 4));
+      SST_TEST_BOOL((s.packages_lost == 0));
+      SST_TEST_BOOL((s.packages_unroutable == 0));
+      // Each package is "x\ny\nmN" plus the EncPkg header.
+      std::size_t const package_size =
+          EncPkg(0, 0, RawData(6)).getRawData().size();
+      SST_TEST_BOOL((s.bytes_sent == 4 * package_size));
+      SST_TEST_BOOL((s.total_latency_ns >= 3 * 20 * ms + 50 * ms));
+      SST_TEST_BOOL((s.max_latency_ns >= 50 * ms));
+      SST_TEST_BOOL((s.max_latency_ns < 10000 * ms));
+    }
+
+    //------------------------------------------------------------------
+    // Lost and unroutable packages are counted but never delivered
+    //------------------------------------------------------------------
+
+    {
+      sim_network_t net(sigint,
+                        {
+                            {"duration_s", 0.3},
+                            {"nodes", {{"a", {{"loss", 1}}}}},
+                        });
+      add_nodes(net, {"a", "b"});
+      net.whisper("a", "b", "lost", 0);
+      net.whisper("b", "z", "unroutable", 0);
+      net.run();
+      sim_network_t::stats_t const s = net.stats();
+      SST_TEST_BOOL((s.messages_sent == 2));
+      SST_TEST_BOOL((s.messages_delivered == 0));
+      SST_TEST_BOOL((s.packages_sent == 2));
+      SST_TEST_BOOL((s.packages_delivered == 0));
+      SST_TEST_BOOL((s.packages_lost == 1));
+      SST_TEST_BOOL((s.packages_unroutable == 1));
+      SST_TEST_BOOL((s.total_latency_ns == 0));
+    }
+
+    //
+  });
+}
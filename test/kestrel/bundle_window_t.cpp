@@ -0,0 +1,175 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/bundle_window_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/bundle_window_t.hpp>
+//
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/test_main.hpp>
+
+using kestrel::bundle_window_t;
+using std::string;
+using std::vector;
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    using window_t = bundle_window_t<int, vector<string>, long>;
+    using sent_t = vector<std::pair<int, vector<string>>>;
+
+    auto const push = [](window_t & w,
+                         sent_t & sent,
+                         int const leader,
+                         string const & item,
+                         long const now) {
+      auto & b = w.open(leader, now);
+      b.value.push_back(item);
+      if (w.add(b, now)) {
+        sent.emplace_back(leader, b.value);
+        w.erase(leader);
+      }
+    };
+
+    auto const flush = [](window_t & w,
+                          sent_t & sent,
+                          long const now,
+                          bool const all) {
+      return w.flush(now,
+                     all,
+                     [&](int const k, window_t::bundle_t & b) {
+                       sent.emplace_back(k, b.value);
+                     });
+    };
+
+    //------------------------------------------------------------------
+    // Packets for the same leader are coalesced, one bundle per leader
+    //------------------------------------------------------------------
+
+    {
+      window_t w(100, 16);
+      sent_t sent;
+      push(w, sent, 1, "a", 0);
+      push(w, sent, 2, "b", 10);
+      push(w, sent, 1, "c", 20);
+      push(w, sent, 2, "d", 30);
+      push(w, sent, 1, "e", 40);
+      SST_TEST_BOOL((sent.empty()));
+      SST_TEST_BOOL((w.size() == 2));
+      SST_TEST_BOOL((flush(w, sent, 99, false) == 100));
+      SST_TEST_BOOL((sent.empty()));
+      SST_TEST_BOOL((flush(w, sent, 100, false) == 110));
+      SST_TEST_BOOL((sent.size() == 1));
+      SST_TEST_BOOL((sent[0].first == 1));
+      SST_TEST_BOOL((sent[0].second == vector<string>{"a", "c", "e"}));
+      SST_TEST_BOOL((flush(w, sent, 110, false) == 0));
+      SST_TEST_BOOL((sent.size() == 2));
+      SST_TEST_BOOL((sent[1].first == 2));
+      SST_TEST_BOOL((sent[1].second == vector<string>{"b", "d"}));
+      SST_TEST_BOOL((w.empty()));
+    }
+
+    //------------------------------------------------------------------
+    // A bundle goes out early once it is full
+    //------------------------------------------------------------------
+
+    {
+      window_t w(100, 3);
+      sent_t sent;
+      push(w, sent, 1, "a", 0);
+      push(w, sent, 1, "b", 1);
+      SST_TEST_BOOL((sent.empty()));
+      push(w, sent, 1, "c", 2);
+      SST_TEST_BOOL((sent.size() == 1));
+      SST_TEST_BOOL((sent[0].second == vector<string>{"a", "b", "c"}));
+      SST_TEST_BOOL((w.empty()));
+      push(w, sent, 1, "d", 3);
+      SST_TEST_BOOL((w.size() == 1));
+      SST_TEST_BOOL((flush(w, sent, 50, false) == 103));
+    }
+
+    //------------------------------------------------------------------
+    // A late arrival sends a bundle whose window has passed
+    //------------------------------------------------------------------
+
+    {
+      window_t w(100, 16);
+      sent_t sent;
+      push(w, sent, 1, "a", 0);
+      push(w, sent, 1, "b", 150);
+      SST_TEST_BOOL((sent.size() == 1));
+      SST_TEST_BOOL((sent[0].second == vector<string>{"a", "b"}));
+    }
+
+    //------------------------------------------------------------------
+    // A zero window sends every packet on its own
+    //------------------------------------------------------------------
+
+    {
+      window_t w(0, 16);
+      sent_t sent;
+      push(w, sent, 1, "a", 0);
+      push(w, sent, 1, "b", 0);
+      SST_TEST_BOOL((sent.size() == 2));
+      SST_TEST_BOOL((w.empty()));
+    }
+
+    //------------------------------------------------------------------
+    // Flushing all sends bundles whose window is still open
+    //------------------------------------------------------------------
+
+    {
+      window_t w(100, 16);
+      sent_t sent;
+      push(w, sent, 1, "a", 0);
+      push(w, sent, 2, "b", 0);
+      SST_TEST_BOOL((flush(w, sent, 1, true) == 0));
+      SST_TEST_BOOL((sent.size() == 2));
+      SST_TEST_BOOL((w.empty()));
+    }
+
+    //------------------------------------------------------------------
+    // A throwing sender still removes the bundle
+    //------------------------------------------------------------------
+
+    {
+      window_t w(100, 16);
+      sent_t sent;
+      push(w, sent, 1, "a", 0);
+      bool threw = false;
+      try {
+        w.flush(100, false, [](int, window_t::bundle_t &) {
+          throw 0;
+        });
+      } catch (int) {
+        threw = true;
+      }
+      SST_TEST_BOOL((threw));
+      SST_TEST_BOOL((w.empty()));
+    }
+
+    //------------------------------------------------------------------
+  });
+}
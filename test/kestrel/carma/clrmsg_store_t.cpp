@@ -0,0 +1,252 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/clrmsg_store_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/clrmsg_store_t.hpp>
+//
+
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/SST_TEST_THROW.hpp>
+#include <sst/catalog/SST_TEV_DEF.hpp>
+#include <sst/catalog/rm_f_r.hpp>
+#include <sst/catalog/test_d.hpp>
+#include <sst/catalog/test_main.hpp>
+
+#include <kestrel/carma/clrmsg_store_entry_t.hpp>
+#include <kestrel/clrmsg_t.hpp>
+#include <kestrel/tracing_event_t.hpp>
+
+// RACE SDK
+#include <ClrMsg.h>
+
+using namespace kestrel;
+using namespace kestrel::carma;
+
+namespace {
+
+std::string const dir = "clrmsg_store_t.tmp";
+
+clrmsg_t make_clrmsg(std::string const & msg) {
+  return clrmsg_t(ClrMsg(msg, "alice", "bob", 1, 2, 3, 4));
+}
+
+clrmsg_store_entry_t make_entry(std::string const & msg) {
+  return clrmsg_store_entry_t(make_clrmsg(msg));
+}
+
+// Returns the log of the current generation, which is the only one
+// left after the store is constructed.
+std::string current_log() {
+  for (int g = 0; g < 100; ++g) {
+    std::string const d = dir + "/log." + std::to_string(g);
+    if (sst::test_d(d)) {
+      return d + "/records";
+    }
+  }
+  return "";
+}
+
+std::streamoff file_size(std::string const & file) {
+  std::ifstream stream(file, std::ios::binary | std::ios::ate);
+  return stream ? static_cast<std::streamoff>(stream.tellg()) : 0;
+}
+
+} // namespace
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    tracing_event_t SST_TEV_DEF(tev);
+
+    sst::rm_f_r(dir);
+
+    //------------------------------------------------------------------
+    // Flushed entries survive a reopen, unflushed ones do not
+    //------------------------------------------------------------------
+
+    std::uint64_t id1;
+    std::uint64_t id2;
+    {
+      clrmsg_store_t store(tev, dir);
+      SST_TEST_BOOL((store.entries().empty()));
+      id1 = store.add(tev, make_entry("one")).id();
+      id2 = store.add(tev, make_entry("two")).id();
+      SST_TEST_BOOL((id1 != 0 && id2 != 0 && id1 != id2));
+      store.flush(tev);
+      store.add(tev, make_entry("lost"));
+    }
+    {
+      clrmsg_store_t store(tev, dir);
+      SST_TEST_BOOL((store.entries().size() == 2));
+      SST_TEST_BOOL((store.find(tev, id1) != nullptr));
+      SST_TEST_BOOL((store.find(tev, id1)->clrmsg()
+                     == make_clrmsg("one")));
+      SST_TEST_BOOL((!store.find(tev, id1)->dirty()));
+      SST_TEST_BOOL((store.find(tev, id2)->id() == id2));
+      auto const & entry = store.add(tev, make_entry("three"));
+      SST_TEST_BOOL((entry.id() > id2));
+      store.flush(tev);
+    }
+
+    //------------------------------------------------------------------
+    // Erasures are logged
+    //------------------------------------------------------------------
+
+    {
+      clrmsg_store_t store(tev, dir);
+      SST_TEST_BOOL((store.entries().size() == 3));
+      SST_TEST_BOOL((store.erase(tev, id1)));
+      SST_TEST_BOOL((!store.erase(tev, id1)));
+      store.flush(tev);
+    }
+    {
+      clrmsg_store_t store(tev, dir);
+      SST_TEST_BOOL((store.entries().size() == 2));
+      SST_TEST_BOOL((store.find(tev, id1) == nullptr));
+      SST_TEST_BOOL((store.find(tev, id2) != nullptr));
+    }
+
+    //------------------------------------------------------------------
+    // A torn tail is dropped and later appends are not lost behind it
+    //------------------------------------------------------------------
+
+    {
+      clrmsg_store_t store(tev, dir);
+      store.add(tev, make_entry("four"));
+      store.flush(tev);
+    }
+    for (int pass = 0; pass < 2; ++pass) {
+      clrmsg_store_t store(tev, dir);
+      SST_TEST_BOOL((store.entries().size() == 3u + pass));
+      if (pass == 0) {
+        store.add(tev, make_entry("five"));
+        store.flush(tev);
+        std::string const log = current_log();
+        SST_TEST_BOOL((!log.empty()));
+        std::string const garbage("\x20\x00\x00\x00garbage", 11);
+        std::ofstream(log, std::ios::binary | std::ios::app)
+            << garbage;
+      }
+    }
+
+    //------------------------------------------------------------------
+    // Compaction keeps every live entry
+    //------------------------------------------------------------------
+
+    {
+      clrmsg_store_t store(tev, dir);
+      std::string const big(4096, 'x');
+      for (int i = 0; i < 600; ++i) {
+        std::uint64_t const id = store.add(tev, make_entry(big)).id();
+        store.flush(tev);
+        store.erase(tev, id);
+      }
+      store.flush(tev);
+      SST_TEST_BOOL((store.entries().size() == 4));
+      store.compact(tev);
+      store.add(tev, make_entry("six"));
+      store.flush(tev);
+    }
+    {
+      clrmsg_store_t store(tev, dir);
+      SST_TEST_BOOL((store.entries().size() == 5));
+      SST_TEST_BOOL((store.find(tev, id2)->clrmsg()
+                     == make_clrmsg("two")));
+    }
+
+    //------------------------------------------------------------------
+    // A failed append does not hide later flushes from replay
+    //------------------------------------------------------------------
+    //
+    // Capping the file size makes the next append write only part of
+    // its record and then fail, as a full disk would.
+    //
+
+    std::size_t n;
+    {
+      clrmsg_store_t store(tev, dir);
+      n = store.entries().size();
+      std::string const log = current_log();
+      SST_TEST_BOOL((!log.empty()));
+      std::streamoff const size = file_size(log);
+
+      std::signal(SIGXFSZ, SIG_IGN);
+      struct rlimit old_limit;
+      SST_TEST_BOOL((getrlimit(RLIMIT_FSIZE, &old_limit) == 0));
+      struct rlimit limit = old_limit;
+      limit.rlim_cur = static_cast<rlim_t>(size) + 16;
+      SST_TEST_BOOL((setrlimit(RLIMIT_FSIZE, &limit) == 0));
+      store.add(tev, make_entry(std::string(4096, 'y')));
+      SST_TEST_THROW((store.flush(tev)), std::exception);
+      SST_TEST_BOOL((setrlimit(RLIMIT_FSIZE, &old_limit) == 0));
+      SST_TEST_BOOL((file_size(log) > size));
+
+      store.add(tev, make_entry("seven"));
+      store.flush(tev);
+      store.add(tev, make_entry("eight"));
+      store.flush(tev);
+    }
+    {
+      clrmsg_store_t store(tev, dir);
+      SST_TEST_BOOL((store.entries().size() == n + 3));
+    }
+
+    //------------------------------------------------------------------
+    // add() refuses entries past max_bytes
+    //------------------------------------------------------------------
+
+    {
+      clrmsg_store_t store(tev, dir);
+      std::size_t const base = store.bytes();
+      std::size_t const size =
+          make_clrmsg("small").to_bytes_size<std::size_t>();
+      store.set_max_bytes(base + 2 * size);
+      std::uint64_t const id = store.add(tev, make_entry("small")).id();
+      store.add(tev, make_entry("small"));
+      SST_TEST_BOOL((store.bytes() == base + 2 * size));
+      SST_TEST_THROW((store.add(tev, make_entry("small"))),
+                     std::exception);
+      SST_TEST_BOOL((store.entries().size() == n + 5));
+      SST_TEST_BOOL((store.erase(tev, id)));
+      SST_TEST_BOOL((store.bytes() == base + size));
+      store.add(tev, make_entry("small"));
+      store.flush(tev);
+    }
+    {
+      clrmsg_store_t store(tev, dir);
+      SST_TEST_BOOL((store.entries().size() == n + 5));
+    }
+
+    //------------------------------------------------------------------
+
+    sst::rm_f_r(dir);
+  });
+}
@@ -0,0 +1,161 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/mix_batcher_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/mix_batcher_t.hpp>
+//
+
+#include <stdexcept>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/SST_TEST_THROW.hpp>
+#include <sst/catalog/test_main.hpp>
+
+using kestrel::carma::mix_batch_t;
+using kestrel::carma::mix_batcher_t;
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    using batcher_t = mix_batcher_t<int, long>;
+
+    //------------------------------------------------------------------
+    // Packets come out oldest first, not in key order
+    //------------------------------------------------------------------
+
+    {
+      batcher_t b(4, 0, 1);
+      SST_TEST_THROW((b.oldest()), std::logic_error);
+      b.add(9, 10);
+      b.add(1, 30);
+      b.add(5, 20);
+      b.add(3, 20);
+      SST_TEST_BOOL((b.oldest() == 9));
+      b.remove(9);
+      SST_TEST_BOOL((b.oldest() == 5));
+      b.remove(5);
+      SST_TEST_BOOL((b.oldest() == 3));
+      b.remove(3);
+      SST_TEST_BOOL((b.oldest() == 1));
+    }
+
+    //------------------------------------------------------------------
+    // A batch closes as soon as mixsize packets are waiting
+    //------------------------------------------------------------------
+
+    {
+      batcher_t b(4, 0, 1);
+      for (int i = 0; i != 3; ++i) {
+        b.add(i, i);
+        SST_TEST_BOOL((b.next(1000000).real == 0));
+      }
+      b.add(3, 3);
+      mix_batch_t const x = b.next(3);
+      SST_TEST_BOOL((x.real == 4 && x.dummies == 0));
+    }
+
+    //------------------------------------------------------------------
+    // Several full batches are due before a partial one
+    //------------------------------------------------------------------
+
+    {
+      batcher_t b(3, 100, 1);
+      for (int i = 0; i != 7; ++i) {
+        b.add(i, 0);
+      }
+      mix_batch_t x = b.next(0);
+      SST_TEST_BOOL((x.real == 3 && x.dummies == 0));
+      b.remove(0);
+      b.remove(1);
+      b.remove(2);
+      x = b.next(0);
+      SST_TEST_BOOL((x.real == 3 && x.dummies == 0));
+      b.remove(3);
+      b.remove(4);
+      b.remove(5);
+      SST_TEST_BOOL((b.next(99).real == 0));
+      x = b.next(100);
+      SST_TEST_BOOL((x.real == 1 && x.dummies == 2));
+    }
+
+    //------------------------------------------------------------------
+    // A partial batch closes at the deadline of its oldest packet
+    //------------------------------------------------------------------
+
+    {
+      batcher_t b(8, 100, 1);
+      b.add(5, 10);
+      b.add(1, 40);
+      b.add(9, 70);
+      SST_TEST_BOOL((b.next(109).real == 0));
+      mix_batch_t x = b.next(110);
+      SST_TEST_BOOL((x.real == 3 && x.dummies == 5));
+
+      // Removing the oldest moves the deadline to the next oldest.
+      b.remove(5);
+      SST_TEST_BOOL((b.next(139).real == 0));
+      x = b.next(140);
+      SST_TEST_BOOL((x.real == 2 && x.dummies == 6));
+
+      // Adding a key again keeps its first arrival time.
+      b.add(1, 1000);
+      SST_TEST_BOOL((b.size() == 2));
+      SST_TEST_BOOL((b.next(140).real == 2));
+    }
+
+    //------------------------------------------------------------------
+    // A partial batch needs min_fill packets
+    //------------------------------------------------------------------
+
+    {
+      batcher_t b(8, 100, 3);
+      b.add(1, 0);
+      b.add(2, 0);
+      SST_TEST_BOOL((b.next(1000).real == 0));
+      b.add(3, 500);
+      mix_batch_t const x = b.next(1000);
+      SST_TEST_BOOL((x.real == 3 && x.dummies == 5));
+    }
+
+    //------------------------------------------------------------------
+    // Without a max latency, partial batches never close
+    //------------------------------------------------------------------
+
+    {
+      batcher_t b(8, 0, 1);
+      b.add(1, 0);
+      SST_TEST_BOOL((b.next(1000000000).real == 0));
+      b.remove(1);
+      b.remove(1);
+      SST_TEST_BOOL((b.empty()));
+    }
+
+    //------------------------------------------------------------------
+    // Bad settings are rejected
+    //------------------------------------------------------------------
+
+    SST_TEST_THROW((batcher_t(0, 0, 1)), std::invalid_argument);
+    SST_TEST_THROW((batcher_t(4, 0, 0)), std::invalid_argument);
+    SST_TEST_THROW((batcher_t(4, 0, 5)), std::invalid_argument);
+
+    //------------------------------------------------------------------
+  });
+}
@@ -0,0 +1,172 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/mix_executor_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/mix_executor_t.hpp>
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/SST_TEST_THROW.hpp>
+#include <sst/catalog/test_main.hpp>
+
+using kestrel::carma::mix_executor_t;
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    //------------------------------------------------------------------
+    // Posted jobs run on the pool threads
+    //------------------------------------------------------------------
+
+    {
+      mix_executor_t ex;
+      ex.start(3);
+      SST_TEST_BOOL((ex.size() == 3));
+      std::size_t const n = 100;
+      std::atomic<std::size_t> count{0};
+      std::promise<void> all_done;
+      auto const caller = std::this_thread::get_id();
+      std::atomic<bool> on_caller{false};
+      for (std::size_t i = 0; i != n; ++i) {
+        ex.post([&]() {
+          if (std::this_thread::get_id() == caller) {
+            on_caller = true;
+          }
+          if (++count == n) {
+            all_done.set_value();
+          }
+        });
+      }
+      all_done.get_future().wait();
+      SST_TEST_BOOL((count == n));
+      SST_TEST_BOOL((!on_caller));
+    }
+
+    //------------------------------------------------------------------
+    // parallel_for calls f once per index
+    //------------------------------------------------------------------
+
+    for (unsigned int const threads : {0U, 1U, 4U}) {
+      mix_executor_t ex;
+      ex.start(threads);
+      for (std::size_t const n : {0U, 1U, 2U, 7U, 1000U}) {
+        std::vector<std::atomic<int>> calls(n);
+        ex.parallel_for(n, [&](std::size_t const i) { ++calls[i]; });
+        bool ok = true;
+        for (auto const & c : calls) {
+          ok = ok && c == 1;
+        }
+        SST_TEST_BOOL((ok));
+      }
+    }
+
+    //------------------------------------------------------------------
+    // parallel_for rethrows after every call has finished
+    //------------------------------------------------------------------
+
+    for (unsigned int const threads : {0U, 4U}) {
+      mix_executor_t ex;
+      ex.start(threads);
+      std::size_t const n = 64;
+      std::atomic<std::size_t> finished{0};
+      bool threw = false;
+      try {
+        ex.parallel_for(n, [&](std::size_t const i) {
+          if (i % 8 == 3) {
+            ++finished;
+            throw std::runtime_error("boom");
+          }
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+          ++finished;
+        });
+      } catch (std::runtime_error const &) {
+        threw = true;
+        SST_TEST_BOOL((finished == n));
+      }
+      SST_TEST_BOOL((threw));
+    }
+
+    //------------------------------------------------------------------
+    // stop discards queued jobs but lets running ones finish
+    //------------------------------------------------------------------
+
+    {
+      mix_executor_t ex;
+      ex.start(1);
+      std::promise<void> started;
+      std::promise<void> release;
+      auto released = release.get_future().share();
+      std::atomic<bool> blocker_done{false};
+      ex.post([&]() {
+        started.set_value();
+        released.wait();
+        blocker_done = true;
+      });
+      started.get_future().wait();
+      std::atomic<int> queued_ran{0};
+      for (int i = 0; i != 10; ++i) {
+        ex.post([&]() { ++queued_ran; });
+      }
+      std::thread releaser([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        release.set_value();
+      });
+      ex.stop();
+      releaser.join();
+      SST_TEST_BOOL((blocker_done));
+      SST_TEST_BOOL((queued_ran == 0));
+      SST_TEST_BOOL((ex.size() == 0));
+      SST_TEST_THROW((ex.post([]() {})), std::logic_error);
+    }
+
+    //------------------------------------------------------------------
+    // With zero threads, nothing runs off the calling thread
+    //------------------------------------------------------------------
+
+    {
+      mix_executor_t ex;
+      ex.start(0);
+      SST_TEST_BOOL((ex.size() == 0));
+      SST_TEST_THROW((ex.post([]() {})), std::logic_error);
+      auto const caller = std::this_thread::get_id();
+      std::vector<std::thread::id> ids(16);
+      ex.parallel_for(ids.size(), [&](std::size_t const i) {
+        ids[i] = std::this_thread::get_id();
+      });
+      bool inline_only = true;
+      for (auto const & id : ids) {
+        inline_only = inline_only && id == caller;
+      }
+      SST_TEST_BOOL((inline_only));
+    }
+
+    //------------------------------------------------------------------
+  });
+}
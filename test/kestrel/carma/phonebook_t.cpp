@@ -0,0 +1,209 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/carma/phonebook_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/carma/phonebook_t.hpp>
+//
+
+#include <atomic>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/SST_TEV_DEF.hpp>
+#include <sst/catalog/rm_f_r.hpp>
+#include <sst/catalog/test_main.hpp>
+
+#include <kestrel/carma/config_t.hpp>
+#include <kestrel/carma/node_count_t.hpp>
+#include <kestrel/carma/phonebook_entry_t.hpp>
+#include <kestrel/carma/phonebook_pair_t.hpp>
+#include <kestrel/carma/role_t.hpp>
+#include <kestrel/psn_t.hpp>
+#include <kestrel/tracing_event_t.hpp>
+
+using namespace kestrel;
+using namespace kestrel::carma;
+
+namespace {
+
+std::string const dir = "phonebook_t.tmp";
+
+std::vector<std::string> const names = {"a", "b", "c", "d", "e"};
+
+psn_t psn(std::string const & name) {
+  return psn_t(name);
+}
+
+node_count_t group_of(std::string const & name) {
+  return static_cast<node_count_t>((name[0] - 'a') % 2);
+}
+
+bool resident(phonebook_t const & pb, std::string const & name) {
+  return std::atomic_load(&pb.expect(psn(name)).second) != nullptr;
+}
+
+std::set<psn_t> psns(std::vector<phonebook_pair_t const *> const & v) {
+  std::set<psn_t> xs;
+  for (phonebook_pair_t const * const p : v) {
+    xs.insert(p->first);
+  }
+  return xs;
+}
+
+std::set<psn_t> psns(std::vector<std::string> const & v) {
+  std::set<psn_t> xs;
+  for (auto const & name : v) {
+    xs.insert(psn(name));
+  }
+  return xs;
+}
+
+} // namespace
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    tracing_event_t SST_TEV_DEF(tev);
+
+    sst::rm_f_r(dir);
+
+    {
+      config_t config(tev, dir);
+      phonebook_t & pb = config.phonebook();
+      for (auto const & name : names) {
+        phonebook_entry_t entry(psn(name));
+        entry.set_role(role_t::rs_server());
+        entry.set_group(group_of(name));
+        entry.pk(std::vector<unsigned char>(32, name[0]));
+        pb.add_fast(tev, std::move(entry));
+      }
+
+      //----------------------------------------------------------------
+      // Entries added since the last flush are never unloaded
+      //----------------------------------------------------------------
+
+      pb.set_max_resident(2);
+      for (auto const & name : names) {
+        SST_TEST_BOOL((resident(pb, name)));
+      }
+
+      //----------------------------------------------------------------
+      // Once flushed, the least recently used entries are unloaded
+      //----------------------------------------------------------------
+
+      pb.set_max_resident(names.size());
+      pb.flush(tev);
+      for (auto const & name : names) {
+        pb.at(tev, psn(name));
+      }
+      pb.set_max_resident(3);
+      SST_TEST_BOOL((!resident(pb, "a")));
+      SST_TEST_BOOL((!resident(pb, "b")));
+      SST_TEST_BOOL((resident(pb, "c")));
+      SST_TEST_BOOL((resident(pb, "d")));
+      SST_TEST_BOOL((resident(pb, "e")));
+
+      //----------------------------------------------------------------
+      // An unloaded entry is reloaded intact and becomes most recent
+      //----------------------------------------------------------------
+
+      {
+        std::shared_ptr<phonebook_entry_t const> const p =
+            pb.at(tev, psn("a"));
+        SST_TEST_BOOL((p->psn() == psn("a")));
+        SST_TEST_BOOL((p->role() == role_t::rs_server()));
+        SST_TEST_BOOL((p->group() == group_of("a")));
+        SST_TEST_BOOL((p->pk() == std::vector<unsigned char>(32, 'a')));
+        SST_TEST_BOOL((resident(pb, "a")));
+        SST_TEST_BOOL((!resident(pb, "c")));
+        SST_TEST_BOOL((resident(pb, "d")));
+        SST_TEST_BOOL((resident(pb, "e")));
+      }
+
+      //----------------------------------------------------------------
+      // Entries referenced from outside the phonebook are skipped
+      //----------------------------------------------------------------
+
+      {
+        std::shared_ptr<phonebook_entry_t const> const held =
+            pb.at(tev, psn("e"));
+        pb.set_max_resident(1);
+        SST_TEST_BOOL((resident(pb, "e")));
+        SST_TEST_BOOL((!resident(pb, "a")));
+        SST_TEST_BOOL((!resident(pb, "d")));
+      }
+
+      //----------------------------------------------------------------
+      // The index answers queries without loading anything
+      //----------------------------------------------------------------
+
+      SST_TEST_BOOL((psns(pb.in_mc_group(tev, 0))
+                     == psns({"a", "c", "e"})));
+      SST_TEST_BOOL((psns(pb.in_mc_group(tev, 1)) == psns({"b", "d"})));
+      SST_TEST_BOOL((psns(pb.with_role(tev, role_t::rs_server()))
+                     == psns(names)));
+      SST_TEST_BOOL((!resident(pb, "a")));
+
+      pb.flush(tev);
+    }
+
+    //------------------------------------------------------------------
+    // The index survives a reopen
+    //------------------------------------------------------------------
+
+    {
+      config_t config(tev, dir);
+      phonebook_t & pb = config.phonebook();
+      pb.set_max_resident(1);
+      for (auto const & name : names) {
+        SST_TEST_BOOL((pb.role_of(tev, pb.expect(psn(name)))
+                       == role_t::rs_server()));
+        SST_TEST_BOOL((!resident(pb, name)));
+      }
+      SST_TEST_BOOL((psns(pb.in_mc_group(tev, 0))
+                     == psns({"a", "c", "e"})));
+      SST_TEST_BOOL((psns(pb.in_mc_group(tev, 1)) == psns({"b", "d"})));
+      SST_TEST_BOOL((pb.at(tev, psn("d"))->group() == group_of("d")));
+    }
+
+    //------------------------------------------------------------------
+    // Without an index, entries are loaded and indexed on first query
+    //------------------------------------------------------------------
+
+    sst::rm_f_r(dir + "/phonebook/index.json");
+
+    {
+      config_t config(tev, dir);
+      phonebook_t & pb = config.phonebook();
+      SST_TEST_BOOL((psns(pb.in_mc_group(tev, 0))
+                     == psns({"a", "c", "e"})));
+      SST_TEST_BOOL((psns(pb.in_mc_group(tev, 1)) == psns({"b", "d"})));
+    }
+
+    sst::rm_f_r(dir);
+
+    //------------------------------------------------------------------
+  });
+}
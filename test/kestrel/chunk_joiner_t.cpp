@@ -0,0 +1,207 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/chunk_joiner_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/chunk_joiner_t.hpp>
+//
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/SST_TEST_THROW.hpp>
+#include <sst/catalog/SST_TEV_DEF.hpp>
+#include <sst/catalog/optional.hpp>
+#include <sst/catalog/rm_f_r.hpp>
+#include <sst/catalog/test_e.hpp>
+#include <sst/catalog/test_main.hpp>
+
+#include <kestrel/bytes_t.hpp>
+#include <kestrel/corruption_t.hpp>
+#include <kestrel/tracing_event_t.hpp>
+
+using kestrel::bytes_t;
+using kestrel::chunk_joiner_t;
+using kestrel::corruption_t;
+using kestrel::tracing_event_t;
+
+namespace {
+
+std::string const dir = "chunk_joiner_t.tmp";
+
+chunk_joiner_t::time_ns_t const second = 1000000000;
+
+bytes_t make_message(std::size_t const size) {
+  bytes_t x(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    x[i] = static_cast<unsigned char>(i * 7 + 1);
+  }
+  return x;
+}
+
+bytes_t chunk_of(bytes_t const & msg,
+                 std::size_t const chunk_size,
+                 std::size_t const index) {
+  auto const begin = msg.begin() + index * chunk_size;
+  auto const end =
+      msg.size() - index * chunk_size <= chunk_size ?
+          msg.end() :
+          begin + chunk_size;
+  return bytes_t(begin, end);
+}
+
+} // namespace
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    tracing_event_t SST_TEV_DEF(tev);
+
+    bytes_t const a = {'a'};
+    bytes_t const b = {'b'};
+    bytes_t const c = {'c'};
+
+    //------------------------------------------------------------------
+    // Chunks join in index order whatever order they arrive in
+    //------------------------------------------------------------------
+
+    {
+      chunk_joiner_t j(tev, dir);
+      bytes_t const msg = make_message(1000);
+      std::size_t const orders[][4] = {{0, 1, 2, 3},
+                                       {3, 2, 1, 0},
+                                       {3, 0, 2, 1},
+                                       {1, 3, 0, 2}};
+      for (auto const & order : orders) {
+        sst::optional<bytes_t> x;
+        for (std::size_t k = 0; k < 4; ++k) {
+          SST_TEST_BOOL((!x));
+          x = j.add(tev, a, order[k], 4, chunk_of(msg, 300, order[k]));
+        }
+        SST_TEST_BOOL((x && *x == msg));
+      }
+      SST_TEST_BOOL((j.add(tev, b, 0, 1, a) == a));
+      SST_TEST_BOOL((j.stats().completed == 5));
+      SST_TEST_BOOL((j.stats().groups == 0));
+      SST_TEST_BOOL((j.stats().bytes == 0));
+    }
+
+    //------------------------------------------------------------------
+    // Duplicates must match and chunks must fit the group
+    //------------------------------------------------------------------
+
+    {
+      chunk_joiner_t j(tev, dir);
+      bytes_t const msg = make_message(25);
+      SST_TEST_BOOL((!j.add(tev, a, 2, 3, chunk_of(msg, 10, 2))));
+      SST_TEST_BOOL((!j.add(tev, a, 2, 3, chunk_of(msg, 10, 2))));
+      SST_TEST_THROW((j.add(tev, a, 2, 3, chunk_of(msg, 10, 1))),
+                     corruption_t);
+      SST_TEST_BOOL((!j.add(tev, a, 0, 3, chunk_of(msg, 10, 0))));
+      SST_TEST_BOOL((!j.add(tev, a, 0, 3, chunk_of(msg, 10, 0))));
+      SST_TEST_THROW((j.add(tev, a, 0, 3, chunk_of(msg, 10, 1))),
+                     corruption_t);
+      SST_TEST_THROW((j.add(tev, a, 1, 3, bytes_t(9))), corruption_t);
+      SST_TEST_THROW((j.add(tev, a, 1, 4, chunk_of(msg, 10, 1))),
+                     corruption_t);
+      SST_TEST_THROW((j.add(tev, a, 3, 3, a)), corruption_t);
+      SST_TEST_BOOL((j.add(tev, a, 1, 3, chunk_of(msg, 10, 1)) == msg));
+
+      SST_TEST_BOOL((!j.add(tev, b, 1, 2, bytes_t(11))));
+      SST_TEST_THROW((j.add(tev, b, 0, 2, bytes_t(10))), corruption_t);
+    }
+
+    //------------------------------------------------------------------
+    // Groups expire once they go too long without a new chunk
+    //------------------------------------------------------------------
+
+    {
+      chunk_joiner_t j(tev, dir);
+      j.configure(10 * second, 1 << 20, 0);
+      SST_TEST_BOOL((!j.add(tev, a, 0, 3, a, 0)));
+      SST_TEST_BOOL((!j.add(tev, b, 0, 2, b, 5 * second)));
+      SST_TEST_BOOL((!j.add(tev, a, 1, 3, a, 9 * second)));
+      j.expire(tev, 17 * second);
+      SST_TEST_BOOL((j.stats().groups == 1));
+      SST_TEST_BOOL((j.stats().expired == 1));
+      SST_TEST_BOOL(
+          (j.add(tev, a, 2, 3, a, 18 * second) == bytes_t(3, 'a')));
+      SST_TEST_BOOL((!j.add(tev, b, 1, 2, b, 18 * second)));
+      SST_TEST_BOOL((j.stats().groups == 1));
+    }
+
+    //------------------------------------------------------------------
+    // The least recently updated groups are evicted to fit the budget
+    //------------------------------------------------------------------
+
+    {
+      chunk_joiner_t j(tev, dir);
+      j.configure(10 * second, 1000, 0);
+      bytes_t const chunk(100);
+      SST_TEST_BOOL((!j.add(tev, a, 0, 4, chunk, 0)));
+      SST_TEST_BOOL((!j.add(tev, b, 0, 4, chunk, 0)));
+      SST_TEST_BOOL((!j.add(tev, a, 1, 4, chunk, 0)));
+      SST_TEST_BOOL((j.stats().bytes <= 1000));
+      SST_TEST_BOOL((!j.add(tev, c, 0, 4, chunk, 0)));
+      SST_TEST_BOOL((j.stats().evicted == 1));
+      SST_TEST_BOOL((j.stats().groups == 2));
+      SST_TEST_BOOL((!j.add(tev, a, 2, 4, chunk, 0)));
+      SST_TEST_BOOL((j.add(tev, a, 3, 4, chunk, 0) == bytes_t(400)));
+      SST_TEST_BOOL((!j.add(tev, b, 1, 4, chunk, 0)));
+      SST_TEST_BOOL((!j.add(tev, a, 0, 11, chunk, 0)));
+      SST_TEST_BOOL((j.stats().refused == 1));
+      SST_TEST_BOOL((j.stats().bytes <= 1000));
+    }
+
+    //------------------------------------------------------------------
+    // Large groups are spilled to storage until they are complete
+    //------------------------------------------------------------------
+
+    {
+      chunk_joiner_t j(tev, dir);
+      j.configure(10 * second, 1000, 500);
+      bytes_t const msg = make_message(5000);
+      sst::optional<bytes_t> x;
+      for (std::size_t i = 10; i-- > 0;) {
+        SST_TEST_BOOL((!x));
+        x = j.add(tev, a, i, 10, chunk_of(msg, 512, i), 0);
+        SST_TEST_BOOL((j.stats().bytes <= 1000));
+      }
+      SST_TEST_BOOL((x && *x == msg));
+      SST_TEST_BOOL((j.stats().spilled == 1));
+      SST_TEST_BOOL((j.stats().groups == 0));
+
+      SST_TEST_BOOL((!j.add(tev, b, 0, 2, bytes_t(600), 0)));
+      SST_TEST_BOOL((sst::test_e(dir)));
+      j.expire(tev, 10 * second);
+      SST_TEST_BOOL((j.stats().expired == 1));
+    }
+    {
+      chunk_joiner_t j(tev, dir);
+      SST_TEST_BOOL((!sst::test_e(dir)));
+    }
+
+    //------------------------------------------------------------------
+
+    sst::rm_f_r(dir);
+  });
+}
@@ -0,0 +1,54 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/crc32c.hpp>
+// Include twice to test idempotence.
+#include <kestrel/crc32c.hpp>
+//
+
+#include <cstdint>
+#include <string>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/test_main.hpp>
+
+using kestrel::crc32c;
+
+namespace {
+
+std::uint32_t crc(std::string const & s, std::uint32_t const x = 0) {
+  return crc32c(reinterpret_cast<unsigned char const *>(s.data()),
+                s.size(),
+                x);
+}
+
+} // namespace
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    SST_TEST_BOOL((crc("") == 0));
+    SST_TEST_BOOL((crc("123456789") == UINT32_C(0xE3069283)));
+    SST_TEST_BOOL((crc(std::string(32, '\0')) == UINT32_C(0x8A9136AA)));
+    SST_TEST_BOOL((crc("56789", crc("1234")) == crc("123456789")));
+
+    ;
+  });
+}
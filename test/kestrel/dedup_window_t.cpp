@@ -0,0 +1,113 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/dedup_window_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/dedup_window_t.hpp>
+//
+
+#include <string>
+#include <vector>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/test_main.hpp>
+
+using kestrel::dedup_window_t;
+using std::vector;
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    using key_t = vector<unsigned char>;
+
+    //------------------------------------------------------------------
+    // Keys are remembered for at least one window and at most two
+    //------------------------------------------------------------------
+
+    {
+      dedup_window_t<key_t> w(100, 1000);
+      SST_TEST_BOOL((!w.test_and_insert({1}, 0)));
+      SST_TEST_BOOL((w.test_and_insert({1}, 50)));
+      SST_TEST_BOOL((!w.test_and_insert({2}, 99)));
+      SST_TEST_BOOL((w.contains({1}, 150)));
+      SST_TEST_BOOL((w.contains({2}, 198)));
+      SST_TEST_BOOL((!w.contains({1}, 250)));
+      SST_TEST_BOOL((!w.contains({2}, 250)));
+      auto const s = w.stats();
+      SST_TEST_BOOL((s.inserts == 2 && s.evicted == 2 && s.size == 0));
+      SST_TEST_BOOL((s.hits == 3));
+    }
+
+    //------------------------------------------------------------------
+    // A long idle gap forgets everything
+    //------------------------------------------------------------------
+
+    {
+      dedup_window_t<key_t> w(100, 1000);
+      w.insert({1}, true, 0);
+      w.insert({2}, true, 10);
+      SST_TEST_BOOL((!w.contains({1}, 1000)));
+      SST_TEST_BOOL((!w.contains({2}, 1000)));
+    }
+
+    //------------------------------------------------------------------
+    // Refreshing a key from the previous generation extends it
+    //------------------------------------------------------------------
+
+    {
+      dedup_window_t<key_t> w(100, 1000);
+      w.insert({1}, true, 0);
+      SST_TEST_BOOL((w.contains({1}, 120)));
+      w.insert({1}, true, 120);
+      SST_TEST_BOOL((w.contains({1}, 220)));
+    }
+
+    //------------------------------------------------------------------
+    // Size cap
+    //------------------------------------------------------------------
+
+    {
+      dedup_window_t<key_t> w(1000000, 8);
+      for (unsigned char i = 0; i < 100; ++i) {
+        w.insert({i}, true, 0);
+        SST_TEST_BOOL((w.stats().size <= 8));
+      }
+      SST_TEST_BOOL((w.contains({99}, 0)));
+      SST_TEST_BOOL((!w.contains({0}, 0)));
+      SST_TEST_BOOL((w.stats().early_rotations > 0));
+    }
+
+    //------------------------------------------------------------------
+    // Values can be updated in place
+    //------------------------------------------------------------------
+
+    {
+      dedup_window_t<key_t, std::string> w(100, 1000);
+      w.insert({7}, "a", 0);
+      std::string * const p = w.find({7}, 10);
+      SST_TEST_BOOL((p != nullptr && *p == "a"));
+      *p = "b";
+      SST_TEST_BOOL((*w.find({7}, 20) == "b"));
+      SST_TEST_BOOL((w.find({8}, 20) == nullptr));
+    }
+
+    //------------------------------------------------------------------
+  });
+}
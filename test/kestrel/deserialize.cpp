@@ -91,6 +91,46 @@ int main() {
       return a == "ab" && b == std::vector<unsigned char>{10, 11, 12};
     }()));
 
+    SST_TEST_BOOL(([] {
+      std::vector<unsigned char> const src{3, 10, 11, 12, 1, 'a'};
+      std::vector<unsigned char>::size_type idx = 0U;
+      bytes_view_t a{};
+      std::string b{};
+      deserialize(src, idx, a, b);
+      return a.data() == src.data() + 1 && a.size() == 3
+             && a.to_bytes() == std::vector<unsigned char>{10, 11, 12}
+             && b == "a" && idx == src.size();
+    }()));
+
+    SST_TEST_BOOL(([] {
+      std::vector<unsigned char> const src{4, 7, 2, 'x', 'y'};
+      std::vector<unsigned char>::size_type idx = 0U;
+      bytes_view_t outer{};
+      deserialize(src, idx, outer);
+      std::vector<unsigned char>::size_type outer_i = 0U;
+      int a{};
+      bytes_view_t b{};
+      deserialize_view(outer, outer_i, a, b);
+      return a == 7 && b.size() == 2 && b[0] == 'x'
+             && outer_i == outer.size();
+    }()));
+
+    SST_TEST_THROW(
+        ([] {
+          std::vector<unsigned char> const src{9, 1};
+          std::vector<unsigned char>::size_type idx = 0U;
+          bytes_view_t a{};
+          deserialize(src, idx, a);
+        }()),
+        std::runtime_error);
+
+    SST_TEST_BOOL(([] {
+      std::vector<unsigned char> const src{10, 11, 12};
+      std::vector<unsigned char> dst;
+      serialize(dst, bytes_view_t(src).subview(1, 2));
+      return dst == std::vector<unsigned char>{2, 11, 12};
+    }()));
+
     ;
   });
 }
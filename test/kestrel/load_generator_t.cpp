@@ -0,0 +1,178 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/load_generator_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/load_generator_t.hpp>
+//
+
+#include <cstdint>
+#include <set>
+#include <string>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/SST_TEST_THROW.hpp>
+#include <sst/catalog/json/exception.hpp>
+#include <sst/catalog/test_main.hpp>
+
+#include <kestrel/json_t.hpp>
+#include <kestrel/load_spec_t.hpp>
+
+using kestrel::json_t;
+using kestrel::load_generator_t;
+using kestrel::load_spec_t;
+
+namespace {
+
+// One second of load starting at t = 1000s, after a one second warmup.
+load_spec_t make_spec(json_t src) {
+  src["dawn"] = "1000000000000";
+  src["warmup"] = "1000000000";
+  src["duration"] = "1000000000";
+  return src.get<load_spec_t>();
+}
+
+} // namespace
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    //------------------------------------------------------------------
+    // Constant arrivals are evenly spaced and stop at the window end
+    //------------------------------------------------------------------
+
+    {
+      load_generator_t g(
+          make_spec({{"arrival", "constant"}, {"rate", 1000}}),
+          1);
+      g.start(0);
+      load_generator_t::arrival_t a;
+      long n = 0;
+      auto previous = g.spec().dawn() - 1000000;
+      while (g.next(a)) {
+        SST_TEST_BOOL((a.count == 1));
+        SST_TEST_BOOL((a.time - previous == 1000000));
+        previous = a.time;
+        ++n;
+      }
+      SST_TEST_BOOL((n == 2000));
+      SST_TEST_BOOL((g.drain_until()
+                     == g.spec().dawn() + 2000000000
+                            + g.spec().drain()));
+    }
+
+    //------------------------------------------------------------------
+    // Bursts carry burst_size messages at the same average rate
+    //------------------------------------------------------------------
+
+    {
+      load_generator_t g(make_spec({{"arrival", "burst"},
+                                    {"rate", 1000},
+                                    {"burst_size", "50"}}),
+                         1);
+      g.start(0);
+      load_generator_t::arrival_t a;
+      long n = 0;
+      long messages = 0;
+      while (g.next(a)) {
+        SST_TEST_BOOL((a.count == 50));
+        messages += a.count;
+        ++n;
+      }
+      SST_TEST_BOOL((n == 40));
+      SST_TEST_BOOL((messages == 2000));
+    }
+
+    //------------------------------------------------------------------
+    // Poisson arrivals have the right mean rate
+    //------------------------------------------------------------------
+
+    {
+      load_generator_t g(
+          make_spec({{"arrival", "poisson"}, {"rate", 10000}}),
+          1);
+      g.start(0);
+      load_generator_t::arrival_t a;
+      long n = 0;
+      while (g.next(a)) {
+        ++n;
+      }
+      SST_TEST_BOOL((n > 19000 && n < 21000));
+    }
+
+    //------------------------------------------------------------------
+    // Messages are tagged, unique, and within the size bounds
+    //------------------------------------------------------------------
+
+    {
+      std::string const tag = load_generator_t::tag();
+      for (char const * const d : {"uniform", "exponential"}) {
+        load_generator_t g(make_spec({{"size_distribution", d},
+                                      {"size_min", "32"},
+                                      {"size_max", "256"},
+                                      {"size_mean", "100"}}),
+                           1);
+        std::set<std::string> seen;
+        for (int i = 0; i < 1000; ++i) {
+          std::string const msg = g.make_message();
+          SST_TEST_BOOL((msg.compare(0, tag.size(), tag) == 0));
+          SST_TEST_BOOL((msg.size() >= 32 && msg.size() <= 256));
+          SST_TEST_BOOL((seen.insert(msg.substr(0, 24)).second));
+        }
+      }
+    }
+
+    //------------------------------------------------------------------
+    // Only load messages sent inside the window are counted
+    //------------------------------------------------------------------
+
+    {
+      load_generator_t g(make_spec({{"rate", 1}}), 1);
+      g.start(0);
+      std::uint64_t const begin_us = 1001000000;
+      std::string const msg = g.make_message();
+      SST_TEST_BOOL((!g.on_recv("hello", begin_us, begin_us + 5)));
+      SST_TEST_BOOL((g.on_recv(msg, begin_us - 1, begin_us + 5)));
+      SST_TEST_BOOL((g.on_recv(msg, begin_us + 1000000, begin_us + 5)));
+      SST_TEST_BOOL((g.on_recv(msg, begin_us, begin_us + 5000)));
+      SST_TEST_BOOL((g.on_recv(msg, begin_us + 10, begin_us + 3010)));
+      json_t const report = g.report();
+      SST_TEST_BOOL((report["received"] == 2));
+      SST_TEST_BOOL((report["received_bytes"] == 2 * msg.size()));
+      SST_TEST_BOOL((report["latency_us"]["max"] == 5000));
+    }
+
+    //------------------------------------------------------------------
+    // Bad specs are rejected
+    //------------------------------------------------------------------
+
+    {
+      SST_TEST_THROW((make_spec({{"arrival", "bursty"}})),
+                     sst::json::exception);
+      SST_TEST_THROW((make_spec({{"rate", 0}})),
+                     sst::json::exception);
+      SST_TEST_THROW(
+          (make_spec({{"size_min", "10"}, {"size_max", "9"}})),
+          sst::json::exception);
+    }
+
+    //------------------------------------------------------------------
+  });
+}
@@ -0,0 +1,112 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/log_sink_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/log_sink_t.hpp>
+//
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/test_main.hpp>
+
+#include <RaceLog.h>
+
+using kestrel::log_sink_t;
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    auto & sink = log_sink_t::instance();
+
+    //------------------------------------------------------------------
+    // Every record is either written or dropped
+    //------------------------------------------------------------------
+
+    {
+      sink.async(4);
+      auto const before = sink.stats();
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&sink, t] {
+          for (int i = 0; i < 100; ++i) {
+            sink.write(RaceLog::LL_DEBUG,
+                       "log_sink_t",
+                       "message " + std::to_string(t * 100 + i),
+                       "");
+          }
+        });
+      }
+      for (auto & thread : threads) {
+        thread.join();
+      }
+      sink.flush();
+      auto const after = sink.stats();
+      SST_TEST_BOOL(
+          (after.written - before.written + after.dropped
+               - before.dropped
+           == 400));
+      SST_TEST_BOOL((after.depth == 0));
+      SST_TEST_BOOL((after.max_depth <= 4));
+    }
+
+    //------------------------------------------------------------------
+    // Errors are never dropped
+    //------------------------------------------------------------------
+
+    {
+      sink.async(1);
+      auto const before = sink.stats();
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&sink] {
+          for (int i = 0; i < 25; ++i) {
+            sink.write(RaceLog::LL_ERROR, "log_sink_t", "error", "");
+          }
+        });
+      }
+      for (auto & thread : threads) {
+        thread.join();
+      }
+      auto const after = sink.stats();
+      SST_TEST_BOOL((after.written - before.written == 100));
+      SST_TEST_BOOL((after.dropped == before.dropped));
+    }
+
+    //------------------------------------------------------------------
+    // Synchronous mode bypasses the ring
+    //------------------------------------------------------------------
+
+    {
+      sink.async(0);
+      auto const before = sink.stats();
+      sink.write(RaceLog::LL_INFO, "log_sink_t", "sync", "");
+      sink.flush();
+      auto const after = sink.stats();
+      SST_TEST_BOOL((after.written == before.written));
+      SST_TEST_BOOL((after.dropped == before.dropped));
+    }
+
+    //------------------------------------------------------------------
+  });
+}
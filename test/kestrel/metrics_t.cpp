@@ -0,0 +1,103 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/metrics_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/metrics_t.hpp>
+//
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/test_main.hpp>
+
+using kestrel::metric_histogram_t;
+using kestrel::metrics_t;
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    //------------------------------------------------------------------
+    // Buckets are contiguous and bound their values
+    //------------------------------------------------------------------
+
+    {
+      using h = metric_histogram_t;
+      SST_TEST_BOOL((h::bucket(0) == 0));
+      SST_TEST_BOOL((h::bucket(h::sub_count) == h::sub_count));
+      SST_TEST_BOOL((h::bucket(UINT64_MAX) == h::bucket_count - 1));
+      for (std::size_t i = 0; i + 1 < h::bucket_count; ++i) {
+        SST_TEST_BOOL((h::bucket(h::bucket_min(i)) == i));
+        SST_TEST_BOOL((h::bucket(h::bucket_min(i + 1) - 1) == i));
+      }
+    }
+
+    //------------------------------------------------------------------
+    // Quantiles are within the relative error
+    //------------------------------------------------------------------
+
+    {
+      metric_histogram_t hist;
+      SST_TEST_BOOL((hist.quantile(0.5) == 0));
+      for (std::uint64_t x = 1; x <= 1000; ++x) {
+        hist.record(x * 1000);
+      }
+      SST_TEST_BOOL((hist.count() == 1000));
+      SST_TEST_BOOL((hist.max() == 1000000));
+      SST_TEST_BOOL((hist.sum() == 500500000));
+      auto const p50 = hist.quantile(0.5);
+      SST_TEST_BOOL((p50 >= 500000 && p50 <= 500000 * 9 / 8));
+      SST_TEST_BOOL((hist.quantile(1) == 1000000));
+    }
+
+    //------------------------------------------------------------------
+    // The registry hands out stable, shared metrics
+    //------------------------------------------------------------------
+
+    {
+      metrics_t metrics;
+      auto & a = metrics.counter("a");
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&metrics] {
+          for (int i = 0; i < 1000; ++i) {
+            metrics.counter("a").add();
+            metrics.histogram("h").record(i);
+          }
+        });
+      }
+      for (auto & thread : threads) {
+        thread.join();
+      }
+      SST_TEST_BOOL((&metrics.counter("a") == &a));
+      SST_TEST_BOOL((a.value() == 4000));
+      metrics.gauge("g").set(-3);
+      auto const json = metrics.to_json();
+      SST_TEST_BOOL((json["counters"]["a"] == 4000));
+      SST_TEST_BOOL((json["gauges"]["g"] == -3));
+      SST_TEST_BOOL((json["histograms"]["h"]["count"] == 4000));
+      SST_TEST_BOOL((json["histograms"]["h"]["max"] == 999));
+    }
+
+    //------------------------------------------------------------------
+  });
+}
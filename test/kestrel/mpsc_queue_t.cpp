@@ -0,0 +1,144 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/mpsc_queue_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/mpsc_queue_t.hpp>
+//
+
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/optional.hpp>
+#include <sst/catalog/test_main.hpp>
+
+using kestrel::mpsc_queue_t;
+using std::size_t;
+using std::vector;
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    //------------------------------------------------------------------
+    // Single producer, including the overflow path
+    //------------------------------------------------------------------
+
+    {
+      mpsc_queue_t<int> q(4);
+      sst::optional<int> x;
+      SST_TEST_BOOL((!q.pop(x)));
+      for (int i = 0; i < 10; ++i) {
+        q.push(i);
+      }
+      SST_TEST_BOOL((q.stats().depth == 10));
+      SST_TEST_BOOL((q.stats().overflowed == 6));
+      q.push(10);
+      bool ok = true;
+      for (int i = 0; i < 11; ++i) {
+        ok = ok && q.pop(x) && *x == i;
+      }
+      SST_TEST_BOOL((ok));
+      SST_TEST_BOOL((!q.pop(x)));
+      auto const s = q.stats();
+      SST_TEST_BOOL((s.pushed == 11 && s.popped == 11 && s.depth == 0));
+      SST_TEST_BOOL((s.max_depth == 11));
+    }
+
+    //------------------------------------------------------------------
+    // Many producers keep their own order
+    //------------------------------------------------------------------
+
+    {
+      constexpr int producers = 4;
+      constexpr int per_producer = 20000;
+      mpsc_queue_t<vector<int>> q(64);
+      vector<std::thread> threads;
+      for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&q, p] {
+          for (int i = 0; i < per_producer; ++i) {
+            q.push({p, i});
+          }
+        });
+      }
+      vector<int> next(producers, 0);
+      bool ok = true;
+      int n = 0;
+      sst::optional<vector<int>> x;
+      while (n < producers * per_producer) {
+        if (q.pop(x)) {
+          auto const p = static_cast<size_t>((*x)[0]);
+          ok = ok && (*x)[1] == next[p];
+          ++next[p];
+          ++n;
+        }
+      }
+      for (auto & t : threads) {
+        t.join();
+      }
+      SST_TEST_BOOL((ok));
+      SST_TEST_BOOL((!q.pop(x)));
+      SST_TEST_BOOL((q.stats().popped == producers * per_producer));
+    }
+
+    //------------------------------------------------------------------
+    // Many producers keep their own order through the overflow deque
+    //------------------------------------------------------------------
+
+    {
+      constexpr int producers = 8;
+      constexpr int per_producer = 20000;
+      mpsc_queue_t<vector<int>> q(2);
+      vector<std::thread> threads;
+      for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&q, p] {
+          for (int i = 0; i < per_producer; ++i) {
+            q.push({p, i});
+          }
+        });
+      }
+      // Give the producers a head start so the ring fills up.
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      vector<int> next(producers, 0);
+      bool ok = true;
+      int n = 0;
+      sst::optional<vector<int>> x;
+      while (n < producers * per_producer) {
+        if (q.pop(x)) {
+          auto const p = static_cast<size_t>((*x)[0]);
+          ok = ok && (*x)[1] == next[p];
+          ++next[p];
+          ++n;
+        }
+      }
+      for (auto & t : threads) {
+        t.join();
+      }
+      SST_TEST_BOOL((ok));
+      SST_TEST_BOOL((!q.pop(x)));
+      SST_TEST_BOOL((q.stats().overflowed > 0));
+      SST_TEST_BOOL((q.stats().popped == producers * per_producer));
+    }
+
+    //------------------------------------------------------------------
+  });
+}
@@ -0,0 +1,203 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/ntt.hpp>
+// Include twice to test idempotence.
+#include <kestrel/ntt.hpp>
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/bignum.hpp>
+#include <sst/catalog/test_main.hpp>
+
+#include <kestrel/graeffe_transform.hpp>
+
+using sst::bignum;
+using std::size_t;
+using std::vector;
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    // 3 * 2^30 + 1
+    bignum const p{3221225473L};
+
+    auto const random_poly = [&](size_t const n) {
+      vector<bignum> f;
+      for (size_t i = 0; i < n; ++i) {
+        f.emplace_back(bignum::rand_range(p));
+      }
+      return f;
+    };
+
+    auto const schoolbook = [&](vector<bignum> const & f,
+                                vector<bignum> const & g) {
+      vector<bignum> x(f.size() + g.size() - 1, bignum::zero());
+      for (size_t i = 0; i < f.size(); ++i) {
+        for (size_t j = 0; j < g.size(); ++j) {
+          x[i + j] = x[i + j].add_mod(f[i].mul_mod(g[j], p), p);
+        }
+      }
+      return x;
+    };
+
+    // One tangent Graeffe step done with schoolbook products, the way
+    // update_linear_expansion() does it below the crossover.
+    auto const graeffe_step = [&](vector<bignum> & h,
+                                  vector<bignum> & hbar) {
+      auto const negate_x = [&](vector<bignum> f) {
+        for (size_t i = 1; i < f.size(); i += 2) {
+          f[i] = (p - f[i]) % p;
+        }
+        return f;
+      };
+      auto const hneg = negate_x(h);
+      auto const hbarneg = negate_x(hbar);
+      auto const a = schoolbook(h, hneg);
+      auto b = schoolbook(h, hbarneg);
+      auto const b2 = schoolbook(hbar, hneg);
+      for (size_t i = 0; i < b2.size(); ++i) {
+        b[i] = b[i].add_mod(b2[i], p);
+      }
+      for (size_t i = 0; i < h.size(); ++i) {
+        h[i] = a[2 * i];
+      }
+      for (size_t i = 0; i < hbar.size(); ++i) {
+        hbar[i] = b[2 * i];
+      }
+    };
+
+    //------------------------------------------------------------------
+
+    SST_TEST_BOOL((ntt_table_t::get(p)->max_log_size() == 30));
+
+    for (size_t const n : {1, 2, 5, 32, 33, 100}) {
+      for (size_t const m : {1, 7, 64, 150}) {
+        auto const f = random_poly(n);
+        auto const g = random_poly(m);
+        vector<bignum> x;
+        SST_TEST_BOOL((ntt_mul(x, f, g, *ntt_table_t::get(p))
+                       && x == schoolbook(f, g)));
+      }
+    }
+
+    {
+      auto const f = random_poly(80);
+      vector<bignum> x;
+      SST_TEST_BOOL((ntt_mul(x, f, f, *ntt_table_t::get(p))
+                     && x == schoolbook(f, f)));
+    }
+
+    //------------------------------------------------------------------
+    // mul() and build_from_roots() above the crossover
+    //------------------------------------------------------------------
+
+    {
+      auto const f = random_poly(ntt_crossover + 10);
+      auto const g = random_poly(3 * ntt_crossover);
+      NumX x{p};
+      mul(x, NumX{p, f}, NumX{p, g});
+      SST_TEST_BOOL((x.rep == schoolbook(f, g)));
+    }
+
+    {
+      auto const roots = random_poly(5 * ntt_crossover);
+      auto const f = build_from_roots(p, roots);
+      bool ok = f.rep.size() == roots.size() + 1
+                && f.rep.back() == bignum(1);
+      for (auto const & r : roots) {
+        auto y = f.rep.back();
+        for (size_t i = f.rep.size() - 1; i--;) {
+          y = y.mul_mod(r, p).add_mod(f.rep[i], p);
+        }
+        ok = ok && y.is_zero();
+      }
+      SST_TEST_BOOL((ok));
+    }
+
+    //------------------------------------------------------------------
+    // update_linear_expansion() above the crossover
+    //------------------------------------------------------------------
+
+    for (size_t const n : {ntt_crossover, 2 * ntt_crossover + 3}) {
+      auto h = random_poly(n + 1);
+      auto hbar = random_poly(n);
+      NumX x{p, h};
+      NumX xbar{p, hbar};
+      update_linear_expansion(x, xbar);
+      graeffe_step(h, hbar);
+      SST_TEST_BOOL((x.rep == h && xbar.rep == hbar));
+    }
+
+    //------------------------------------------------------------------
+    // tangent_graeffe_transform() above the crossover
+    //------------------------------------------------------------------
+
+    {
+      auto const roots = random_poly(ntt_crossover + 8);
+      auto const f = build_from_roots(p, roots);
+      auto const tau = bignum::rand_range(p);
+      auto const hs = tangent_graeffe_transform(f, bignum(256), tau);
+      auto ref = initial_linear_expansion(f, tau);
+      auto & h = ref.first.rep;
+      auto & hbar = ref.second.rep;
+      for (int i = 0; i < 8; ++i) {
+        graeffe_step(h, hbar);
+      }
+      SST_TEST_BOOL((hs.first.rep == h && hs.second.rep == hbar));
+    }
+
+    //------------------------------------------------------------------
+    // find_roots() above the crossover
+    //------------------------------------------------------------------
+    //
+    // find_roots() picks its own random shift, so the NTT path is
+    // checked against the roots themselves. The prime is the one the
+    // mix uses, whose odd factor must exceed the number of roots.
+    //
+
+    {
+      long const m = 123;
+      long const M = 101;
+      bignum const q = (bignum(1) << m) * bignum(M) + bignum(1);
+      vector<bignum> roots;
+      while (roots.size() < ntt_crossover + 8) {
+        auto const r = bignum::rand_range(q);
+        if (std::find(roots.begin(), roots.end(), r) == roots.end()) {
+          roots.emplace_back(r);
+        }
+      }
+      auto x = find_roots(build_from_roots(q, roots), bignum(3), m, M);
+      auto const less = [](bignum const & a, bignum const & b) {
+        return a < b;
+      };
+      std::sort(roots.begin(), roots.end(), less);
+      std::sort(x.begin(), x.end(), less);
+      SST_TEST_BOOL((x == roots));
+    }
+
+    //------------------------------------------------------------------
+  });
+}
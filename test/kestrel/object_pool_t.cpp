@@ -0,0 +1,157 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/object_pool_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/object_pool_t.hpp>
+//
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/test_main.hpp>
+
+#include <kestrel/pooled.hpp>
+
+using kestrel::object_pool_t;
+using kestrel::pooled;
+
+namespace {
+
+struct resettable_t {
+  int resets = 0;
+  std::vector<std::string> big;
+  void pool_reset() {
+    ++resets;
+  }
+};
+
+struct plain_t {
+  int x = 0;
+};
+
+} // namespace
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    //------------------------------------------------------------------
+    // Released objects are reused
+    //------------------------------------------------------------------
+
+    {
+      auto & pool = object_pool_t<plain_t>::instance();
+      plain_t * first;
+      {
+        auto p = pool.acquire();
+        first = p.get();
+        p->x = 7;
+      }
+      auto p = pool.acquire();
+      SST_TEST_BOOL((p.get() == first));
+      SST_TEST_BOOL((p->x == 0));
+      auto const s = pool.stats();
+      SST_TEST_BOOL((s.acquires == 2 && s.hits == 1));
+      SST_TEST_BOOL((s.in_use == 1 && s.free == 0));
+    }
+
+    //------------------------------------------------------------------
+    // pool_reset is used when present
+    //------------------------------------------------------------------
+
+    {
+      auto & pool = object_pool_t<resettable_t>::instance();
+      {
+        auto p = pool.acquire();
+        p->big.resize(100);
+      }
+      auto p = pool.acquire();
+      SST_TEST_BOOL((p->resets == 1 && p->big.size() == 100));
+    }
+
+    //------------------------------------------------------------------
+    // Vectors of trivial elements are cleared but keep their capacity
+    //------------------------------------------------------------------
+
+    {
+      auto & pool = object_pool_t<std::vector<unsigned char>>::instance();
+      {
+        auto p = pool.acquire();
+        p->resize(1000);
+      }
+      auto p = pool.acquire();
+      SST_TEST_BOOL((p->empty() && p->capacity() >= 1000));
+    }
+
+    //------------------------------------------------------------------
+    // The free list is bounded
+    //------------------------------------------------------------------
+
+    {
+      auto & pool = object_pool_t<std::vector<int>>::instance();
+      pool.set_max_free(2);
+      {
+        std::vector<pooled<std::vector<int>>> ps;
+        for (int i = 0; i != 5; ++i) {
+          ps.push_back(pool.acquire());
+        }
+      }
+      auto const s = pool.stats();
+      SST_TEST_BOOL((s.free == 2 && s.discards == 3 && s.in_use == 0));
+    }
+
+    //------------------------------------------------------------------
+    // A default constructed pooled<T> just deletes
+    //------------------------------------------------------------------
+
+    {
+      pooled<plain_t> p(new plain_t);
+      p.reset();
+      SST_TEST_BOOL((p == nullptr));
+    }
+
+    //------------------------------------------------------------------
+    // Concurrent use
+    //------------------------------------------------------------------
+
+    {
+      auto & pool = object_pool_t<std::vector<double>>::instance();
+      std::vector<std::thread> threads;
+      for (int t = 0; t != 4; ++t) {
+        threads.emplace_back([&pool]() {
+          for (int i = 0; i != 10000; ++i) {
+            auto p = pool.acquire();
+            p->push_back(i);
+          }
+        });
+      }
+      for (auto & thread : threads) {
+        thread.join();
+      }
+      auto const s = pool.stats();
+      SST_TEST_BOOL((s.acquires == 40000 && s.in_use == 0));
+      SST_TEST_BOOL((kestrel::object_pool_stats().size() >= 5));
+    }
+
+    //------------------------------------------------------------------
+  });
+}
@@ -0,0 +1,126 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/pkc/shared_key_cache_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/pkc/shared_key_cache_t.hpp>
+//
+
+#include <vector>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/test_main.hpp>
+
+#include <kestrel/pkc.hpp>
+
+using namespace kestrel;
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    using bytes = std::vector<unsigned char>;
+
+    auto const a = pkc::generate_keypair();
+    auto const b = pkc::generate_keypair();
+    auto const c = pkc::generate_keypair();
+    bytes const pt = {1, 2, 3, 4, 5};
+
+    //------------------------------------------------------------------
+    // Both directions compute the same shared key
+    //------------------------------------------------------------------
+
+    {
+      pkc::shared_key_cache_t cache;
+      SST_TEST_BOOL((cache.get(a.second, b.first)
+                     == cache.get(b.second, a.first)));
+      SST_TEST_BOOL((cache.get(a.second, b.first)
+                     != cache.get(a.second, c.first)));
+      SST_TEST_BOOL((cache.size() == 3));
+      SST_TEST_BOOL((cache.misses() == 3 && cache.hits() == 1));
+    }
+
+    //------------------------------------------------------------------
+    // The afternm variants interoperate with the plain ones
+    //------------------------------------------------------------------
+
+    {
+      pkc::shared_key_cache_t cache;
+      auto const k_ab = cache.get(a.second, b.first);
+      auto const k_ba = cache.get(b.second, a.first);
+
+      auto const ct1 = pkc::auth_encrypt_afternm(k_ab, pt).first;
+      SST_TEST_BOOL((pkc::auth_decrypt(a.first, b.second, ct1).first
+                     == pt));
+
+      auto const ct2 = pkc::auth_encrypt(a.second, b.first, pt).first;
+      bytes pt2;
+      pkc::auth_decrypt_afternm(k_ba, ct2, pt2);
+      SST_TEST_BOOL((pt2 == pt));
+
+      auto const k_cb = cache.get(c.second, b.first);
+      bool threw = false;
+      try {
+        bytes pt3;
+        pkc::auth_decrypt_afternm(k_cb, ct1, pt3);
+      } catch (pkc::invalid_ciphertext const &) {
+        threw = true;
+      }
+      SST_TEST_BOOL((threw));
+    }
+
+    //------------------------------------------------------------------
+    // Size cap
+    //------------------------------------------------------------------
+
+    {
+      pkc::shared_key_cache_t cache(2);
+      cache.get(a.second, b.first);
+      cache.get(a.second, c.first);
+      cache.get(b.second, c.first);
+      SST_TEST_BOOL((cache.size() == 2));
+      cache.clear();
+      SST_TEST_BOOL((cache.size() == 0));
+    }
+
+    //------------------------------------------------------------------
+    // The least recently used entry is evicted first
+    //------------------------------------------------------------------
+
+    {
+      pkc::shared_key_cache_t cache(2);
+      cache.get(a.second, b.first);
+      cache.get(a.second, c.first);
+      cache.get(a.second, b.first);
+      SST_TEST_BOOL((cache.misses() == 2 && cache.hits() == 1));
+      cache.get(b.second, c.first);
+      SST_TEST_BOOL((cache.size() == 2));
+      cache.get(a.second, b.first);
+      SST_TEST_BOOL((cache.misses() == 3 && cache.hits() == 2));
+      cache.get(a.second, c.first);
+      SST_TEST_BOOL((cache.misses() == 4 && cache.hits() == 2));
+      cache.get(a.second, b.first);
+      SST_TEST_BOOL((cache.misses() == 4 && cache.hits() == 3));
+      cache.clear();
+      SST_TEST_BOOL((cache.size() == 0));
+    }
+
+    //------------------------------------------------------------------
+  });
+}
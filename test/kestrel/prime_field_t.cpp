@@ -0,0 +1,91 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/prime_field_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/prime_field_t.hpp>
+//
+
+#include <cstddef>
+#include <vector>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/bigint.hpp>
+#include <sst/catalog/test_main.hpp>
+
+#include <kestrel/secret_sharing.hpp>
+
+using namespace kestrel;
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    for (sst::bigint const p : {
+             sst::bigint(3221225473L),
+             (sst::bigint(1) << 3767) * 101 + 1,
+         }) {
+      mix_field_t const field(p);
+
+      for (int k = 0; k < 20; ++k) {
+        auto const a = rand_range(p);
+        auto const b = rand_range(p);
+        auto const fa = field.from_bigint(a);
+        auto const fb = field.from_bigint(b);
+        SST_TEST_BOOL((field.to_bigint(fa) == a));
+        SST_TEST_BOOL((field.to_bigint(field.add(fa, fb))
+                       == add_mod(a, b, p)));
+        SST_TEST_BOOL((field.to_bigint(field.sub(fa, fb))
+                       == sub_mod(a, b, p)));
+        SST_TEST_BOOL((field.to_bigint(field.mul(fa, fb))
+                       == mul_mod(a, b, p)));
+        SST_TEST_BOOL((field.is_zero(fa)
+                       || field.mul(fa, field.inv(fa)) == field.one()));
+      }
+
+      {
+        std::vector<mix_field_t::element_t> xs;
+        for (int k = 1; k <= 10; ++k) {
+          xs.push_back(field.from_uint(k));
+        }
+        auto ys = xs;
+        field.batch_inv(ys);
+        bool ok = true;
+        for (std::size_t i = 0; i < xs.size(); ++i) {
+          ok = ok && field.mul(xs[i], ys[i]) == field.one();
+        }
+        SST_TEST_BOOL((ok));
+      }
+
+      {
+        auto const secret = rand_range(p);
+        std::vector<sst::bigint> shrs;
+        sss_share(shrs, secret, 7, 3, field);
+        std::vector<std::size_t> const pts = {6, 1, 4, 2};
+        sst::bigint a;
+        sst::bigint b;
+        sss_recon(a, shrs, pts, field);
+        sss_recon(b, shrs, pts, p);
+        SST_TEST_BOOL((a == secret && b == secret));
+      }
+    }
+
+    ;
+  });
+}
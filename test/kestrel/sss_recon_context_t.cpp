@@ -0,0 +1,211 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/sss_recon_context_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/sss_recon_context_t.hpp>
+//
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/SST_TEST_THROW.hpp>
+#include <sst/catalog/bigint.hpp>
+#include <sst/catalog/test_main.hpp>
+
+#include <kestrel/prime_field_t.hpp>
+#include <kestrel/secret_sharing.hpp>
+
+using namespace kestrel;
+
+namespace {
+
+struct shape_t final {
+  std::size_t numshares;
+  std::size_t degree;
+};
+
+// Some threshold-sized point sets for a shape: the first, the last,
+// every other one, and all of them.
+std::vector<std::vector<std::size_t>> point_sets(shape_t const & s) {
+  std::vector<std::vector<std::size_t>> sets(4);
+  for (std::size_t i = 0; i != s.degree + 1; ++i) {
+    sets[0].push_back(i);
+    sets[1].push_back(s.numshares - s.degree - 1 + i);
+  }
+  for (std::size_t i = 0; i < s.numshares; i += 2) {
+    if (sets[2].size() != s.degree + 1) {
+      sets[2].push_back(i);
+    }
+  }
+  for (std::size_t i = 1; i < s.numshares; i += 2) {
+    if (sets[2].size() != s.degree + 1) {
+      sets[2].push_back(i);
+    }
+  }
+  for (std::size_t i = 0; i != s.numshares; ++i) {
+    sets[3].push_back(i);
+  }
+  return sets;
+}
+
+} // namespace
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    for (sst::bigint const p : {
+             sst::bigint(3221225473L),
+             (sst::bigint(1) << 3767) * 101 + 1,
+         }) {
+      mix_field_t const field(p);
+
+      //----------------------------------------------------------------
+      // Both contexts agree with sss_recon, from the smallest shape
+      // up to a threshold of every share
+      //----------------------------------------------------------------
+
+      for (shape_t const s : {
+               shape_t{2, 1},
+               shape_t{3, 1},
+               shape_t{3, 2},
+               shape_t{7, 3},
+               shape_t{7, 6},
+           }) {
+        for (sst::bigint const secret : {
+                 sst::bigint(0),
+                 sst::bigint(1),
+                 p - 1,
+                 rand_range(p),
+             }) {
+          std::vector<sst::bigint> shrs;
+          sss_share(shrs, secret, s.numshares, s.degree, p);
+          for (auto const & pts : point_sets(s)) {
+            sss_recon_context_t const a(pts, p);
+            sss_recon_context_t const b(pts, field);
+            SST_TEST_BOOL((a.coeffs() == b.coeffs()));
+            sst::bigint x;
+            sss_recon(x, shrs, pts, p);
+            sst::bigint y;
+            a.recon(y, shrs);
+            sst::bigint z;
+            b.recon(z, shrs);
+            SST_TEST_BOOL((x == secret));
+            SST_TEST_BOOL((y == secret));
+            SST_TEST_BOOL((z == secret));
+          }
+        }
+      }
+
+      //----------------------------------------------------------------
+      // recon_many matches recon for each secret
+      //----------------------------------------------------------------
+
+      {
+        shape_t const s{7, 3};
+        std::vector<std::size_t> const pts = {1, 2, 4, 6};
+        std::vector<sst::bigint> secrets;
+        std::vector<std::vector<sst::bigint>> by_secret;
+        for (int j = 0; j != 5; ++j) {
+          secrets.push_back(rand_range(p));
+          by_secret.emplace_back();
+          sss_share(by_secret.back(),
+                    secrets.back(),
+                    s.numshares,
+                    s.degree,
+                    field);
+        }
+        std::vector<std::vector<sst::bigint>> by_point(s.numshares);
+        for (auto const & shrs : by_secret) {
+          for (std::size_t i = 0; i != s.numshares; ++i) {
+            by_point[i].push_back(shrs[i]);
+          }
+        }
+        std::vector<std::vector<sst::bigint> const *> rows;
+        for (auto const i : pts) {
+          rows.push_back(&by_point[i]);
+        }
+        for (bool const use_field : {false, true}) {
+          sss_recon_context_t const ctx =
+              use_field ? sss_recon_context_t(pts, field)
+                        : sss_recon_context_t(pts, p);
+          std::vector<sst::bigint> out(secrets.size());
+          ctx.recon_many(out, rows);
+          SST_TEST_BOOL((out == secrets));
+          for (std::size_t j = 0; j != secrets.size(); ++j) {
+            sst::bigint x;
+            ctx.recon(x, by_secret[j]);
+            SST_TEST_BOOL((x == secrets[j]));
+          }
+        }
+      }
+
+      //----------------------------------------------------------------
+      // A single point reconstructs a constant polynomial
+      //----------------------------------------------------------------
+
+      {
+        sst::bigint const secret = rand_range(p);
+        std::vector<sst::bigint> const shrs(4, secret);
+        for (std::size_t const k : {0, 3}) {
+          sss_recon_context_t const a({k}, p);
+          sss_recon_context_t const b({k}, field);
+          SST_TEST_BOOL((a.coeffs() == std::vector<sst::bigint>{1}));
+          SST_TEST_BOOL((b.coeffs() == std::vector<sst::bigint>{1}));
+          sst::bigint x;
+          a.recon(x, shrs);
+          SST_TEST_BOOL((x == secret));
+          b.recon(x, shrs);
+          SST_TEST_BOOL((x == secret));
+        }
+      }
+
+      //----------------------------------------------------------------
+      // Bad inputs are rejected
+      //----------------------------------------------------------------
+
+      {
+        std::vector<std::size_t> const pts = {0, 5};
+        std::vector<sst::bigint> const shrs(5, 1);
+        for (bool const use_field : {false, true}) {
+          sss_recon_context_t const ctx =
+              use_field ? sss_recon_context_t(pts, field)
+                        : sss_recon_context_t(pts, p);
+          sst::bigint x;
+          SST_TEST_THROW((ctx.recon(x, shrs)), std::runtime_error);
+          std::vector<sst::bigint> out(1);
+          std::vector<std::vector<sst::bigint> const *> const rows = {
+              &shrs};
+          SST_TEST_THROW((ctx.recon_many(out, rows)),
+                         std::runtime_error);
+          std::vector<std::vector<sst::bigint> const *> const
+              short_rows = {&shrs, &shrs};
+          std::vector<sst::bigint> too_many(6);
+          SST_TEST_THROW((ctx.recon_many(too_many, short_rows)),
+                         std::runtime_error);
+        }
+      }
+    }
+
+    //------------------------------------------------------------------
+  });
+}
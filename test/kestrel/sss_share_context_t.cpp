@@ -0,0 +1,86 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/sss_share_context_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/sss_share_context_t.hpp>
+//
+
+#include <cstddef>
+#include <vector>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/bigint.hpp>
+#include <sst/catalog/test_main.hpp>
+
+#include <kestrel/prime_field_t.hpp>
+#include <kestrel/sss_recon_context_t.hpp>
+
+using namespace kestrel;
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    sst::bigint const p = (sst::bigint(1) << 3767) * 101 + 1;
+    mix_field_t const field(p);
+
+    std::vector<sst::bigint> secrets;
+    for (int j = 0; j < 5; ++j) {
+      secrets.push_back(rand_range(p));
+    }
+    std::vector<std::size_t> const pts = {0, 2, 3, 5};
+
+    auto const check = [&](sss_share_context_t & share,
+                           sss_recon_context_t const & recon) {
+      std::vector<std::vector<sst::bigint>> shrs;
+      share.share_many(shrs, secrets);
+      if (shrs.size() != 6) {
+        return false;
+      }
+      std::vector<std::vector<sst::bigint> const *> rows;
+      for (auto const i : pts) {
+        rows.push_back(&shrs[i]);
+      }
+      std::vector<sst::bigint> out(secrets.size());
+      recon.recon_many(out, rows);
+      return out == secrets;
+    };
+
+    {
+      sss_share_context_t share(6, 3, p);
+      sss_recon_context_t const recon(pts, p);
+      SST_TEST_BOOL((check(share, recon)));
+    }
+
+    {
+      sss_share_context_t share(6, 3, field);
+      sss_recon_context_t const recon(pts, field);
+      SST_TEST_BOOL((check(share, recon)));
+    }
+
+    {
+      sss_share_context_t share(6, 3, field);
+      sss_recon_context_t const recon(pts, p);
+      SST_TEST_BOOL((check(share, recon)));
+    }
+
+    ;
+  });
+}
@@ -0,0 +1,180 @@
+//
+// Copyright (C) 2019-2024 Stealth Software Technologies, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an "AS
+// IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language
+// governing permissions and limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Include first to test independence.
+#include <kestrel/timer_wheel_t.hpp>
+// Include twice to test idempotence.
+#include <kestrel/timer_wheel_t.hpp>
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <sst/catalog/SST_TEST_BOOL.hpp>
+#include <sst/catalog/test_main.hpp>
+
+using kestrel::timer_wheel_t;
+
+int main() {
+  return sst::test_main([] {
+    ;
+
+    //------------------------------------------------------------------
+    // Items come due at their deadlines, not before
+    //------------------------------------------------------------------
+
+    {
+      timer_wheel_t<int> w(10);
+      w.advance(0);
+      w.insert(1, 25);
+      w.insert(2, 5);
+      w.insert(3, 0);
+      timer_wheel_t<int>::handle_t h;
+      SST_TEST_BOOL((w.next_ready(h) && w.value(h) == 3));
+      w.erase(h);
+      SST_TEST_BOOL((!w.next_ready(h)));
+      w.advance(9);
+      SST_TEST_BOOL((!w.next_ready(h)));
+      w.advance(10);
+      SST_TEST_BOOL((w.next_ready(h) && w.value(h) == 2));
+      w.erase(h);
+      w.advance(29);
+      SST_TEST_BOOL((!w.next_ready(h)));
+      w.advance(30);
+      SST_TEST_BOOL((w.next_ready(h) && w.value(h) == 1));
+      w.erase(h);
+      SST_TEST_BOOL((w.empty()));
+    }
+
+    //------------------------------------------------------------------
+    // Far deadlines cascade down through every level
+    //------------------------------------------------------------------
+
+    {
+      using wheel_t = timer_wheel_t<std::int64_t, 1, 2, 3>;
+      wheel_t w(1);
+      w.advance(0);
+      std::mt19937_64 rng(1);
+      std::vector<std::int64_t> deadlines;
+      for (int i = 0; i < 1000; ++i) {
+        // Up to well past the 64 ticks that 3 levels of 4 slots reach.
+        auto const d = static_cast<std::int64_t>(rng() % 500);
+        deadlines.push_back(d);
+        w.insert(d, d);
+      }
+      std::size_t seen = 0;
+      bool early = false;
+      bool late = false;
+      for (std::int64_t now = 0; now < 600; ++now) {
+        w.advance(now);
+        wheel_t::handle_t h;
+        while (w.next_ready(h)) {
+          early = early || w.value(h) > now;
+          late = late || w.value(h) < now;
+          w.erase(h);
+          ++seen;
+        }
+      }
+      SST_TEST_BOOL((!early));
+      SST_TEST_BOOL((!late));
+      SST_TEST_BOOL((seen == deadlines.size()));
+    }
+
+    //------------------------------------------------------------------
+    // Ready items come out most urgent first
+    //------------------------------------------------------------------
+
+    {
+      timer_wheel_t<int, 3> w(10);
+      w.advance(0);
+      w.insert(20, 10, 2);
+      w.insert(10, 10, 1);
+      w.insert(0, 30, 0);
+      w.insert(11, 10, 1);
+      w.advance(100);
+      SST_TEST_BOOL((w.ready() == 4));
+      std::vector<int> order;
+      timer_wheel_t<int, 3>::handle_t h;
+      while (w.next_ready(h)) {
+        order.push_back(w.value(h));
+        w.erase(h);
+      }
+      SST_TEST_BOOL((order == std::vector<int>{0, 10, 11, 20}));
+    }
+
+    //------------------------------------------------------------------
+    // Handles survive rescheduling and cascading
+    //------------------------------------------------------------------
+
+    {
+      timer_wheel_t<int, 1, 2, 2> w(1);
+      w.advance(0);
+      auto const a = w.insert(1, 100);
+      auto const b = w.insert(2, 12);
+      w.advance(12);
+      timer_wheel_t<int, 1, 2, 2>::handle_t h;
+      SST_TEST_BOOL((w.next_ready(h) && h == b));
+      w.reschedule(b, 14);
+      SST_TEST_BOOL((w.ready() == 0 && w.size() == 2));
+      w.erase(a);
+      w.advance(14);
+      SST_TEST_BOOL((w.next_ready(h) && h == b && w.size() == 1));
+      w.erase(h);
+      SST_TEST_BOOL((w.empty()));
+    }
+
+    //------------------------------------------------------------------
+    // Items inserted before the first advance, and long jumps
+    //------------------------------------------------------------------
+
+    {
+      std::int64_t const t0 = std::int64_t(1) << 40;
+      timer_wheel_t<int> w(1);
+      w.insert(1, t0 + 5);
+      w.insert(2, t0 + 100000);
+      w.advance(t0);
+      timer_wheel_t<int>::handle_t h;
+      SST_TEST_BOOL((!w.next_ready(h)));
+      w.advance(t0 + 5);
+      SST_TEST_BOOL((w.next_ready(h) && w.value(h) == 1));
+      w.erase(h);
+      w.advance(t0 + 99999);
+      SST_TEST_BOOL((!w.next_ready(h)));
+      w.advance(t0 + 100000);
+      SST_TEST_BOOL((w.next_ready(h) && w.value(h) == 2));
+    }
+
+    //------------------------------------------------------------------
+    // A long idle gap with nothing pending is skipped
+    //------------------------------------------------------------------
+
+    {
+      timer_wheel_t<int> w(1);
+      w.advance(0);
+      w.advance(std::int64_t(1) << 40);
+      w.insert(1, (std::int64_t(1) << 40) + 3);
+      w.advance((std::int64_t(1) << 40) + 3);
+      timer_wheel_t<int>::handle_t h;
+      SST_TEST_BOOL((w.next_ready(h) && w.value(h) == 1));
+    }
+
+    //------------------------------------------------------------------
+  });
+}